@@ -0,0 +1,132 @@
+/* Copyright 2023 The StableHLO Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "stablehlo/reference/BufferPool.h"
+
+#include <algorithm>
+#include <mutex>
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/MemAlloc.h"
+
+namespace mlir {
+namespace stablehlo {
+namespace {
+
+// Upper bound for the number of bytes of cached buffers. Buffers which are
+// freed while the cache is full are returned to the system.
+constexpr uint64_t kMaxBytesCached = uint64_t(1) << 30;
+
+// Returns the number of bytes of the buffers which the pool hands out for
+// requests of `size` bytes: multiples of `kBufferAlignment` up to four times
+// the alignment, and four sizes per power of two above, so that at most a
+// fifth of a buffer goes to waste.
+size_t getSizeClass(size_t size) {
+  size = llvm::alignTo(std::max<size_t>(size, 1), kBufferAlignment);
+  if (size <= 4 * kBufferAlignment) return size;
+  return llvm::alignTo(size, (uint64_t(1) << llvm::Log2_64(size)) / 4);
+}
+
+class BufferPool {
+ public:
+  static BufferPool &get() {
+    // Leaked, as blobs may outlive static destructors.
+    static BufferPool *pool = new BufferPool();
+    return *pool;
+  }
+
+  void *allocate(size_t sizeClass) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    statistics_.numBytesInUse += sizeClass;
+    statistics_.peakBytesInUse =
+        std::max(statistics_.peakBytesInUse, statistics_.numBytesInUse);
+    auto it = freeBuffers_.find(sizeClass);
+    if (it != freeBuffers_.end() && !it->second.empty()) {
+      ++statistics_.numHits;
+      statistics_.numBytesCached -= sizeClass;
+      return it->second.pop_back_val();
+    }
+    ++statistics_.numMisses;
+    return llvm::allocate_buffer(sizeClass, kBufferAlignment);
+  }
+
+  void deallocate(void *data, size_t sizeClass) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      statistics_.numBytesInUse -= sizeClass;
+      if (statistics_.numBytesCached + sizeClass <= kMaxBytesCached) {
+        statistics_.numBytesCached += sizeClass;
+        freeBuffers_[sizeClass].push_back(data);
+        return;
+      }
+    }
+    llvm::deallocate_buffer(data, sizeClass, kBufferAlignment);
+  }
+
+  BufferPoolStatistics getStatistics() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return statistics_;
+  }
+
+  void resetStatistics() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    statistics_.numHits = 0;
+    statistics_.numMisses = 0;
+    statistics_.peakBytesInUse = statistics_.numBytesInUse;
+  }
+
+  void trim() {
+    llvm::DenseMap<size_t, SmallVector<void *>> freeBuffers;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      std::swap(freeBuffers, freeBuffers_);
+      statistics_.numBytesCached = 0;
+    }
+    for (auto &[sizeClass, buffers] : freeBuffers)
+      for (void *data : buffers)
+        llvm::deallocate_buffer(data, sizeClass, kBufferAlignment);
+  }
+
+ private:
+  std::mutex mutex_;
+  llvm::DenseMap<size_t, SmallVector<void *>> freeBuffers_;
+  BufferPoolStatistics statistics_;
+};
+
+}  // namespace
+
+AsmResourceBlob allocatePooledBlob(size_t size) {
+  size_t sizeClass = getSizeClass(size);
+  char *data = static_cast<char *>(BufferPool::get().allocate(sizeClass));
+  return AsmResourceBlob(
+      ArrayRef<char>(data, size), kBufferAlignment,
+      [sizeClass](void *data, size_t, size_t) {
+        BufferPool::get().deallocate(data, sizeClass);
+      },
+      /*dataIsMutable=*/true);
+}
+
+BufferPoolStatistics getBufferPoolStatistics() {
+  return BufferPool::get().getStatistics();
+}
+
+void resetBufferPoolStatistics() { BufferPool::get().resetStatistics(); }
+
+void trimBufferPool() { BufferPool::get().trim(); }
+
+}  // namespace stablehlo
+}  // namespace mlir
@@ -0,0 +1,69 @@
+/* Copyright 2023 The StableHLO Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef STABLEHLO_REFERENCE_BUFFERPOOL_H
+#define STABLEHLO_REFERENCE_BUFFERPOOL_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "mlir/IR/AsmState.h"
+
+namespace mlir {
+namespace stablehlo {
+
+/// Alignment of the storage of tensors, which is suitable for aligned vector
+/// loads and stores of any width.
+constexpr size_t kBufferAlignment = 64;
+
+/// Counters of the buffer pool of the interpreter.
+struct BufferPoolStatistics {
+  /// Number of allocations which reused a cached buffer, and number of
+  /// allocations which allocated a new buffer.
+  uint64_t numHits = 0;
+  uint64_t numMisses = 0;
+
+  /// Number of bytes of the buffers which are in use, and the highest number
+  /// of bytes in use at any point since the statistics were last reset.
+  uint64_t numBytesInUse = 0;
+  uint64_t peakBytesInUse = 0;
+
+  /// Number of bytes of the buffers which are cached for reuse.
+  uint64_t numBytesCached = 0;
+};
+
+/// Returns a blob of `size` bytes, aligned to `kBufferAlignment`, whose
+/// storage comes from the buffer pool of the interpreter. Buffers are
+/// rounded up to one of a few size classes per power of two, and destroying
+/// the blob returns its buffer to the pool, which caches freed buffers by
+/// size class. So evaluators which allocate results of the same sizes over
+/// and over, e.g. in the body of a `while` loop, only allocate new memory in
+/// the first iteration. The storage isn't initialized. Thread-safe.
+AsmResourceBlob allocatePooledBlob(size_t size);
+
+/// Returns the counters of the buffer pool.
+BufferPoolStatistics getBufferPoolStatistics();
+
+/// Resets the hit and miss counters of the buffer pool, and the peak number
+/// of bytes in use to the current number of bytes in use.
+void resetBufferPoolStatistics();
+
+/// Frees all buffers which are cached by the buffer pool.
+void trimBufferPool();
+
+}  // namespace stablehlo
+}  // namespace mlir
+
+#endif  // STABLEHLO_REFERENCE_BUFFERPOOL_H
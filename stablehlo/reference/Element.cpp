@@ -15,10 +15,14 @@ limitations under the License.
 
 #include "stablehlo/reference/Element.h"
 
+#include <algorithm>
+#include <cmath>
 #include <complex>
+#include <limits>
 
 #include "llvm/ADT/APFloat.h"
 #include "llvm/Support/Error.h"
+#include "llvm/Support/MathExtras.h"
 #include "mlir/Dialect/Complex/IR/Complex.h"
 #include "mlir/IR/BuiltinAttributes.h"
 #include "mlir/Support/DebugStringHelper.h"
@@ -30,31 +34,78 @@ namespace stablehlo {
 
 namespace {
 
+// TODO(#22): StableHLO, as bootstrapped from MHLO, inherits signless integers
+// which was added in MHLO for legacy reasons. Signless integers are signed.
+bool isSigned(Type type) { return !type.isUnsignedInteger(); }
+
+// Returns the low bits of `value` which fit into the integer type `type`.
+uint64_t getBits(Type type, int64_t value) {
+  return static_cast<uint64_t>(value) &
+         llvm::maskTrailingOnes<uint64_t>(type.getIntOrFloatBitWidth());
+}
+
+// Returns the bits of `value` which fit into the integer type `type`,
+// sign-extended if `type` is signed and zero-extended otherwise.
+int64_t normalizeInteger(Type type, int64_t value) {
+  if (isSigned(type))
+    return llvm::SignExtend64(static_cast<uint64_t>(value),
+                              type.getIntOrFloatBitWidth());
+  return static_cast<int64_t>(getBits(type, value));
+}
+
+// Rounds `value` to nearest, ties to even, to the floating-point type `type`.
+// Rounding the exact result of an operation on values of `type` to `double`
+// first doesn't change the result of this rounding, as `double` has more than
+// twice the precision of the narrower supported types.
+double roundToType(double value, Type type) {
+  if (type.isF64()) return value;
+  if (type.isF32()) return static_cast<float>(value);
+  APFloat result(value);
+  bool losesInfo;
+  result.convert(type.cast<FloatType>().getFloatSemantics(),
+                 APFloat::rmNearestTiesToEven, &losesInfo);
+  return result.convertToDouble();
+}
+
+// Returns `value`, which is a value of the floating-point type `type`, with
+// the semantics of `type`.
+APFloat getAPFloat(double value, Type type) {
+  APFloat result(value);
+  if (type.isF64()) return result;
+  bool losesInfo;
+  result.convert(type.cast<FloatType>().getFloatSemantics(),
+                 APFloat::rmNearestTiesToEven, &losesInfo);
+  return result;
+}
+
+Type getComplexElementType(Type type) {
+  return type.cast<ComplexType>().getElementType();
+}
+
 template <typename IntegerFn, typename BooleanFn, typename FloatFn,
           typename ComplexFn>
 Element map(const Element &el, IntegerFn integerFn, BooleanFn boolFn,
             FloatFn floatFn, ComplexFn complexFn) {
   Type type = el.getType();
 
-  if (isSupportedIntegerType(type)) {
-    auto intEl = el.getIntegerValue();
-    return Element(type, integerFn(intEl));
-  }
-
   if (isSupportedBooleanType(type)) {
     auto boolEl = el.getBooleanValue();
     return Element(type, boolFn(boolEl));
   }
 
-  if (isSupportedFloatType(type)) {
-    auto floatEl = el.getFloatValue();
-    return Element(type, floatFn(floatEl));
+  if (type.isa<IntegerType>()) {
+    auto intEl = el.getNativeIntegerValue();
+    return Element(type, static_cast<int64_t>(integerFn(intEl)));
   }
 
-  if (isSupportedComplexType(type)) {
-    auto complexEl = el.getComplexValue();
-    auto complexResult = complexFn(complexEl);
-    return Element(type, complexResult);
+  if (type.isa<FloatType>()) {
+    auto floatEl = el.getNativeFloatValue();
+    return Element(type, static_cast<double>(floatFn(floatEl)));
+  }
+
+  if (type.isa<ComplexType>()) {
+    auto complexEl = el.getNativeComplexValue();
+    return Element(type, std::complex<double>(complexFn(complexEl)));
   }
 
   report_fatal_error(invalidArgument("Unsupported element type: %s",
@@ -71,66 +122,113 @@ Element map(const Element &lhs, const Element &rhs, IntegerFn integerFn,
                                        debugString(lhs.getType()).c_str(),
                                        debugString(rhs.getType()).c_str()));
 
-  if (isSupportedIntegerType(type)) {
-    auto intLhs = lhs.getIntegerValue();
-    auto intRhs = rhs.getIntegerValue();
-    return Element(type, integerFn(intLhs, intRhs));
-  }
-
   if (isSupportedBooleanType(type)) {
     auto boolLhs = lhs.getBooleanValue();
     auto boolRhs = rhs.getBooleanValue();
     return Element(type, boolFn(boolLhs, boolRhs));
   }
 
-  if (isSupportedFloatType(type)) {
-    auto floatLhs = lhs.getFloatValue();
-    auto floatRhs = rhs.getFloatValue();
-    return Element(type, floatFn(floatLhs, floatRhs));
+  if (type.isa<IntegerType>()) {
+    auto intLhs = lhs.getNativeIntegerValue();
+    auto intRhs = rhs.getNativeIntegerValue();
+    return Element(type, static_cast<int64_t>(integerFn(intLhs, intRhs)));
   }
 
-  if (isSupportedComplexType(type)) {
-    auto complexLhs = lhs.getComplexValue();
-    auto complexRhs = rhs.getComplexValue();
-    auto complexResult = complexFn(complexLhs, complexRhs);
-    return Element(type, complexResult);
+  if (type.isa<FloatType>()) {
+    auto floatLhs = lhs.getNativeFloatValue();
+    auto floatRhs = rhs.getNativeFloatValue();
+    return Element(type, static_cast<double>(floatFn(floatLhs, floatRhs)));
+  }
+
+  if (type.isa<ComplexType>()) {
+    auto complexLhs = lhs.getNativeComplexValue();
+    auto complexRhs = rhs.getNativeComplexValue();
+    return Element(type,
+                   std::complex<double>(complexFn(complexLhs, complexRhs)));
   }
 
   report_fatal_error(invalidArgument("Unsupported element type: %s",
                                      debugString(type).c_str()));
 }
 
+// Applies `floatFn` or `complexFn` to the values of Element objects with
+// floating-point or complex type, which are computed in `double` and then
+// rounded to the element type.
 template <typename FloatFn, typename ComplexFn>
 Element mapWithUpcastToDouble(const Element &el, FloatFn floatFn,
                               ComplexFn complexFn) {
   Type type = el.getType();
+  if (type.isa<FloatType>() || type.isa<ComplexType>())
+    return map(
+        el,
+        [&](int64_t) -> int64_t {
+          llvm_unreachable("integers are handled above");
+        },
+        [&](bool) -> bool { llvm_unreachable("booleans are handled above"); },
+        floatFn, complexFn);
 
-  if (isSupportedFloatType(type)) {
-    APFloat elVal = el.getFloatValue();
-    const llvm::fltSemantics &elSemantics = elVal.getSemantics();
-    APFloat resultVal(floatFn(elVal.convertToDouble()));
-    bool roundingErr;
-    resultVal.convert(elSemantics, APFloat::rmNearestTiesToEven, &roundingErr);
-    return Element(type, resultVal);
-  }
+  report_fatal_error(invalidArgument("Unsupported element type: %s",
+                                     debugString(type).c_str()));
+}
 
-  if (isSupportedComplexType(type)) {
-    auto elVal = el.getComplexValue();
-    const llvm::fltSemantics &elSemantics = elVal.real().getSemantics();
-    auto resultVal = complexFn(std::complex<double>(
-        elVal.real().convertToDouble(), elVal.imag().convertToDouble()));
-    bool roundingErr;
-    APFloat resultReal(resultVal.real());
-    resultReal.convert(elSemantics, APFloat::rmNearestTiesToEven, &roundingErr);
-    APFloat resultImag(resultVal.imag());
-    resultImag.convert(elSemantics, APFloat::rmNearestTiesToEven, &roundingErr);
-    return Element(type, std::complex<APFloat>(resultReal, resultImag));
-  }
+template <typename FloatFn, typename ComplexFn>
+Element mapWithUpcastToDouble(const Element &lhs, const Element &rhs,
+                              FloatFn floatFn, ComplexFn complexFn) {
+  Type type = lhs.getType();
+  if (type.isa<FloatType>() || type.isa<ComplexType>())
+    return map(
+        lhs, rhs,
+        [&](int64_t, int64_t) -> int64_t {
+          llvm_unreachable("integers are handled above");
+        },
+        [&](bool, bool) -> bool {
+          llvm_unreachable("booleans are handled above");
+        },
+        floatFn, complexFn);
 
   report_fatal_error(invalidArgument("Unsupported element type: %s",
                                      debugString(type).c_str()));
 }
 
+// Applies `fn` to Element objects with integer type, which are the only types
+// that bitwise ops like shifts support.
+template <typename IntegerFn>
+Element mapInteger(const Element &lhs, const Element &rhs, IntegerFn fn,
+                   const char *name) {
+  return map(
+      lhs, rhs, fn,
+      [&](bool, bool) -> bool {
+        llvm::report_fatal_error(llvm::Twine(name) + " of bool is unsupported");
+      },
+      [&](double, double) -> double {
+        llvm::report_fatal_error(llvm::Twine(name) +
+                                 " of float is unsupported");
+      },
+      [&](std::complex<double>,
+          std::complex<double>) -> std::complex<double> {
+        llvm::report_fatal_error(llvm::Twine(name) +
+                                 " of complex is unsupported");
+      });
+}
+
+// Unary version of `mapInteger`.
+template <typename IntegerFn>
+Element mapInteger(const Element &el, IntegerFn fn, const char *name) {
+  return map(
+      el, fn,
+      [&](bool) -> bool {
+        llvm::report_fatal_error(llvm::Twine(name) + " of bool is unsupported");
+      },
+      [&](double) -> double {
+        llvm::report_fatal_error(llvm::Twine(name) +
+                                 " of float is unsupported");
+      },
+      [&](std::complex<double>) -> std::complex<double> {
+        llvm::report_fatal_error(llvm::Twine(name) +
+                                 " of complex is unsupported");
+      });
+}
+
 template <typename T>
 std::enable_if_t<std::is_floating_point<T>::value, bool> areApproximatelyEqual(
     T x, T y) {
@@ -141,54 +239,104 @@ std::enable_if_t<std::is_floating_point<T>::value, bool> areApproximatelyEqual(
          std::fabs(x - y) < std::numeric_limits<T>::min();
 }
 
-// Checks if two APFloat values, f and g, are almost equal.
-bool areApproximatelyEqual(APFloat f, APFloat g) {
-  if (&f.getSemantics() != &g.getSemantics()) return false;
-
-  llvm::APFloatBase::cmpResult cmpResult = f.compare(g);
-  if (cmpResult == APFloat::cmpEqual) return true;
-  if (cmpResult == APFloat::cmpUnordered) return f.isNaN() == g.isNaN();
-  if (!f.isFiniteNonZero() || !g.isFiniteNonZero()) return false;
+// Checks if two values f and g of the floating-point type `type` are almost
+// equal.
+bool areApproximatelyEqual(double f, double g, Type type) {
+  if (f == g) return true;
+  if (std::isnan(f) || std::isnan(g)) return std::isnan(f) == std::isnan(g);
+  if (!std::isfinite(f) || !std::isfinite(g) || f == 0 || g == 0)
+    return false;
 
   // Both f and g are normal values.
-  if (f.isNegative() != g.isNegative()) return false;
-  if (&f.getSemantics() == &llvm::APFloat::IEEEdouble())
-    return areApproximatelyEqual<double>(f.convertToDouble(),
-                                         g.convertToDouble());
+  if (std::signbit(f) != std::signbit(g)) return false;
+  if (type.isF64()) return areApproximatelyEqual<double>(f, g);
 
   // Convert the half and bfloat16 types to float before comparison.
-  return areApproximatelyEqual<float>(f.convertToFloat(), g.convertToFloat());
+  return areApproximatelyEqual<float>(static_cast<float>(f),
+                                      static_cast<float>(g));
 }
 
 }  // namespace
 
+Element::Element(Type type, APInt value)
+    : type_(type),
+      kind_(Kind::Integer),
+      integer_(normalizeInteger(type, static_cast<int64_t>(
+                                          value.getRawData()[0]))) {}
+
+Element::Element(Type type, int64_t value)
+    : type_(type),
+      kind_(Kind::Integer),
+      integer_(normalizeInteger(type, value)) {}
+
+Element::Element(Type type, APFloat value)
+    : type_(type),
+      kind_(Kind::Float),
+      float_(roundToType(value.convertToDouble(), type)) {}
+
+Element::Element(Type type, double value)
+    : type_(type), kind_(Kind::Float), float_(roundToType(value, type)) {}
+
+Element::Element(Type type, std::complex<APFloat> value)
+    : Element(type, std::complex<double>(value.real().convertToDouble(),
+                                         value.imag().convertToDouble())) {}
+
+Element::Element(Type type, std::complex<double> value)
+    : type_(type), kind_(Kind::Complex) {
+  Type elementType = getComplexElementType(type);
+  complex_[0] = roundToType(value.real(), elementType);
+  complex_[1] = roundToType(value.imag(), elementType);
+}
+
 APInt Element::getIntegerValue() const {
   if (!isSupportedIntegerType(type_))
     llvm::report_fatal_error("Element is not an integer");
 
-  return std::get<APInt>(value_);
+  return APInt(type_.getIntOrFloatBitWidth(), integer_, isSigned(type_));
 }
 
 bool Element::getBooleanValue() const {
   if (!isSupportedBooleanType(type_))
     llvm::report_fatal_error("Element is not a boolean");
 
-  return std::get<bool>(value_);
+  return boolean_;
 }
 
 APFloat Element::getFloatValue() const {
   if (!isSupportedFloatType(type_))
     llvm::report_fatal_error("Element is not a floating-point");
 
-  return std::get<APFloat>(value_);
+  return getAPFloat(float_, type_);
 }
 
 std::complex<APFloat> Element::getComplexValue() const {
   if (!isSupportedComplexType(type_))
     llvm::report_fatal_error("Element is not a complex value");
 
-  auto floatPair = std::get<std::pair<APFloat, APFloat>>(value_);
-  return std::complex<APFloat>(floatPair.first, floatPair.second);
+  Type elementType = getComplexElementType(type_);
+  return std::complex<APFloat>(getAPFloat(complex_[0], elementType),
+                               getAPFloat(complex_[1], elementType));
+}
+
+int64_t Element::getNativeIntegerValue() const {
+  if (kind_ != Kind::Integer)
+    llvm::report_fatal_error("Element is not an integer");
+
+  return integer_;
+}
+
+double Element::getNativeFloatValue() const {
+  if (kind_ != Kind::Float)
+    llvm::report_fatal_error("Element is not a floating-point");
+
+  return float_;
+}
+
+std::complex<double> Element::getNativeComplexValue() const {
+  if (kind_ != Kind::Complex)
+    llvm::report_fatal_error("Element is not a complex value");
+
+  return std::complex<double>(complex_[0], complex_[1]);
 }
 
 bool Element::operator==(const Element &other) const {
@@ -198,33 +346,17 @@ bool Element::operator==(const Element &other) const {
                                        debugString(type_).c_str(),
                                        debugString(type).c_str()));
 
-  if (isSupportedIntegerType(type)) {
-    auto intLhs = getIntegerValue();
-    auto intRhs = other.getIntegerValue();
-    return intLhs == intRhs;
+  switch (kind_) {
+    case Kind::Integer:
+      return integer_ == other.getNativeIntegerValue();
+    case Kind::Boolean:
+      return boolean_ == other.getBooleanValue();
+    case Kind::Float:
+      return float_ == other.getNativeFloatValue();
+    case Kind::Complex:
+      return getNativeComplexValue() == other.getNativeComplexValue();
   }
-
-  if (isSupportedBooleanType(type)) {
-    auto boolLhs = getBooleanValue();
-    auto boolRhs = other.getBooleanValue();
-    return boolLhs == boolRhs;
-  }
-
-  if (isSupportedFloatType(type)) {
-    auto floatLhs = getFloatValue();
-    auto floatRhs = other.getFloatValue();
-    return floatLhs.compare(floatRhs) == APFloat::cmpEqual;
-  }
-
-  if (isSupportedComplexType(type)) {
-    auto complexLhs = getComplexValue();
-    auto complexRhs = other.getComplexValue();
-    return complexLhs.real().compare(complexRhs.real()) == APFloat::cmpEqual &&
-           complexLhs.imag().compare(complexRhs.imag()) == APFloat::cmpEqual;
-  }
-
-  report_fatal_error(invalidArgument("Unsupported element type: %s",
-                                     debugString(type).c_str()));
+  llvm_unreachable("unknown element kind");
 }
 
 bool Element::operator!=(const Element &other) const {
@@ -233,150 +365,134 @@ bool Element::operator!=(const Element &other) const {
 
 Element Element::operator&(const Element &other) const {
   return map(
-      *this, other, [](APInt lhs, APInt rhs) { return lhs & rhs; },
+      *this, other, [](int64_t lhs, int64_t rhs) { return lhs & rhs; },
       [](bool lhs, bool rhs) -> bool { return lhs & rhs; },
-      [](APFloat lhs, APFloat rhs) -> APFloat {
+      [](double lhs, double rhs) -> double {
         llvm::report_fatal_error("float & float is unsupported");
       },
-      [](std::complex<APFloat> lhs,
-         std::complex<APFloat> rhs) -> std::complex<APFloat> {
+      [](std::complex<double> lhs,
+         std::complex<double> rhs) -> std::complex<double> {
         llvm::report_fatal_error("complex & complex is unsupported");
       });
 }
 
+// Integer arithmetic is carried out on `uint64_t`, where it wraps around like
+// APInt arithmetic, and then truncated to the element type.
 Element Element::operator+(const Element &other) const {
   return map(
-      *this, other, [](APInt lhs, APInt rhs) { return lhs + rhs; },
+      *this, other,
+      [](int64_t lhs, int64_t rhs) {
+        return static_cast<uint64_t>(lhs) + static_cast<uint64_t>(rhs);
+      },
       [](bool lhs, bool rhs) -> bool { return lhs | rhs; },
-      [](APFloat lhs, APFloat rhs) { return lhs + rhs; },
-      [](std::complex<APFloat> lhs, std::complex<APFloat> rhs) {
-        // NOTE: lhs + rhs doesn't work for std::complex<APFloat>
-        // because the default implementation for the std::complex template
-        // needs operator+= which is not defined on APFloat.
-        auto resultReal = lhs.real() + rhs.real();
-        auto resultImag = lhs.imag() + rhs.imag();
-        return std::complex<APFloat>(resultReal, resultImag);
+      [](double lhs, double rhs) { return lhs + rhs; },
+      [](std::complex<double> lhs, std::complex<double> rhs) {
+        return lhs + rhs;
       });
 }
 
 Element Element::operator/(const Element &other) const {
-  auto lhs = *this;
-  auto rhs = other;
-
-  Type type = lhs.getType();
-  if (lhs.getType() != rhs.getType())
-    report_fatal_error(invalidArgument("Element types don't match: %s vs %s",
-                                       debugString(lhs.getType()).c_str(),
-                                       debugString(rhs.getType()).c_str()));
-
-  if (isSupportedIntegerType(type)) {
-    auto intLhs = lhs.getIntegerValue();
-    auto intRhs = rhs.getIntegerValue();
-    return Element(type, isSupportedSignedIntegerType(type)
-                             ? intLhs.sdiv(intRhs)
-                             : intLhs.udiv(intRhs));
-  }
-
-  if (isSupportedFloatType(type)) {
-    APFloat lhsVal = lhs.getFloatValue();
-    APFloat rhsVal = rhs.getFloatValue();
-    return Element(type, lhsVal / rhsVal);
-  }
-
-  if (isSupportedComplexType(type)) {
-    auto lhsVal = lhs.getComplexValue();
-    auto rhsVal = rhs.getComplexValue();
-    const llvm::fltSemantics &elSemantics = lhsVal.real().getSemantics();
-    auto resultVal = std::complex<double>(lhsVal.real().convertToDouble(),
-                                          lhsVal.imag().convertToDouble()) /
-                     std::complex<double>(rhsVal.real().convertToDouble(),
-                                          rhsVal.imag().convertToDouble());
-    bool roundingErr;
-    APFloat resultReal(resultVal.real());
-    resultReal.convert(elSemantics, APFloat::rmNearestTiesToEven, &roundingErr);
-    APFloat resultImag(resultVal.imag());
-    resultImag.convert(elSemantics, APFloat::rmNearestTiesToEven, &roundingErr);
-    return Element(type, std::complex<APFloat>(resultReal, resultImag));
-  }
-
-  report_fatal_error(invalidArgument("Unsupported element type: %s",
-                                     debugString(type).c_str()));
+  return map(
+      *this, other,
+      [&](int64_t lhs, int64_t rhs) -> uint64_t {
+        if (rhs == 0) llvm::report_fatal_error("Integer division by zero");
+        if (!isSigned(type_))
+          return static_cast<uint64_t>(lhs) / static_cast<uint64_t>(rhs);
+        // The quotient of the minimum value by -1 wraps around.
+        if (rhs == -1) return -static_cast<uint64_t>(lhs);
+        return lhs / rhs;
+      },
+      [](bool lhs, bool rhs) -> bool {
+        llvm::report_fatal_error("bool / bool is unsupported");
+      },
+      [](double lhs, double rhs) { return lhs / rhs; },
+      [](std::complex<double> lhs, std::complex<double> rhs) {
+        return lhs / rhs;
+      });
 }
 
 Element Element::operator*(const Element &other) const {
   return map(
-      *this, other, [](APInt lhs, APInt rhs) { return lhs * rhs; },
+      *this, other,
+      [](int64_t lhs, int64_t rhs) {
+        return static_cast<uint64_t>(lhs) * static_cast<uint64_t>(rhs);
+      },
       [](bool lhs, bool rhs) -> bool { return lhs & rhs; },
-      [](APFloat lhs, APFloat rhs) { return lhs * rhs; },
-      [](std::complex<APFloat> lhs, std::complex<APFloat> rhs) {
+      [](double lhs, double rhs) { return lhs * rhs; },
+      [&](std::complex<double> lhs, std::complex<double> rhs) {
         // TODO(#226): Use std::complex::operator*
-        auto resultReal = lhs.real() * rhs.real() - lhs.imag() * rhs.imag();
-        auto resultImag = lhs.real() * rhs.imag() + lhs.imag() * rhs.real();
-        return std::complex<APFloat>(resultReal, resultImag);
+        // Every product and sum is rounded to the element type on its own.
+        Type elementType = getComplexElementType(type_);
+        auto round = [&](double value) {
+          return roundToType(value, elementType);
+        };
+        double realReal = round(lhs.real() * rhs.real());
+        double imagImag = round(lhs.imag() * rhs.imag());
+        double realImag = round(lhs.real() * rhs.imag());
+        double imagReal = round(lhs.imag() * rhs.real());
+        return std::complex<double>(realReal - imagImag, realImag + imagReal);
       });
 }
 
 Element Element::operator-() const {
   return map(
-      *this, [&](APInt val) { return -val; },
+      *this, [&](int64_t val) { return -static_cast<uint64_t>(val); },
       [](bool val) -> bool {
         llvm::report_fatal_error("-bool is unsupported");
       },
-      [&](APFloat val) { return -val; },
-      [](std::complex<APFloat> val) { return -val; });
+      [&](double val) { return -val; },
+      [](std::complex<double> val) { return -val; });
 }
 
 Element Element::operator-(const Element &other) const {
   return map(
-      *this, other, [](APInt lhs, APInt rhs) { return lhs - rhs; },
+      *this, other,
+      [](int64_t lhs, int64_t rhs) {
+        return static_cast<uint64_t>(lhs) - static_cast<uint64_t>(rhs);
+      },
       [](bool lhs, bool rhs) -> bool {
         llvm::report_fatal_error("bool - bool is unsupported");
       },
-      [](APFloat lhs, APFloat rhs) { return lhs - rhs; },
-      [](std::complex<APFloat> lhs, std::complex<APFloat> rhs) {
-        // NOTE: lhs - rhs doesn't work for std::complex<APFloat>
-        // because the default implementation for the std::complex template
-        // needs operator-= which is not defined on APFloat.
-        auto resultReal = lhs.real() - rhs.real();
-        auto resultImag = lhs.imag() - rhs.imag();
-        return std::complex<APFloat>(resultReal, resultImag);
+      [](double lhs, double rhs) { return lhs - rhs; },
+      [](std::complex<double> lhs, std::complex<double> rhs) {
+        return lhs - rhs;
       });
 }
 
 Element Element::operator^(const Element &other) const {
   return map(
-      *this, other, [](APInt lhs, APInt rhs) { return lhs ^ rhs; },
+      *this, other, [](int64_t lhs, int64_t rhs) { return lhs ^ rhs; },
       [](bool lhs, bool rhs) -> bool { return lhs ^ rhs; },
-      [](APFloat lhs, APFloat rhs) -> APFloat {
+      [](double lhs, double rhs) -> double {
         llvm::report_fatal_error("float ^ float is unsupported");
       },
-      [](std::complex<APFloat> lhs,
-         std::complex<APFloat> rhs) -> std::complex<APFloat> {
+      [](std::complex<double> lhs,
+         std::complex<double> rhs) -> std::complex<double> {
         llvm::report_fatal_error("complex ^ complex is unsupported");
       });
 }
 
 Element Element::operator|(const Element &other) const {
   return map(
-      *this, other, [](APInt lhs, APInt rhs) { return lhs | rhs; },
+      *this, other, [](int64_t lhs, int64_t rhs) { return lhs | rhs; },
       [](bool lhs, bool rhs) -> bool { return lhs | rhs; },
-      [](APFloat lhs, APFloat rhs) -> APFloat {
+      [](double lhs, double rhs) -> double {
         llvm::report_fatal_error("float | float is unsupported");
       },
-      [](std::complex<APFloat> lhs,
-         std::complex<APFloat> rhs) -> std::complex<APFloat> {
+      [](std::complex<double> lhs,
+         std::complex<double> rhs) -> std::complex<double> {
         llvm::report_fatal_error("complex | complex is unsupported");
       });
 }
 
 Element Element::operator~() const {
   return map(
-      *this, [](APInt val) { return ~val; },
+      *this, [](int64_t val) { return ~val; },
       [](bool val) -> bool { return !val; },
-      [](APFloat val) -> APFloat {
+      [](double val) -> double {
         llvm::report_fatal_error("~float is unsupported");
       },
-      [](std::complex<APFloat> val) -> std::complex<APFloat> {
+      [](std::complex<double> val) -> std::complex<double> {
         llvm::report_fatal_error("~complex is unsupported");
       });
 }
@@ -384,26 +500,20 @@ Element Element::operator~() const {
 Element abs(const Element &el) {
   Type type = el.getType();
 
-  if (isSupportedIntegerType(el.getType())) {
-    auto intEl = el.getIntegerValue();
-    return Element(type, intEl.abs());
+  if (isSupportedIntegerType(type)) {
+    // Like APInt::abs, this interprets the bits of the value as signed.
+    int64_t val = llvm::SignExtend64(getBits(type, el.getNativeIntegerValue()),
+                                     type.getIntOrFloatBitWidth());
+    return Element(type, static_cast<int64_t>(
+                             val < 0 ? -static_cast<uint64_t>(val) : val));
   }
 
-  if (isSupportedFloatType(type)) {
-    auto elVal = el.getFloatValue();
-    return Element(type, llvm::abs(elVal));
-  }
+  if (isSupportedFloatType(type))
+    return Element(type, std::fabs(el.getNativeFloatValue()));
 
-  if (isSupportedComplexType(type)) {
-    auto elVal = el.getComplexValue();
-    const llvm::fltSemantics &elSemantics = elVal.real().getSemantics();
-    auto resultVal = std::abs(std::complex<double>(
-        elVal.real().convertToDouble(), elVal.imag().convertToDouble()));
-    bool roundingErr;
-    APFloat result(resultVal);
-    result.convert(elSemantics, APFloat::rmNearestTiesToEven, &roundingErr);
-    return Element(type.cast<ComplexType>().getElementType(), result);
-  }
+  if (isSupportedComplexType(type))
+    return Element(getComplexElementType(type),
+                   std::abs(el.getNativeComplexValue()));
 
   report_fatal_error(invalidArgument("Unsupported element type: %s",
                                      debugString(type).c_str()));
@@ -417,23 +527,52 @@ bool areApproximatelyEqual(const Element &e1, const Element &e2) {
                                        debugString(e2.getType()).c_str()));
 
   if (isSupportedFloatType(type))
-    return areApproximatelyEqual(e1.getFloatValue(), e2.getFloatValue());
+    return areApproximatelyEqual(e1.getNativeFloatValue(),
+                                 e2.getNativeFloatValue(), type);
 
   if (isSupportedComplexType(type)) {
-    auto complexLhs = e1.getComplexValue();
-    auto complexRhs = e2.getComplexValue();
-    return areApproximatelyEqual(complexLhs.real(), complexRhs.real()) &&
-           areApproximatelyEqual(complexLhs.imag(), complexRhs.imag());
+    auto complexLhs = e1.getNativeComplexValue();
+    auto complexRhs = e2.getNativeComplexValue();
+    Type elementType = getComplexElementType(type);
+    return areApproximatelyEqual(complexLhs.real(), complexRhs.real(),
+                                 elementType) &&
+           areApproximatelyEqual(complexLhs.imag(), complexRhs.imag(),
+                                 elementType);
   }
 
   report_fatal_error(invalidArgument("Unsupported element type: %s",
                                      debugString(type).c_str()));
 }
 
+Element atan2(const Element &e1, const Element &e2) {
+  return mapWithUpcastToDouble(
+      e1, e2, [](double y, double x) { return std::atan2(y, x); },
+      [](std::complex<double> y, std::complex<double> x) {
+        // atan2(y, x) = -i * log((x + i * y) / sqrt(x * x + y * y))
+        std::complex<double> i(0, 1);
+        return -i * std::log((x + i * y) / std::sqrt(x * x + y * y));
+      });
+}
+
+Element cbrt(const Element &el) {
+  return mapWithUpcastToDouble(
+      el, [](double e) { return std::cbrt(e); },
+      [](std::complex<double> e) { return std::pow(e, 1.0 / 3); });
+}
+
 Element ceil(const Element &el) {
-  APFloat val = el.getFloatValue();
-  val.roundToIntegral(APFloat::rmTowardPositive);
-  return Element(el.getType(), val);
+  return Element(el.getType(), std::ceil(el.getNativeFloatValue()));
+}
+
+Element countLeadingZeros(const Element &el) {
+  Type type = el.getType();
+  return mapInteger(
+      el,
+      [&](int64_t val) -> int64_t {
+        return llvm::countLeadingZeros(getBits(type, val)) -
+               (64 - type.getIntOrFloatBitWidth());
+      },
+      "count_leading_zeros");
 }
 
 Element exponential(const Element &el) {
@@ -442,23 +581,28 @@ Element exponential(const Element &el) {
       [](std::complex<double> e) { return std::exp(e); });
 }
 
+Element exponentialMinusOne(const Element &el) {
+  return mapWithUpcastToDouble(
+      el, [](double e) { return std::expm1(e); },
+      [](std::complex<double> e) {
+        // expm1(x + i * y) = expm1(x) * cos(y) - 2 * sin(y / 2)^2 +
+        //                    i * exp(x) * sin(y), which is accurate near 0.
+        double sinHalfImag = std::sin(e.imag() / 2);
+        return std::complex<double>(std::expm1(e.real()) * std::cos(e.imag()) -
+                                        2 * sinHalfImag * sinHalfImag,
+                                    std::exp(e.real()) * std::sin(e.imag()));
+      });
+}
+
 Element floor(const Element &el) {
-  APFloat val = el.getFloatValue();
-  val.roundToIntegral(APFloat::rmTowardNegative);
-  return Element(el.getType(), val);
+  return Element(el.getType(), std::floor(el.getNativeFloatValue()));
 }
 
 Element imag(const Element &el) {
-  if (isSupportedFloatType(el.getType())) {
-    const llvm::fltSemantics &elSemantics = el.getFloatValue().getSemantics();
-    bool roundingErr;
-    APFloat resultImag(0.0);
-    resultImag.convert(elSemantics, APFloat::rmNearestTiesToEven, &roundingErr);
-    return Element(el.getType(), resultImag);
-  }
+  if (isSupportedFloatType(el.getType())) return Element(el.getType(), 0.0);
   if (isSupportedComplexType(el.getType()))
-    return Element(el.getType().cast<ComplexType>().getElementType(),
-                   el.getComplexValue().imag());
+    return Element(getComplexElementType(el.getType()),
+                   el.getNativeComplexValue().imag());
   report_fatal_error(invalidArgument("Unsupported element type: %s",
                                      debugString(el.getType()).c_str()));
 }
@@ -475,20 +619,45 @@ Element log(const Element &el) {
       [](std::complex<double> e) { return std::log(e); });
 }
 
+Element logPlusOne(const Element &el) {
+  return mapWithUpcastToDouble(
+      el, [](double e) { return std::log1p(e); },
+      [](std::complex<double> e) {
+        // log1p(x + i * y) = log1p(x * (2 + x) + y * y) / 2 +
+        //                    i * atan2(y, 1 + x), which is accurate near 0.
+        return std::complex<double>(
+            std::log1p(e.real() * (2 + e.real()) + e.imag() * e.imag()) / 2,
+            std::atan2(e.imag(), 1 + e.real()));
+      });
+}
+
+Element logistic(const Element &el) {
+  return mapWithUpcastToDouble(
+      el, [](double e) { return 1.0 / (1.0 + std::exp(-e)); },
+      [](std::complex<double> e) { return 1.0 / (1.0 + std::exp(-e)); });
+}
+
+// Floating-point `max` and `min` follow `llvm::maximum` and `llvm::minimum`:
+// NaNs are propagated, and -0.0 is less than +0.0.
 Element max(const Element &e1, const Element &e2) {
   return map(
       e1, e2,
-      [&](APInt lhs, APInt rhs) {
-        return isSupportedSignedIntegerType(e1.getType())
-                   ? llvm::APIntOps::smax(lhs, rhs)
-                   : llvm::APIntOps::umax(lhs, rhs);
+      [&](int64_t lhs, int64_t rhs) -> int64_t {
+        if (isSigned(e1.getType())) return std::max(lhs, rhs);
+        return std::max(static_cast<uint64_t>(lhs),
+                        static_cast<uint64_t>(rhs));
       },
       [](bool lhs, bool rhs) -> bool { return lhs | rhs; },
-      [](APFloat lhs, APFloat rhs) { return llvm::maximum(lhs, rhs); },
-      [](std::complex<APFloat> lhs, std::complex<APFloat> rhs) {
-        auto cmpRes = lhs.real().compare(rhs.real()) == APFloat::cmpEqual
-                          ? lhs.imag() > rhs.imag()
-                          : lhs.real() > rhs.real();
+      [](double lhs, double rhs) {
+        if (std::isnan(lhs)) return lhs;
+        if (std::isnan(rhs)) return rhs;
+        if (lhs == 0 && rhs == 0 && std::signbit(lhs) != std::signbit(rhs))
+          return std::signbit(lhs) ? rhs : lhs;
+        return lhs < rhs ? rhs : lhs;
+      },
+      [](std::complex<double> lhs, std::complex<double> rhs) {
+        auto cmpRes = lhs.real() == rhs.real() ? lhs.imag() > rhs.imag()
+                                               : lhs.real() > rhs.real();
         return cmpRes ? lhs : rhs;
       });
 }
@@ -496,36 +665,164 @@ Element max(const Element &e1, const Element &e2) {
 Element min(const Element &e1, const Element &e2) {
   return map(
       e1, e2,
-      [&](APInt lhs, APInt rhs) {
-        return isSupportedSignedIntegerType(e1.getType())
-                   ? llvm::APIntOps::smin(lhs, rhs)
-                   : llvm::APIntOps::umin(lhs, rhs);
+      [&](int64_t lhs, int64_t rhs) -> int64_t {
+        if (isSigned(e1.getType())) return std::min(lhs, rhs);
+        return std::min(static_cast<uint64_t>(lhs),
+                        static_cast<uint64_t>(rhs));
       },
       [](bool lhs, bool rhs) -> bool { return lhs & rhs; },
-      [](APFloat lhs, APFloat rhs) { return llvm::minimum(lhs, rhs); },
-      [](std::complex<APFloat> lhs, std::complex<APFloat> rhs) {
-        auto cmpRes = lhs.real().compare(rhs.real()) == APFloat::cmpEqual
-                          ? lhs.imag() < rhs.imag()
-                          : lhs.real() < rhs.real();
+      [](double lhs, double rhs) {
+        if (std::isnan(lhs)) return lhs;
+        if (std::isnan(rhs)) return rhs;
+        if (lhs == 0 && rhs == 0 && std::signbit(lhs) != std::signbit(rhs))
+          return std::signbit(lhs) ? lhs : rhs;
+        return rhs < lhs ? rhs : lhs;
+      },
+      [](std::complex<double> lhs, std::complex<double> rhs) {
+        auto cmpRes = lhs.real() == rhs.real() ? lhs.imag() < rhs.imag()
+                                               : lhs.real() < rhs.real();
         return cmpRes ? lhs : rhs;
       });
 }
 
+Element popcnt(const Element &el) {
+  Type type = el.getType();
+  return mapInteger(
+      el,
+      [&](int64_t val) -> int64_t {
+        return llvm::countPopulation(getBits(type, val));
+      },
+      "popcnt");
+}
+
+Element power(const Element &e1, const Element &e2) {
+  Type type = e1.getType();
+  if (isSupportedIntegerType(type))
+    return mapInteger(
+        e1, e2,
+        [&](int64_t lhs, int64_t rhs) -> uint64_t {
+          if (isSigned(type) && rhs < 0) {
+            if (lhs == 1) return lhs;
+            if (lhs == -1) return rhs & 1 ? lhs : 1;
+            return 0;
+          }
+          uint64_t base = lhs;
+          uint64_t result = 1;
+          for (uint64_t exponent = rhs; exponent != 0; exponent >>= 1) {
+            if (exponent & 1) result *= base;
+            base *= base;
+          }
+          return result;
+        },
+        "power");
+  return mapWithUpcastToDouble(
+      e1, e2, [](double x, double y) { return std::pow(x, y); },
+      [](std::complex<double> x, std::complex<double> y) {
+        return std::pow(x, y);
+      });
+}
+
 Element real(const Element &el) {
   if (isSupportedFloatType(el.getType())) return el;
   if (isSupportedComplexType(el.getType()))
-    return Element(el.getType().cast<ComplexType>().getElementType(),
-                   el.getComplexValue().real());
+    return Element(getComplexElementType(el.getType()),
+                   el.getNativeComplexValue().real());
   report_fatal_error(invalidArgument("Unsupported element type: %s",
                                      debugString(el.getType()).c_str()));
 }
 
+Element rem(const Element &e1, const Element &e2) {
+  return map(
+      e1, e2,
+      [&](int64_t lhs, int64_t rhs) -> uint64_t {
+        if (rhs == 0) llvm::report_fatal_error("Integer remainder by zero");
+        if (!isSigned(e1.getType()))
+          return static_cast<uint64_t>(lhs) % static_cast<uint64_t>(rhs);
+        // The remainder of the minimum value by -1 doesn't overflow.
+        if (rhs == -1) return 0;
+        return lhs % rhs;
+      },
+      [](bool lhs, bool rhs) -> bool {
+        llvm::report_fatal_error("bool % bool is unsupported");
+      },
+      // fmod is exact, like APFloat::mod.
+      [](double lhs, double rhs) { return std::fmod(lhs, rhs); },
+      [](std::complex<double> lhs,
+         std::complex<double> rhs) -> std::complex<double> {
+        llvm::report_fatal_error("complex % complex is unsupported");
+      });
+}
+
 Element rsqrt(const Element &el) {
   return mapWithUpcastToDouble(
       el, [](double e) { return 1.0 / std::sqrt(e); },
       [](std::complex<double> e) { return 1.0 / std::sqrt(e); });
 }
 
+// Shift amounts are the unsigned bits of `e2`, and shifting by the bit width
+// or more shifts out all bits, like the shifts of APInt.
+Element shiftLeft(const Element &e1, const Element &e2) {
+  Type type = e1.getType();
+  return mapInteger(
+      e1, e2,
+      [&](int64_t lhs, int64_t rhs) -> uint64_t {
+        uint64_t amount = getBits(type, rhs);
+        if (amount >= type.getIntOrFloatBitWidth()) return 0;
+        return static_cast<uint64_t>(lhs) << amount;
+      },
+      "shift_left");
+}
+
+Element shiftRightArithmetic(const Element &e1, const Element &e2) {
+  Type type = e1.getType();
+  return mapInteger(
+      e1, e2,
+      [&](int64_t lhs, int64_t rhs) -> int64_t {
+        unsigned bitWidth = type.getIntOrFloatBitWidth();
+        int64_t val = llvm::SignExtend64(getBits(type, lhs), bitWidth);
+        uint64_t amount = getBits(type, rhs);
+        if (amount >= bitWidth) return val < 0 ? -1 : 0;
+        return val >> amount;
+      },
+      "shift_right_arithmetic");
+}
+
+Element shiftRightLogical(const Element &e1, const Element &e2) {
+  Type type = e1.getType();
+  return mapInteger(
+      e1, e2,
+      [&](int64_t lhs, int64_t rhs) -> uint64_t {
+        uint64_t amount = getBits(type, rhs);
+        if (amount >= type.getIntOrFloatBitWidth()) return 0;
+        return getBits(type, lhs) >> amount;
+      },
+      "shift_right_logical");
+}
+
+Element sign(const Element &el) {
+  Type type = el.getType();
+  return map(
+      el,
+      [&](int64_t val) -> int64_t {
+        if (isSigned(type) && val < 0) return -1;
+        return val == 0 ? 0 : 1;
+      },
+      [](bool val) -> bool {
+        llvm::report_fatal_error("sign of bool is unsupported");
+      },
+      [](double val) {
+        if (std::isnan(val) || val == 0) return val;
+        return std::copysign(1.0, val);
+      },
+      [](std::complex<double> val) {
+        if (std::isnan(val.real()) || std::isnan(val.imag()))
+          return std::complex<double>(
+              std::numeric_limits<double>::quiet_NaN(),
+              std::numeric_limits<double>::quiet_NaN());
+        return val / std::abs(val);
+      });
+}
+
 Element sine(const Element &el) {
   return mapWithUpcastToDouble(
       el, [](double e) { return std::sin(e); },
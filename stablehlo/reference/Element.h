@@ -17,9 +17,10 @@ limitations under the License.
 #define STABLEHLO_REFERENCE_ELEMENT_H
 
 #include <complex>
-#include <variant>
+#include <cstdint>
 
 #include "llvm/ADT/APFloat.h"
+#include "llvm/ADT/APInt.h"
 #include "llvm/Support/raw_ostream.h"
 #include "mlir/IR/BuiltinTypes.h"
 #include "mlir/IR/Types.h"
@@ -30,15 +31,30 @@ namespace stablehlo {
 /// Class to represent an element of a tensor. An Element object stores the
 /// element type of the tensor and, depending on that element type, a constant
 /// value of type integer, floating-paint, or complex type.
+///
+/// Values are stored inline as native scalars rather than as APInt and
+/// APFloat, so that creating, copying and computing with Element objects
+/// doesn't allocate: integers as `int64_t`, and floating-point numbers and
+/// the parts of complex numbers as `double`, which represents all values of
+/// the supported floating-point types exactly. Arithmetic is carried out on
+/// the native scalars and then rounded to the element type, which gives the
+/// same results as APFloat arithmetic in the element type. APInt and APFloat
+/// values are only created on demand by the accessors below.
 class Element {
  public:
   /// \name Constructors
+  /// Integer values are truncated to the bit width of `type`, and
+  /// floating-point values are rounded to nearest, ties to even, to the
+  /// floating-point type of `type`.
   /// @{
-  Element(Type type, APInt value) : type_(type), value_(value) {}
-  Element(Type type, bool value) : type_(type), value_(value) {}
-  Element(Type type, APFloat value) : type_(type), value_(value) {}
-  Element(Type type, std::complex<APFloat> value)
-      : type_(type), value_(std::make_pair(value.real(), value.imag())) {}
+  Element(Type type, APInt value);
+  Element(Type type, int64_t value);
+  Element(Type type, bool value)
+      : type_(type), kind_(Kind::Boolean), boolean_(value) {}
+  Element(Type type, APFloat value);
+  Element(Type type, double value);
+  Element(Type type, std::complex<APFloat> value);
+  Element(Type type, std::complex<double> value);
 
   Element(const Element &other) = default;
   /// @}
@@ -65,6 +81,19 @@ class Element {
   /// complex type.
   std::complex<APFloat> getComplexValue() const;
 
+  /// Returns the underlying integer value stored in an Element object with
+  /// integer type, sign-extended to 64 bits for signed integer types and
+  /// zero-extended to 64 bits for unsigned integer types.
+  int64_t getNativeIntegerValue() const;
+
+  /// Returns the underlying floating-point value stored in an Element object
+  /// with floating-point type, which `double` represents exactly.
+  double getNativeFloatValue() const;
+
+  /// Returns the underlying complex value stored in an Element object with
+  /// complex type, which `std::complex<double>` represents exactly.
+  std::complex<double> getNativeComplexValue() const;
+
   /// Overloaded equality operator.
   bool operator==(const Element &other) const;
 
@@ -105,8 +134,17 @@ class Element {
   void dump() const;
 
  private:
+  /// Which member of the union below holds the value.
+  enum class Kind : uint8_t { Integer, Boolean, Float, Complex };
+
   Type type_;
-  std::variant<APInt, bool, APFloat, std::pair<APFloat, APFloat>> value_;
+  Kind kind_;
+  union {
+    int64_t integer_;
+    bool boolean_;
+    double float_;
+    double complex_[2];
+  };
 };
 
 /// Returns abs of Element object.
@@ -123,15 +161,29 @@ Element abs(const Element &e);
 /// individually equal modulo the tolerance.
 bool areApproximatelyEqual(const Element &e1, const Element &e2);
 
+/// Returns atan2 of Element objects `e1` and `e2`, i.e. the angle of the point
+/// (e2, e1).
+Element atan2(const Element &e1, const Element &e2);
+
+/// Returns cubic root of Element object.
+Element cbrt(const Element &e);
+
 /// Returns ceil of Element object.
 Element ceil(const Element &e);
 
 /// Returns cosine of Element object.
 Element cosine(const Element &e);
 
+/// Returns the number of leading zero bits of Element object with integer
+/// type.
+Element countLeadingZeros(const Element &el);
+
 /// Returns exponential of Element object.
 Element exponential(const Element &el);
 
+/// Returns exponential minus one of Element object.
+Element exponentialMinusOne(const Element &el);
+
 /// Returns floor of Element object.
 Element floor(const Element &e);
 
@@ -142,19 +194,49 @@ Element imag(const Element &el);
 /// Returns log of Element object.
 Element log(const Element &el);
 
+/// Returns log plus one of Element object.
+Element logPlusOne(const Element &el);
+
+/// Returns logistic of Element object.
+Element logistic(const Element &el);
+
 /// Returns the maximum between two Element objects.
 Element max(const Element &e1, const Element &e2);
 
 /// Returns the minimum between two Element objects.
 Element min(const Element &e1, const Element &e2);
 
+/// Returns the number of bits set in Element object with integer type.
+Element popcnt(const Element &el);
+
+/// Returns Element object `e1` raised to the power of `e2`. For integers,
+/// negative exponents give 0 unless `e1` is 1 or -1.
+Element power(const Element &e1, const Element &e2);
+
 /// Returns the real part extracted from the Element object with floating-point
 /// or complex type.
 Element real(const Element &e);
 
+/// Returns the remainder of the division of Element objects `e1` by `e2`,
+/// whose sign is the sign of `e1`.
+Element rem(const Element &e1, const Element &e2);
+
 /// Returns reverse square root of Element object.
 Element rsqrt(const Element &e);
 
+/// Returns Element object `e1` with integer type shifted by `e2` bits. Shift
+/// amounts are unsigned, and shifting by the bit width or more shifts out all
+/// bits.
+/// @{
+Element shiftLeft(const Element &e1, const Element &e2);
+Element shiftRightArithmetic(const Element &e1, const Element &e2);
+Element shiftRightLogical(const Element &e1, const Element &e2);
+/// @}
+
+/// Returns the sign of Element object: -1, 0 or 1 for integers, NaN, +/-0.0
+/// or +/-1.0 for floating-point types, and `e / abs(e)` for complex types.
+Element sign(const Element &e);
+
 /// Returns sine of Element object.
 Element sine(const Element &e);
 
@@ -0,0 +1,277 @@
+/* Copyright 2023 The StableHLO Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "stablehlo/reference/Fft.h"
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "llvm/Support/MathExtras.h"
+#include "stablehlo/reference/Kernels.h"
+#include "stablehlo/reference/Parallel.h"
+
+namespace mlir {
+namespace stablehlo {
+namespace native {
+namespace {
+
+// Complex products are spelled out by `multiply` rather than computed by
+// `std::complex::operator*`, which handles infinities at a considerable cost.
+using Complex = std::complex<double>;
+
+// Largest prime factor for which lengths are transformed by Cooley-Tukey.
+// The generic butterfly takes O(radix) operations per element, so lengths
+// with larger prime factors go through Bluestein's algorithm instead.
+constexpr int64_t kMaxRadix = 32;
+
+// Returns `exp(sign * pi * i * numerator / denominator)` for a non-negative
+// `numerator`. Multiples of a quarter turn are exact, so e.g. transforms of
+// length 4 don't pick up rounding errors from `cos(pi / 2)`.
+Complex getRootOfUnity(int64_t numerator, int64_t denominator, double sign) {
+  if (2 * numerator % denominator == 0) {
+    switch (2 * numerator / denominator % 4) {
+      case 0:
+        return {1, 0};
+      case 1:
+        return {0, sign};
+      case 2:
+        return {-1, 0};
+      default:
+        return {0, -sign};
+    }
+  }
+  double angle = sign * llvm::numbers::pi * static_cast<double>(numerator) /
+                 static_cast<double>(denominator);
+  return {std::cos(angle), std::sin(angle)};
+}
+
+// Returns `value` multiplied by `i` if `inverse`, and by `-i` otherwise. This
+// is the product with the twiddle factor of a quarter turn, which is exact.
+Complex rotateQuarter(Complex value, bool inverse) {
+  return inverse ? Complex(-value.imag(), value.real())
+                 : Complex(value.imag(), -value.real());
+}
+
+}  // namespace
+
+const FftPlan &FftPlan::get(int64_t length, bool inverse) {
+  static std::mutex mutex;
+  static std::map<std::pair<int64_t, bool>, std::unique_ptr<FftPlan>> plans;
+  std::lock_guard<std::mutex> lock(mutex);
+  std::unique_ptr<FftPlan> &plan = plans[{length, inverse}];
+  if (!plan) plan.reset(new FftPlan(length, inverse));
+  return *plan;
+}
+
+FftPlan::FftPlan(int64_t length, bool inverse)
+    : length_(length), inverse_(inverse) {
+  double sign = inverse ? 1 : -1;
+
+  // Radix 4 first, which takes fewer operations than two stages of radix 2.
+  SmallVector<int64_t> radices;
+  int64_t remaining = length;
+  while (remaining % 4 == 0) {
+    radices.push_back(4);
+    remaining /= 4;
+  }
+  for (int64_t radix = 2; radix * radix <= remaining; ++radix) {
+    while (remaining % radix == 0) {
+      radices.push_back(radix);
+      remaining /= radix;
+    }
+  }
+  if (remaining > 1) radices.push_back(remaining);
+
+  if (!radices.empty() && radices.back() > kMaxRadix) {
+    // X[k] = chirp[k] * sum(x[j] * chirp[j] * conj(chirp[k - j])), which is
+    // a convolution of a power-of-two length of at least 2 * length - 1.
+    int64_t convolutionLength = llvm::PowerOf2Ceil(2 * length - 1);
+    convolutionPlan_.reset(new FftPlan(convolutionLength, /*inverse=*/false));
+    chirp_.resize(length);
+    for (int64_t k = 0; k < length; ++k)
+      chirp_[k] = getRootOfUnity(k * k % (2 * length), length, sign);
+
+    std::vector<Complex> conjugateChirp(convolutionLength);
+    conjugateChirp[0] = std::conj(chirp_[0]);
+    for (int64_t k = 1; k < length; ++k)
+      conjugateChirp[k] = conjugateChirp[convolutionLength - k] =
+          std::conj(chirp_[k]);
+    chirpTransform_.resize(convolutionLength);
+    std::vector<Complex> workspace(convolutionPlan_->getWorkspaceSize());
+    convolutionPlan_->transform(conjugateChirp.data(), 1,
+                                chirpTransform_.data(), workspace.data());
+    for (Complex &value : chirpTransform_)
+      value /= static_cast<double>(convolutionLength);
+    return;
+  }
+
+  int64_t subLength = length;
+  for (int64_t radix : radices) {
+    subLength /= radix;
+    stages_.emplace_back(radix, subLength);
+  }
+  twiddles_.resize(length);
+  for (int64_t k = 0; k < length; ++k)
+    twiddles_[k] = getRootOfUnity(2 * k, length, sign);
+}
+
+int64_t FftPlan::getWorkspaceSize() const {
+  if (convolutionPlan_)
+    return 2 * convolutionPlan_->getLength() +
+           convolutionPlan_->getWorkspaceSize();
+  int64_t size = 0;
+  for (auto [radix, subLength] : stages_) size = std::max(size, radix);
+  return size;
+}
+
+void FftPlan::transform(const Complex *input, int64_t inputStride,
+                        Complex *output, Complex *workspace) const {
+  if (convolutionPlan_)
+    return transformBluestein(input, inputStride, output, workspace);
+  if (stages_.empty()) {
+    if (length_ == 1) output[0] = input[0];
+    return;
+  }
+  transformStage(0, input, inputStride, 1, output, workspace);
+}
+
+// Decimation in time: the stage of radix `p` transforms the `p` subsequences
+// `input[q], input[q + p], ...` into consecutive parts of `output`, and then
+// combines them with butterflies. `twiddleStride` is `length_` divided by the
+// length of this stage, i.e. the step in `twiddles_` for its roots of unity.
+void FftPlan::transformStage(size_t stage, const Complex *input,
+                             int64_t inputStride, int64_t twiddleStride,
+                             Complex *output, Complex *workspace) const {
+  auto [radix, subLength] = stages_[stage];
+  if (subLength == 1) {
+    for (int64_t q = 0; q < radix; ++q) output[q] = input[q * inputStride];
+  } else {
+    for (int64_t q = 0; q < radix; ++q)
+      transformStage(stage + 1, input + q * inputStride, inputStride * radix,
+                     twiddleStride * radix, output + q * subLength,
+                     workspace);
+  }
+
+  const Complex *twiddles = twiddles_.data();
+  switch (radix) {
+    case 2: {
+      for (int64_t k = 0; k < subLength; ++k) {
+        Complex t =
+            multiply(output[k + subLength], twiddles[k * twiddleStride]);
+        output[k + subLength] = output[k] - t;
+        output[k] += t;
+      }
+      return;
+    }
+    case 4: {
+      for (int64_t k = 0; k < subLength; ++k) {
+        Complex *x = output + k;
+        Complex y0 = x[0];
+        Complex y1 = multiply(x[subLength], twiddles[k * twiddleStride]);
+        Complex y2 =
+            multiply(x[2 * subLength], twiddles[2 * k * twiddleStride]);
+        Complex y3 =
+            multiply(x[3 * subLength], twiddles[3 * k * twiddleStride]);
+        Complex a0 = y0 + y2;
+        Complex a1 = y0 - y2;
+        Complex b0 = y1 + y3;
+        Complex b1 = rotateQuarter(y1 - y3, inverse_);
+        x[0] = a0 + b0;
+        x[subLength] = a1 + b1;
+        x[2 * subLength] = a0 - b0;
+        x[3 * subLength] = a1 - b1;
+      }
+      return;
+    }
+    default: {
+      // The stage has length `radix * subLength`, so its roots of unity are
+      // `twiddles[e * twiddleStride]` for exponents `e` modulo that length.
+      int64_t stageLength = radix * subLength;
+      for (int64_t k = 0; k < subLength; ++k) {
+        for (int64_t q = 0; q < radix; ++q)
+          workspace[q] = output[k + q * subLength];
+        for (int64_t p = 0; p < radix; ++p) {
+          int64_t index = k + p * subLength;
+          Complex sum = workspace[0];
+          for (int64_t q = 1; q < radix; ++q)
+            sum += multiply(workspace[q],
+                            twiddles[q * index % stageLength * twiddleStride]);
+          output[index] = sum;
+        }
+      }
+      return;
+    }
+  }
+}
+
+void FftPlan::transformBluestein(const Complex *input, int64_t inputStride,
+                                 Complex *output, Complex *workspace) const {
+  int64_t convolutionLength = convolutionPlan_->getLength();
+  Complex *padded = workspace;
+  Complex *transformed = workspace + convolutionLength;
+  Complex *planWorkspace = workspace + 2 * convolutionLength;
+
+  for (int64_t j = 0; j < length_; ++j)
+    padded[j] = multiply(input[j * inputStride], chirp_[j]);
+  std::fill(padded + length_, padded + convolutionLength, Complex());
+  convolutionPlan_->transform(padded, 1, transformed, planWorkspace);
+
+  // The inverse transform of the product is computed by the forward plan as
+  // `conj(fft(conj(x)))`.
+  for (int64_t k = 0; k < convolutionLength; ++k)
+    padded[k] = std::conj(multiply(transformed[k], chirpTransform_[k]));
+  convolutionPlan_->transform(padded, 1, transformed, planWorkspace);
+  for (int64_t k = 0; k < length_; ++k)
+    output[k] = multiply(chirp_[k], std::conj(transformed[k]));
+}
+
+void fftAlongDimension(Complex *data, ArrayRef<int64_t> shape,
+                       int64_t dimension, bool inverse) {
+  int64_t length = shape[dimension];
+  int64_t outerSize = 1;
+  for (int64_t d = 0; d < dimension; ++d) outerSize *= shape[d];
+  int64_t innerSize = 1;
+  for (int64_t d = dimension + 1; d < static_cast<int64_t>(shape.size()); ++d)
+    innerSize *= shape[d];
+  int64_t numLines = outerSize * innerSize;
+  if (length <= 1 || numLines == 0) return;
+
+  const FftPlan &plan = FftPlan::get(length, inverse);
+  double scale = inverse ? 1.0 / static_cast<double>(length) : 1.0;
+  parallelFor(
+      numLines, std::max<int64_t>(1, kDefaultGrainSize / length),
+      [&](int64_t begin, int64_t end) {
+        std::vector<Complex> line(length);
+        std::vector<Complex> workspace(plan.getWorkspaceSize());
+        for (int64_t i = begin; i < end; ++i) {
+          Complex *first = data + i / innerSize * length * innerSize +
+                           i % innerSize;
+          plan.transform(first, innerSize, line.data(), workspace.data());
+          for (int64_t k = 0; k < length; ++k)
+            first[k * innerSize] = inverse ? line[k] * scale : line[k];
+        }
+      });
+}
+
+}  // namespace native
+}  // namespace stablehlo
+}  // namespace mlir
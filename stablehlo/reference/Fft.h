@@ -0,0 +1,104 @@
+/* Copyright 2023 The StableHLO Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef STABLEHLO_REFERENCE_FFT_H
+#define STABLEHLO_REFERENCE_FFT_H
+
+#include <complex>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/SmallVector.h"
+#include "mlir/Support/LLVM.h"
+
+namespace mlir {
+namespace stablehlo {
+namespace native {
+
+/// A plan for the unnormalized discrete Fourier transform of a fixed length
+/// in a fixed direction, i.e. `output[k] = sum(input[j] * w^(j * k))` where
+/// `w = exp(-2 * pi * i / length)` for forward and `exp(2 * pi * i / length)`
+/// for inverse transforms.
+///
+/// The transform is computed by a recursive mixed-radix Cooley-Tukey
+/// algorithm, with dedicated butterflies for radices 2 and 4, a generic one
+/// for other small primes, and precomputed twiddle factors. Lengths with a
+/// large prime factor are reduced to a power-of-two transform via Bluestein's
+/// algorithm, so every transform takes O(length * log(length)) operations.
+class FftPlan {
+ public:
+  /// Returns the plan for `length` and `inverse`. Plans are built once and
+  /// cached for the lifetime of the process, so repeated transforms of the
+  /// same length, e.g. in a `while` loop, don't recompute twiddle factors.
+  /// Thread-safe.
+  static const FftPlan &get(int64_t length, bool inverse);
+
+  int64_t getLength() const { return length_; }
+
+  /// Returns the number of elements of the `workspace` of `transform`.
+  int64_t getWorkspaceSize() const;
+
+  /// Transforms the elements `input[j * inputStride]` for all `j` in
+  /// `[0, getLength())` into `output[0], ..., output[getLength() - 1]`.
+  /// `output` and `workspace` must not overlap with each other or with the
+  /// input.
+  void transform(const std::complex<double> *input, int64_t inputStride,
+                 std::complex<double> *output,
+                 std::complex<double> *workspace) const;
+
+ private:
+  FftPlan(int64_t length, bool inverse);
+
+  void transformStage(size_t stage, const std::complex<double> *input,
+                      int64_t inputStride, int64_t twiddleStride,
+                      std::complex<double> *output,
+                      std::complex<double> *workspace) const;
+  void transformBluestein(const std::complex<double> *input,
+                          int64_t inputStride, std::complex<double> *output,
+                          std::complex<double> *workspace) const;
+
+  int64_t length_;
+  bool inverse_;
+
+  // Radix and length of the sub-transforms of every stage, outermost first.
+  SmallVector<std::pair<int64_t, int64_t>> stages_;
+
+  // `twiddles_[k] = w^k` for all `k` in `[0, length_)`.
+  std::vector<std::complex<double>> twiddles_;
+
+  // Bluestein's algorithm: a forward plan for the power-of-two length of the
+  // convolution, the chirp `exp(-+pi * i * k^2 / length_)` and the transform
+  // of the conjugate chirp, divided by the length of the convolution.
+  std::unique_ptr<FftPlan> convolutionPlan_;
+  std::vector<std::complex<double>> chirp_;
+  std::vector<std::complex<double>> chirpTransform_;
+};
+
+/// Applies the discrete Fourier transform along `dimension` to `data`, a
+/// dense row-major array of shape `shape`, in place. Inverse transforms are
+/// normalized, i.e. divided by `shape[dimension]`. Lines are transformed
+/// independently on up to `getNumThreads()` threads, so results don't
+/// depend on the number of threads.
+void fftAlongDimension(std::complex<double> *data, ArrayRef<int64_t> shape,
+                       int64_t dimension, bool inverse);
+
+}  // namespace native
+}  // namespace stablehlo
+}  // namespace mlir
+
+#endif  // STABLEHLO_REFERENCE_FFT_H
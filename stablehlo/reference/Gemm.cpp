@@ -0,0 +1,193 @@
+/* Copyright 2023 The StableHLO Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "stablehlo/reference/Gemm.h"
+
+#include <algorithm>
+#include <complex>
+#include <cstdint>
+#include <memory>
+
+#include "llvm/Support/MathExtras.h"
+#include "stablehlo/reference/Kernels.h"
+#include "stablehlo/reference/Parallel.h"
+
+namespace mlir {
+namespace stablehlo {
+namespace native {
+namespace {
+
+// Size of the tiles of `result` computed by the micro-kernel. The tile is
+// accumulated in local variables, which the compiler keeps in vector
+// registers.
+constexpr int64_t kMr = 4;
+constexpr int64_t kNr = 8;
+
+// Size of the blocks of `lhs` and `rhs` which are packed at once. A
+// `kKc x kNc` block of `rhs` is reused for all rows of `lhs`, a `kMc x kKc`
+// block of `lhs` is meant to stay in L2 while it is multiplied with every
+// panel of the `rhs` block, and a `kKc x kNr` panel of `rhs` is meant to stay
+// in L1 while it is multiplied with every panel of the `lhs` block.
+constexpr int64_t kKc = 256;
+constexpr int64_t kMc = 128;
+constexpr int64_t kNc = 1024;
+
+// Packs the `mc x kc` block of `lhs` at `lhs`, whose rows are `ld` elements
+// apart, into panels of `kMr` rows. Panel `i` stores element `(i * kMr + r,
+// p)` at position `p * kMr + r`. Missing rows of the last panel are zero.
+template <typename T>
+void packLhs(const T *lhs, int64_t ld, int64_t mc, int64_t kc, T *packed) {
+  for (int64_t i = 0; i < mc; i += kMr, packed += kMr * kc) {
+    int64_t mr = std::min(kMr, mc - i);
+    for (int64_t p = 0; p < kc; ++p)
+      for (int64_t r = 0; r < kMr; ++r)
+        packed[p * kMr + r] = r < mr ? lhs[(i + r) * ld + p] : T();
+  }
+}
+
+// Packs the `kc x nc` block of `rhs` at `rhs`, whose rows are `ld` elements
+// apart, into panels of `kNr` columns. Panel `j` stores element `(p, j * kNr
+// + c)` at position `p * kNr + c`. Missing columns of the last panel are
+// zero.
+template <typename T>
+void packRhs(const T *rhs, int64_t ld, int64_t kc, int64_t nc, T *packed) {
+  parallelFor(llvm::divideCeil(nc, kNr),
+              llvm::divideCeil(kMinTaskSize, kNr * kc),
+              [&](int64_t begin, int64_t end) {
+                for (int64_t j = begin; j < end; ++j) {
+                  int64_t nr = std::min(kNr, nc - j * kNr);
+                  T *panel = packed + j * kNr * kc;
+                  const T *source = rhs + j * kNr;
+                  for (int64_t p = 0; p < kc; ++p)
+                    for (int64_t c = 0; c < kNr; ++c)
+                      panel[p * kNr + c] = c < nr ? source[p * ld + c] : T();
+                }
+              });
+}
+
+// Computes the `mr x nr` tile of `result` at `result`, whose rows are `ld`
+// elements apart, from a panel of packed `lhs` and a panel of packed `rhs`.
+// Adds to the tile if `accumulate` is set, and overwrites it otherwise.
+template <typename T>
+void microKernel(int64_t kc, const T *packedLhs, const T *packedRhs, T *result,
+                 int64_t ld, int64_t mr, int64_t nr, bool accumulate) {
+  T tile[kMr][kNr] = {};
+  if (accumulate)
+    for (int64_t r = 0; r < mr; ++r)
+      for (int64_t c = 0; c < nr; ++c) tile[r][c] = result[r * ld + c];
+
+  for (int64_t p = 0; p < kc; ++p) {
+    const T *lhs = packedLhs + p * kMr;
+    const T *rhs = packedRhs + p * kNr;
+    for (int64_t r = 0; r < kMr; ++r)
+      for (int64_t c = 0; c < kNr; ++c)
+        tile[r][c] = add(tile[r][c], multiply(lhs[r], rhs[c]));
+  }
+
+  for (int64_t r = 0; r < mr; ++r)
+    for (int64_t c = 0; c < nr; ++c) result[r * ld + c] = tile[r][c];
+}
+
+template <typename T>
+void gemmOneBatch(int64_t m, int64_t n, int64_t k, const T *lhs, const T *rhs,
+                  T *result) {
+  if (k == 0) {
+    std::fill(result, result + m * n, T());
+    return;
+  }
+
+  // Not `std::vector`, which has no `data()` for `bool`.
+  auto packedLhs = std::make_unique<T[]>(
+      llvm::divideCeil(std::min(m, kMc), kMr) * kMr * std::min(k, kKc));
+  auto packedRhs = std::make_unique<T[]>(
+      llvm::divideCeil(std::min(n, kNc), kNr) * kNr * std::min(k, kKc));
+  for (int64_t jc = 0; jc < n; jc += kNc) {
+    int64_t nc = std::min(kNc, n - jc);
+    int64_t numRhsPanels = llvm::divideCeil(nc, kNr);
+    for (int64_t pc = 0; pc < k; pc += kKc) {
+      int64_t kc = std::min(kKc, k - pc);
+      packRhs(rhs + pc * n + jc, n, kc, nc, packedRhs.get());
+      for (int64_t ic = 0; ic < m; ic += kMc) {
+        int64_t mc = std::min(kMc, m - ic);
+        int64_t numLhsPanels = llvm::divideCeil(mc, kMr);
+        packLhs(lhs + ic * k + pc, k, mc, kc, packedLhs.get());
+
+        // Consecutive tiles share the panel of `rhs`, which thus stays in L1.
+        parallelFor(numLhsPanels * numRhsPanels,
+                    llvm::divideCeil(kMinTaskSize, kMr * kNr * kc),
+                    [&](int64_t begin, int64_t end) {
+                      for (int64_t t = begin; t < end; ++t) {
+                        int64_t i = t % numLhsPanels;
+                        int64_t j = t / numLhsPanels;
+                        microKernel(kc, packedLhs.get() + i * kMr * kc,
+                                    packedRhs.get() + j * kNr * kc,
+                                    result + (ic + i * kMr) * n + jc + j * kNr,
+                                    n, std::min(kMr, mc - i * kMr),
+                                    std::min(kNr, nc - j * kNr), pc != 0);
+                      }
+                    });
+      }
+    }
+  }
+}
+
+}  // namespace
+
+template <typename T>
+void gemm(int64_t batchSize, int64_t m, int64_t n, int64_t k, const T *lhs,
+          const T *rhs, T *result) {
+  // Small matrices are distributed over threads by batch, large matrices
+  // additionally by tile.
+  int64_t batchCost = std::max<int64_t>(m * n * std::max<int64_t>(k, 1), 1);
+  parallelFor(batchSize, llvm::divideCeil(kMinTaskSize, batchCost),
+              [&](int64_t begin, int64_t end) {
+                for (int64_t b = begin; b < end; ++b)
+                  gemmOneBatch(m, n, k, lhs + b * m * k, rhs + b * k * n,
+                               result + b * m * n);
+              });
+}
+
+template void gemm(int64_t, int64_t, int64_t, int64_t, const bool *,
+                   const bool *, bool *);
+template void gemm(int64_t, int64_t, int64_t, int64_t, const int8_t *,
+                   const int8_t *, int8_t *);
+template void gemm(int64_t, int64_t, int64_t, int64_t, const int16_t *,
+                   const int16_t *, int16_t *);
+template void gemm(int64_t, int64_t, int64_t, int64_t, const int32_t *,
+                   const int32_t *, int32_t *);
+template void gemm(int64_t, int64_t, int64_t, int64_t, const int64_t *,
+                   const int64_t *, int64_t *);
+template void gemm(int64_t, int64_t, int64_t, int64_t, const uint8_t *,
+                   const uint8_t *, uint8_t *);
+template void gemm(int64_t, int64_t, int64_t, int64_t, const uint16_t *,
+                   const uint16_t *, uint16_t *);
+template void gemm(int64_t, int64_t, int64_t, int64_t, const uint32_t *,
+                   const uint32_t *, uint32_t *);
+template void gemm(int64_t, int64_t, int64_t, int64_t, const uint64_t *,
+                   const uint64_t *, uint64_t *);
+template void gemm(int64_t, int64_t, int64_t, int64_t, const float *,
+                   const float *, float *);
+template void gemm(int64_t, int64_t, int64_t, int64_t, const double *,
+                   const double *, double *);
+template void gemm(int64_t, int64_t, int64_t, int64_t,
+                   const std::complex<float> *, const std::complex<float> *,
+                   std::complex<float> *);
+template void gemm(int64_t, int64_t, int64_t, int64_t,
+                   const std::complex<double> *, const std::complex<double> *,
+                   std::complex<double> *);
+
+}  // namespace native
+}  // namespace stablehlo
+}  // namespace mlir
@@ -0,0 +1,55 @@
+/* Copyright 2023 The StableHLO Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef STABLEHLO_REFERENCE_GEMM_H
+#define STABLEHLO_REFERENCE_GEMM_H
+
+#include <cstdint>
+
+namespace mlir {
+namespace stablehlo {
+namespace native {
+
+/// Minimum number of multiply-adds per task which the parallel matrix
+/// kernels, i.e. `gemm` and those of LinearAlgebra.h, hand to `parallelFor`.
+constexpr int64_t kMinTaskSize = 1 << 16;
+
+/// Computes the batched matrix product `result[b] = lhs[b] x rhs[b]` for all
+/// `b` in `[0, batchSize)`, where `lhs[b]` is an `m x k` matrix, `rhs[b]` is
+/// a `k x n` matrix and `result[b]` is an `m x n` matrix. All matrices are
+/// stored densely in row-major order, one batch after the other, and
+/// `result` must not overlap with `lhs` or `rhs`.
+///
+/// The product is computed by a cache-blocked GEMM: blocks of `lhs` and `rhs`
+/// are packed into panels which fit into the caches, and a register-tiled
+/// micro-kernel computes small tiles of `result` from them. Tiles are
+/// distributed over `getNumThreads()` threads.
+///
+/// Arithmetic follows `native::add` and `native::multiply` from Kernels.h.
+/// Every element of `result` is computed by a single thread, which adds up
+/// the products in order of increasing `k`, starting from zero. Results are
+/// thus bit-identical regardless of the blocking and the number of threads.
+///
+/// `T` is one of the C++ types which are used to store elements of boolean,
+/// integer, floating-point and complex types (see `dispatchNativeType`).
+template <typename T>
+void gemm(int64_t batchSize, int64_t m, int64_t n, int64_t k, const T *lhs,
+          const T *rhs, T *result);
+
+}  // namespace native
+}  // namespace stablehlo
+}  // namespace mlir
+
+#endif  // STABLEHLO_REFERENCE_GEMM_H
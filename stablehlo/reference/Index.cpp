@@ -15,34 +15,46 @@ limitations under the License.
 
 #include "stablehlo/reference/Index.h"
 
+#include <utility>
+
+#include "llvm/ADT/STLExtras.h"
+
 namespace mlir {
 namespace stablehlo {
 
+IndexSpaceIterator::IndexSpaceIterator(Sizes shape, std::optional<Index> index)
+    : shape_(std::move(shape)), index_(shape_.size()), numElements_(1) {
+  for (int64_t dimSize : shape_) numElements_ *= dimSize;
+  linearIndex_ = numElements_;
+  if (!index) return;
+
+  if (!index->inBounds(shape_))
+    llvm::report_fatal_error(
+        "Incompatible index and shape found while creating "
+        "an IndexSpaceIterator");
+  index_ = std::move(*index);
+  linearIndex_ = 0;
+  for (auto [indexElement, dimSize] : llvm::zip(index_, shape_))
+    linearIndex_ = linearIndex_ * dimSize + indexElement;
+}
+
 const Index &IndexSpaceIterator::operator*() const {
-  if (!index_)
+  if (linearIndex_ == numElements_)
     llvm::report_fatal_error("Dereferencing a past-the-end iterator.");
-  return *index_;
+  return index_;
 }
 
-const Index *IndexSpaceIterator::operator->() const { return &(*index_); }
+const Index *IndexSpaceIterator::operator->() const { return &**this; }
 
 IndexSpaceIterator &IndexSpaceIterator::operator++() {
-  if (!index_)
+  if (linearIndex_ == numElements_)
     llvm::report_fatal_error("Incrementing a past-the-end iterator.");
 
-  if (shape_.empty()) index_.reset();
-
+  // Past the last index, all dimensions wrap around to zero.
+  ++linearIndex_;
   for (int64_t i = shape_.size() - 1; i >= 0; --i) {
-    (*index_)[i] += 1;
-    if ((*index_)[i] >= shape_[i]) {
-      (*index_)[i] = 0;
-      if (i == 0) {
-        index_.reset();
-        break;
-      }
-    } else {
-      break;
-    }
+    if (++index_[i] < shape_[i]) break;
+    index_[i] = 0;
   }
 
   return *this;
@@ -29,16 +29,16 @@ namespace stablehlo {
 /// [2,3], the iterator enumerates the indices (0,0), (0,1), (0,2), (1,0),
 /// (1,1), (1,2) and <END> (special past-the-end element which cannot be
 /// dereferenced).
+///
+/// Along with the current index, the iterator keeps track of its linear
+/// index, i.e. the position of the current index in lexicographical order,
+/// which it updates incrementally. Tensors whose index space is iterated can
+/// be accessed through the linear index (see `Tensor::getAt`), which is
+/// cheaper than accessing them through the index.
 class IndexSpaceIterator {
  public:
   /// \name Constructor
-  IndexSpaceIterator(Sizes shape, std::optional<Index> index)
-      : shape_(shape), index_(index) {
-    if (index && !index->inBounds(shape))
-      llvm::report_fatal_error(
-          "Incompatible index and shape found while creating "
-          "an IndexSpaceIterator");
-  }
+  IndexSpaceIterator(Sizes shape, std::optional<Index> index);
 
   /// Get the current index.
   /// At any point in time, the iterator can either reference an actual index
@@ -47,13 +47,19 @@ class IndexSpaceIterator {
   const Index &operator*() const;
   const Index *operator->() const;
 
-  /// Compare the iterator to another iterator.
-  /// Two iterators are equal if they have the same underlying shape and
-  /// reference the same element in the index space.
-  bool operator==(const IndexSpaceIterator &it) {
-    return shape_ == it.shape_ && index_ == it.index_;
+  /// Returns the linear index of the current index, which is the number of
+  /// elements of the index space for the past-the-end element.
+  int64_t getLinearIndex() const { return linearIndex_; }
+
+  /// Compare the iterator to another iterator over the same index space.
+  /// Two iterators are equal if they reference the same element in the index
+  /// space.
+  bool operator==(const IndexSpaceIterator &it) const {
+    return linearIndex_ == it.linearIndex_;
+  }
+  bool operator!=(const IndexSpaceIterator &it) const {
+    return !(*this == it);
   }
-  bool operator!=(const IndexSpaceIterator &it) { return !(*this == it); }
 
   /// Increment to the next index while iterating over the index space
   /// of a tensor in lexicographical order.
@@ -67,9 +73,13 @@ class IndexSpaceIterator {
   /// Shape of the tensor whose index space to be iterated on.
   Sizes shape_;
 
-  /// Current multi-dimensional index.
-  /// If the optional is empty, then we're at the end
-  std::optional<Index> index_;
+  /// Current multi-dimensional index, which is all zeros at the end.
+  Index index_;
+
+  /// Linear index of `index_`, and the number of elements of the index
+  /// space, which is the linear index of the past-the-end element.
+  int64_t linearIndex_;
+  int64_t numElements_;
 };
 
 }  // namespace stablehlo
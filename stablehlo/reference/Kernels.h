@@ -0,0 +1,684 @@
+/* Copyright 2023 The StableHLO Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef STABLEHLO_REFERENCE_KERNELS_H
+#define STABLEHLO_REFERENCE_KERNELS_H
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+#include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/MathExtras.h"
+#include "mlir/IR/BuiltinTypes.h"
+#include "stablehlo/reference/Parallel.h"
+#include "stablehlo/reference/Tensor.h"
+#include "stablehlo/reference/Types.h"
+
+namespace mlir {
+namespace stablehlo {
+
+/// Categories of element types which are stored in `Tensor` buffers using a
+/// builtin C++ type. Kernels pass a combination of these to
+/// `dispatchNativeType` to declare which element types they can handle.
+enum NativeTypeCategory : unsigned {
+  kNativeBoolean = 1 << 0,
+  kNativeInteger = 1 << 1,
+  kNativeFloat = 1 << 2,
+  kNativeComplex = 1 << 3,
+  kNativeIntegral = kNativeBoolean | kNativeInteger,
+  kNativeFloatOrComplex = kNativeFloat | kNativeComplex,
+  kNativeNumeric = kNativeInteger | kNativeFloat | kNativeComplex,
+  kNativeAll = kNativeBoolean | kNativeNumeric,
+};
+
+/// Invokes `fn` with a value-initialized object of the C++ type which is used
+/// to store elements of type `type` in `Tensor` buffers, provided that `type`
+/// belongs to one of `Categories`. Returns false without invoking `fn`
+/// otherwise.
+///
+/// Element types which don't have a builtin C++ counterpart, i.e. i4, ui4,
+/// f16 and bf16, are never dispatched. Kernels are expected to handle them
+/// via `Element`.
+template <unsigned Categories, typename Fn>
+bool dispatchNativeType(Type type, Fn &&fn) {
+  if constexpr ((Categories & kNativeBoolean) != 0) {
+    if (isSupportedBooleanType(type)) {
+      fn(bool());
+      return true;
+    }
+  }
+
+  if constexpr ((Categories & kNativeInteger) != 0) {
+    // TODO(#22): StableHLO, as bootstrapped from MHLO, inherits signless
+    // integers which was added in MHLO for legacy reasons. Going forward,
+    // StableHLO will adopt signfull integer semantics with signed and unsigned
+    // integer variants.
+    if (type.isSignlessInteger(8)) {
+      fn(int8_t());
+      return true;
+    }
+    if (type.isSignlessInteger(16)) {
+      fn(int16_t());
+      return true;
+    }
+    if (type.isSignlessInteger(32)) {
+      fn(int32_t());
+      return true;
+    }
+    if (type.isSignlessInteger(64)) {
+      fn(int64_t());
+      return true;
+    }
+    if (type.isUnsignedInteger(8)) {
+      fn(uint8_t());
+      return true;
+    }
+    if (type.isUnsignedInteger(16)) {
+      fn(uint16_t());
+      return true;
+    }
+    if (type.isUnsignedInteger(32)) {
+      fn(uint32_t());
+      return true;
+    }
+    if (type.isUnsignedInteger(64)) {
+      fn(uint64_t());
+      return true;
+    }
+  }
+
+  if constexpr ((Categories & kNativeFloat) != 0) {
+    if (type.isF32()) {
+      fn(float());
+      return true;
+    }
+    if (type.isF64()) {
+      fn(double());
+      return true;
+    }
+  }
+
+  if constexpr ((Categories & kNativeComplex) != 0) {
+    if (auto complexType = type.dyn_cast<ComplexType>()) {
+      if (complexType.getElementType().isF32()) {
+        fn(std::complex<float>());
+        return true;
+      }
+      if (complexType.getElementType().isF64()) {
+        fn(std::complex<double>());
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
+
+/// Invokes `fn` with a value-initialized object of a C++ type which has the
+/// same size as elements of type `type` in `Tensor` buffers. This is meant for
+/// kernels which only move elements around, e.g. with `std::memcpy`, and can
+/// thus handle all element types, including those which `dispatchNativeType`
+/// doesn't dispatch.
+template <typename Fn>
+void dispatchStorageType(Type type, Fn &&fn) {
+  unsigned bitWidth = 0;
+  if (auto complexType = type.dyn_cast<ComplexType>())
+    bitWidth = 2 * complexType.getElementType().getIntOrFloatBitWidth();
+  else
+    bitWidth = type.getIntOrFloatBitWidth();
+  switch (std::max(bitWidth, 8u) / 8) {
+    case 1:
+      return fn(uint8_t());
+    case 2:
+      return fn(uint16_t());
+    case 4:
+      return fn(uint32_t());
+    case 8:
+      return fn(uint64_t());
+    case 16:
+      return fn(std::complex<double>());
+  }
+  llvm::report_fatal_error("Unsupported element type");
+}
+
+/// Computes `result[i] = fn(operand[i])` for all elements using the native
+/// storage of the tensors. `operand` and `result` are expected to have the
+/// same type. Returns false and leaves `result` untouched if the element type
+/// is not in `Categories`. Operands which aren't contiguous are materialized
+/// before running the kernel.
+template <unsigned Categories, typename Fn>
+bool mapNative(const Tensor &operand, Tensor &result, Fn fn) {
+  if (operand.getType() != result.getType()) return false;
+  return dispatchNativeType<Categories>(
+      result.getElementType(), [&](auto tag) {
+        using T = decltype(tag);
+        Tensor contiguousOperand = operand.materialize();
+        const T *operandData = contiguousOperand.getData<T>().data();
+        T *resultData = result.getMutableData<T>().data();
+        parallelFor(result.getNumElements(), kDefaultGrainSize,
+                    [&](int64_t begin, int64_t end) {
+                      for (int64_t i = begin; i < end; ++i)
+                        resultData[i] = fn(operandData[i]);
+                    });
+      });
+}
+
+/// Invokes `fn(operandData, resultData)` with the native storage of the
+/// tensors as `ArrayRef<T>` and `MutableArrayRef<T>`. This is meant for
+/// kernels which process whole arrays at once, e.g. the batch functions from
+/// VectorMath.h. Same requirements and return value as `mapNative`.
+template <unsigned Categories, typename Fn>
+bool mapNativeArray(const Tensor &operand, Tensor &result, Fn fn) {
+  if (operand.getType() != result.getType()) return false;
+  return dispatchNativeType<Categories>(
+      result.getElementType(), [&](auto tag) {
+        using T = decltype(tag);
+        Tensor contiguousOperand = operand.materialize();
+        ArrayRef<T> operandData = contiguousOperand.getData<T>();
+        MutableArrayRef<T> resultData = result.getMutableData<T>();
+        parallelFor(result.getNumElements(), kDefaultGrainSize,
+                    [&](int64_t begin, int64_t end) {
+                      fn(operandData.slice(begin, end - begin),
+                         resultData.slice(begin, end - begin));
+                    });
+      });
+}
+
+/// Computes `result[i] = fn(lhs[i], rhs[i])` for all elements using the
+/// native storage of the tensors. `lhs`, `rhs` and `result` are expected to
+/// have the same type. Returns false and leaves `result` untouched if the
+/// element type is not in `Categories`.
+template <unsigned Categories, typename Fn>
+bool mapNative(const Tensor &lhs, const Tensor &rhs, Tensor &result, Fn fn) {
+  if (lhs.getType() != result.getType() || rhs.getType() != result.getType())
+    return false;
+  return dispatchNativeType<Categories>(
+      result.getElementType(), [&](auto tag) {
+        using T = decltype(tag);
+        Tensor contiguousLhs = lhs.materialize();
+        Tensor contiguousRhs = rhs.materialize();
+        const T *lhsData = contiguousLhs.getData<T>().data();
+        const T *rhsData = contiguousRhs.getData<T>().data();
+        T *resultData = result.getMutableData<T>().data();
+        parallelFor(result.getNumElements(), kDefaultGrainSize,
+                    [&](int64_t begin, int64_t end) {
+                      for (int64_t i = begin; i < end; ++i)
+                        resultData[i] = fn(lhsData[i], rhsData[i]);
+                    });
+      });
+}
+
+/// Computes `result[i] = fn(lhs[i], rhs[i])` for all elements, where `lhs` and
+/// `rhs` have the same type and `result` is a boolean tensor of the same
+/// shape, e.g. for comparisons. Returns false and leaves `result` untouched if
+/// the element type of `lhs` is not in `Categories`.
+template <unsigned Categories, typename Fn>
+bool mapNativePredicate(const Tensor &lhs, const Tensor &rhs, Tensor &result,
+                        Fn fn) {
+  if (lhs.getType() != rhs.getType() ||
+      !isSupportedBooleanType(result.getElementType()))
+    return false;
+  return dispatchNativeType<Categories>(lhs.getElementType(), [&](auto tag) {
+    using T = decltype(tag);
+    Tensor contiguousLhs = lhs.materialize();
+    Tensor contiguousRhs = rhs.materialize();
+    const T *lhsData = contiguousLhs.getData<T>().data();
+    const T *rhsData = contiguousRhs.getData<T>().data();
+    bool *resultData = result.getMutableData<bool>().data();
+    parallelFor(result.getNumElements(), kDefaultGrainSize,
+                [&](int64_t begin, int64_t end) {
+                  for (int64_t i = begin; i < end; ++i)
+                    resultData[i] = fn(lhsData[i], rhsData[i]);
+                });
+  });
+}
+
+/// Scalar building blocks for native kernels. These implement the same
+/// semantics as the corresponding `Element` functions in Element.h, e.g.
+/// integer arithmetic wraps around and `add` on booleans is a logical or, so
+/// native kernels and their `Element` fallbacks produce identical results.
+namespace native {
+
+template <typename T>
+constexpr bool isComplex = false;
+template <typename T>
+constexpr bool isComplex<std::complex<T>> = true;
+
+template <typename T>
+constexpr bool isInteger = std::is_integral_v<T> && !std::is_same_v<T, bool>;
+
+/// Unsigned type which is used to carry out integer arithmetic on `T` without
+/// signed overflow or promotion to `int`.
+template <typename T>
+using WrappingType = std::make_unsigned_t<decltype(+T())>;
+
+template <typename T>
+T add(T lhs, T rhs) {
+  if constexpr (std::is_same_v<T, bool>)
+    return lhs | rhs;
+  else if constexpr (isInteger<T>)
+    return static_cast<T>(static_cast<WrappingType<T>>(lhs) +
+                          static_cast<WrappingType<T>>(rhs));
+  else if constexpr (isComplex<T>)
+    return T(lhs.real() + rhs.real(), lhs.imag() + rhs.imag());
+  else
+    return lhs + rhs;
+}
+
+template <typename T>
+T subtract(T lhs, T rhs) {
+  static_assert(!std::is_same_v<T, bool>, "bool - bool is unsupported");
+  if constexpr (isInteger<T>)
+    return static_cast<T>(static_cast<WrappingType<T>>(lhs) -
+                          static_cast<WrappingType<T>>(rhs));
+  else if constexpr (isComplex<T>)
+    return T(lhs.real() - rhs.real(), lhs.imag() - rhs.imag());
+  else
+    return lhs - rhs;
+}
+
+template <typename T>
+T multiply(T lhs, T rhs) {
+  if constexpr (std::is_same_v<T, bool>)
+    return lhs & rhs;
+  else if constexpr (isInteger<T>)
+    return static_cast<T>(static_cast<WrappingType<T>>(lhs) *
+                          static_cast<WrappingType<T>>(rhs));
+  else if constexpr (isComplex<T>)
+    // Spelled out rather than using std::complex::operator* to match the
+    // rounding behavior of `Element::operator*`.
+    return T(lhs.real() * rhs.real() - lhs.imag() * rhs.imag(),
+             lhs.real() * rhs.imag() + lhs.imag() * rhs.real());
+  else
+    return lhs * rhs;
+}
+
+template <typename T>
+T divide(T lhs, T rhs) {
+  static_assert(!std::is_same_v<T, bool>, "bool / bool is unsupported");
+  if constexpr (isInteger<T>) {
+    if (rhs == 0) llvm::report_fatal_error("Integer division by zero");
+    // Like APInt::sdiv, the only overflowing case, min / -1, wraps around.
+    if constexpr (std::is_signed_v<T>)
+      if (rhs == -1) return static_cast<T>(-static_cast<WrappingType<T>>(lhs));
+    return lhs / rhs;
+  } else if constexpr (isComplex<T>) {
+    // Like `Element::operator/`, complex division is carried out in double
+    // precision.
+    auto result = std::complex<double>(lhs) / std::complex<double>(rhs);
+    return T(result.real(), result.imag());
+  } else {
+    return lhs / rhs;
+  }
+}
+
+/// Follows APInt::srem and APInt::urem for integers, and fmod, which is exact,
+/// for floating-point types.
+template <typename T>
+T remainder(T lhs, T rhs) {
+  static_assert(!std::is_same_v<T, bool>, "bool % bool is unsupported");
+  static_assert(!isComplex<T>, "complex % complex is unsupported");
+  if constexpr (isInteger<T>) {
+    if (rhs == 0) llvm::report_fatal_error("Integer remainder by zero");
+    // Like APInt::srem, min % -1 is 0 rather than overflowing.
+    if constexpr (std::is_signed_v<T>)
+      if (rhs == -1) return 0;
+    return static_cast<T>(lhs % rhs);
+  } else {
+    return std::fmod(lhs, rhs);
+  }
+}
+
+template <typename T>
+T negate(T operand) {
+  static_assert(!std::is_same_v<T, bool>, "-bool is unsupported");
+  if constexpr (isInteger<T>)
+    return static_cast<T>(-static_cast<WrappingType<T>>(operand));
+  else
+    return -operand;
+}
+
+template <typename T>
+T bitwiseAnd(T lhs, T rhs) {
+  return static_cast<T>(lhs & rhs);
+}
+
+template <typename T>
+T bitwiseOr(T lhs, T rhs) {
+  return static_cast<T>(lhs | rhs);
+}
+
+template <typename T>
+T bitwiseXor(T lhs, T rhs) {
+  return static_cast<T>(lhs ^ rhs);
+}
+
+template <typename T>
+T bitwiseNot(T operand) {
+  if constexpr (std::is_same_v<T, bool>)
+    return !operand;
+  else
+    return static_cast<T>(~operand);
+}
+
+template <typename T>
+T abs(T operand) {
+  static_assert(!isComplex<T>, "abs of complex changes the element type");
+  if constexpr (std::is_unsigned_v<T>)
+    return operand;
+  else if constexpr (isInteger<T>)
+    // Like APInt::abs, abs(min) wraps around to min.
+    return operand < 0 ? negate(operand) : operand;
+  else
+    return std::fabs(operand);
+}
+
+/// Integer shifts treat the shift amount as unsigned. Like APInt, shifting by
+/// the bit width or more yields 0, or -1 for arithmetic right shifts of
+/// negative numbers.
+template <typename T>
+T shiftLeft(T lhs, T rhs) {
+  static_assert(isInteger<T>, "shifts are only supported for integers");
+  auto amount = static_cast<std::make_unsigned_t<T>>(rhs);
+  if (amount >= sizeof(T) * 8) return 0;
+  return static_cast<T>(static_cast<WrappingType<T>>(lhs) << amount);
+}
+
+template <typename T>
+T shiftRightArithmetic(T lhs, T rhs) {
+  static_assert(isInteger<T>, "shifts are only supported for integers");
+  auto amount = static_cast<std::make_unsigned_t<T>>(rhs);
+  if (amount >= sizeof(T) * 8) amount = sizeof(T) * 8 - 1;
+  return static_cast<T>(static_cast<std::make_signed_t<T>>(lhs) >> amount);
+}
+
+template <typename T>
+T shiftRightLogical(T lhs, T rhs) {
+  static_assert(isInteger<T>, "shifts are only supported for integers");
+  auto amount = static_cast<std::make_unsigned_t<T>>(rhs);
+  if (amount >= sizeof(T) * 8) return 0;
+  return static_cast<T>(static_cast<std::make_unsigned_t<T>>(lhs) >> amount);
+}
+
+template <typename T>
+T countLeadingZeros(T operand) {
+  static_assert(isInteger<T>, "clz is only supported for integers");
+  return static_cast<T>(
+      llvm::countLeadingZeros(static_cast<std::make_unsigned_t<T>>(operand)));
+}
+
+template <typename T>
+T popcnt(T operand) {
+  static_assert(isInteger<T>, "popcnt is only supported for integers");
+  return static_cast<T>(
+      llvm::countPopulation(static_cast<std::make_unsigned_t<T>>(operand)));
+}
+
+/// Orders values for `compare`: integers and booleans by value,
+/// floating-point numbers like IEEE-754 comparisons, i.e. NaNs are unordered,
+/// and complex numbers lexicographically by their real and imaginary parts.
+/// Equality is `operator==` for all types.
+template <typename T>
+bool isLess(T lhs, T rhs) {
+  if constexpr (isComplex<T>)
+    return lhs.real() < rhs.real() ||
+           (lhs.real() == rhs.real() && lhs.imag() < rhs.imag());
+  else
+    return lhs < rhs;
+}
+
+template <typename T>
+bool isLessOrEqual(T lhs, T rhs) {
+  if constexpr (isComplex<T>)
+    return lhs.real() < rhs.real() ||
+           (lhs.real() == rhs.real() && lhs.imag() <= rhs.imag());
+  else
+    return lhs <= rhs;
+}
+
+/// Maps a floating-point number to a signed integer whose order is the
+/// totalOrder predicate of IEEE-754, as used by `compare` with `TOTALORDER`.
+template <typename T>
+auto totalOrderKey(T operand) {
+  static_assert(std::is_floating_point_v<T>, "expected a floating-point type");
+  using Key = std::conditional_t<sizeof(T) == 4, int32_t, int64_t>;
+  Key bits;
+  std::memcpy(&bits, &operand, sizeof(T));
+  return bits < 0 ? static_cast<Key>(bits ^ std::numeric_limits<Key>::max())
+                  : bits;
+}
+
+/// Follows llvm::maximum for floating-point types: NaNs are propagated and
+/// +0.0 is considered greater than -0.0.
+template <typename T>
+T max(T lhs, T rhs) {
+  if constexpr (std::is_same_v<T, bool>) {
+    return lhs | rhs;
+  } else if constexpr (isComplex<T>) {
+    bool lhsIsGreater = lhs.real() == rhs.real() ? lhs.imag() > rhs.imag()
+                                                 : lhs.real() > rhs.real();
+    return lhsIsGreater ? lhs : rhs;
+  } else if constexpr (std::is_floating_point_v<T>) {
+    if (std::isnan(lhs)) return lhs;
+    if (std::isnan(rhs)) return rhs;
+    if (lhs == 0 && rhs == 0 && std::signbit(lhs) != std::signbit(rhs))
+      return std::signbit(lhs) ? rhs : lhs;
+    return lhs < rhs ? rhs : lhs;
+  } else {
+    return lhs < rhs ? rhs : lhs;
+  }
+}
+
+/// Follows llvm::minimum for floating-point types: NaNs are propagated and
+/// -0.0 is considered less than +0.0.
+template <typename T>
+T min(T lhs, T rhs) {
+  if constexpr (std::is_same_v<T, bool>) {
+    return lhs & rhs;
+  } else if constexpr (isComplex<T>) {
+    bool lhsIsLess = lhs.real() == rhs.real() ? lhs.imag() < rhs.imag()
+                                              : lhs.real() < rhs.real();
+    return lhsIsLess ? lhs : rhs;
+  } else if constexpr (std::is_floating_point_v<T>) {
+    if (std::isnan(lhs)) return lhs;
+    if (std::isnan(rhs)) return rhs;
+    if (lhs == 0 && rhs == 0 && std::signbit(lhs) != std::signbit(rhs))
+      return std::signbit(lhs) ? lhs : rhs;
+    return rhs < lhs ? rhs : lhs;
+  } else {
+    return rhs < lhs ? rhs : lhs;
+  }
+}
+
+/// Applies a double-precision math function `fn` to a floating-point or
+/// complex value and rounds the result back to `T`. This mirrors how
+/// `Element` implements transcendental functions.
+template <typename T, typename Fn>
+T mapWithUpcastToDouble(T operand, Fn fn) {
+  if constexpr (isComplex<T>) {
+    auto result = fn(std::complex<double>(operand));
+    return T(result.real(), result.imag());
+  } else {
+    return static_cast<T>(fn(static_cast<double>(operand)));
+  }
+}
+
+/// Binary version of `mapWithUpcastToDouble`.
+template <typename T, typename Fn>
+T mapWithUpcastToDouble(T lhs, T rhs, Fn fn) {
+  if constexpr (isComplex<T>) {
+    auto result = fn(std::complex<double>(lhs), std::complex<double>(rhs));
+    return T(result.real(), result.imag());
+  } else {
+    return static_cast<T>(
+        fn(static_cast<double>(lhs), static_cast<double>(rhs)));
+  }
+}
+
+template <typename T>
+T atan2(T lhs, T rhs) {
+  return mapWithUpcastToDouble(lhs, rhs, [](auto y, auto x) {
+    if constexpr (isComplex<decltype(x)>) {
+      // atan2(y, x) = -i * log((x + i * y) / sqrt(x * x + y * y))
+      decltype(x) i(0, 1);
+      return -i * std::log((x + i * y) / std::sqrt(x * x + y * y));
+    } else {
+      return std::atan2(y, x);
+    }
+  });
+}
+
+template <typename T>
+T cbrt(T operand) {
+  return mapWithUpcastToDouble(operand, [](auto e) {
+    if constexpr (isComplex<decltype(e)>)
+      return std::pow(e, 1.0 / 3);
+    else
+      return std::cbrt(e);
+  });
+}
+
+template <typename T>
+T cosine(T operand) {
+  return mapWithUpcastToDouble(operand, [](auto e) { return std::cos(e); });
+}
+
+template <typename T>
+T exponential(T operand) {
+  return mapWithUpcastToDouble(operand, [](auto e) { return std::exp(e); });
+}
+
+template <typename T>
+T exponentialMinusOne(T operand) {
+  return mapWithUpcastToDouble(operand, [](auto e) {
+    if constexpr (isComplex<decltype(e)>) {
+      // expm1(x + i * y) = expm1(x) * cos(y) - 2 * sin(y / 2)^2 +
+      //                    i * exp(x) * sin(y), which is accurate near 0.
+      double sinHalfImag = std::sin(e.imag() / 2);
+      return decltype(e)(std::expm1(e.real()) * std::cos(e.imag()) -
+                             2 * sinHalfImag * sinHalfImag,
+                         std::exp(e.real()) * std::sin(e.imag()));
+    } else {
+      return std::expm1(e);
+    }
+  });
+}
+
+template <typename T>
+T log(T operand) {
+  return mapWithUpcastToDouble(operand, [](auto e) { return std::log(e); });
+}
+
+template <typename T>
+T logPlusOne(T operand) {
+  return mapWithUpcastToDouble(operand, [](auto e) {
+    if constexpr (isComplex<decltype(e)>) {
+      // log1p(x + i * y) = log1p(x * (2 + x) + y * y) / 2 +
+      //                    i * atan2(y, 1 + x), which is accurate near 0.
+      return decltype(e)(
+          std::log1p(e.real() * (2 + e.real()) + e.imag() * e.imag()) / 2,
+          std::atan2(e.imag(), 1 + e.real()));
+    } else {
+      return std::log1p(e);
+    }
+  });
+}
+
+template <typename T>
+T logistic(T operand) {
+  return mapWithUpcastToDouble(
+      operand, [](auto e) { return 1.0 / (1.0 + std::exp(-e)); });
+}
+
+/// Integer exponentiation by squaring wraps around like `multiply`. Like XLA,
+/// negative exponents give 0 unless the base is 1 or -1.
+template <typename T>
+T power(T lhs, T rhs) {
+  static_assert(!std::is_same_v<T, bool>, "bool ^ bool is unsupported");
+  if constexpr (isInteger<T>) {
+    if constexpr (std::is_signed_v<T>) {
+      if (rhs < 0) {
+        if (lhs == 1) return 1;
+        if (lhs == -1) return rhs % 2 == 0 ? 1 : -1;
+        return 0;
+      }
+    }
+    WrappingType<T> base = static_cast<WrappingType<T>>(lhs);
+    WrappingType<T> exponent = static_cast<WrappingType<T>>(rhs);
+    WrappingType<T> result = 1;
+    for (; exponent != 0; exponent >>= 1) {
+      if (exponent & 1) result *= base;
+      base *= base;
+    }
+    return static_cast<T>(result);
+  } else {
+    return mapWithUpcastToDouble(
+        lhs, rhs, [](auto x, auto y) { return std::pow(x, y); });
+  }
+}
+
+template <typename T>
+T rsqrt(T operand) {
+  return mapWithUpcastToDouble(operand,
+                               [](auto e) { return 1.0 / std::sqrt(e); });
+}
+
+/// Returns -1, 0 or 1 for integers. Floating-point NaNs and zeros are returned
+/// as is, and complex numbers are divided by their magnitude.
+template <typename T>
+T sign(T operand) {
+  if constexpr (isInteger<T>) {
+    if constexpr (std::is_signed_v<T>)
+      return static_cast<T>((operand > 0) - (operand < 0));
+    else
+      return operand != 0;
+  } else if constexpr (isComplex<T>) {
+    return mapWithUpcastToDouble(operand, [](std::complex<double> e) {
+      if (std::isnan(e.real()) || std::isnan(e.imag()))
+        return std::complex<double>(std::numeric_limits<double>::quiet_NaN(),
+                                    std::numeric_limits<double>::quiet_NaN());
+      return e / std::abs(e);
+    });
+  } else {
+    if (std::isnan(operand) || operand == 0) return operand;
+    return std::copysign(T(1), operand);
+  }
+}
+
+template <typename T>
+T sine(T operand) {
+  return mapWithUpcastToDouble(operand, [](auto e) { return std::sin(e); });
+}
+
+template <typename T>
+T sqrt(T operand) {
+  return mapWithUpcastToDouble(operand, [](auto e) { return std::sqrt(e); });
+}
+
+template <typename T>
+T tanh(T operand) {
+  return mapWithUpcastToDouble(operand, [](auto e) { return std::tanh(e); });
+}
+
+}  // namespace native
+}  // namespace stablehlo
+}  // namespace mlir
+
+#endif  // STABLEHLO_REFERENCE_KERNELS_H
@@ -0,0 +1,265 @@
+/* Copyright 2023 The StableHLO Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "stablehlo/reference/LinearAlgebra.h"
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <vector>
+
+#include "llvm/Support/MathExtras.h"
+#include "stablehlo/reference/Gemm.h"
+#include "stablehlo/reference/Kernels.h"
+#include "stablehlo/reference/Parallel.h"
+
+namespace mlir {
+namespace stablehlo {
+namespace native {
+namespace {
+
+// Number of columns which `cholesky` factorizes before it updates the
+// trailing submatrix.
+constexpr int64_t kBlockSize = 64;
+
+// Number of columns of `result` which `triangularSolve` solves for at once
+// if `leftSide` is set.
+constexpr int64_t kColumnBlockSize = 256;
+
+// Returns the grain size of `parallelFor` for tasks of `taskCost` multiply-adds
+// each, which may be zero.
+int64_t getGrainSize(int64_t taskCost) {
+  return llvm::divideCeil(kMinTaskSize, std::max<int64_t>(taskCost, 1));
+}
+
+template <typename T>
+T conjugate(T value) {
+  if constexpr (isComplex<T>)
+    return std::conj(value);
+  else
+    return value;
+}
+
+// Returns `sum(x[k] * conj(y[k]))` for all `k` in `[0, size)`, added up in
+// order of increasing `k`.
+template <typename T>
+T dotConjugate(const T *x, const T *y, int64_t size) {
+  T sum = T();
+  for (int64_t k = 0; k < size; ++k)
+    sum = add(sum, multiply(x[k], conjugate(y[k])));
+  return sum;
+}
+
+// Computes columns `[k0, k1)` of row `i` of the Cholesky factor `l`, given
+// that the updates of all blocks of columns before `k0` have been applied to
+// the row and that the rows before `i` are done.
+template <typename T>
+void factorizeRow(int64_t n, T *l, int64_t i, int64_t k0, int64_t k1) {
+  T *row = l + i * n;
+  for (int64_t j = k0; j < std::min(i, k1); ++j) {
+    const T *pivotRow = l + j * n;
+    T sum = dotConjugate(row + k0, pivotRow + k0, j - k0);
+    row[j] = divide(subtract(row[j], sum), pivotRow[j]);
+  }
+  if (i < k1) {
+    // The diagonal of a Hermitian matrix, and thus of its factor, is real.
+    T sum = dotConjugate(row + k0, row + k0, i - k0);
+    row[i] = T(std::sqrt(std::real(subtract(row[i], sum))));
+  }
+}
+
+// Replaces the lower triangle of the `n x n` matrix `l` with its Cholesky
+// factor. The strict upper triangle isn't accessed.
+template <typename T>
+void choleskyLower(int64_t n, T *l) {
+  for (int64_t k0 = 0; k0 < n; k0 += kBlockSize) {
+    int64_t k1 = std::min(n, k0 + kBlockSize);
+    for (int64_t i = k0; i < k1; ++i) factorizeRow(n, l, i, k0, k1);
+
+    // The panel below the diagonal block, and then the trailing submatrix
+    // minus the product of the panel with its conjugate transpose. Rows of
+    // the update read the panel of other rows, so the panel must be done.
+    int64_t numRows = n - k1;
+    int64_t blockSize = k1 - k0;
+    parallelFor(numRows, getGrainSize(blockSize * blockSize),
+                [&](int64_t begin, int64_t end) {
+                  for (int64_t i = k1 + begin; i < k1 + end; ++i)
+                    factorizeRow(n, l, i, k0, k1);
+                });
+    parallelFor(numRows, getGrainSize(blockSize * numRows),
+                [&](int64_t begin, int64_t end) {
+                  for (int64_t i = k1 + begin; i < k1 + end; ++i) {
+                    T *row = l + i * n;
+                    for (int64_t j = k1; j <= i; ++j)
+                      row[j] = subtract(row[j], dotConjugate(row + k0,
+                                                             l + j * n + k0,
+                                                             blockSize));
+                  }
+                });
+  }
+}
+
+}  // namespace
+
+template <typename T>
+void cholesky(int64_t batchSize, int64_t n, bool lower, const T *a,
+              T *result) {
+  parallelFor(
+      batchSize, getGrainSize(n * n * n / 3),
+      [&](int64_t begin, int64_t end) {
+        // The upper factor is the conjugate transpose of the lower factor of
+        // the conjugate transpose, which is factorized in `transposed`.
+        std::vector<T> transposed(lower ? 0 : n * n);
+        for (int64_t batch = begin; batch < end; ++batch) {
+          const T *matrix = a + batch * n * n;
+          T *factor = result + batch * n * n;
+          if (lower) {
+            for (int64_t i = 0; i < n; ++i) {
+              std::copy(matrix + i * n, matrix + i * n + i + 1,
+                        factor + i * n);
+              std::fill(factor + i * n + i + 1, factor + (i + 1) * n, T());
+            }
+            choleskyLower(n, factor);
+            continue;
+          }
+          for (int64_t i = 0; i < n; ++i)
+            for (int64_t j = 0; j <= i; ++j)
+              transposed[i * n + j] = conjugate(matrix[j * n + i]);
+          choleskyLower(n, transposed.data());
+          for (int64_t i = 0; i < n; ++i)
+            for (int64_t j = 0; j < n; ++j)
+              factor[i * n + j] =
+                  j >= i ? conjugate(transposed[j * n + i]) : T();
+        }
+      });
+}
+
+template <typename T>
+void triangularSolve(int64_t batchSize, int64_t m, int64_t n, const T *a,
+                     const T *b, bool leftSide, bool lower, bool unitDiagonal,
+                     bool transposeA, bool conjugateA, T *result) {
+  // Both sides are reduced to solving `coefficients * x = rhs` for a
+  // triangular matrix `coefficients`: with `leftSide`, `coefficients` is
+  // `op(a)` and the columns of `b` are the right-hand sides; otherwise,
+  // `coefficients` is the transpose of `op(a)` and the rows of `b` are the
+  // right-hand sides. `coefficients` holds the zeros of the unused triangle
+  // and the unit diagonal explicitly.
+  int64_t k = leftSide ? m : n;
+  bool transposed = transposeA == leftSide;
+  bool isLower = lower != transposed;
+  std::vector<T> coefficients(batchSize * k * k);
+  parallelFor(batchSize, getGrainSize(k * k),
+              [&](int64_t begin, int64_t end) {
+                for (int64_t batch = begin; batch < end; ++batch) {
+                  const T *matrix = a + batch * k * k;
+                  T *coefficient = coefficients.data() + batch * k * k;
+                  for (int64_t i = 0; i < k; ++i) {
+                    for (int64_t j = 0; j < k; ++j) {
+                      int64_t r = transposed ? j : i;
+                      int64_t c = transposed ? i : j;
+                      T value = T();
+                      if (r == c && unitDiagonal)
+                        value = T(1);
+                      else if (lower ? c <= r : c >= r)
+                        value = matrix[r * k + c];
+                      coefficient[i * k + j] =
+                          conjugateA ? conjugate(value) : value;
+                    }
+                  }
+                }
+              });
+  if (result != b) std::copy(b, b + batchSize * m * n, result);
+
+  if (leftSide) {
+    // Forward or back substitution on whole rows of a block of columns,
+    // which stays in the caches while it is solved for.
+    int64_t numBlocks = llvm::divideCeil(n, kColumnBlockSize);
+    parallelFor(
+        batchSize * numBlocks,
+        getGrainSize(m * m * std::min(n, kColumnBlockSize)),
+        [&](int64_t begin, int64_t end) {
+          for (int64_t task = begin; task < end; ++task) {
+            const T *coefficient =
+                coefficients.data() + task / numBlocks * k * k;
+            T *x = result + task / numBlocks * m * n;
+            int64_t c0 = task % numBlocks * kColumnBlockSize;
+            int64_t c1 = std::min(n, c0 + kColumnBlockSize);
+            for (int64_t step = 0; step < m; ++step) {
+              int64_t i = isLower ? step : m - 1 - step;
+              T *row = x + i * n;
+              int64_t pBegin = isLower ? 0 : i + 1;
+              int64_t pEnd = isLower ? i : m;
+              for (int64_t p = pBegin; p < pEnd; ++p) {
+                T factor = coefficient[i * k + p];
+                const T *solved = x + p * n;
+                for (int64_t c = c0; c < c1; ++c)
+                  row[c] = subtract(row[c], multiply(factor, solved[c]));
+              }
+              T diagonal = coefficient[i * k + i];
+              for (int64_t c = c0; c < c1; ++c)
+                row[c] = divide(row[c], diagonal);
+            }
+          }
+        });
+    return;
+  }
+
+  // Forward or back substitution on every row.
+  parallelFor(batchSize * m, getGrainSize(n * n),
+              [&](int64_t begin, int64_t end) {
+                for (int64_t task = begin; task < end; ++task) {
+                  const T *coefficient =
+                      coefficients.data() + task / m * k * k;
+                  T *row = result + task * n;
+                  for (int64_t step = 0; step < n; ++step) {
+                    int64_t j = isLower ? step : n - 1 - step;
+                    int64_t pBegin = isLower ? 0 : j + 1;
+                    int64_t pEnd = isLower ? j : n;
+                    T sum = T();
+                    for (int64_t p = pBegin; p < pEnd; ++p)
+                      sum = add(sum, multiply(coefficient[j * k + p], row[p]));
+                    row[j] = divide(subtract(row[j], sum),
+                                    coefficient[j * k + j]);
+                  }
+                }
+              });
+}
+
+template void cholesky(int64_t, int64_t, bool, const float *, float *);
+template void cholesky(int64_t, int64_t, bool, const double *, double *);
+template void cholesky(int64_t, int64_t, bool, const std::complex<float> *,
+                       std::complex<float> *);
+template void cholesky(int64_t, int64_t, bool, const std::complex<double> *,
+                       std::complex<double> *);
+
+template void triangularSolve(int64_t, int64_t, int64_t, const float *,
+                              const float *, bool, bool, bool, bool, bool,
+                              float *);
+template void triangularSolve(int64_t, int64_t, int64_t, const double *,
+                              const double *, bool, bool, bool, bool, bool,
+                              double *);
+template void triangularSolve(int64_t, int64_t, int64_t,
+                              const std::complex<float> *,
+                              const std::complex<float> *, bool, bool, bool,
+                              bool, bool, std::complex<float> *);
+template void triangularSolve(int64_t, int64_t, int64_t,
+                              const std::complex<double> *,
+                              const std::complex<double> *, bool, bool, bool,
+                              bool, bool, std::complex<double> *);
+
+}  // namespace native
+}  // namespace stablehlo
+}  // namespace mlir
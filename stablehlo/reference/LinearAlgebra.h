@@ -0,0 +1,72 @@
+/* Copyright 2023 The StableHLO Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef STABLEHLO_REFERENCE_LINEARALGEBRA_H
+#define STABLEHLO_REFERENCE_LINEARALGEBRA_H
+
+#include <cstdint>
+
+namespace mlir {
+namespace stablehlo {
+namespace native {
+
+/// Computes the Cholesky decompositions of `batchSize` Hermitian
+/// positive-definite `n x n` matrices `a[b]`, i.e. `result[b] = L` with
+/// `a[b] = L * L^H` if `lower`, and `result[b] = U` with `a[b] = U^H * U`
+/// otherwise. Only the triangle of `a[b]` selected by `lower` is read, and the
+/// opposite triangle of `result[b]` is set to zero. Matrices are stored
+/// densely in row-major order, one batch after the other, and `result` may be
+/// `a`. Matrices which aren't positive-definite produce NaNs.
+///
+/// Every matrix is factorized by a blocked right-looking algorithm: once a
+/// block of columns is factorized, it is applied to the trailing submatrix as
+/// a whole, so the trailing submatrix is streamed once per block rather than
+/// once per column. Batches are distributed over `getNumThreads()` threads,
+/// as are the rows of large matrices. Every element is computed by a single
+/// thread in a fixed order, so results don't depend on the number of threads.
+///
+/// `T` is one of `float`, `double`, `std::complex<float>` and
+/// `std::complex<double>`.
+template <typename T>
+void cholesky(int64_t batchSize, int64_t n, bool lower, const T *a, T *result);
+
+/// Solves `batchSize` triangular systems of linear equations, i.e. computes
+/// `result[b] = op(a[b])^-1 * b[b]` if `leftSide`, and
+/// `result[b] = b[b] * op(a[b])^-1` otherwise. `b[b]` and `result[b]` are
+/// `m x n` matrices, and `a[b]` is an `m x m` matrix if `leftSide`, and an
+/// `n x n` matrix otherwise. `op(a)` is `a` transposed if `transposeA` and
+/// conjugated if `conjugateA`. Only the triangle of `a[b]` selected by `lower`
+/// is read, and its diagonal is assumed to be 1 if `unitDiagonal`. Matrices
+/// are stored densely in row-major order, one batch after the other, and
+/// `result` may be `b`.
+///
+/// Solutions are computed by substitution on rows of `result`: with
+/// `leftSide`, for blocks of columns which stay in the caches; otherwise,
+/// one row at a time. Blocks and rows of all batches are distributed over
+/// `getNumThreads()` threads, and results don't depend on the number of
+/// threads.
+///
+/// `T` is one of `float`, `double`, `std::complex<float>` and
+/// `std::complex<double>`.
+template <typename T>
+void triangularSolve(int64_t batchSize, int64_t m, int64_t n, const T *a,
+                     const T *b, bool leftSide, bool lower, bool unitDiagonal,
+                     bool transposeA, bool conjugateA, T *result);
+
+}  // namespace native
+}  // namespace stablehlo
+}  // namespace mlir
+
+#endif  // STABLEHLO_REFERENCE_LINEARALGEBRA_H
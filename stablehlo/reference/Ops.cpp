@@ -15,16 +15,41 @@ limitations under the License.
 
 #include "stablehlo/reference/Ops.h"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <complex>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
 #include "llvm/ADT/APFloat.h"
 #include "llvm/ADT/APInt.h"
 #include "llvm/Support/Errc.h"
 #include "llvm/Support/Error.h"
+#include "llvm/Support/MathExtras.h"
 #include "mlir/Dialect/Func/IR/FuncOps.h"
 #include "mlir/IR/BuiltinTypes.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
 #include "mlir/Support/DebugStringHelper.h"
 #include "stablehlo/reference/Element.h"
 #include "stablehlo/reference/Errors.h"
+#include "stablehlo/reference/Fft.h"
+#include "stablehlo/reference/Gemm.h"
+#include "stablehlo/reference/Kernels.h"
+#include "stablehlo/reference/LinearAlgebra.h"
+#include "stablehlo/reference/Parallel.h"
+#include "stablehlo/reference/PreparedRegion.h"
+#include "stablehlo/reference/Process.h"
+#include "stablehlo/reference/Random.h"
 #include "stablehlo/reference/Types.h"
+#include "stablehlo/reference/VectorMath.h"
 
 namespace mlir {
 namespace stablehlo {
@@ -37,80 +62,2192 @@ Index evalIndices(ArrayRef<Tensor> runtimeIndices) {
   return index;
 }
 
-}  // namespace
+// Returns the additive identity of `type`.
+Element getZero(Type type) {
+  if (isSupportedBooleanType(type)) return Element(type, false);
+  if (isSupportedIntegerType(type)) return Element(type, int64_t{0});
+  if (isSupportedFloatType(type)) return Element(type, 0.0);
+  if (isSupportedComplexType(type))
+    return Element(type, std::complex<double>());
+  report_fatal_error(invalidArgument("Unsupported element type: %s",
+                                     debugString(type).c_str()));
+}
 
-Tensor evalAbsOp(const Tensor &operand, TensorType resultType) {
-  Tensor result(resultType);
-  for (auto it = result.index_begin(); it != result.index_end(); ++it)
-    result.set(*it, abs(operand.get(*it)));
+// Describes how the windows of a convolution are laid over the spatial
+// dimensions of `lhs`, see `evalConvolutionOp`.
+struct ConvolutionWindow {
+  Sizes inputShape;
+  Sizes kernelShape;
+  Sizes windowStrides;
+  Sizes paddingLow;
+  Sizes lhsDilation;
+  Sizes rhsDilation;
+  SmallVector<bool> windowReversal;
+
+  // Computes the spatial index of the element of `lhs` which is multiplied
+  // with the kernel element at `kernelIndex` for the result element at
+  // `outputIndex`. Returns false if that element is padding, either from
+  // `paddingLow` and the corresponding high padding or from the holes
+  // introduced by `lhsDilation`.
+  bool getInputIndex(const Sizes &outputIndex, const Sizes &kernelIndex,
+                     Sizes &inputIndex) const {
+    for (size_t i = 0; i < inputShape.size(); ++i) {
+      int64_t windowIndex = windowReversal[i]
+                                ? kernelShape[i] - 1 - kernelIndex[i]
+                                : kernelIndex[i];
+      int64_t dilatedIndex = outputIndex[i] * windowStrides[i] +
+                             windowIndex * rhsDilation[i] - paddingLow[i];
+      if (dilatedIndex < 0 || dilatedIndex % lhsDilation[i] != 0) return false;
+      inputIndex[i] = dilatedIndex / lhsDilation[i];
+      if (inputIndex[i] >= inputShape[i]) return false;
+    }
+    return true;
+  }
+};
+
+// Advances `index` to the next index of the index space of `shape` in
+// lexicographical order. Returns false, and resets `index` to all zeros,
+// after the last index.
+bool incrementIndex(Sizes &index, const Sizes &shape) {
+  for (int64_t d = index.size() - 1; d >= 0; --d) {
+    if (++index[d] < shape[d]) return true;
+    index[d] = 0;
+  }
+  return false;
+}
+
+// Number of elements of the im2col matrix which are materialized at once.
+constexpr int64_t kIm2colBlockSize = 1 << 20;
+
+// Computes a convolution of canonicalized operands, see `evalConvolutionOp`,
+// by lowering it to matrix products. For every group, the windows of `lhs`
+// are unrolled into the rows of a matrix (im2col), whose product with the
+// kernel of the group, a `[kernel positions * inputFeatures, outputFeatures]`
+// matrix, is the result of the group. The im2col matrix is built in blocks
+// of rows to bound its memory usage.
+template <typename T>
+void convolveNative(const ConvolutionWindow &window, const Sizes &outputShape,
+                    int64_t numGroups, int64_t batchSize,
+                    int64_t inputFeatures, int64_t outputFeatures,
+                    const T *lhs, const T *rhs, T *result) {
+  int64_t numInputPositions = ShapedType::getNumElements(window.inputShape);
+  int64_t numKernelPositions = ShapedType::getNumElements(window.kernelShape);
+  int64_t numOutputPositions = ShapedType::getNumElements(outputShape);
+  int64_t numRows = batchSize * numOutputPositions;
+  int64_t numColumns = numKernelPositions * inputFeatures;
+  if (numRows == 0 || outputFeatures == 0) return;
+
+  int64_t rowSize = std::max<int64_t>(numColumns, 1);
+  int64_t blockRows =
+      std::clamp<int64_t>(kIm2colBlockSize / rowSize, 1, numRows);
+  auto im2col = std::make_unique<T[]>(blockRows * numColumns);
+  for (int64_t group = 0; group < numGroups; ++group) {
+    const T *groupLhs =
+        lhs + group * batchSize * numInputPositions * inputFeatures;
+    const T *groupRhs = rhs + group * numColumns * outputFeatures;
+    T *groupResult = result + group * numRows * outputFeatures;
+    for (int64_t rowBegin = 0; rowBegin < numRows; rowBegin += blockRows) {
+      int64_t rowEnd = std::min(numRows, rowBegin + blockRows);
+      parallelFor(
+          rowEnd - rowBegin, kDefaultGrainSize / rowSize,
+          [&](int64_t begin, int64_t end) {
+            Sizes outputIndex(outputShape.size());
+            Sizes kernelIndex(window.kernelShape.size());
+            Sizes inputIndex(window.inputShape.size());
+            for (int64_t row = begin; row < end; ++row) {
+              int64_t batch = (rowBegin + row) / numOutputPositions;
+              int64_t outputPosition = (rowBegin + row) % numOutputPositions;
+              for (int64_t d = outputShape.size() - 1; d >= 0; --d) {
+                outputIndex[d] = outputPosition % outputShape[d];
+                outputPosition /= outputShape[d];
+              }
+
+              // Features are the minor dimension of `lhs`, so every kernel
+              // position copies a contiguous run of `inputFeatures` elements.
+              T *column = im2col.get() + row * numColumns;
+              for (int64_t kernelPosition = 0;
+                   kernelPosition < numKernelPositions; ++kernelPosition) {
+                T *features = column + kernelPosition * inputFeatures;
+                if (window.getInputIndex(outputIndex, kernelIndex,
+                                         inputIndex)) {
+                  int64_t inputPosition = 0;
+                  for (auto [index, size] :
+                       llvm::zip(inputIndex, window.inputShape))
+                    inputPosition = inputPosition * size + index;
+                  const T *source =
+                      groupLhs +
+                      (batch * numInputPositions + inputPosition) *
+                          inputFeatures;
+                  std::copy(source, source + inputFeatures, features);
+                } else {
+                  std::fill(features, features + inputFeatures, T());
+                }
+                incrementIndex(kernelIndex, window.kernelShape);
+              }
+            }
+          });
+      native::gemm(1, rowEnd - rowBegin, outputFeatures, numColumns,
+                   im2col.get(), groupRhs,
+                   groupResult + rowBegin * outputFeatures);
+    }
+  }
+}
+
+// Computes a convolution of canonicalized operands, see `evalConvolutionOp`,
+// element by element, directly following the definition of the spec.
+void convolveDirect(const ConvolutionWindow &window, const Tensor &lhs,
+                    const Tensor &rhs, Tensor &result) {
+  Type elementType = result.getElementType();
+  int64_t numSpatialDims = window.inputShape.size();
+  int64_t inputFeatures = lhs.getShape().back();
+  Sizes kernelIndex(numSpatialDims);
+  Sizes inputIndex(numSpatialDims);
+  for (auto it = result.index_begin(); it != result.index_end(); ++it) {
+    const Index &resultIndex = *it;
+    int64_t group = resultIndex[0];
+    int64_t batch = resultIndex[1];
+    int64_t outputFeature = resultIndex.back();
+    Sizes outputIndex(ArrayRef<int64_t>(resultIndex).slice(2, numSpatialDims));
+
+    // Products are added up in the order of the contracting dimensions of
+    // the `dot_general` in the spec, i.e. kernel positions major and input
+    // features minor.
+    Element dotProduct = getZero(elementType);
+    if (ShapedType::getNumElements(window.kernelShape) != 0) {
+      do {
+        bool isPadding =
+            !window.getInputIndex(outputIndex, kernelIndex, inputIndex);
+        for (int64_t feature = 0; feature < inputFeatures; ++feature) {
+          Index lhsIndex = {group, batch};
+          lhsIndex.append(inputIndex);
+          lhsIndex.push_back(feature);
+          Element lhsElement =
+              isPadding ? getZero(elementType) : lhs.get(lhsIndex);
+          Index rhsIndex = {group};
+          rhsIndex.append(kernelIndex);
+          rhsIndex.append({feature, outputFeature});
+          dotProduct = dotProduct + lhsElement * rhs.get(rhsIndex);
+        }
+      } while (incrementIndex(kernelIndex, window.kernelShape));
+    }
+    result.set(resultIndex, dotProduct);
+  }
+}
+
+// See `setPairwiseSummation`. Evaluations may run concurrently with the
+// setter, e.g. in different threads of an embedder, so the flag is atomic.
+std::atomic<bool> pairwiseSummation = false;
+
+// Ops which make up the body of a reduction that can be evaluated without
+// evaluating the body, see `getReductionKind`.
+enum class ReductionKind { kAdd, kAnd, kMax, kMin, kMultiply, kOr };
+
+// Recognizes bodies of `reduce` and `reduce_window` which consist of a single
+// binary op, applied to the two block arguments in either order, whose result
+// is returned. All ops in `ReductionKind` are commutative, so the order of
+// the block arguments doesn't matter.
+std::optional<ReductionKind> getReductionKind(Region &body) {
+  Block &block = body.front();
+  if (block.getNumArguments() != 2 || block.getOperations().size() != 2)
+    return std::nullopt;
+  Operation &op = block.front();
+  auto returnOp = dyn_cast<ReturnOp>(block.back());
+  if (!returnOp || returnOp->getNumOperands() != 1 ||
+      op.getNumOperands() != 2 || op.getNumResults() != 1 ||
+      returnOp->getOperand(0) != op.getResult(0))
+    return std::nullopt;
+  Value lhs = block.getArgument(0);
+  Value rhs = block.getArgument(1);
+  if (!(op.getOperand(0) == lhs && op.getOperand(1) == rhs) &&
+      !(op.getOperand(0) == rhs && op.getOperand(1) == lhs))
+    return std::nullopt;
+  if (isa<AddOp>(op)) return ReductionKind::kAdd;
+  if (isa<AndOp>(op)) return ReductionKind::kAnd;
+  if (isa<MaxOp>(op)) return ReductionKind::kMax;
+  if (isa<MinOp>(op)) return ReductionKind::kMin;
+  if (isa<MulOp>(op)) return ReductionKind::kMultiply;
+  if (isa<OrOp>(op)) return ReductionKind::kOr;
+  return std::nullopt;
+}
+
+// Number of elements which the leaves of `reduceTree` reduce at most.
+constexpr int64_t kTreeLeafSize = 128;
+
+// Number of partial results which the leaves of `reduceTree` compute side by
+// side, so that the compiler can keep them in a vector register.
+constexpr int64_t kTreeLeafWidth = 8;
+
+// Number of elements above which `reduceTree` reduces both halves of the
+// data on different threads.
+constexpr int64_t kMinParallelTreeSize = 1 << 16;
+
+// Reduces `data[0], ..., data[size - 1]` with `op` in this order, starting
+// from `init`.
+template <typename T, typename Op>
+T reduceSequential(T init, const T *data, int64_t size, Op op) {
+  for (int64_t i = 0; i < size; ++i) init = op(init, data[i]);
+  return init;
+}
+
+// Reduces the `size` elements at `data`, which must not be empty, with `op`
+// by splitting them in halves until at most `kTreeLeafSize` elements are
+// left. This is pairwise summation if `op` is `add`, whose rounding error
+// only grows with the logarithm of `size`. The shape of the tree only depends
+// on `size`, so results don't depend on the number of threads.
+template <typename T, typename Op>
+T reduceTree(const T *data, int64_t size, Op op) {
+  if (size > kTreeLeafSize) {
+    int64_t half = size / 2;
+    T halves[2];
+    parallelFor(2, size < kMinParallelTreeSize ? 2 : 1,
+                [&](int64_t begin, int64_t end) {
+                  for (int64_t i = begin; i < end; ++i)
+                    halves[i] = i == 0 ? reduceTree(data, half, op)
+                                       : reduceTree(data + half, size - half,
+                                                    op);
+                });
+    return op(halves[0], halves[1]);
+  }
+
+  if (size < kTreeLeafWidth)
+    return reduceSequential(data[0], data + 1, size - 1, op);
+  T lanes[kTreeLeafWidth];
+  std::copy(data, data + kTreeLeafWidth, lanes);
+  int64_t i = kTreeLeafWidth;
+  for (; i + kTreeLeafWidth <= size; i += kTreeLeafWidth)
+    for (int64_t lane = 0; lane < kTreeLeafWidth; ++lane)
+      lanes[lane] = op(lanes[lane], data[i + lane]);
+  for (int64_t lane = 0; i + lane < size; ++lane)
+    lanes[lane] = op(lanes[lane], data[i + lane]);
+  for (int64_t width = kTreeLeafWidth / 2; width > 0; width /= 2)
+    for (int64_t lane = 0; lane < width; ++lane)
+      lanes[lane] = op(lanes[lane], lanes[lane + width]);
+  return lanes[0];
+}
+
+// Invokes `fn(tag, op)` with a value-initialized object of the C++ type which
+// is used to store elements of type `type`, provided that `type` belongs to
+// one of `Categories` (see `dispatchNativeType`).
+template <unsigned Categories, typename Op, typename Fn>
+bool dispatchNativeOp(Type type, Op op, Fn &fn) {
+  return dispatchNativeType<Categories>(type, [&](auto tag) { fn(tag, op); });
+}
+
+// Invokes `fn(tag, op)` with a value-initialized object of the C++ type which
+// is used to store elements of type `type` and the native counterpart of the
+// op of `kind` as a generic function object. Returns false without invoking
+// `fn` if the op has no native counterpart for `type`.
+template <typename Fn>
+bool dispatchReduction(ReductionKind kind, Type type, Fn fn) {
+  switch (kind) {
+    case ReductionKind::kAdd:
+      return dispatchNativeOp<kNativeAll>(
+          type, [](auto x, auto y) { return native::add(x, y); }, fn);
+    case ReductionKind::kAnd:
+      return dispatchNativeOp<kNativeIntegral>(
+          type, [](auto x, auto y) { return native::bitwiseAnd(x, y); }, fn);
+    case ReductionKind::kMax:
+      return dispatchNativeOp<kNativeAll>(
+          type, [](auto x, auto y) { return native::max(x, y); }, fn);
+    case ReductionKind::kMin:
+      return dispatchNativeOp<kNativeAll>(
+          type, [](auto x, auto y) { return native::min(x, y); }, fn);
+    case ReductionKind::kMultiply:
+      return dispatchNativeOp<kNativeAll>(
+          type, [](auto x, auto y) { return native::multiply(x, y); }, fn);
+    case ReductionKind::kOr:
+      return dispatchNativeOp<kNativeIntegral>(
+          type, [](auto x, auto y) { return native::bitwiseOr(x, y); }, fn);
+  }
+  llvm_unreachable("Unknown reduction kind");
+}
+
+// Copies the elements of `input` at the indices which start with the index
+// at linear position `row` of `keptShape`, the shape of the leading
+// dimensions of `input`, into `buffer` in major-to-minor order. `storage`
+// is the underlying storage of `input` (see `Tensor::getStorage`).
+template <typename T>
+void gatherRow(const T *storage, const Tensor &input, const Sizes &keptShape,
+               int64_t row, MutableArrayRef<T> buffer) {
+  const Sizes &strides = input.getStrides();
+  int64_t numKeptDims = keptShape.size();
+  int64_t position = input.getOffset();
+  for (int64_t dim = numKeptDims - 1; dim >= 0; --dim) {
+    position += row % keptShape[dim] * strides[dim];
+    row /= keptShape[dim];
+  }
+
+  Sizes shape = input.getShape();
+  int64_t rank = shape.size();
+  Index index(rank);
+  for (T &element : buffer) {
+    element = storage[position];
+    for (int64_t dim = rank - 1; dim >= numKeptDims; --dim) {
+      position += strides[dim];
+      if (++index[dim] < shape[dim]) break;
+      position -= strides[dim] * shape[dim];
+      index[dim] = 0;
+    }
+  }
+}
+
+// Reduces every row of `input` with the op of `kind` into the corresponding
+// element of `result`, starting from `initValue`. The rows are made up of the
+// elements whose indices share their leading dimensions, one per dimension of
+// `result`, so each row is as many consecutive elements as there are elements
+// in `input` per element of `result` if `input` is contiguous. Otherwise,
+// e.g. for the overlapping windows of `reduce_window`, the rows are gathered
+// one at a time instead of materializing `input`, which could be many times
+// larger than the tensor it views. Rows of floating-point and complex
+// elements are reduced in order, since the op may not be associative for
+// them, unless `kind` is `kAdd` and pairwise summation is enabled. Other rows
+// are reduced by `reduceTree`, which gives the same results but vectorizes
+// better. Returns false and leaves `result` untouched if the op has no native
+// counterpart for the element type.
+bool reduceNative(ReductionKind kind, const Tensor &input,
+                  const Tensor &initValue, Tensor &result) {
+  return dispatchReduction(kind, result.getElementType(), [&](auto tag,
+                                                              auto op) {
+    using T = decltype(tag);
+    bool reassociate = !(std::is_floating_point_v<T> || native::isComplex<T>) ||
+                       (kind == ReductionKind::kAdd &&
+                        pairwiseSummation.load(std::memory_order_relaxed));
+    int64_t numRows = result.getNumElements();
+    if (numRows == 0) return;
+    int64_t rowSize = input.getNumElements() / numRows;
+    bool isContiguous = input.isContiguous();
+    const T *inputData = isContiguous ? input.getData<T>().data()
+                                      : input.getStorage<T>().data();
+    Sizes keptShape = result.getShape();
+    T init = initValue.materialize().getData<T>()[0];
+    T *resultData = result.getMutableData<T>().data();
+    parallelFor(numRows, kDefaultGrainSize / std::max<int64_t>(rowSize, 1),
+                [&](int64_t begin, int64_t end) {
+                  SmallVector<T> buffer(isContiguous ? 0 : rowSize);
+                  for (int64_t row = begin; row < end; ++row) {
+                    const T *rowData = inputData + row * rowSize;
+                    if (!isContiguous) {
+                      gatherRow(inputData, input, keptShape, row,
+                                MutableArrayRef<T>(buffer));
+                      rowData = buffer.data();
+                    }
+                    resultData[row] =
+                        reassociate && rowSize != 0
+                            ? op(init, reduceTree(rowData, rowSize, op))
+                            : reduceSequential(init, rowData, rowSize, op);
+                  }
+                });
+  });
+}
+
+// Applies the op of `kind` to elements which have no native counterpart.
+Element combineElements(ReductionKind kind, const Element &lhs,
+                        const Element &rhs) {
+  switch (kind) {
+    case ReductionKind::kAdd:
+      return lhs + rhs;
+    case ReductionKind::kAnd:
+      return lhs & rhs;
+    case ReductionKind::kMax:
+      return stablehlo::max(lhs, rhs);
+    case ReductionKind::kMin:
+      return stablehlo::min(lhs, rhs);
+    case ReductionKind::kMultiply:
+      return lhs * rhs;
+    case ReductionKind::kOr:
+      return lhs | rhs;
+  }
+  llvm_unreachable("Unknown reduction kind");
+}
+
+// Recognizes bodies of `scatter` which return their second block argument,
+// i.e. which replace elements of the inputs with the updates.
+bool isReplacement(Region &body) {
+  Block &block = body.front();
+  if (block.getNumArguments() != 2 || block.getOperations().size() != 1)
+    return false;
+  auto returnOp = dyn_cast<ReturnOp>(block.back());
+  return returnOp && returnOp->getNumOperands() == 1 &&
+         returnOp->getOperand(0) == block.getArgument(1);
+}
+
+// Returns a 0-dimensional tensor which holds `element`, e.g. to pass it to a
+// region.
+Tensor makeScalarTensor(const Element &element) {
+  Tensor tensor(RankedTensorType::get({}, element.getType()));
+  tensor.set({}, element);
+  return tensor;
+}
+
+// Returns the process which evaluates `scope`. Programs which aren't
+// evaluated as part of a process grid are evaluated by the only process of a
+// grid with one replica and one partition.
+Process &getProcess(Scope &scope) {
+  if (Process *process = scope.getProcess()) return *process;
+  static ProcessGrid grid(/*numReplicas=*/1, /*numPartitions=*/1);
+  static Process process({/*replicaId=*/0, /*partitionId=*/0}, grid);
+  return process;
+}
+
+// Decodes `replica_groups` and `source_target_pairs`, i.e. 2-dimensional
+// tensors with one group of ids per row. Rows may be padded with negative
+// ids, which are dropped.
+SmallVector<SmallVector<uint32_t>> getIdGroups(DenseIntElementsAttr attr) {
+  SmallVector<SmallVector<uint32_t>> groups;
+  int64_t groupSize = attr.getType().getDimSize(1);
+  if (groupSize == 0) return groups;
+  auto values = llvm::to_vector(attr.getValues<int64_t>());
+  for (size_t begin = 0; begin < values.size(); begin += groupSize) {
+    SmallVector<uint32_t> group;
+    for (int64_t id : ArrayRef<int64_t>(values).slice(begin, groupSize))
+      if (id >= 0) group.push_back(id);
+    if (!group.empty()) groups.push_back(std::move(group));
+  }
+  return groups;
+}
+
+// Returns the `channel_id` of a collective op, which is 0 if the op doesn't
+// have a channel handle.
+template <typename Op>
+int64_t getChannelId(Op op) {
+  ChannelHandleAttr channelHandle = op.getChannelHandleAttr();
+  return channelHandle ? channelHandle.getHandle() : 0;
+}
+
+// Returns the process group of `process` among `processGroups`.
+ProcessGroup findProcessGroup(ArrayRef<ProcessGroup> processGroups,
+                              const Process &process) {
+  for (const auto &processGroup : processGroups)
+    if (llvm::is_contained(processGroup, process.getId())) return processGroup;
+  report_fatal_error(invalidArgument(
+      "Process (%d, %d) is not a member of any process group",
+      process.getId().replicaId, process.getId().partitionId));
+}
+
+// Returns the process group of `process` for `all_gather`, `all_reduce` and
+// `reduce_scatter`, whose grouping strategy depends on `channelId` and
+// `useGlobalDeviceIds`.
+ProcessGroup getProcessGroup(const Process &process,
+                             ArrayRef<SmallVector<uint32_t>> replicaGroups,
+                             int64_t channelId, bool useGlobalDeviceIds) {
+  const ProcessGrid &grid = process.getGrid();
+  if (channelId <= 0 && !useGlobalDeviceIds)
+    return findProcessGroup(grid.crossReplica(replicaGroups), process);
+  if (channelId > 0 && !useGlobalDeviceIds)
+    return findProcessGroup(grid.crossReplicaAndPartition(replicaGroups),
+                            process);
+  if (channelId > 0 && useGlobalDeviceIds)
+    return findProcessGroup(grid.flattenedIds(replicaGroups), process);
+  report_fatal_error(invalidArgument(
+      "Expected a positive channel_id with use_global_device_ids, but got %d",
+      channelId));
+}
+
+// Returns the process group of `process` for `all_to_all` and
+// `collective_permute`, which communicate across replicas if `channelId` is
+// not positive and across partitions otherwise.
+ProcessGroup getProcessGroup(const Process &process,
+                             ArrayRef<SmallVector<uint32_t>> replicaGroups,
+                             int64_t channelId) {
+  const ProcessGrid &grid = process.getGrid();
+  return findProcessGroup(channelId <= 0
+                              ? grid.crossReplica(replicaGroups)
+                              : grid.crossPartition(replicaGroups),
+                          process);
+}
+
+// Returns the position of `process` in `processGroup`.
+int64_t getProcessIndex(const ProcessGroup &processGroup,
+                        const Process &process) {
+  return llvm::find(processGroup, process.getId()) - processGroup.begin();
+}
+
+// Reduces `values`, which must have the same type, elementwise with
+// `computation` in the order of `values`, e.g. the element at index `i` of
+// the result is `computation(computation(values[0][i], values[1][i]),
+// values[2][i])` for three values. Bodies recognized by `getReductionKind`
+// are applied without evaluating them.
+Tensor reduceValues(ArrayRef<Tensor> values, Region &computation,
+                    Scope &scope) {
+  Tensor result(values[0].getType());
+  result.copyFrom(values[0]);
+  if (values.size() == 1) return result;
+
+  std::optional<ReductionKind> kind = getReductionKind(computation);
+  if (kind) {
+    SmallVector<Tensor> contiguousValues;
+    for (const auto &value : values.drop_front())
+      contiguousValues.push_back(value.materialize());
+    if (dispatchReduction(*kind, result.getElementType(), [&](auto tag,
+                                                              auto op) {
+          using T = decltype(tag);
+          T *resultData = result.getMutableData<T>().data();
+          parallelFor(result.getNumElements(), kDefaultGrainSize,
+                      [&](int64_t begin, int64_t end) {
+                        for (const auto &value : contiguousValues) {
+                          const T *valueData = value.getData<T>().data();
+                          for (int64_t i = begin; i < end; ++i)
+                            resultData[i] = op(resultData[i], valueData[i]);
+                        }
+                      });
+        }))
+      return result;
+
+    for (int64_t i = 0, e = result.getNumElements(); i < e; ++i) {
+      Element accumulator = result.getAt(i);
+      for (const auto &value : values.drop_front())
+        accumulator = combineElements(*kind, accumulator, value.getAt(i));
+      result.setAt(i, accumulator);
+    }
+    return result;
+  }
+
+  for (int64_t i = 0, e = result.getNumElements(); i < e; ++i) {
+    Tensor accumulator = makeScalarTensor(result.getAt(i));
+    for (const auto &value : values.drop_front())
+      accumulator = eval(computation,
+                         {accumulator, makeScalarTensor(value.getAt(i))},
+                         &scope)[0];
+    result.setAt(i, accumulator.get({}));
+  }
   return result;
 }
 
-Tensor evalAddOp(const Tensor &lhs, const Tensor &rhs, TensorType resultType) {
+// Reads the index vectors of `gather` and `scatter` from `indices`, whose
+// dimension `indexVectorDim` holds the components of the index vectors. If
+// `indexVectorDim` is the rank of `indices`, every element of `indices` is an
+// index vector of size 1. Returns a matrix in row-major order with one index
+// vector per row, in the lexicographic order of the other dimensions.
+SmallVector<int64_t> getIndexVectors(const Tensor &indices,
+                                     Axis indexVectorDim) {
+  Sizes shape = indices.getShape();
+  Sizes strides = indices.getStrides();
+  if (indexVectorDim == indices.getRank()) {
+    shape.push_back(1);
+    strides.push_back(0);
+  } else {
+    Axes permutation;
+    for (int64_t dim = 0; dim < indices.getRank(); ++dim)
+      if (dim != indexVectorDim) permutation.push_back(dim);
+    permutation.push_back(indexVectorDim);
+    shape = shape.permute(permutation);
+    strides = strides.permute(permutation);
+  }
+  Type elementType = indices.getElementType();
+  Tensor matrix = Tensor(RankedTensorType::get(shape, elementType), indices,
+                         indices.getOffset(), strides)
+                      .materialize();
+
+  SmallVector<int64_t> values(matrix.getNumElements());
+  if (dispatchNativeType<kNativeInteger>(elementType, [&](auto tag) {
+        using T = decltype(tag);
+        llvm::copy(matrix.getData<T>(), values.begin());
+      }))
+    return values;
+  bool isUnsigned = isSupportedUnsignedIntegerType(elementType);
+  for (int64_t i = 0, e = matrix.getNumElements(); i < e; ++i) {
+    APInt value = matrix.getAt(i).getIntegerValue();
+    values[i] = isUnsigned ? value.getZExtValue() : value.getSExtValue();
+  }
+  return values;
+}
+
+// Returns the position, in a tensor whose dimensions have strides `strides`,
+// of the element at position `linearIndex` in the lexicographic order of the
+// index space of `shape`.
+int64_t getPosition(int64_t linearIndex, const Sizes &shape,
+                    const Sizes &strides) {
+  int64_t position = 0;
+  for (int64_t dim = shape.size() - 1; dim >= 0; --dim) {
+    position += linearIndex % shape[dim] * strides[dim];
+    linearIndex /= shape[dim];
+  }
+  return position;
+}
+
+// A copy of a block of elements between two tensors, split into runs of
+// elements which are contiguous in both of them. See `getCopyRuns`.
+struct CopyRuns {
+  // Number of elements per run.
+  int64_t length = 0;
+
+  // Positions of the first element of every run in the source and the
+  // destination, relative to the first element of the block.
+  SmallVector<std::pair<int64_t, int64_t>> offsets;
+};
+
+// Splits the copy of a block of shape `shape`, whose dimensions have strides
+// `sourceStrides` in the source and `destStrides` in the destination, into
+// runs. Minor dimensions which are laid out densely in both tensors are
+// merged into the runs, so that e.g. rows of an embedding table are copied
+// with a single `std::memcpy`.
+CopyRuns getCopyRuns(const Sizes &shape, const Sizes &sourceStrides,
+                     const Sizes &destStrides) {
+  CopyRuns runs;
+  if (llvm::is_contained(shape, 0)) return runs;
+
+  // Dimensions of size 1 don't affect the layout.
+  Sizes runShape, runSourceStrides, runDestStrides;
+  for (auto [size, sourceStride, destStride] :
+       llvm::zip(shape, sourceStrides, destStrides)) {
+    if (size == 1) continue;
+    runShape.push_back(size);
+    runSourceStrides.push_back(sourceStride);
+    runDestStrides.push_back(destStride);
+  }
+
+  runs.length = 1;
+  while (!runShape.empty() && runSourceStrides.back() == runs.length &&
+         runDestStrides.back() == runs.length) {
+    runs.length *= runShape.pop_back_val();
+    runSourceStrides.pop_back();
+    runDestStrides.pop_back();
+  }
+
+  Sizes index(runShape.size());
+  do {
+    int64_t sourceOffset = 0;
+    int64_t destOffset = 0;
+    for (size_t dim = 0; dim < runShape.size(); ++dim) {
+      sourceOffset += index[dim] * runSourceStrides[dim];
+      destOffset += index[dim] * runDestStrides[dim];
+    }
+    runs.offsets.emplace_back(sourceOffset, destOffset);
+  } while (incrementIndex(index, runShape));
+  return runs;
+}
+
+// Compares `lhs` and `rhs` elementwise in `direction` after mapping their
+// elements through `key`, see `mapNativePredicate`.
+template <unsigned Categories, typename Key>
+bool compareNative(const Tensor &lhs, const Tensor &rhs,
+                   ComparisonDirection direction, Tensor &result, Key key) {
+  auto compare = [&](auto fn) {
+    return mapNativePredicate<Categories>(
+        lhs, rhs, result, [&](auto x, auto y) { return fn(key(x), key(y)); });
+  };
+  switch (direction) {
+    case ComparisonDirection::EQ:
+      return compare([](auto x, auto y) { return x == y; });
+    case ComparisonDirection::NE:
+      return compare([](auto x, auto y) { return x != y; });
+    case ComparisonDirection::GE:
+      return compare(
+          [](auto x, auto y) { return native::isLessOrEqual(y, x); });
+    case ComparisonDirection::GT:
+      return compare([](auto x, auto y) { return native::isLess(y, x); });
+    case ComparisonDirection::LE:
+      return compare(
+          [](auto x, auto y) { return native::isLessOrEqual(x, y); });
+    case ComparisonDirection::LT:
+      return compare([](auto x, auto y) { return native::isLess(x, y); });
+  }
+  llvm_unreachable("Unknown comparison direction");
+}
+
+// Returns whether integer and boolean elements of type `elementType` are
+// compared as signed integers by a `compare` with `compareType`.
+bool isSignedComparison(Type elementType,
+                        std::optional<ComparisonType> compareType) {
+  if (compareType == ComparisonType::SIGNED) return true;
+  if (compareType == ComparisonType::UNSIGNED) return false;
+  return isSupportedSignedIntegerType(elementType);
+}
+
+// Returns -1, 0 or 1 if `lhs` is less than, equal to or greater than `rhs`, or
+// std::nullopt if they are unordered because of NaNs. Complex numbers are
+// ordered lexicographically.
+std::optional<int> getOrdering(const Element &lhs, const Element &rhs,
+                               std::optional<ComparisonType> compareType) {
+  auto getFloatOrdering = [](const APFloat &x,
+                             const APFloat &y) -> std::optional<int> {
+    switch (x.compare(y)) {
+      case APFloat::cmpLessThan:
+        return -1;
+      case APFloat::cmpEqual:
+        return 0;
+      case APFloat::cmpGreaterThan:
+        return 1;
+      case APFloat::cmpUnordered:
+        return std::nullopt;
+    }
+    llvm_unreachable("Unknown APFloat comparison result");
+  };
+
+  Type type = lhs.getType();
+  if (isSupportedIntegerType(type) || isSupportedBooleanType(type)) {
+    auto getValue = [](const Element &el) {
+      return isSupportedBooleanType(el.getType())
+                 ? APInt(1, el.getBooleanValue())
+                 : el.getIntegerValue();
+    };
+    APInt x = getValue(lhs);
+    APInt y = getValue(rhs);
+    if (x == y) return 0;
+    if (isSignedComparison(type, compareType)) return x.slt(y) ? -1 : 1;
+    return x.ult(y) ? -1 : 1;
+  }
+
+  if (isSupportedFloatType(type)) {
+    if (compareType != ComparisonType::TOTALORDER)
+      return getFloatOrdering(lhs.getFloatValue(), rhs.getFloatValue());
+    // Like `native::totalOrderKey`: flipping all bits but the sign bit of
+    // negative numbers orders the bit patterns like totalOrder.
+    auto getKey = [](const Element &el) {
+      int64_t bits = el.getFloatValue().bitcastToAPInt().getSExtValue();
+      return bits < 0 ? bits ^ std::numeric_limits<int64_t>::max() : bits;
+    };
+    int64_t x = getKey(lhs);
+    int64_t y = getKey(rhs);
+    return x < y ? -1 : x == y ? 0 : 1;
+  }
+
+  if (isSupportedComplexType(type)) {
+    auto x = lhs.getComplexValue();
+    auto y = rhs.getComplexValue();
+    auto ordering = getFloatOrdering(x.real(), y.real());
+    if (ordering != 0) return ordering;
+    return getFloatOrdering(x.imag(), y.imag());
+  }
+
+  report_fatal_error(invalidArgument("Unsupported element type: %s",
+                                     debugString(type).c_str()));
+}
+
+// Element version of `compareNative`.
+bool compareElements(const Element &lhs, const Element &rhs,
+                     ComparisonDirection direction,
+                     std::optional<ComparisonType> compareType) {
+  std::optional<int> ordering = getOrdering(lhs, rhs, compareType);
+  // Unordered elements are only not equal.
+  if (!ordering) return direction == ComparisonDirection::NE;
+  switch (direction) {
+    case ComparisonDirection::EQ:
+      return *ordering == 0;
+    case ComparisonDirection::NE:
+      return *ordering != 0;
+    case ComparisonDirection::GE:
+      return *ordering >= 0;
+    case ComparisonDirection::GT:
+      return *ordering > 0;
+    case ComparisonDirection::LE:
+      return *ordering <= 0;
+    case ComparisonDirection::LT:
+      return *ordering < 0;
+  }
+  llvm_unreachable("Unknown comparison direction");
+}
+
+// Calls `fn(operandData, resultData)`, where `operandData` holds a pointer to
+// the dense elements of every operand and `resultData` points to the elements
+// of a result of `resultType`. Elements are of the native storage type of
+// their floating-point or complex element type, or `double` for `f16` and
+// `bf16`, which are then rounded to the result type after `fn` returns.
+template <typename Fn>
+Tensor evalInNativePrecision(ArrayRef<Tensor> operands, TensorType resultType,
+                             Fn fn) {
   Tensor result(resultType);
-  for (auto it = result.index_begin(); it != result.index_end(); ++it)
-    result.set(*it, lhs.get(*it) + rhs.get(*it));
+  Type elementType = resultType.getElementType();
+  if (dispatchNativeType<kNativeFloatOrComplex>(elementType, [&](auto tag) {
+        using T = decltype(tag);
+        SmallVector<Tensor> contiguousOperands;
+        SmallVector<const T *> operandData;
+        for (const Tensor &operand : operands)
+          contiguousOperands.push_back(operand.materialize());
+        for (const Tensor &operand : contiguousOperands)
+          operandData.push_back(operand.getData<T>().data());
+        fn(ArrayRef<const T *>(operandData),
+           result.getMutableData<T>().data());
+      }))
+    return result;
+
+  if (!isSupportedFloatType(elementType))
+    report_fatal_error(invalidArgument("Unsupported element type: %s",
+                                       debugString(elementType).c_str()));
+  SmallVector<std::vector<double>> operandValues;
+  SmallVector<const double *> operandData;
+  for (const Tensor &operand : operands) {
+    std::vector<double> &values = operandValues.emplace_back();
+    for (int64_t i = 0, e = operand.getNumElements(); i < e; ++i)
+      values.push_back(operand.getAt(i).getNativeFloatValue());
+  }
+  for (const std::vector<double> &values : operandValues)
+    operandData.push_back(values.data());
+  std::vector<double> resultValues(result.getNumElements());
+  fn(ArrayRef<const double *>(operandData), resultValues.data());
+
+  // Element objects round their values to the element type.
+  for (int64_t i = 0, e = result.getNumElements(); i < e; ++i)
+    result.setAt(i, Element(elementType, resultValues[i]));
+  return result;
+}
+
+// Philox key of `rng`.
+constexpr std::array<uint32_t, 2> kRngKey = {0x9E3779B9, 0x7F4A7C15};
+
+// Returns the Philox block for element `i` of an `rng` of the process
+// `processId` whose first element has counter `firstCounter`. Every process
+// has its own stream of blocks, since processes count from zero.
+std::array<uint32_t, 4> getRngBlock(uint64_t firstCounter, int64_t i,
+                                    ProcessId processId) {
+  uint64_t counter = firstCounter + i;
+  return native::philox4x32(
+      {static_cast<uint32_t>(counter), static_cast<uint32_t>(counter >> 32),
+       processId.replicaId, processId.partitionId},
+      kRngKey);
+}
+
+// Maps the 53 most significant bits of `bits` to a double in [0, 1).
+double toUnitInterval(uint64_t bits) { return (bits >> 11) * 0x1p-53; }
+
+// Comparators of `sort` which order the elements of the first input with a
+// single `compare`, see `getSortComparison`.
+struct SortComparison {
+  // Whether elements are sorted in descending rather than ascending order.
+  bool descending = false;
+
+  // Whether integer elements are compared as unsigned integers.
+  bool isUnsigned = false;
+
+  // Whether floating-point elements are compared with `TOTALORDER`, which
+  // orders -0.0 before +0.0 and NaNs after or before everything else, rather
+  // than as IEEE values.
+  bool totalOrder = false;
+};
+
+// Recognizes comparators of `sort` which consist of an `LT` or `GT` compare of
+// the two block arguments for the first input, in either order, whose result
+// is returned. Only integer, boolean and floating-point inputs are recognized.
+std::optional<SortComparison> getSortComparison(Region &comparator) {
+  Block &block = comparator.front();
+  if (block.getNumArguments() < 2 || block.getOperations().size() != 2)
+    return std::nullopt;
+  auto compareOp = dyn_cast<CompareOp>(block.front());
+  auto returnOp = dyn_cast<ReturnOp>(block.back());
+  if (!compareOp || !returnOp || returnOp->getNumOperands() != 1 ||
+      returnOp->getOperand(0) != compareOp.getResult())
+    return std::nullopt;
+
+  Value lhs = block.getArgument(0);
+  Value rhs = block.getArgument(1);
+  bool isSwapped = compareOp.getLhs() == rhs && compareOp.getRhs() == lhs;
+  if (!isSwapped && (compareOp.getLhs() != lhs || compareOp.getRhs() != rhs))
+    return std::nullopt;
+
+  SortComparison comparison;
+  switch (compareOp.getComparisonDirection()) {
+    case ComparisonDirection::LT:
+      comparison.descending = isSwapped;
+      break;
+    case ComparisonDirection::GT:
+      comparison.descending = !isSwapped;
+      break;
+    default:
+      return std::nullopt;
+  }
+
+  Type elementType = getElementTypeOrSelf(lhs.getType());
+  auto compareType = compareOp.getCompareType();
+  if (isSupportedIntegerType(elementType) ||
+      isSupportedBooleanType(elementType)) {
+    if (compareType == ComparisonType::FLOAT ||
+        compareType == ComparisonType::TOTALORDER)
+      return std::nullopt;
+    comparison.isUnsigned =
+        compareType ? *compareType == ComparisonType::UNSIGNED
+                    : !isSupportedSignedIntegerType(elementType);
+    return comparison;
+  }
+  if (isSupportedFloatType(elementType)) {
+    if (compareType == ComparisonType::SIGNED ||
+        compareType == ComparisonType::UNSIGNED)
+      return std::nullopt;
+    comparison.totalOrder = compareType == ComparisonType::TOTALORDER;
+    return comparison;
+  }
+  return std::nullopt;
+}
+
+// Keys which order elements like a `SortComparison`, see `getSortKeys`.
+struct SortKeys {
+  // Unsigned integers which are in ascending order iff the elements are in
+  // the order of the comparison.
+  SmallVector<uint64_t> values;
+
+  // Number of bits of `values` which can differ between elements.
+  int64_t numBits = 0;
+
+  // Flags floating-point NaNs, which compare false with everything unless the
+  // comparison uses `TOTALORDER`, and thus have no place in the order of
+  // `values`. Empty if there are no such NaNs.
+  SmallVector<bool> isNaN;
+};
+
+// Computes the sort keys of the elements of `tensor`, a contiguous tensor,
+// from their bit patterns: signed integers are offset by their minimum value,
+// and floating-point numbers are mapped to sign and magnitude order.
+SortKeys getSortKeys(const Tensor &tensor, const SortComparison &comparison) {
+  SortKeys keys;
+  Type elementType = tensor.getElementType();
+  dispatchStorageType(elementType, [&](auto tag) {
+    using T = decltype(tag);
+    if constexpr (std::is_integral_v<T>) {
+      keys.numBits = sizeof(T) * 8;
+      uint64_t signBit = uint64_t(1) << (keys.numBits - 1);
+      uint64_t mask = signBit | (signBit - 1);
+      uint64_t infinity = 0;
+      if (auto floatType = elementType.dyn_cast<FloatType>())
+        infinity = APFloat::getInf(floatType.getFloatSemantics())
+                       .bitcastToAPInt()
+                       .getZExtValue();
+
+      ArrayRef<T> data = tensor.getData<T>();
+      keys.values.resize(data.size());
+      for (auto [i, bits] : llvm::enumerate(data)) {
+        uint64_t key = bits;
+        if (infinity) {
+          if (!comparison.totalOrder) {
+            if ((key & ~signBit) > infinity) {
+              if (keys.isNaN.empty()) keys.isNaN.resize(data.size());
+              keys.isNaN[i] = true;
+            }
+            // -0.0 and +0.0 are equal.
+            if (key == signBit) key = 0;
+          }
+          key = key & signBit ? ~key & mask : key | signBit;
+        } else if (!comparison.isUnsigned) {
+          key ^= signBit;
+        }
+        keys.values[i] = comparison.descending ? ~key & mask : key;
+      }
+    }
+  });
+  return keys;
+}
+
+// Number of elements per row below which `sort` doesn't use `radixSort`.
+constexpr int64_t kMinRadixSortSize = 256;
+
+// Number of bits which `radixSort` sorts by in every pass.
+constexpr int64_t kRadixBits = 8;
+
+// Sorts `order`, which initially holds `0, ..., keys.size() - 1`, by the
+// corresponding `keys`, whose `numBits` least significant bits can differ,
+// stably. This is an LSD radix sort which skips passes for digits which are
+// the same for all keys.
+void radixSort(ArrayRef<uint64_t> keys, int64_t numBits,
+               MutableArrayRef<int64_t> order) {
+  constexpr int64_t kNumBuckets = 1 << kRadixBits;
+  int64_t size = keys.size();
+  int64_t numPasses = (numBits + kRadixBits - 1) / kRadixBits;
+  std::vector<std::array<int64_t, kNumBuckets>> counts(numPasses);
+  for (uint64_t key : keys)
+    for (int64_t pass = 0; pass < numPasses; ++pass)
+      ++counts[pass][(key >> (pass * kRadixBits)) & (kNumBuckets - 1)];
+
+  SmallVector<uint64_t> currentKeys(keys.begin(), keys.end());
+  SmallVector<uint64_t> nextKeys(size);
+  SmallVector<int64_t> currentOrder(order.begin(), order.end());
+  SmallVector<int64_t> nextOrder(size);
+  for (int64_t pass = 0; pass < numPasses; ++pass) {
+    int64_t shift = pass * kRadixBits;
+    auto &passCounts = counts[pass];
+    if (passCounts[(keys[0] >> shift) & (kNumBuckets - 1)] == size) continue;
+    int64_t position = 0;
+    for (int64_t &count : passCounts) {
+      int64_t bucketSize = count;
+      count = position;
+      position += bucketSize;
+    }
+    for (int64_t i = 0; i < size; ++i) {
+      int64_t target =
+          passCounts[(currentKeys[i] >> shift) & (kNumBuckets - 1)]++;
+      nextKeys[target] = currentKeys[i];
+      nextOrder[target] = currentOrder[i];
+    }
+    std::swap(currentKeys, nextKeys);
+    std::swap(currentOrder, nextOrder);
+  }
+  llvm::copy(currentOrder, order.begin());
+}
+
+// Number of elements which `mergeSort` sorts by insertion before it starts
+// merging.
+constexpr int64_t kInsertionSortSize = 16;
+
+// Sorts `order` stably, such that `order[j]` only moves before `order[i]`, for
+// `i < j`, if `less(order[j], order[i])`. Only the results of `less` decide
+// the order, so comparators which aren't strict weak orders, e.g. arbitrary
+// comparator regions, still give well-defined results.
+template <typename Less>
+void mergeSort(MutableArrayRef<int64_t> order, Less less) {
+  int64_t size = order.size();
+  for (int64_t begin = 0; begin < size; begin += kInsertionSortSize) {
+    int64_t end = std::min(begin + kInsertionSortSize, size);
+    for (int64_t i = begin + 1; i < end; ++i) {
+      int64_t element = order[i];
+      int64_t j = i;
+      for (; j > begin && less(element, order[j - 1]); --j)
+        order[j] = order[j - 1];
+      order[j] = element;
+    }
+  }
+
+  SmallVector<int64_t> buffer(size);
+  MutableArrayRef<int64_t> source = order;
+  MutableArrayRef<int64_t> dest = buffer;
+  for (int64_t width = kInsertionSortSize; width < size; width *= 2) {
+    for (int64_t begin = 0; begin < size; begin += 2 * width) {
+      int64_t middle = std::min(begin + width, size);
+      int64_t end = std::min(begin + 2 * width, size);
+      int64_t left = begin, right = middle, out = begin;
+      while (left < middle && right < end)
+        dest[out++] = less(source[right], source[left]) ? source[right++]
+                                                        : source[left++];
+      while (left < middle) dest[out++] = source[left++];
+      while (right < end) dest[out++] = source[right++];
+    }
+    std::swap(source, dest);
+  }
+  if (source.data() != order.data()) llvm::copy(source, order.begin());
+}
+
+// Returns the types of the results of `op`, which must all be tensors.
+SmallVector<TensorType> getResultTensorTypes(Operation &op) {
+  return llvm::to_vector(llvm::map_range(
+      op.getResultTypes(), [](Type type) { return type.cast<TensorType>(); }));
+}
+
+// Wraps `fn`, which evaluates an op with a single result given the runtime
+// values of its operands, into a kernel.
+template <typename Fn>
+Instruction::Kernel makeKernel(Fn fn) {
+  return [fn](MutableArrayRef<Tensor> operands,
+              Scope &) -> SmallVector<Tensor> { return {fn(operands)}; };
+}
+
+// Wraps `fn`, which evaluates an op with a single result given the runtime
+// values of its operands and the scope of the op, into a kernel.
+template <typename Fn>
+Instruction::Kernel makeScopedKernel(Fn fn) {
+  return [fn](MutableArrayRef<Tensor> operands,
+              Scope &scope) -> SmallVector<Tensor> {
+    return {fn(operands, scope)};
+  };
+}
+
+// Runtime values of constants, keyed by their value attribute. Constants are
+// decoded when their region is prepared, and ops with the same value share
+// one immutable runtime value, see `makeTensor`.
+using ConstantCache = llvm::DenseMap<Attribute, Tensor>;
+
+// Decodes `op` into a kernel. Returns null for ops which the interpreter
+// doesn't support.
+Instruction::Kernel prepareKernel(Operation &op, ConstantCache &constants) {
+  if (auto absOp = dyn_cast<AbsOp>(op))
+    return makeKernel([resultType = absOp.getType()](auto operands) {
+      return evalAbsOp(std::move(operands[0]), resultType);
+    });
+  if (auto addOp = dyn_cast<AddOp>(op))
+    return makeKernel([resultType = addOp.getType()](auto operands) {
+      return evalAddOp(std::move(operands[0]), std::move(operands[1]),
+                       resultType);
+    });
+  if (auto allGatherOp = dyn_cast<AllGatherOp>(op))
+    return makeScopedKernel(
+        [allGatherDim = static_cast<Axis>(allGatherOp.getAllGatherDim()),
+         replicaGroups = getIdGroups(allGatherOp.getReplicaGroups()),
+         channelId = getChannelId(allGatherOp),
+         useGlobalDeviceIds = allGatherOp.getUseGlobalDeviceIds(),
+         resultType = allGatherOp.getType()](auto operands, Scope &scope) {
+          return evalAllGatherOp(operands[0], allGatherDim, replicaGroups,
+                                 channelId, useGlobalDeviceIds,
+                                 getProcess(scope), resultType);
+        });
+  if (auto allReduceOp = dyn_cast<AllReduceOp>(op))
+    return makeScopedKernel(
+        [replicaGroups = getIdGroups(allReduceOp.getReplicaGroups()),
+         channelId = getChannelId(allReduceOp),
+         useGlobalDeviceIds = allReduceOp.getUseGlobalDeviceIds(),
+         computation = &allReduceOp.getComputation(),
+         resultType = allReduceOp.getType()](auto operands, Scope &scope) {
+          return evalAllReduceOp(operands[0], replicaGroups, channelId,
+                                 useGlobalDeviceIds, *computation,
+                                 getProcess(scope), scope, resultType);
+        });
+  if (auto allToAllOp = dyn_cast<AllToAllOp>(op))
+    return makeScopedKernel(
+        [splitDimension = static_cast<Axis>(allToAllOp.getSplitDimension()),
+         concatDimension = static_cast<Axis>(allToAllOp.getConcatDimension()),
+         splitCount = allToAllOp.getSplitCount(),
+         replicaGroups = getIdGroups(allToAllOp.getReplicaGroups()),
+         channelId = getChannelId(allToAllOp),
+         resultType = allToAllOp.getType()](auto operands, Scope &scope) {
+          return evalAllToAllOp(operands[0], splitDimension, concatDimension,
+                                splitCount, replicaGroups, channelId,
+                                getProcess(scope), resultType);
+        });
+  if (auto andOp = dyn_cast<AndOp>(op))
+    return makeKernel([resultType = andOp.getType()](auto operands) {
+      return evalAndOp(std::move(operands[0]), std::move(operands[1]),
+                       resultType);
+    });
+  if (auto atan2Op = dyn_cast<Atan2Op>(op))
+    return makeKernel([resultType = atan2Op.getType()](auto operands) {
+      return evalAtan2Op(std::move(operands[0]), std::move(operands[1]),
+                         resultType);
+    });
+  if (auto broadcastInDimOp = dyn_cast<BroadcastInDimOp>(op))
+    return makeKernel(
+        [broadcastDimensions = Axes(broadcastInDimOp.getBroadcastDimensions()),
+         resultType = broadcastInDimOp.getType()](auto operands) {
+          return evalBroadcastInDimOp(operands[0], broadcastDimensions,
+                                      resultType);
+        });
+  if (auto cbrtOp = dyn_cast<CbrtOp>(op))
+    return makeKernel([resultType = cbrtOp.getType()](auto operands) {
+      return evalCbrtOp(std::move(operands[0]), resultType);
+    });
+  if (auto ceilOp = dyn_cast<CeilOp>(op))
+    return makeKernel([resultType = ceilOp.getType()](auto operands) {
+      return evalCeilOp(std::move(operands[0]), resultType);
+    });
+  if (auto choleskyOp = dyn_cast<CholeskyOp>(op))
+    return makeKernel([lower = choleskyOp.getLower(),
+                       resultType = choleskyOp.getType()](auto operands) {
+      return evalCholeskyOp(operands[0], lower, resultType);
+    });
+  if (auto clampOp = dyn_cast<ClampOp>(op))
+    return makeKernel([resultType = clampOp.getType()](auto operands) {
+      return evalClampOp(std::move(operands[0]), std::move(operands[1]),
+                         std::move(operands[2]), resultType);
+    });
+  if (auto clzOp = dyn_cast<ClzOp>(op))
+    return makeKernel([resultType = clzOp.getType()](auto operands) {
+      return evalCountLeadingZerosOp(std::move(operands[0]), resultType);
+    });
+  if (auto collectivePermuteOp = dyn_cast<CollectivePermuteOp>(op))
+    return makeScopedKernel(
+        [sourceTargetPairs =
+             getIdGroups(collectivePermuteOp.getSourceTargetPairs()),
+         channelId = getChannelId(collectivePermuteOp),
+         resultType = collectivePermuteOp.getType()](auto operands,
+                                                     Scope &scope) {
+          return evalCollectivePermuteOp(operands[0], sourceTargetPairs,
+                                         channelId, getProcess(scope),
+                                         resultType);
+        });
+  if (auto compareOp = dyn_cast<CompareOp>(op))
+    return makeKernel(
+        [comparisonDirection = compareOp.getComparisonDirection(),
+         compareType = std::optional<ComparisonType>(
+             compareOp.getCompareType()),
+         resultType = compareOp.getType()](auto operands) {
+          return evalCompareOp(operands[0], operands[1], comparisonDirection,
+                               compareType, resultType);
+        });
+  if (auto concatenateOp = dyn_cast<ConcatenateOp>(op))
+    return makeKernel([dimension = concatenateOp.getDimension(),
+                       resultType = concatenateOp.getType()](auto operands) {
+      return evalConcatenateOp(operands, dimension, resultType);
+    });
+  if (auto constantOp = dyn_cast<ConstantOp>(op)) {
+    Tensor &value = constants[constantOp.getValue()];
+    if (!value) value = evalConstantOp(constantOp.getValue());
+    return makeKernel([value](auto) { return value; });
+  }
+  if (auto convertOp = dyn_cast<ConvertOp>(op))
+    return makeKernel([resultType = convertOp.getType()](auto operands) {
+      return evalConvertOp(operands[0], resultType);
+    });
+  if (auto convolutionOp = dyn_cast<ConvolutionOp>(op)) {
+    int64_t numSpatialDims = convolutionOp.getLhs().getType().getRank() - 2;
+    auto getSizes = [&](DenseIntElementsAttr attr, int64_t defaultValue) {
+      return attr ? Sizes(attr) : Sizes(numSpatialDims, defaultValue);
+    };
+    Sizes paddingLow(numSpatialDims, 0);
+    if (auto padding = convolutionOp.getPaddingAttr())
+      for (auto [i, value] : llvm::enumerate(padding.getValues<int64_t>()))
+        if (i % 2 == 0) paddingLow[i / 2] = value;
+    SmallVector<bool> windowReversal(numSpatialDims, false);
+    if (auto reversal = convolutionOp.getWindowReversalAttr())
+      windowReversal = llvm::to_vector(reversal.getValues<bool>());
+    auto dimensionNumbers = convolutionOp.getDimensionNumbers();
+    return makeKernel(
+        [windowStrides = getSizes(convolutionOp.getWindowStridesAttr(), 1),
+         paddingLow,
+         lhsDilation = getSizes(convolutionOp.getLhsDilationAttr(), 1),
+         rhsDilation = getSizes(convolutionOp.getRhsDilationAttr(), 1),
+         windowReversal,
+         inputBatchDimension = dimensionNumbers.getInputBatchDimension(),
+         inputFeatureDimension = dimensionNumbers.getInputFeatureDimension(),
+         inputSpatialDimensions =
+             Axes(dimensionNumbers.getInputSpatialDimensions()),
+         kernelInputFeatureDimension =
+             dimensionNumbers.getKernelInputFeatureDimension(),
+         kernelOutputFeatureDimension =
+             dimensionNumbers.getKernelOutputFeatureDimension(),
+         kernelSpatialDimensions =
+             Axes(dimensionNumbers.getKernelSpatialDimensions()),
+         outputBatchDimension = dimensionNumbers.getOutputBatchDimension(),
+         outputFeatureDimension = dimensionNumbers.getOutputFeatureDimension(),
+         outputSpatialDimensions =
+             Axes(dimensionNumbers.getOutputSpatialDimensions()),
+         featureGroupCount = convolutionOp.getFeatureGroupCount(),
+         batchGroupCount = convolutionOp.getBatchGroupCount(),
+         resultType = convolutionOp.getType()](auto operands) {
+          return evalConvolutionOp(
+              operands[0], operands[1], windowStrides, paddingLow, lhsDilation,
+              rhsDilation, windowReversal, inputBatchDimension,
+              inputFeatureDimension, inputSpatialDimensions,
+              kernelInputFeatureDimension, kernelOutputFeatureDimension,
+              kernelSpatialDimensions, outputBatchDimension,
+              outputFeatureDimension, outputSpatialDimensions,
+              featureGroupCount, batchGroupCount, resultType);
+        });
+  }
+  if (auto cosineOp = dyn_cast<CosineOp>(op))
+    return makeKernel([resultType = cosineOp.getType()](auto operands) {
+      return evalCosineOp(std::move(operands[0]), resultType);
+    });
+  if (auto divideOp = dyn_cast<DivOp>(op))
+    return makeKernel([resultType = divideOp.getType()](auto operands) {
+      return evalDivideOp(std::move(operands[0]), std::move(operands[1]),
+                          resultType);
+    });
+  if (auto dotGeneralOp = dyn_cast<DotGeneralOp>(op)) {
+    auto dimensionNumbers = dotGeneralOp.getDotDimensionNumbers();
+    return makeKernel(
+        [lhsBatchingDimensions =
+             Axes(dimensionNumbers.getLhsBatchingDimensions()),
+         rhsBatchingDimensions =
+             Axes(dimensionNumbers.getRhsBatchingDimensions()),
+         lhsContractingDimensions =
+             Axes(dimensionNumbers.getLhsContractingDimensions()),
+         rhsContractingDimensions =
+             Axes(dimensionNumbers.getRhsContractingDimensions()),
+         resultType = dotGeneralOp.getType()](auto operands) {
+          return evalDotGeneralOp(operands[0], operands[1],
+                                  lhsBatchingDimensions, rhsBatchingDimensions,
+                                  lhsContractingDimensions,
+                                  rhsContractingDimensions, resultType);
+        });
+  }
+  if (auto dynamicSliceOp = dyn_cast<DynamicSliceOp>(op))
+    return makeKernel([sliceSizes = Sizes(dynamicSliceOp.getSliceSizes()),
+                       resultType = dynamicSliceOp.getType()](auto operands) {
+      return evalDynamicSliceOp(operands[0], operands.drop_front(), sliceSizes,
+                                resultType);
+    });
+  if (auto dynamicUpdateSliceOp = dyn_cast<DynamicUpdateSliceOp>(op))
+    return makeKernel(
+        [resultType = dynamicUpdateSliceOp.getType()](auto operands) {
+          return evalDynamicUpdateSliceOp(operands[0], operands[1],
+                                          operands.drop_front(2), resultType);
+        });
+  if (auto expOp = dyn_cast<ExpOp>(op))
+    return makeKernel([resultType = expOp.getType()](auto operands) {
+      return evalExponentialOp(std::move(operands[0]), resultType);
+    });
+  if (auto expm1Op = dyn_cast<Expm1Op>(op))
+    return makeKernel([resultType = expm1Op.getType()](auto operands) {
+      return evalExponentialMinusOneOp(std::move(operands[0]), resultType);
+    });
+  if (auto fftOp = dyn_cast<FftOp>(op))
+    return makeKernel([fftType = fftOp.getFftType(),
+                       fftLength = Sizes(fftOp.getFftLength()),
+                       resultType = fftOp.getType()](auto operands) {
+      return evalFftOp(operands[0], fftType, fftLength, resultType);
+    });
+  if (auto floorOp = dyn_cast<FloorOp>(op))
+    return makeKernel([resultType = floorOp.getType()](auto operands) {
+      return evalFloorOp(std::move(operands[0]), resultType);
+    });
+  if (auto gatherOp = dyn_cast<GatherOp>(op)) {
+    auto dimensionNumbers = gatherOp.getDimensionNumbers();
+    return makeKernel(
+        [offsetDims = Axes(dimensionNumbers.getOffsetDims()),
+         collapsedSliceDims = Axes(dimensionNumbers.getCollapsedSliceDims()),
+         startIndexMap = Axes(dimensionNumbers.getStartIndexMap()),
+         indexVectorDim = dimensionNumbers.getIndexVectorDim(),
+         sliceSizes = Sizes(gatherOp.getSliceSizes()),
+         resultType = gatherOp.getType()](auto operands) {
+          return evalGatherOp(operands[0], operands[1], offsetDims,
+                              collapsedSliceDims, startIndexMap,
+                              indexVectorDim, sliceSizes, resultType);
+        });
+  }
+  if (auto ifOp = dyn_cast<IfOp>(op))
+    return [trueBranch = &ifOp.getTrueBranch(),
+            falseBranch = &ifOp.getFalseBranch()](
+               MutableArrayRef<Tensor> operands, Scope &scope) {
+      return evalIfOp(operands[0], *trueBranch, *falseBranch, scope);
+    };
+  if (auto imagOp = dyn_cast<ImagOp>(op))
+    return makeKernel([resultType = imagOp.getType()](auto operands) {
+      return evalImagOp(operands[0], resultType);
+    });
+  if (auto iotaOp = dyn_cast<IotaOp>(op))
+    return makeKernel([iotaDimension = iotaOp.getIotaDimension(),
+                       resultType = iotaOp.getType()](auto) {
+      return evalIotaOp(iotaDimension, resultType);
+    });
+  if (auto logOp = dyn_cast<LogOp>(op))
+    return makeKernel([resultType = logOp.getType()](auto operands) {
+      return evalLogOp(std::move(operands[0]), resultType);
+    });
+  if (auto log1pOp = dyn_cast<Log1pOp>(op))
+    return makeKernel([resultType = log1pOp.getType()](auto operands) {
+      return evalLogPlusOneOp(std::move(operands[0]), resultType);
+    });
+  if (auto logisticOp = dyn_cast<LogisticOp>(op))
+    return makeKernel([resultType = logisticOp.getType()](auto operands) {
+      return evalLogisticOp(std::move(operands[0]), resultType);
+    });
+  if (auto maxOp = dyn_cast<MaxOp>(op))
+    return makeKernel([resultType = maxOp.getType()](auto operands) {
+      return evalMaxOp(std::move(operands[0]), std::move(operands[1]),
+                       resultType);
+    });
+  if (auto minOp = dyn_cast<MinOp>(op))
+    return makeKernel([resultType = minOp.getType()](auto operands) {
+      return evalMinOp(std::move(operands[0]), std::move(operands[1]),
+                       resultType);
+    });
+  if (auto multiplyOp = dyn_cast<MulOp>(op))
+    return makeKernel([resultType = multiplyOp.getType()](auto operands) {
+      return evalMultiplyOp(std::move(operands[0]), std::move(operands[1]),
+                            resultType);
+    });
+  if (auto negOp = dyn_cast<NegOp>(op))
+    return makeKernel([resultType = negOp.getType()](auto operands) {
+      return evalNegOp(std::move(operands[0]), resultType);
+    });
+  if (auto notOp = dyn_cast<NotOp>(op))
+    return makeKernel([resultType = notOp.getType()](auto operands) {
+      return evalNotOp(std::move(operands[0]), resultType);
+    });
+  if (auto orOp = dyn_cast<OrOp>(op))
+    return makeKernel([resultType = orOp.getType()](auto operands) {
+      return evalOrOp(std::move(operands[0]), std::move(operands[1]),
+                      resultType);
+    });
+  if (auto padOp = dyn_cast<PadOp>(op))
+    return makeKernel([edgePaddingLow = Sizes(padOp.getEdgePaddingLow()),
+                       interiorPadding = Sizes(padOp.getInteriorPadding()),
+                       resultType = padOp.getType()](auto operands) {
+      return evalPadOp(operands[0], operands[1], edgePaddingLow,
+                       interiorPadding, resultType);
+    });
+  if (auto partitionIdOp = dyn_cast<PartitionIdOp>(op))
+    return makeScopedKernel([resultType = partitionIdOp.getType()](
+                                auto, Scope &scope) {
+      return evalPartitionIdOp(getProcess(scope), resultType);
+    });
+  if (auto popcntOp = dyn_cast<PopulationCountOp>(op))
+    return makeKernel([resultType = popcntOp.getType()](auto operands) {
+      return evalPopcntOp(std::move(operands[0]), resultType);
+    });
+  if (auto powerOp = dyn_cast<PowOp>(op))
+    return makeKernel([resultType = powerOp.getType()](auto operands) {
+      return evalPowerOp(std::move(operands[0]), std::move(operands[1]),
+                         resultType);
+    });
+  if (auto realOp = dyn_cast<RealOp>(op))
+    return makeKernel([resultType = realOp.getType()](auto operands) {
+      return evalRealOp(operands[0], resultType);
+    });
+  if (auto reduceOp = dyn_cast<ReduceOp>(op))
+    return [numInputs = reduceOp.getInputs().size(),
+            dimensions = Axes(reduceOp.getDimensions()),
+            body = &reduceOp.getBody(),
+            resultTypes = getResultTensorTypes(op)](
+               MutableArrayRef<Tensor> operands, Scope &scope) {
+      return evalReduceOp(operands.take_front(numInputs),
+                          operands.drop_front(numInputs), dimensions, *body,
+                          scope, resultTypes);
+    };
+  if (auto reduceScatterOp = dyn_cast<ReduceScatterOp>(op))
+    return makeScopedKernel(
+        [scatterDimension =
+             static_cast<Axis>(reduceScatterOp.getScatterDimension()),
+         replicaGroups = getIdGroups(reduceScatterOp.getReplicaGroups()),
+         channelId = getChannelId(reduceScatterOp),
+         useGlobalDeviceIds = reduceScatterOp.getUseGlobalDeviceIds(),
+         computation = &reduceScatterOp.getComputation(),
+         resultType = reduceScatterOp.getType()](auto operands,
+                                                 Scope &scope) {
+          return evalReduceScatterOp(operands[0], scatterDimension,
+                                     replicaGroups, channelId,
+                                     useGlobalDeviceIds, *computation,
+                                     getProcess(scope), scope, resultType);
+        });
+  if (auto reduceWindowOp = dyn_cast<ReduceWindowOp>(op)) {
+    int64_t rank =
+        reduceWindowOp.getInputs()[0].getType().cast<TensorType>().getRank();
+    auto getSizes = [&](DenseIntElementsAttr attr, int64_t defaultValue) {
+      return attr ? Sizes(attr) : Sizes(rank, defaultValue);
+    };
+    Sizes paddingLow(rank, 0);
+    Sizes paddingHigh(rank, 0);
+    if (auto padding = reduceWindowOp.getPaddingAttr()) {
+      for (auto [i, value] : llvm::enumerate(padding.getValues<int64_t>())) {
+        if (i % 2 == 0)
+          paddingLow[i / 2] = value;
+        else
+          paddingHigh[i / 2] = value;
+      }
+    }
+    return [numInputs = reduceWindowOp.getInputs().size(),
+            windowDimensions = Sizes(reduceWindowOp.getWindowDimensions()),
+            windowStrides = getSizes(reduceWindowOp.getWindowStridesAttr(), 1),
+            baseDilations = getSizes(reduceWindowOp.getBaseDilationsAttr(), 1),
+            windowDilations =
+                getSizes(reduceWindowOp.getWindowDilationsAttr(), 1),
+            paddingLow, paddingHigh, body = &reduceWindowOp.getBody(),
+            resultTypes = getResultTensorTypes(op)](
+               MutableArrayRef<Tensor> operands, Scope &scope) {
+      return evalReduceWindowOp(
+          operands.take_front(numInputs), operands.drop_front(numInputs),
+          windowDimensions, windowStrides, baseDilations, windowDilations,
+          paddingLow, paddingHigh, *body, scope, resultTypes);
+    };
+  }
+  if (auto remOp = dyn_cast<RemOp>(op))
+    return makeKernel([resultType = remOp.getType()](auto operands) {
+      return evalRemainderOp(std::move(operands[0]), std::move(operands[1]),
+                             resultType);
+    });
+  if (auto replicaIdOp = dyn_cast<ReplicaIdOp>(op))
+    return makeScopedKernel([resultType = replicaIdOp.getType()](
+                                auto, Scope &scope) {
+      return evalReplicaIdOp(getProcess(scope), resultType);
+    });
+  if (auto reshapeOp = dyn_cast<ReshapeOp>(op))
+    return makeKernel([resultType = reshapeOp.getType()](auto operands) {
+      return evalReshapeOp(operands[0], resultType);
+    });
+  if (auto reverseOp = dyn_cast<ReverseOp>(op))
+    return makeKernel([dimensions = Axes(reverseOp.getDimensions()),
+                       resultType = reverseOp.getType()](auto operands) {
+      return evalReverseOp(operands[0], dimensions, resultType);
+    });
+  if (auto rngBitGeneratorOp = dyn_cast<RngBitGeneratorOp>(op))
+    return [rngAlgorithm = rngBitGeneratorOp.getRngAlgorithm(),
+            outputStateType =
+                rngBitGeneratorOp.getOutputState().getType().cast<TensorType>(),
+            outputType =
+                rngBitGeneratorOp.getOutput().getType().cast<TensorType>()](
+               MutableArrayRef<Tensor> operands, Scope &) {
+      return evalRngBitGeneratorOp(rngAlgorithm, operands[0], outputStateType,
+                                   outputType);
+    };
+  if (auto rngOp = dyn_cast<RngOp>(op))
+    return makeScopedKernel([rngDistribution = rngOp.getRngDistribution(),
+                             resultType = rngOp.getType()](auto operands,
+                                                           Scope &scope) {
+      return evalRngOp(operands[0], operands[1], rngDistribution, scope,
+                       resultType);
+    });
+  if (auto rsqrtOp = dyn_cast<RsqrtOp>(op))
+    return makeKernel([resultType = rsqrtOp.getType()](auto operands) {
+      return evalRsqrtOp(std::move(operands[0]), resultType);
+    });
+  if (auto scatterOp = dyn_cast<ScatterOp>(op)) {
+    auto dimensionNumbers = scatterOp.getScatterDimensionNumbers();
+    return [numInputs = scatterOp.getInputs().size(),
+            updateWindowDims = Axes(dimensionNumbers.getUpdateWindowDims()),
+            insertedWindowDims = Axes(dimensionNumbers.getInsertedWindowDims()),
+            scatterDimsToOperandDims =
+                Axes(dimensionNumbers.getScatterDimsToOperandDims()),
+            indexVectorDim = dimensionNumbers.getIndexVectorDim(),
+            updateComputation = &scatterOp.getUpdateComputation(),
+            resultTypes = getResultTensorTypes(op)](
+               MutableArrayRef<Tensor> operands, Scope &scope) {
+      return evalScatterOp(operands.take_front(numInputs), operands[numInputs],
+                           operands.drop_front(numInputs + 1),
+                           updateWindowDims, insertedWindowDims,
+                           scatterDimsToOperandDims, indexVectorDim,
+                           *updateComputation, scope, resultTypes);
+    };
+  }
+  if (auto selectOp = dyn_cast<SelectOp>(op))
+    return makeKernel([resultType = selectOp.getType()](auto operands) {
+      return evalSelectOp(operands[0], std::move(operands[1]),
+                          std::move(operands[2]), resultType);
+    });
+  if (auto shiftLeftOp = dyn_cast<ShiftLeftOp>(op))
+    return makeKernel([resultType = shiftLeftOp.getType()](auto operands) {
+      return evalShiftLeftOp(std::move(operands[0]), std::move(operands[1]),
+                             resultType);
+    });
+  if (auto shiftRightArithmeticOp = dyn_cast<ShiftRightArithmeticOp>(op))
+    return makeKernel(
+        [resultType = shiftRightArithmeticOp.getType()](auto operands) {
+          return evalShiftRightArithmeticOp(std::move(operands[0]),
+                                            std::move(operands[1]), resultType);
+        });
+  if (auto shiftRightLogicalOp = dyn_cast<ShiftRightLogicalOp>(op))
+    return makeKernel(
+        [resultType = shiftRightLogicalOp.getType()](auto operands) {
+          return evalShiftRightLogicalOp(std::move(operands[0]),
+                                         std::move(operands[1]), resultType);
+        });
+  if (auto signOp = dyn_cast<SignOp>(op))
+    return makeKernel([resultType = signOp.getType()](auto operands) {
+      return evalSignOp(std::move(operands[0]), resultType);
+    });
+  if (auto sineOp = dyn_cast<SineOp>(op))
+    return makeKernel([resultType = sineOp.getType()](auto operands) {
+      return evalSineOp(std::move(operands[0]), resultType);
+    });
+  if (auto sliceOp = dyn_cast<SliceOp>(op))
+    return makeKernel([startIndices = Sizes(sliceOp.getStartIndices()),
+                       strides = Sizes(sliceOp.getStrides()),
+                       resultType = sliceOp.getType()](auto operands) {
+      return evalSliceOp(operands[0], startIndices, strides, resultType);
+    });
+  if (auto sortOp = dyn_cast<SortOp>(op))
+    return [dimension = static_cast<Axis>(sortOp.getDimension()),
+            comparator = &sortOp.getComparator(),
+            resultTypes = getResultTensorTypes(op)](
+               MutableArrayRef<Tensor> operands, Scope &scope) {
+      return evalSortOp(operands, dimension, *comparator, scope, resultTypes);
+    };
+  if (auto sqrtOp = dyn_cast<SqrtOp>(op))
+    return makeKernel([resultType = sqrtOp.getType()](auto operands) {
+      return evalSqrtOp(std::move(operands[0]), resultType);
+    });
+  if (auto subtractOp = dyn_cast<SubtractOp>(op))
+    return makeKernel([resultType = subtractOp.getType()](auto operands) {
+      return evalSubtractOp(std::move(operands[0]), std::move(operands[1]),
+                            resultType);
+    });
+  if (auto tanhOp = dyn_cast<TanhOp>(op))
+    return makeKernel([resultType = tanhOp.getType()](auto operands) {
+      return evalTanhOp(std::move(operands[0]), resultType);
+    });
+  if (auto transposeOp = dyn_cast<TransposeOp>(op))
+    return makeKernel([permutation = Axes(transposeOp.getPermutation()),
+                       resultType = transposeOp.getType()](auto operands) {
+      return evalTransposeOp(operands[0], permutation, resultType);
+    });
+  if (auto triangularSolveOp = dyn_cast<TriangularSolveOp>(op))
+    return makeKernel([leftSide = triangularSolveOp.getLeftSide(),
+                       lower = triangularSolveOp.getLower(),
+                       unitDiagonal = triangularSolveOp.getUnitDiagonal(),
+                       transposeA = triangularSolveOp.getTransposeA(),
+                       resultType = triangularSolveOp.getType()](
+                          auto operands) {
+      return evalTriangularSolveOp(operands[0], operands[1], leftSide, lower,
+                                   unitDiagonal, transposeA, resultType);
+    });
+  if (auto whileOp = dyn_cast<WhileOp>(op))
+    return [cond = &whileOp.getCond(), body = &whileOp.getBody()](
+               MutableArrayRef<Tensor> operands, Scope &scope) {
+      return evalWhileOp(operands, *cond, *body, scope);
+    };
+  if (auto xorOp = dyn_cast<XorOp>(op))
+    return makeKernel([resultType = xorOp.getType()](auto operands) {
+      return evalXorOp(std::move(operands[0]), std::move(operands[1]),
+                       resultType);
+    });
+  return nullptr;
+}
+
+// Lowers `region` into a flat array of instructions, see `PreparedRegion`.
+// `parent` is the prepared form of the enclosing region if `region` is
+// prepared together with it, and null otherwise. `constants` holds the
+// constants decoded so far.
+std::unique_ptr<PreparedRegion> prepareRegion(Region &region,
+                                              const PreparedRegion *parent,
+                                              ConstantCache &constants) {
+  auto prepared = std::make_unique<PreparedRegion>();
+  Block &block = region.front();
+  prepared->block = &block;
+
+  auto &slots = prepared->slots;
+  auto &numUsers = prepared->numUsers;
+  // For each slot, the instruction which defines it, or -1 for block
+  // arguments, captures and results of hoisted instructions, and whether the
+  // slot holds the same runtime value whenever the region is evaluated for
+  // the same parent scope.
+  SmallVector<int64_t> definingInstructions;
+  SmallVector<bool> invariantSlots;
+  auto addSlot = [&](Value value, int64_t definingInstruction,
+                     bool isInvariant) {
+    int64_t slot = slots.size();
+    slots[value] = slot;
+    numUsers.push_back(0);
+    definingInstructions.push_back(definingInstruction);
+    invariantSlots.push_back(isInvariant);
+    return slot;
+  };
+  auto getSlot = [&](Value value) {
+    auto it = slots.find(value);
+    if (it != slots.end()) return it->second;
+    int64_t slot = addSlot(value, -1, /*isInvariant=*/true);
+    int64_t parentSlot = -1;
+    if (parent) {
+      auto parentIt = parent->slots.find(value);
+      if (parentIt != parent->slots.end()) parentSlot = parentIt->second;
+    }
+    prepared->captures.push_back({value, slot, parentSlot});
+    return slot;
+  };
+  auto isInvariant = [&](Value value) {
+    return value.getParentBlock() != &block ||
+           invariantSlots[slots.lookup(value)];
+  };
+
+  for (BlockArgument arg : block.getArguments())
+    addSlot(arg, -1, /*isInvariant=*/false);
+
+  // The regions of while loops are evaluated many times for the same parent
+  // scope, so ops which only depend on captures, e.g. constants, are hoisted
+  // out of the loop. Ops with regions aren't hoisted, and neither are ops
+  // with side effects, e.g. collective ops, which have to take part in every
+  // rendezvous.
+  bool isLoopRegion = isa_and_nonnull<WhileOp>(region.getParentOp());
+
+  auto &instructions = prepared->instructions;
+  int64_t lastSideEffectingInstruction = -1;
+  for (Operation &op : block) {
+    bool isTerminator = isa<func::ReturnOp, ReturnOp>(op);
+    Instruction::Kernel kernel =
+        isTerminator ? nullptr : prepareKernel(op, constants);
+    if (isLoopRegion && kernel && op.getNumRegions() == 0 &&
+        isMemoryEffectFree(&op) &&
+        llvm::all_of(op.getOperands(), isInvariant)) {
+      Instruction &instruction = prepared->hoistedInstructions.emplace_back();
+      instruction.op = &op;
+      instruction.kernel = std::move(kernel);
+      for (Value operand : op.getOperands())
+        instruction.operandSlots.push_back(getSlot(operand));
+      for (Value result : op.getResults())
+        instruction.resultSlots.push_back(
+            addSlot(result, -1, /*isInvariant=*/true));
+      continue;
+    }
+
+    int64_t index = instructions.size();
+    Instruction &instruction = instructions.emplace_back();
+    instruction.op = &op;
+    instruction.isTerminator = isTerminator;
+    instruction.kernel = std::move(kernel);
+
+    // Operands can be moved into kernels at their last use, unless nested
+    // regions may still look them up in the scope. Operands used more than
+    // once by the op are always copied.
+    bool canMove = instruction.kernel || instruction.isTerminator;
+    for (Value operand : op.getOperands()) {
+      bool isUsedInRegions = llvm::any_of(operand.getUsers(), [&](auto user) {
+        return user != &op && op.isAncestor(user);
+      });
+      instruction.operandSlots.push_back(getSlot(operand));
+      instruction.movableOperands.push_back(
+          canMove && !isUsedInRegions &&
+          llvm::count(op.getOperands(), operand) == 1);
+    }
+
+    // Uses within nested regions count as uses by `op`, because the nested
+    // regions fetch these values from the slots while `op` runs. Values from
+    // further out which nested regions use are captured. Like captures,
+    // results of hoisted instructions are never released.
+    auto &usedSlots = instruction.usedSlots;
+    op.walk([&](Operation *user) {
+      for (Value operand : user->getOperands()) {
+        if (operand.getParentBlock() == &block) {
+          int64_t slot = slots.lookup(operand);
+          if (!invariantSlots[slot]) usedSlots.push_back(slot);
+        } else if (!region.isAncestor(operand.getParentRegion())) {
+          getSlot(operand);
+        }
+      }
+    });
+    llvm::sort(usedSlots);
+    usedSlots.erase(std::unique(usedSlots.begin(), usedSlots.end()),
+                    usedSlots.end());
+
+    SmallVector<int64_t> predecessors;
+    for (int64_t slot : usedSlots) {
+      ++numUsers[slot];
+      if (definingInstructions[slot] >= 0)
+        predecessors.push_back(definingInstructions[slot]);
+    }
+    // Ops with side effects keep their relative order, e.g. `rng` ops
+    // advance the same generator, and so do ops evaluated by the fallback,
+    // e.g. check ops, which report errors.
+    if (!instruction.isTerminator &&
+        (!instruction.kernel || !isMemoryEffectFree(&op))) {
+      if (lastSideEffectingInstruction >= 0)
+        predecessors.push_back(lastSideEffectingInstruction);
+      lastSideEffectingInstruction = index;
+    }
+    llvm::sort(predecessors);
+    predecessors.erase(std::unique(predecessors.begin(), predecessors.end()),
+                       predecessors.end());
+    if (!instruction.isTerminator) {
+      instruction.numPredecessors = predecessors.size();
+      for (int64_t predecessor : predecessors)
+        instructions[predecessor].successors.push_back(index);
+    }
+
+    for (Value result : op.getResults())
+      instruction.resultSlots.push_back(
+          addSlot(result, index, /*isInvariant=*/false));
+  }
+
+  // Nested regions are prepared once all captures of this region have slots.
+  for (Operation &op : block)
+    for (Region &nested : op.getRegions())
+      if (!nested.empty())
+        prepared->regions[&nested] =
+            prepareRegion(nested, prepared.get(), constants);
+  return prepared;
+}
+
+// Fetches the operands of `instruction` from `slots`. `numUsers` holds the
+// number of remaining users of each slot, see `PreparedRegion::numUsers`.
+// Operands whose only remaining user is `instruction` are moved.
+template <typename Counter>
+SmallVector<Tensor> fetchOperands(const Instruction &instruction,
+                                  MutableArrayRef<Tensor> slots,
+                                  MutableArrayRef<Counter> numUsers) {
+  SmallVector<Tensor> operands;
+  for (auto [slot, movable] :
+       llvm::zip(instruction.operandSlots, instruction.movableOperands))
+    operands.push_back(movable && numUsers[slot] == 1 ? std::move(slots[slot])
+                                                      : slots[slot]);
+  return operands;
+}
+
+// Fetches the operands of `terminator` from `slots` like `fetchOperands`,
+// and releases the runtime values which remain in the slots it uses.
+template <typename Counter>
+SmallVector<Tensor> fetchResults(const Instruction &terminator,
+                                 MutableArrayRef<Tensor> slots,
+                                 MutableArrayRef<Counter> numUsers) {
+  SmallVector<Tensor> results = fetchOperands(terminator, slots, numUsers);
+  for (int64_t slot : terminator.usedSlots) slots[slot] = Tensor();
+  return results;
+}
+
+// Evaluates `instruction`, which is not a terminator, and stores its results
+// in `slots`. Afterwards, releases the runtime values which have no users
+// left. `Counter` is `std::atomic<int64_t>` if instructions are evaluated
+// concurrently.
+template <typename Counter>
+void evalInstruction(
+    const Instruction &instruction, Scope &scope,
+    MutableArrayRef<Tensor> slots, MutableArrayRef<Counter> numUsers,
+    llvm::function_ref<llvm::Error(Operation &, Scope &)> fallback) {
+  if (instruction.kernel) {
+    SmallVector<Tensor> operands =
+        fetchOperands(instruction, slots, numUsers);
+    SmallVector<Tensor> results = instruction.kernel(operands, scope);
+    for (auto [slot, result] : llvm::zip(instruction.resultSlots, results))
+      slots[slot] = std::move(result);
+  } else {
+    if (!fallback)
+      report_fatal_error(invalidArgument("Unsupported op: %s",
+                                         debugString(*instruction.op).c_str()));
+    auto status = fallback(*instruction.op, scope);
+    if (status) llvm::report_fatal_error(std::move(status));
+  }
+
+  for (int64_t slot : instruction.usedSlots)
+    if (--numUsers[slot] == 0) slots[slot] = Tensor();
+  for (int64_t slot : instruction.resultSlots)
+    if (numUsers[slot] == 0) slots[slot] = Tensor();
+}
+
+// Evaluates the instructions of `prepared` in parallel, running each one as
+// soon as the instructions it depends on are done. Returns the runtime values
+// of the operands of the terminator.
+SmallVector<Tensor> evalInstructionsInParallel(
+    const PreparedRegion &prepared, Scope &scope,
+    llvm::function_ref<llvm::Error(Operation &, Scope &)> fallback) {
+  const auto &instructions = prepared.instructions;
+  MutableArrayRef<Tensor> slots = scope.getSlots();
+  std::vector<std::atomic<int64_t>> numUsers(prepared.numUsers.size());
+  for (auto [counter, initialValue] : llvm::zip(numUsers, prepared.numUsers))
+    counter = initialValue;
+  std::vector<std::atomic<int64_t>> numPendingPredecessors(instructions.size());
+  for (auto [counter, instruction] :
+       llvm::zip(numPendingPredecessors, instructions))
+    counter = instruction.numPredecessors;
+
+  TaskGroup group;
+  std::function<void(int64_t)> run = [&](int64_t index) {
+    const Instruction &instruction = instructions[index];
+    evalInstruction<std::atomic<int64_t>>(instruction, scope, slots, numUsers,
+                                          fallback);
+    for (int64_t successor : instruction.successors)
+      if (--numPendingPredecessors[successor] == 0)
+        group.async([&run, successor] { run(successor); });
+  };
+  for (auto [index, instruction] : llvm::enumerate(instructions))
+    if (!instruction.isTerminator && instruction.numPredecessors == 0)
+      group.async([&run, index = index] { run(index); });
+  group.wait();
+
+  const Instruction &terminator = instructions.back();
+  if (!terminator.isTerminator)
+    llvm::report_fatal_error("Expected a terminator when evaluating a region");
+  return fetchResults<std::atomic<int64_t>>(terminator, slots, numUsers);
+}
+
+// Returns the prepared form of `region`, which is evaluated by a child scope
+// of `parent`.
+const PreparedRegion &getPreparedRegion(Region &region, Scope &parent) {
+  if (const PreparedRegion *enclosing = parent.getRegion()) {
+    auto it = enclosing->regions.find(&region);
+    if (it != enclosing->regions.end()) return *it->second;
+  }
+  return parent.getPreparedRegion(region, [](Region &region) {
+    ConstantCache constants;
+    return prepareRegion(region, /*parent=*/nullptr, constants);
+  });
+}
+
+// Fills the slots of `scope`, which evaluates `prepared` for `parent`, that
+// hold the same runtime values whenever `prepared` is evaluated for `parent`:
+// the captures and the results of the hoisted instructions.
+void initializeSlots(const PreparedRegion &prepared, Scope &scope,
+                     Scope &parent) {
+  MutableArrayRef<Tensor> slots = scope.getSlots();
+  for (const Capture &capture : prepared.captures)
+    slots[capture.slot] = capture.parentSlot >= 0
+                              ? parent.getSlots()[capture.parentSlot]
+                              : parent.find(capture.value);
+  for (const Instruction &instruction : prepared.hoistedInstructions) {
+    SmallVector<Tensor> operands;
+    for (int64_t slot : instruction.operandSlots)
+      operands.push_back(slots[slot]);
+    SmallVector<Tensor> results = instruction.kernel(operands, scope);
+    for (auto [slot, result] : llvm::zip(instruction.resultSlots, results))
+      slots[slot] = std::move(result);
+  }
+}
+
+// Evaluates the instructions of `prepared` in `scope`, whose slots hold the
+// runtime values of the used block arguments, the captures and the results
+// of the hoisted instructions. Returns the runtime values of the operands of
+// the terminator. All other runtime values are released by then, so `scope`
+// can evaluate `prepared` again given new block arguments.
+SmallVector<Tensor> evalInstructions(
+    const PreparedRegion &prepared, Scope &scope,
+    llvm::function_ref<llvm::Error(Operation &, Scope &)> fallback) {
+  // Independent ops can only run concurrently if the MLIRContext is
+  // thread-safe, since kernels may create types. Processes of a process
+  // grid evaluate their ops one after the other, since collective ops block
+  // until the other processes of their group arrive, which could starve the
+  // thread pool, and since rendezvous are matched in program order.
+  Process *process = scope.getProcess();
+  if (isInterOpParallelismEnabled() && getNumThreads() > 1 &&
+      prepared.block->getParent()->getContext()->isMultithreadingEnabled() &&
+      !(process && process->getGrid().getNumProcesses() > 1))
+    return evalInstructionsInParallel(prepared, scope, fallback);
+
+  // Runtime values are released after their last use, so that their storage
+  // is freed, or reused by the results of elementwise ops, as soon as
+  // possible.
+  MutableArrayRef<Tensor> slots = scope.getSlots();
+  SmallVector<int64_t> numUsers(prepared.numUsers);
+  for (const Instruction &instruction : prepared.instructions) {
+    if (instruction.isTerminator)
+      return fetchResults<int64_t>(instruction, slots, numUsers);
+    evalInstruction<int64_t>(instruction, scope, slots, numUsers, fallback);
+  }
+
+  llvm::report_fatal_error("Expected a terminator when evaluating a region");
+}
+
+// Checks that `prepared` takes `numArgs` block arguments.
+void checkNumArguments(const PreparedRegion &prepared, size_t numArgs) {
+  if (prepared.block->getArguments().size() != numArgs)
+    report_fatal_error(invalidArgument(
+        "Expected same number of block arguments and runtime arguments (%d)",
+        numArgs));
+}
+
+}  // namespace
+
+Tensor evalAbsOp(Tensor operand, TensorType resultType) {
+  Tensor result = reuseOrAllocate(resultType, operand);
+  if (mapNative<kNativeInteger | kNativeFloat>(operand, result, [](auto x) {
+        return native::abs(x);
+      }))
+    return result;
+  for (int64_t i = 0, e = result.getNumElements(); i < e; ++i)
+    result.setAt(i, abs(operand.getAt(i)));
+  return result;
+}
+
+Tensor evalAddOp(Tensor lhs, Tensor rhs, TensorType resultType) {
+  Tensor result = reuseOrAllocate(resultType, lhs, rhs);
+  if (mapNative<kNativeAll>(lhs, rhs, result, [](auto x, auto y) {
+        return native::add(x, y);
+      }))
+    return result;
+  for (int64_t i = 0, e = result.getNumElements(); i < e; ++i)
+    result.setAt(i, lhs.getAt(i) + rhs.getAt(i));
   return result;
 }
 
-Tensor evalAndOp(const Tensor &lhs, const Tensor &rhs, TensorType resultType) {
+Tensor evalAllGatherOp(const Tensor &operand, Axis allGatherDim,
+                       ArrayRef<SmallVector<uint32_t>> replicaGroups,
+                       int64_t channelId, bool useGlobalDeviceIds,
+                       Process &process, TensorType resultType) {
+  ProcessGroup processGroup =
+      getProcessGroup(process, replicaGroups, channelId, useGlobalDeviceIds);
+  SmallVector<Tensor> operands = process.rendezvous(processGroup, operand);
+  return evalConcatenateOp(operands, allGatherDim, resultType);
+}
+
+Tensor evalAllReduceOp(const Tensor &operand,
+                       ArrayRef<SmallVector<uint32_t>> replicaGroups,
+                       int64_t channelId, bool useGlobalDeviceIds,
+                       Region &computation, Process &process, Scope &scope,
+                       TensorType resultType) {
+  ProcessGroup processGroup =
+      getProcessGroup(process, replicaGroups, channelId, useGlobalDeviceIds);
+  SmallVector<Tensor> operands =
+      process.rendezvous(processGroup, operand.materialize());
+
+  // Like in a ring all-reduce, the work is split between the processes of
+  // the group: every process reduces one part of the elements of all
+  // operands, and then gathers the parts reduced by the other processes.
+  // Every part is reduced in the order of the group, so all processes get
+  // the same result.
+  int64_t numElements = operand.getNumElements();
+  int64_t numParts = processGroup.size();
+  auto getPart = [&](const Tensor &tensor, int64_t part) {
+    int64_t begin = numElements * part / numParts;
+    int64_t end = numElements * (part + 1) / numParts;
+    return Tensor(
+        RankedTensorType::get({end - begin}, resultType.getElementType()),
+        tensor, tensor.getOffset() + begin, Sizes({1}));
+  };
+  int64_t index = getProcessIndex(processGroup, process);
+  SmallVector<Tensor> operandParts;
+  for (const auto &value : operands)
+    operandParts.push_back(getPart(value, index));
+  SmallVector<Tensor> reducedParts = process.rendezvous(
+      processGroup, reduceValues(operandParts, computation, scope));
+
   Tensor result(resultType);
-  for (auto it = lhs.index_begin(); it != lhs.index_end(); ++it)
-    result.set(*it, lhs.get(*it) & rhs.get(*it));
+  for (auto [part, reducedPart] : llvm::enumerate(reducedParts))
+    getPart(result, part).copyFrom(reducedPart);
+  return result;
+}
+
+Tensor evalAllToAllOp(const Tensor &operand, Axis splitDimension,
+                      Axis concatDimension, int64_t splitCount,
+                      ArrayRef<SmallVector<uint32_t>> replicaGroups,
+                      int64_t channelId, Process &process,
+                      TensorType resultType) {
+  ProcessGroup processGroup =
+      getProcessGroup(process, replicaGroups, channelId);
+  if (static_cast<int64_t>(processGroup.size()) != splitCount)
+    report_fatal_error(invalidArgument(
+        "Expected process groups of size split_count (%d), but got %d",
+        splitCount, processGroup.size()));
+  SmallVector<Tensor> operands = process.rendezvous(processGroup, operand);
+
+  // Every process receives the part of every operand at its own position in
+  // the group.
+  Sizes partShape = operand.getShape();
+  partShape[splitDimension] /= splitCount;
+  auto partType = RankedTensorType::get(partShape, operand.getElementType());
+  Index startIndices(operand.getRank(), 0);
+  startIndices[splitDimension] =
+      getProcessIndex(processGroup, process) * partShape[splitDimension];
+  Sizes strides(operand.getRank(), 1);
+  SmallVector<Tensor> scatteredParts;
+  for (const auto &value : operands)
+    scatteredParts.push_back(
+        evalSliceOp(value, startIndices, strides, partType));
+  return evalConcatenateOp(scatteredParts, concatDimension, resultType);
+}
+
+Tensor evalAndOp(Tensor lhs, Tensor rhs, TensorType resultType) {
+  Tensor result = reuseOrAllocate(resultType, lhs, rhs);
+  if (mapNative<kNativeIntegral>(lhs, rhs, result, [](auto x, auto y) {
+        return native::bitwiseAnd(x, y);
+      }))
+    return result;
+  for (int64_t i = 0, e = lhs.getNumElements(); i < e; ++i)
+    result.setAt(i, lhs.getAt(i) & rhs.getAt(i));
+  return result;
+}
+
+Tensor evalAtan2Op(Tensor lhs, Tensor rhs, TensorType resultType) {
+  Tensor result = reuseOrAllocate(resultType, lhs, rhs);
+  if (mapNative<kNativeFloatOrComplex>(lhs, rhs, result, [](auto x, auto y) {
+        return native::atan2(x, y);
+      }))
+    return result;
+  for (int64_t i = 0, e = result.getNumElements(); i < e; ++i)
+    result.setAt(i, atan2(lhs.getAt(i), rhs.getAt(i)));
   return result;
 }
 
 Tensor evalBroadcastInDimOp(const Tensor &operand, Axes broadcastDimensions,
                             TensorType resultType) {
-  Tensor result(resultType);
+  // The result is a view of `operand` which repeats its elements along the
+  // broadcasted dimensions by using strides of zero.
   auto operandShape = operand.getShape();
-  for (auto resultIt = result.index_begin(); resultIt != result.index_end();
-       ++resultIt) {
-    Index operandIdx(operandShape.size());
-    for (auto [operandDim, resultDim] : llvm::enumerate(broadcastDimensions))
-      operandIdx[operandDim] =
-          operandShape[operandDim] == 1 ? 0 : (*resultIt)[resultDim];
-    result.set(*resultIt, operand.get(operandIdx));
+  auto operandStrides = operand.getStrides();
+  Sizes resultStrides(resultType.getRank(), 0);
+  for (auto [operandDim, resultDim] : llvm::enumerate(broadcastDimensions))
+    if (operandShape[operandDim] != 1)
+      resultStrides[resultDim] = operandStrides[operandDim];
+  return Tensor(resultType, operand, operand.getOffset(), resultStrides);
+}
+
+Tensor evalCbrtOp(Tensor operand, TensorType resultType) {
+  Tensor result = reuseOrAllocate(resultType, operand);
+  if (mapNative<kNativeFloatOrComplex>(operand, result, [](auto x) {
+        return native::cbrt(x);
+      }))
+    return result;
+  for (int64_t i = 0, e = result.getNumElements(); i < e; ++i)
+    result.setAt(i, cbrt(operand.getAt(i)));
+  return result;
+}
+
+Tensor evalCeilOp(Tensor operand, TensorType resultType) {
+  Tensor result = reuseOrAllocate(resultType, operand);
+  if (mapNative<kNativeFloat>(operand, result, [](auto x) {
+        return std::ceil(x);
+      }))
+    return result;
+  for (int64_t i = 0, e = result.getNumElements(); i < e; ++i)
+    result.setAt(i, ceil(operand.getAt(i)));
+  return result;
+}
+
+Tensor evalCholeskyOp(const Tensor &a, bool lower, TensorType resultType) {
+  int64_t n = a.getShape().back();
+  int64_t batchSize = n == 0 ? 0 : a.getNumElements() / (n * n);
+  return evalInNativePrecision(
+      {a}, resultType, [&](auto operands, auto *result) {
+        native::cholesky(batchSize, n, lower, operands[0], result);
+      });
+}
+
+Tensor evalClampOp(Tensor min, Tensor operand, Tensor max,
+                   TensorType resultType) {
+  Tensor result = reuseOrAllocate(resultType, min, operand, max);
+  Type elementType = resultType.getElementType();
+  if (operand.getType() == resultType &&
+      dispatchNativeType<kNativeAll>(elementType, [&](auto tag) {
+        using T = decltype(tag);
+        // `min` and `max` are either scalars or have the same shape as
+        // `operand`, in which case they are indexed in lockstep.
+        Tensor contiguousMin = min.materialize();
+        Tensor contiguousOperand = operand.materialize();
+        Tensor contiguousMax = max.materialize();
+        const T *minData = contiguousMin.getData<T>().data();
+        const T *operandData = contiguousOperand.getData<T>().data();
+        const T *maxData = contiguousMax.getData<T>().data();
+        T *resultData = result.getMutableData<T>().data();
+        int64_t minStride = min.getRank() != 0 ? 1 : 0;
+        int64_t maxStride = max.getRank() != 0 ? 1 : 0;
+        parallelFor(result.getNumElements(), kDefaultGrainSize,
+                    [&](int64_t begin, int64_t end) {
+                      for (int64_t i = begin; i < end; ++i)
+                        resultData[i] = native::min(
+                            native::max(operandData[i], minData[i * minStride]),
+                            maxData[i * maxStride]);
+                    });
+      }))
+    return result;
+  for (int64_t i = 0, e = result.getNumElements(); i < e; ++i) {
+    Element minElement = min.getRank() != 0 ? min.getAt(i) : min.get({});
+    Element maxElement = max.getRank() != 0 ? max.getAt(i) : max.get({});
+    result.setAt(i, stablehlo::min(stablehlo::max(operand.getAt(i), minElement),
+                                   maxElement));
   }
   return result;
 }
 
-Tensor evalCeilOp(const Tensor &operand, TensorType resultType) {
+Tensor evalCollectivePermuteOp(
+    const Tensor &operand, ArrayRef<SmallVector<uint32_t>> sourceTargetPairs,
+    int64_t channelId, Process &process, TensorType resultType) {
+  // All processes of the partition, or of the replica if `channelId` is
+  // positive, meet at the rendezvous, including processes which neither send
+  // nor receive, so that every process takes part in the same rendezvous.
+  ProcessGroup processGroup = getProcessGroup(process, {}, channelId);
+  SmallVector<Tensor> operands = process.rendezvous(processGroup, operand);
+
+  ProcessId processId = process.getId();
+  uint32_t id = channelId <= 0 ? processId.replicaId : processId.partitionId;
+  for (const auto &sourceTargetPair : sourceTargetPairs) {
+    if (sourceTargetPair[1] != id) continue;
+    if (sourceTargetPair[0] >= operands.size())
+      report_fatal_error(invalidArgument(
+          "Expected source_target_pairs to be less than %d, but got %d",
+          operands.size(), sourceTargetPair[0]));
+    return operands[sourceTargetPair[0]];
+  }
+
   Tensor result(resultType);
-  for (auto it = result.index_begin(); it != result.index_end(); ++it)
-    result.set(*it, ceil(operand.get(*it)));
+  Element zero = getZero(resultType.getElementType());
+  for (int64_t i = 0, e = result.getNumElements(); i < e; ++i)
+    result.setAt(i, zero);
   return result;
 }
 
-Tensor evalClampOp(const Tensor &min, const Tensor &operand, const Tensor &max,
-                   TensorType resultType) {
+Tensor evalCompareOp(const Tensor &lhs, const Tensor &rhs,
+                     ComparisonDirection comparisonDirection,
+                     std::optional<ComparisonType> compareType,
+                     TensorType resultType) {
   Tensor result(resultType);
-  for (auto it = result.index_begin(); it != result.index_end(); ++it) {
-    Element minElement = min.getRank() != 0 ? min.get(*it) : min.get({});
-    Element maxElement = max.getRank() != 0 ? max.get(*it) : max.get({});
-    result.set(*it, stablehlo::min(stablehlo::max(operand.get(*it), minElement),
-                                   maxElement));
+  Type elementType = lhs.getElementType();
+  bool isIntegral = isSupportedIntegerType(elementType) ||
+                    isSupportedBooleanType(elementType);
+  if (compareType == ComparisonType::TOTALORDER) {
+    if (compareNative<kNativeFloat>(
+            lhs, rhs, comparisonDirection, result,
+            [](auto x) { return native::totalOrderKey(x); }))
+      return result;
+  } else if (!isIntegral || isSignedComparison(elementType, compareType) ==
+                                isSupportedSignedIntegerType(elementType)) {
+    // Unless `compare_type` overrides the signedness of integers, elements
+    // are compared as their native types.
+    if (compareNative<kNativeAll>(lhs, rhs, comparisonDirection, result,
+                                  [](auto x) { return x; }))
+      return result;
   }
+  Type resultElementType = resultType.getElementType();
+  for (int64_t i = 0, e = result.getNumElements(); i < e; ++i)
+    result.setAt(i, Element(resultElementType,
+                            compareElements(lhs.getAt(i), rhs.getAt(i),
+                                            comparisonDirection, compareType)));
   return result;
 }
 
 Tensor evalConcatenateOp(ArrayRef<Tensor> inputs, Axis dimension,
                          TensorType resultType) {
+  // Each input is copied into a view of the part of the result it covers.
   Tensor result(resultType);
+  const Sizes &resultStrides = result.getStrides();
   int64_t dimensionOffset = 0;
   for (const auto &input : inputs) {
-    for (auto inputIt = input.index_begin(); inputIt != input.index_end();
-         ++inputIt) {
-      Index resultIdx(*inputIt);
-      resultIdx[dimension] += dimensionOffset;
-      result.set(resultIdx, input.get(*inputIt));
-    }
+    Tensor(input.getType(), result, dimensionOffset * resultStrides[dimension],
+           resultStrides)
+        .copyFrom(input);
     dimensionOffset += input.getShape()[dimension];
   }
   return result;
 }
 
 Tensor evalConstantOp(ElementsAttr value) {
+  if (auto resourceAttr = value.dyn_cast<DenseResourceElementsAttr>())
+    return makeTensor(resourceAttr);
   return makeTensor(value.cast<DenseElementsAttr>());
 }
 
@@ -119,24 +2256,217 @@ Tensor evalConstantOp(ElementsAttr value) {
 Tensor evalConvertOp(const Tensor &operand, TensorType resultType) {
   Tensor result(resultType);
   Type elType = result.getElementType();
-  for (auto it = result.index_begin(); it != result.index_end(); ++it)
-    result.set(*it, Element(elType,
-                            operand.get(*it).getIntegerValue().getBoolValue()));
+  for (int64_t i = 0, e = result.getNumElements(); i < e; ++i)
+    result.setAt(i, Element(elType,
+                            operand.getAt(i).getIntegerValue().getBoolValue()));
   return result;
 }
 
-Tensor evalCosineOp(const Tensor &operand, TensorType resultType) {
+Tensor evalConvolutionOp(
+    const Tensor &lhs, const Tensor &rhs, const Sizes &windowStrides,
+    const Sizes &paddingLow, const Sizes &lhsDilation,
+    const Sizes &rhsDilation, ArrayRef<bool> windowReversal,
+    Axis inputBatchDimension, Axis inputFeatureDimension,
+    const Axes &inputSpatialDimensions, Axis kernelInputFeatureDimension,
+    Axis kernelOutputFeatureDimension, const Axes &kernelSpatialDimensions,
+    Axis outputBatchDimension, Axis outputFeatureDimension,
+    const Axes &outputSpatialDimensions, int64_t featureGroupCount,
+    int64_t batchGroupCount, TensorType resultType) {
+  // The operands and the result are canonicalized into views with the groups
+  // as the major dimension and the features as the minor dimension:
+  //   lhs:    [group, batch, input spatial..., input feature]
+  //   rhs:    [group, kernel spatial..., input feature, output feature]
+  //   result: [group, batch, output spatial..., output feature]
+  // Splitting the grouped dimension of a tensor into [group, dimension / group]
+  // is just a matter of strides, so these views are free, and the operands
+  // are only copied if they aren't laid out this way already.
+  int64_t numGroups = std::max(featureGroupCount, batchGroupCount);
+  auto makeGroupedView = [&](const Tensor &tensor, Axis groupedDimension,
+                             ArrayRef<Axis> dimensions) {
+    const Sizes &strides = tensor.getStrides();
+    Sizes shape = tensor.getShape();
+    Sizes viewShape = {numGroups};
+    Sizes viewStrides = {strides[groupedDimension] *
+                         (shape[groupedDimension] / numGroups)};
+    for (Axis d : dimensions) {
+      viewShape.push_back(d == groupedDimension ? shape[d] / numGroups
+                                                : shape[d]);
+      viewStrides.push_back(strides[d]);
+    }
+    auto type = RankedTensorType::get(viewShape, tensor.getElementType());
+    return Tensor(type, tensor, tensor.getOffset(), viewStrides);
+  };
+
+  Axes lhsDimensions = {inputBatchDimension};
+  lhsDimensions.append(inputSpatialDimensions);
+  lhsDimensions.push_back(inputFeatureDimension);
+  Tensor groupedLhs =
+      makeGroupedView(lhs,
+                      featureGroupCount > 1 ? inputFeatureDimension
+                                            : inputBatchDimension,
+                      lhsDimensions)
+          .materialize();
+
+  Axes rhsDimensions(kernelSpatialDimensions);
+  rhsDimensions.push_back(kernelInputFeatureDimension);
+  rhsDimensions.push_back(kernelOutputFeatureDimension);
+  Tensor groupedRhs =
+      makeGroupedView(rhs, kernelOutputFeatureDimension, rhsDimensions)
+          .materialize();
+
   Tensor result(resultType);
-  for (auto it = result.index_begin(); it != result.index_end(); ++it)
-    result.set(*it, cosine(operand.get(*it)));
+  Axes resultDimensions = {outputBatchDimension};
+  resultDimensions.append(outputSpatialDimensions);
+  resultDimensions.push_back(outputFeatureDimension);
+  Tensor groupedResultView =
+      makeGroupedView(result, outputFeatureDimension, resultDimensions);
+  Tensor groupedResult(groupedResultView.getType());
+
+  Sizes lhsShape = groupedLhs.getShape();
+  Sizes rhsShape = groupedRhs.getShape();
+  Sizes resultShape = groupedResult.getShape();
+  int64_t numSpatialDims = inputSpatialDimensions.size();
+  ConvolutionWindow window{
+      Sizes(ArrayRef<int64_t>(lhsShape).slice(2, numSpatialDims)),
+      Sizes(ArrayRef<int64_t>(rhsShape).slice(1, numSpatialDims)),
+      windowStrides,
+      paddingLow,
+      lhsDilation,
+      rhsDilation,
+      SmallVector<bool>(windowReversal)};
+
+  Type elementType = resultType.getElementType();
+  if (lhs.getElementType() != elementType ||
+      !dispatchNativeType<kNativeAll>(elementType, [&](auto tag) {
+        using T = decltype(tag);
+        convolveNative(
+            window,
+            Sizes(ArrayRef<int64_t>(resultShape).slice(2, numSpatialDims)),
+            numGroups, lhsShape[1], lhsShape.back(), resultShape.back(),
+            groupedLhs.getData<T>().data(), groupedRhs.getData<T>().data(),
+            groupedResult.getMutableData<T>().data());
+      }))
+    convolveDirect(window, groupedLhs, groupedRhs, groupedResult);
+
+  groupedResultView.copyFrom(groupedResult);
   return result;
 }
 
-Tensor evalDivideOp(const Tensor &lhs, const Tensor &rhs,
-                    TensorType resultType) {
+Tensor evalCosineOp(Tensor operand, TensorType resultType) {
+  Tensor result = reuseOrAllocate(resultType, operand);
+  if (mapNativeArray<kNativeFloat>(operand, result, [](auto x, auto y) {
+        native::cosine(x, y);
+      }))
+    return result;
+  if (mapNative<kNativeComplex>(operand, result, [](auto x) {
+        return native::cosine(x);
+      }))
+    return result;
+  for (int64_t i = 0, e = result.getNumElements(); i < e; ++i)
+    result.setAt(i, cosine(operand.getAt(i)));
+  return result;
+}
+
+Tensor evalCountLeadingZerosOp(Tensor operand, TensorType resultType) {
+  Tensor result = reuseOrAllocate(resultType, operand);
+  if (mapNative<kNativeInteger>(operand, result, [](auto x) {
+        return native::countLeadingZeros(x);
+      }))
+    return result;
+  for (int64_t i = 0, e = result.getNumElements(); i < e; ++i)
+    result.setAt(i, countLeadingZeros(operand.getAt(i)));
+  return result;
+}
+
+Tensor evalDivideOp(Tensor lhs, Tensor rhs, TensorType resultType) {
+  Tensor result = reuseOrAllocate(resultType, lhs, rhs);
+  if (mapNative<kNativeNumeric>(lhs, rhs, result, [](auto x, auto y) {
+        return native::divide(x, y);
+      }))
+    return result;
+  for (int64_t i = 0, e = result.getNumElements(); i < e; ++i)
+    result.setAt(i, lhs.getAt(i) / rhs.getAt(i));
+  return result;
+}
+
+Tensor evalDotGeneralOp(const Tensor &lhs, const Tensor &rhs,
+                        const Axes &lhsBatchingDimensions,
+                        const Axes &rhsBatchingDimensions,
+                        const Axes &lhsContractingDimensions,
+                        const Axes &rhsContractingDimensions,
+                        TensorType resultType) {
+  auto getResultDimensions = [](const Tensor &operand,
+                                const Axes &batchingDimensions,
+                                const Axes &contractingDimensions) {
+    Axes resultDimensions;
+    for (Axis d = 0; d < operand.getRank(); ++d)
+      if (!llvm::is_contained(batchingDimensions, d) &&
+          !llvm::is_contained(contractingDimensions, d))
+        resultDimensions.push_back(d);
+    return resultDimensions;
+  };
+  Axes lhsResultDimensions = getResultDimensions(lhs, lhsBatchingDimensions,
+                                                 lhsContractingDimensions);
+  Axes rhsResultDimensions = getResultDimensions(rhs, rhsBatchingDimensions,
+                                                 rhsContractingDimensions);
+
+  // The operands are canonicalized into batched matrices: `lhs` is transposed
+  // to [batching, result, contracting] dimensions and `rhs` to [batching,
+  // contracting, result] dimensions, so that the result is their batched
+  // matrix product. Transposes are views, so operands which are already laid
+  // out this way, e.g. for a plain matrix product, aren't copied.
+  auto toBatchedMatrix = [](const Tensor &operand, ArrayRef<Axes> dimensions) {
+    Axes permutation;
+    for (const Axes &part : dimensions) permutation.append(part);
+    auto type = RankedTensorType::get(operand.getShape().permute(permutation),
+                                      operand.getElementType());
+    return evalTransposeOp(operand, permutation, type).materialize();
+  };
+  Tensor lhsMatrix = toBatchedMatrix(
+      lhs,
+      {lhsBatchingDimensions, lhsResultDimensions, lhsContractingDimensions});
+  Tensor rhsMatrix = toBatchedMatrix(
+      rhs,
+      {rhsBatchingDimensions, rhsContractingDimensions, rhsResultDimensions});
+
+  auto getSize = [](const Tensor &operand, const Axes &dimensions) {
+    int64_t size = 1;
+    for (Axis d : dimensions) size *= operand.getShape()[d];
+    return size;
+  };
+  int64_t batchSize = getSize(lhs, lhsBatchingDimensions);
+  int64_t m = getSize(lhs, lhsResultDimensions);
+  int64_t n = getSize(rhs, rhsResultDimensions);
+  int64_t k = getSize(lhs, lhsContractingDimensions);
+
   Tensor result(resultType);
-  for (auto it = result.index_begin(); it != result.index_end(); ++it)
-    result.set(*it, lhs.get(*it) / rhs.get(*it));
+  Type elementType = resultType.getElementType();
+  if (lhs.getElementType() == elementType &&
+      dispatchNativeType<kNativeAll>(elementType, [&](auto tag) {
+        using T = decltype(tag);
+        native::gemm(batchSize, m, n, k, lhsMatrix.getData<T>().data(),
+                     rhsMatrix.getData<T>().data(),
+                     result.getMutableData<T>().data());
+      }))
+    return result;
+
+  // Other element types are multiplied element by element, viewing the
+  // contiguous operands and result as rank-3 tensors.
+  auto asRank3 = [&](const Tensor &tensor, Sizes shape) {
+    auto type = RankedTensorType::get(shape, tensor.getElementType());
+    return Tensor(type, tensor, tensor.getOffset(),
+                  getContiguousStrides(shape));
+  };
+  Tensor lhs3 = asRank3(lhsMatrix, {batchSize, m, k});
+  Tensor rhs3 = asRank3(rhsMatrix, {batchSize, k, n});
+  Tensor result3 = asRank3(result, {batchSize, m, n});
+  for (auto it = result3.index_begin(); it != result3.index_end(); ++it) {
+    int64_t b = (*it)[0], i = (*it)[1], j = (*it)[2];
+    Element dotProduct = getZero(elementType);
+    for (int64_t p = 0; p < k; ++p)
+      dotProduct = dotProduct + lhs3.get({b, i, p}) * rhs3.get({b, p, j});
+    result3.set(*it, dotProduct);
+  }
   return result;
 }
 
@@ -167,17 +2497,182 @@ Tensor evalDynamicUpdateSliceOp(const Tensor &operand, const Tensor &update,
   return result;
 }
 
-Tensor evalExponentialOp(const Tensor &operand, TensorType resultType) {
+Tensor evalExponentialOp(Tensor operand, TensorType resultType) {
+  Tensor result = reuseOrAllocate(resultType, operand);
+  if (mapNativeArray<kNativeFloat>(operand, result, [](auto x, auto y) {
+        native::exponential(x, y);
+      }))
+    return result;
+  if (mapNative<kNativeComplex>(operand, result, [](auto x) {
+        return native::exponential(x);
+      }))
+    return result;
+  for (int64_t i = 0, e = result.getNumElements(); i < e; ++i)
+    result.setAt(i, exponential(operand.getAt(i)));
+  return result;
+}
+
+Tensor evalExponentialMinusOneOp(Tensor operand, TensorType resultType) {
+  Tensor result = reuseOrAllocate(resultType, operand);
+  if (mapNative<kNativeFloatOrComplex>(operand, result, [](auto x) {
+        return native::exponentialMinusOne(x);
+      }))
+    return result;
+  for (int64_t i = 0, e = result.getNumElements(); i < e; ++i)
+    result.setAt(i, exponentialMinusOne(operand.getAt(i)));
+  return result;
+}
+
+Tensor evalFftOp(const Tensor &operand, FftType fftType,
+                 const Sizes &fftLength, TensorType resultType) {
+  // The transforms are computed in double precision on a dense array whose
+  // trailing dimensions are `fftLength`, i.e. on the operand for all types
+  // but `IRFFT`, whose operand only has `fftLength.back() / 2 + 1` elements
+  // along its last dimension.
+  bool isIrfft = fftType == FftType::IRFFT;
+  Sizes shape = isIrfft ? Sizes(resultType.getShape()) : operand.getShape();
+  int64_t numElements =
+      isIrfft ? resultType.getNumElements() : operand.getNumElements();
+  int64_t rank = shape.size();
+  int64_t rowSize = shape.back();
+  int64_t numRows = rowSize == 0 ? 0 : numElements / rowSize;
+  std::vector<std::complex<double>> data(numElements);
+
+  Tensor contiguousOperand = operand.materialize();
+  int64_t operandRowSize = operand.getShape().back();
+  Type operandElementType = operand.getElementType();
+  if (!dispatchNativeType<kNativeFloatOrComplex>(
+          operandElementType, [&](auto tag) {
+            using T = decltype(tag);
+            const T *operandData = contiguousOperand.getData<T>().data();
+            for (int64_t row = 0; row < numRows; ++row)
+              for (int64_t k = 0; k < operandRowSize; ++k)
+                data[row * rowSize + k] =
+                    std::complex<double>(operandData[row * operandRowSize + k]);
+          }))
+    report_fatal_error(
+        invalidArgument("Unsupported element type: %s",
+                        debugString(operandElementType).c_str()));
+
+  int64_t numDims = fftLength.size();
+  switch (fftType) {
+    case FftType::FFT:
+    case FftType::RFFT:
+      for (int64_t d = rank - 1; d >= rank - numDims; --d)
+        native::fftAlongDimension(data.data(), shape, d, /*inverse=*/false);
+      break;
+    case FftType::IFFT:
+      for (int64_t d = rank - numDims; d < rank; ++d)
+        native::fftAlongDimension(data.data(), shape, d, /*inverse=*/true);
+      break;
+    case FftType::IRFFT:
+      for (int64_t d = rank - numDims; d < rank - 1; ++d)
+        native::fftAlongDimension(data.data(), shape, d, /*inverse=*/true);
+      // Restores the elements which `RFFT` truncated from their conjugate
+      // symmetric counterparts. The real part of the inverse transform
+      // doesn't depend on the imaginary parts of the elements for
+      // frequencies 0 and `rowSize / 2`, which are therefore ignored.
+      for (int64_t row = 0; row < numRows; ++row)
+        for (int64_t k = operandRowSize; k < rowSize; ++k)
+          data[row * rowSize + k] =
+              std::conj(data[row * rowSize + rowSize - k]);
+      native::fftAlongDimension(data.data(), shape, rank - 1,
+                                /*inverse=*/true);
+      break;
+  }
+
   Tensor result(resultType);
-  for (auto it = result.index_begin(); it != result.index_end(); ++it)
-    result.set(*it, exponential(operand.get(*it)));
+  int64_t resultRowSize = resultType.getShape().back();
+  dispatchNativeType<kNativeFloatOrComplex>(
+      resultType.getElementType(), [&](auto tag) {
+        using T = decltype(tag);
+        T *resultData = result.getMutableData<T>().data();
+        for (int64_t row = 0; row < numRows; ++row) {
+          for (int64_t k = 0; k < resultRowSize; ++k) {
+            std::complex<double> value = data[row * rowSize + k];
+            if constexpr (std::is_floating_point_v<T>)
+              resultData[row * resultRowSize + k] = value.real();
+            else
+              resultData[row * resultRowSize + k] = T(value);
+          }
+        }
+      });
   return result;
 }
 
-Tensor evalFloorOp(const Tensor &operand, TensorType resultType) {
+Tensor evalFloorOp(Tensor operand, TensorType resultType) {
+  Tensor result = reuseOrAllocate(resultType, operand);
+  if (mapNative<kNativeFloat>(operand, result, [](auto x) {
+        return std::floor(x);
+      }))
+    return result;
+  for (int64_t i = 0, e = result.getNumElements(); i < e; ++i)
+    result.setAt(i, floor(operand.getAt(i)));
+  return result;
+}
+
+Tensor evalGatherOp(const Tensor &operand, const Tensor &startIndices,
+                    const Axes &offsetDims, const Axes &collapsedSliceDims,
+                    const Axes &startIndexMap, Axis indexVectorDim,
+                    const Sizes &sliceSizes, TensorType resultType) {
+  // Every index vector selects a slice of the operand, which is copied into
+  // the window spanned by the offset dimensions of the result, at the
+  // position given by the batch dimensions. How slices map onto windows
+  // doesn't depend on the index vectors, so it is computed upfront.
   Tensor result(resultType);
-  for (auto it = result.index_begin(); it != result.index_end(); ++it)
-    result.set(*it, floor(operand.get(*it)));
+  Tensor contiguousOperand = operand.materialize();
+  Sizes operandShape = operand.getShape();
+  Sizes resultShape = result.getShape();
+  const Sizes &operandStrides = contiguousOperand.getStrides();
+  const Sizes &resultStrides = result.getStrides();
+  Sizes sliceShape, sliceStrides, windowStrides;
+  for (int64_t dim = 0; dim < operand.getRank(); ++dim) {
+    if (llvm::is_contained(collapsedSliceDims, dim)) continue;
+    windowStrides.push_back(resultStrides[offsetDims[sliceShape.size()]]);
+    sliceShape.push_back(sliceSizes[dim]);
+    sliceStrides.push_back(operandStrides[dim]);
+  }
+  CopyRuns runs = getCopyRuns(sliceShape, sliceStrides, windowStrides);
+
+  Sizes batchShape, batchStrides;
+  for (int64_t dim = 0; dim < result.getRank(); ++dim) {
+    if (llvm::is_contained(offsetDims, dim)) continue;
+    batchShape.push_back(resultShape[dim]);
+    batchStrides.push_back(resultStrides[dim]);
+  }
+  SmallVector<int64_t> indexVectors =
+      getIndexVectors(startIndices, indexVectorDim);
+  int64_t indexVectorSize = startIndexMap.size();
+  int64_t sliceSize = ShapedType::getNumElements(sliceShape);
+
+  dispatchStorageType(resultType.getElementType(), [&](auto tag) {
+    using T = decltype(tag);
+    const T *operandData = contiguousOperand.getData<T>().data();
+    T *resultData = result.getMutableData<T>().data();
+    parallelFor(
+        ShapedType::getNumElements(batchShape),
+        kDefaultGrainSize / std::max<int64_t>(sliceSize, 1),
+        [&](int64_t begin, int64_t end) {
+          for (int64_t batch = begin; batch < end; ++batch) {
+            // Like XLA, slices which are out of bounds are moved back into
+            // the operand.
+            const int64_t *indexVector =
+                indexVectors.data() + batch * indexVectorSize;
+            int64_t operandPosition = 0;
+            for (auto [i, dim] : llvm::enumerate(startIndexMap))
+              operandPosition +=
+                  std::clamp<int64_t>(indexVector[i], 0,
+                                      operandShape[dim] - sliceSizes[dim]) *
+                  operandStrides[dim];
+            int64_t resultPosition =
+                getPosition(batch, batchShape, batchStrides);
+            for (auto [sourceOffset, destOffset] : runs.offsets)
+              std::memcpy(resultData + resultPosition + destOffset,
+                          operandData + operandPosition + sourceOffset,
+                          runs.length * sizeof(T));
+          }
+        });
+  });
   return result;
 }
 
@@ -189,8 +2684,8 @@ SmallVector<Tensor> evalIfOp(const Tensor &pred, Region &trueBranch,
 
 Tensor evalImagOp(const Tensor &operand, TensorType resultType) {
   Tensor result(resultType);
-  for (auto it = operand.index_begin(); it != operand.index_end(); ++it)
-    result.set(*it, imag(operand.get(*it)));
+  for (int64_t i = 0, e = operand.getNumElements(); i < e; ++i)
+    result.setAt(i, imag(operand.getAt(i)));
   return result;
 }
 
@@ -230,426 +2725,1038 @@ Tensor evalIotaOp(Axis iotaDimension, TensorType resultType) {
   return result;
 }
 
-Tensor evalLogOp(const Tensor &operand, TensorType resultType) {
-  Tensor result(resultType);
-  for (auto it = result.index_begin(); it != result.index_end(); ++it)
-    result.set(*it, log(operand.get(*it)));
+Tensor evalLogOp(Tensor operand, TensorType resultType) {
+  Tensor result = reuseOrAllocate(resultType, operand);
+  if (mapNativeArray<kNativeFloat>(operand, result, [](auto x, auto y) {
+        native::log(x, y);
+      }))
+    return result;
+  if (mapNative<kNativeComplex>(operand, result, [](auto x) {
+        return native::log(x);
+      }))
+    return result;
+  for (int64_t i = 0, e = result.getNumElements(); i < e; ++i)
+    result.setAt(i, log(operand.getAt(i)));
   return result;
 }
 
-Tensor evalMaxOp(const Tensor &lhs, const Tensor &rhs, TensorType resultType) {
-  Tensor result(resultType);
-  for (auto it = result.index_begin(); it != result.index_end(); ++it)
-    result.set(*it, max(lhs.get(*it), rhs.get(*it)));
+Tensor evalLogPlusOneOp(Tensor operand, TensorType resultType) {
+  Tensor result = reuseOrAllocate(resultType, operand);
+  if (mapNative<kNativeFloatOrComplex>(operand, result, [](auto x) {
+        return native::logPlusOne(x);
+      }))
+    return result;
+  for (int64_t i = 0, e = result.getNumElements(); i < e; ++i)
+    result.setAt(i, logPlusOne(operand.getAt(i)));
   return result;
 }
 
-Tensor evalMinOp(const Tensor &lhs, const Tensor &rhs, TensorType resultType) {
-  Tensor result(resultType);
-  for (auto it = result.index_begin(); it != result.index_end(); ++it)
-    result.set(*it, min(lhs.get(*it), rhs.get(*it)));
+Tensor evalLogisticOp(Tensor operand, TensorType resultType) {
+  Tensor result = reuseOrAllocate(resultType, operand);
+  if (mapNative<kNativeFloatOrComplex>(operand, result, [](auto x) {
+        return native::logistic(x);
+      }))
+    return result;
+  for (int64_t i = 0, e = result.getNumElements(); i < e; ++i)
+    result.setAt(i, logistic(operand.getAt(i)));
   return result;
 }
 
-Tensor evalMultiplyOp(const Tensor &lhs, const Tensor &rhs,
-                      TensorType resultType) {
-  Tensor result(resultType);
-  for (auto it = result.index_begin(); it != result.index_end(); ++it)
-    result.set(*it, lhs.get(*it) * rhs.get(*it));
+Tensor evalMaxOp(Tensor lhs, Tensor rhs, TensorType resultType) {
+  Tensor result = reuseOrAllocate(resultType, lhs, rhs);
+  if (mapNative<kNativeAll>(lhs, rhs, result, [](auto x, auto y) {
+        return native::max(x, y);
+      }))
+    return result;
+  for (int64_t i = 0, e = result.getNumElements(); i < e; ++i)
+    result.setAt(i, max(lhs.getAt(i), rhs.getAt(i)));
   return result;
 }
 
-Tensor evalNegOp(const Tensor &operand, TensorType resultType) {
-  Tensor result(resultType);
-  for (auto it = result.index_begin(); it != result.index_end(); ++it)
-    result.set(*it, -operand.get(*it));
+Tensor evalMinOp(Tensor lhs, Tensor rhs, TensorType resultType) {
+  Tensor result = reuseOrAllocate(resultType, lhs, rhs);
+  if (mapNative<kNativeAll>(lhs, rhs, result, [](auto x, auto y) {
+        return native::min(x, y);
+      }))
+    return result;
+  for (int64_t i = 0, e = result.getNumElements(); i < e; ++i)
+    result.setAt(i, min(lhs.getAt(i), rhs.getAt(i)));
   return result;
 }
 
-Tensor evalNotOp(const Tensor &operand, TensorType resultType) {
-  Tensor result(resultType);
-  for (auto it = operand.index_begin(); it != operand.index_end(); ++it)
-    result.set(*it, ~operand.get(*it));
+Tensor evalMultiplyOp(Tensor lhs, Tensor rhs, TensorType resultType) {
+  Tensor result = reuseOrAllocate(resultType, lhs, rhs);
+  if (mapNative<kNativeAll>(lhs, rhs, result, [](auto x, auto y) {
+        return native::multiply(x, y);
+      }))
+    return result;
+  for (int64_t i = 0, e = result.getNumElements(); i < e; ++i)
+    result.setAt(i, lhs.getAt(i) * rhs.getAt(i));
   return result;
 }
 
-Tensor evalOrOp(const Tensor &lhs, const Tensor &rhs, TensorType resultType) {
-  Tensor result(resultType);
-  for (auto it = lhs.index_begin(); it != lhs.index_end(); ++it)
-    result.set(*it, lhs.get(*it) | rhs.get(*it));
+Tensor evalNegOp(Tensor operand, TensorType resultType) {
+  Tensor result = reuseOrAllocate(resultType, operand);
+  if (mapNative<kNativeNumeric>(operand, result, [](auto x) {
+        return native::negate(x);
+      }))
+    return result;
+  for (int64_t i = 0, e = result.getNumElements(); i < e; ++i)
+    result.setAt(i, -operand.getAt(i));
+  return result;
+}
+
+Tensor evalNotOp(Tensor operand, TensorType resultType) {
+  Tensor result = reuseOrAllocate(resultType, operand);
+  if (mapNative<kNativeIntegral>(operand, result, [](auto x) {
+        return native::bitwiseNot(x);
+      }))
+    return result;
+  for (int64_t i = 0, e = operand.getNumElements(); i < e; ++i)
+    result.setAt(i, ~operand.getAt(i));
+  return result;
+}
+
+Tensor evalOrOp(Tensor lhs, Tensor rhs, TensorType resultType) {
+  Tensor result = reuseOrAllocate(resultType, lhs, rhs);
+  if (mapNative<kNativeIntegral>(lhs, rhs, result, [](auto x, auto y) {
+        return native::bitwiseOr(x, y);
+      }))
+    return result;
+  for (int64_t i = 0, e = lhs.getNumElements(); i < e; ++i)
+    result.setAt(i, lhs.getAt(i) | rhs.getAt(i));
   return result;
 }
 
 Tensor evalPadOp(const Tensor &operand, const Tensor &paddingValue,
                  Sizes edgePaddingLow, Sizes interiorPadding,
                  TensorType resultType) {
+  // Fill the result by copying from a broadcast of `paddingValue`.
   Tensor result(resultType);
-  for (auto resultIt = result.index_begin(); resultIt != result.index_end();
-       ++resultIt)
-    result.set(*resultIt, paddingValue.get({}));
-  for (auto operandIt = operand.index_begin(); operandIt != operand.index_end();
-       ++operandIt) {
-    auto resultIdx = edgePaddingLow + *operandIt * (interiorPadding + 1);
-    // Bound check is needed here because of negative padding which could
-    // swallow some operand indices.
-    if (resultIdx.inBounds(result.getShape()))
-      result.set(resultIdx, operand.get(*operandIt));
+  result.copyFrom(Tensor(resultType, paddingValue, paddingValue.getOffset(),
+                         Sizes(resultType.getRank(), 0)));
+
+  // Operand element `i` goes to result element `edgePaddingLow + i * step`.
+  // Negative padding can swallow some operand elements, so only the part of
+  // the operand which lands within the bounds of the result is copied, from
+  // a slice of the operand into a strided view of the result.
+  auto operandShape = operand.getShape();
+  auto resultShape = result.getShape();
+  const auto &operandStrides = operand.getStrides();
+  const auto &resultStrides = result.getStrides();
+  Sizes shape(operand.getRank());
+  int64_t operandOffset = operand.getOffset();
+  int64_t resultOffset = 0;
+  Sizes strides(operand.getRank());
+  for (int64_t dim = 0; dim < operand.getRank(); ++dim) {
+    int64_t low = edgePaddingLow[dim];
+    int64_t step = interiorPadding[dim] + 1;
+    int64_t first = low < 0 ? (-low + step - 1) / step : 0;
+    int64_t last = std::min(operandShape[dim],
+                            (resultShape[dim] - low + step - 1) / step);
+    shape[dim] = std::max<int64_t>(last - first, 0);
+    operandOffset += first * operandStrides[dim];
+    resultOffset += (low + first * step) * resultStrides[dim];
+    strides[dim] = step * resultStrides[dim];
   }
+  if (llvm::is_contained(shape, 0)) return result;
+  auto type = RankedTensorType::get(shape, resultType.getElementType());
+  Tensor(type, result, resultOffset, strides)
+      .copyFrom(Tensor(type, operand, operandOffset, operandStrides));
+  return result;
+}
+
+Tensor evalPartitionIdOp(const Process &process, TensorType resultType) {
+  Tensor result(resultType);
+  result.set({}, Element(resultType.getElementType(),
+                         APInt(32, process.getId().partitionId)));
+  return result;
+}
+
+Tensor evalPopcntOp(Tensor operand, TensorType resultType) {
+  Tensor result = reuseOrAllocate(resultType, operand);
+  if (mapNative<kNativeInteger>(operand, result, [](auto x) {
+        return native::popcnt(x);
+      }))
+    return result;
+  for (int64_t i = 0, e = result.getNumElements(); i < e; ++i)
+    result.setAt(i, popcnt(operand.getAt(i)));
+  return result;
+}
+
+Tensor evalPowerOp(Tensor lhs, Tensor rhs, TensorType resultType) {
+  Tensor result = reuseOrAllocate(resultType, lhs, rhs);
+  if (mapNative<kNativeNumeric>(lhs, rhs, result, [](auto x, auto y) {
+        return native::power(x, y);
+      }))
+    return result;
+  for (int64_t i = 0, e = result.getNumElements(); i < e; ++i)
+    result.setAt(i, power(lhs.getAt(i), rhs.getAt(i)));
   return result;
 }
 
 Tensor evalRealOp(const Tensor &operand, TensorType resultType) {
   Tensor result(resultType);
-  for (auto it = operand.index_begin(); it != operand.index_end(); ++it)
-    result.set(*it, real(operand.get(*it)));
+  for (int64_t i = 0, e = operand.getNumElements(); i < e; ++i)
+    result.setAt(i, real(operand.getAt(i)));
   return result;
 }
 
-Tensor evalReshapeOp(const Tensor &operand, TensorType resultType) {
+SmallVector<Tensor> evalReduceOp(ArrayRef<Tensor> inputs,
+                                 ArrayRef<Tensor> initValues,
+                                 const Axes &dimensions, Region &body,
+                                 Scope &scope,
+                                 ArrayRef<TensorType> resultTypes) {
+  // The inputs are viewed with the reduced dimensions, in ascending order, as
+  // their minor dimensions. Every result element is thus reduced from a run
+  // of consecutive elements of the views, in the order of the spec.
+  int64_t rank = inputs[0].getRank();
+  Axes reducedDimensions(dimensions);
+  llvm::sort(reducedDimensions);
+  Axes permutation;
+  for (int64_t dim = 0; dim < rank; ++dim)
+    if (!llvm::is_contained(reducedDimensions, dim)) permutation.push_back(dim);
+  int64_t numKeptDims = permutation.size();
+  permutation.append(reducedDimensions);
+  Sizes viewShape = inputs[0].getShape().permute(permutation);
+  SmallVector<Tensor> views;
+  for (const Tensor &input : inputs)
+    views.emplace_back(
+        RankedTensorType::get(viewShape, input.getElementType()), input,
+        input.getOffset(), input.getStrides().permute(permutation));
+
+  SmallVector<Tensor> results;
+  for (TensorType resultType : resultTypes) results.emplace_back(resultType);
+
+  // Bodies which consist of a single known op are applied to the elements
+  // directly, using native kernels if possible.
+  auto kind = getReductionKind(body);
+  bool isKnownReduction =
+      kind && inputs.size() == 1 &&
+      inputs[0].getElementType() == resultTypes[0].getElementType();
+  if (isKnownReduction &&
+      reduceNative(*kind, views[0], initValues[0], results[0]))
+    return results;
+
+  Sizes reducedShape(ArrayRef<int64_t>(viewShape).drop_front(numKeptDims));
+  bool isEmpty = llvm::is_contained(reducedShape, 0);
+  Sizes reducedIndex(reducedShape.size());
+  for (auto it = results[0].index_begin(); it != results[0].index_end(); ++it) {
+    Index viewIndex = *it;
+    viewIndex.append(reducedIndex);
+
+    if (isKnownReduction) {
+      Element accumulator = initValues[0].get({});
+      if (!isEmpty) {
+        do {
+          llvm::copy(reducedIndex, viewIndex.begin() + numKeptDims);
+          accumulator =
+              combineElements(*kind, accumulator, views[0].get(viewIndex));
+        } while (incrementIndex(reducedIndex, reducedShape));
+      }
+      results[0].set(*it, accumulator);
+      continue;
+    }
+
+    SmallVector<Tensor> accumulators(initValues);
+    if (!isEmpty) {
+      do {
+        llvm::copy(reducedIndex, viewIndex.begin() + numKeptDims);
+        SmallVector<Tensor> args = std::move(accumulators);
+        for (const Tensor &view : views)
+          args.push_back(makeScalarTensor(view.get(viewIndex)));
+        accumulators = eval(body, args, &scope);
+      } while (incrementIndex(reducedIndex, reducedShape));
+    }
+    for (auto [result, accumulator] : llvm::zip(results, accumulators))
+      result.set(*it, accumulator.get({}));
+  }
+  return results;
+}
+
+Tensor evalReduceScatterOp(const Tensor &operand, Axis scatterDimension,
+                           ArrayRef<SmallVector<uint32_t>> replicaGroups,
+                           int64_t channelId, bool useGlobalDeviceIds,
+                           Region &computation, Process &process,
+                           Scope &scope, TensorType resultType) {
+  ProcessGroup processGroup =
+      getProcessGroup(process, replicaGroups, channelId, useGlobalDeviceIds);
+  SmallVector<Tensor> operands = process.rendezvous(processGroup, operand);
+
+  // Every process only reduces the part of the operands which it receives.
+  Index startIndices(operand.getRank(), 0);
+  startIndices[scatterDimension] = getProcessIndex(processGroup, process) *
+                                   resultType.getDimSize(scatterDimension);
+  Sizes strides(operand.getRank(), 1);
+  SmallVector<Tensor> operandParts;
+  for (const auto &value : operands)
+    operandParts.push_back(
+        evalSliceOp(value, startIndices, strides, resultType));
+  return reduceValues(operandParts, computation, scope);
+}
+
+SmallVector<Tensor> evalReduceWindowOp(
+    ArrayRef<Tensor> inputs, ArrayRef<Tensor> initValues,
+    const Sizes &windowDimensions, const Sizes &windowStrides,
+    const Sizes &baseDilations, const Sizes &windowDilations,
+    const Sizes &paddingLow, const Sizes &paddingHigh, Region &body,
+    Scope &scope, ArrayRef<TensorType> resultTypes) {
+  // As in the spec, the inputs are padded with the init values. A view of
+  // each padded input then exposes the window of every result element as
+  // additional minor dimensions, which are reduced by `evalReduceOp`.
+  int64_t rank = inputs[0].getRank();
+  Sizes inputShape = inputs[0].getShape();
+  Sizes paddedShape(rank);
+  Sizes interiorPadding(rank);
+  for (int64_t dim = 0; dim < rank; ++dim) {
+    int64_t dilatedSize = inputShape[dim] == 0
+                              ? 0
+                              : (inputShape[dim] - 1) * baseDilations[dim] + 1;
+    paddedShape[dim] = paddingLow[dim] + dilatedSize + paddingHigh[dim];
+    interiorPadding[dim] = baseDilations[dim] - 1;
+  }
+
+  Sizes windowsShape(resultTypes[0].getShape());
+  windowsShape.append(windowDimensions);
+  Axes windowAxes;
+  for (int64_t dim = 0; dim < rank; ++dim) windowAxes.push_back(rank + dim);
+  SmallVector<Tensor> windows;
+  for (auto [input, initValue] : llvm::zip(inputs, initValues)) {
+    Tensor padded = evalPadOp(
+        input, initValue, paddingLow, interiorPadding,
+        RankedTensorType::get(paddedShape, input.getElementType()));
+    const Sizes &paddedStrides = padded.getStrides();
+    Sizes windowsStrides(2 * rank);
+    for (int64_t dim = 0; dim < rank; ++dim) {
+      windowsStrides[dim] = paddedStrides[dim] * windowStrides[dim];
+      windowsStrides[rank + dim] = paddedStrides[dim] * windowDilations[dim];
+    }
+    windows.emplace_back(
+        RankedTensorType::get(windowsShape, input.getElementType()), padded,
+        padded.getOffset(), windowsStrides);
+  }
+  return evalReduceOp(windows, initValues, windowAxes, body, scope,
+                      resultTypes);
+}
+
+Tensor evalRemainderOp(Tensor lhs, Tensor rhs, TensorType resultType) {
+  Tensor result = reuseOrAllocate(resultType, lhs, rhs);
+  if (mapNative<kNativeInteger | kNativeFloat>(
+          lhs, rhs, result,
+          [](auto x, auto y) { return native::remainder(x, y); }))
+    return result;
+  for (int64_t i = 0, e = result.getNumElements(); i < e; ++i)
+    result.setAt(i, rem(lhs.getAt(i), rhs.getAt(i)));
+  return result;
+}
+
+Tensor evalReplicaIdOp(const Process &process, TensorType resultType) {
   Tensor result(resultType);
-  for (auto resultIt = result.index_begin(), operandIt = operand.index_begin();
-       resultIt != result.index_end(); ++resultIt, ++operandIt)
-    result.set(*resultIt, operand.get(*operandIt));
+  result.set({}, Element(resultType.getElementType(),
+                         APInt(32, process.getId().replicaId)));
   return result;
 }
 
+Tensor evalReshapeOp(const Tensor &operand, TensorType resultType) {
+  // Reshapes preserve the major-to-minor order of elements, so the result is
+  // a view of the contiguous version of `operand`.
+  Tensor contiguousOperand = operand.materialize();
+  return Tensor(resultType, contiguousOperand, contiguousOperand.getOffset(),
+                getContiguousStrides(Sizes(resultType.getShape())));
+}
+
 Tensor evalReverseOp(const Tensor &operand, Axes dimensions,
                      TensorType resultType) {
+  // The result is a view of `operand` which starts at the last element and
+  // walks backwards along the reversed dimensions.
+  auto operandShape = operand.getShape();
+  auto resultStrides = operand.getStrides();
+  int64_t resultOffset = operand.getOffset();
+  for (auto dim : dimensions) {
+    resultOffset += (operandShape[dim] - 1) * resultStrides[dim];
+    resultStrides[dim] = -resultStrides[dim];
+  }
+  return Tensor(resultType, operand, resultOffset, resultStrides);
+}
+
+SmallVector<Tensor> evalRngBitGeneratorOp(RngAlgorithm rngAlgorithm,
+                                          const Tensor &initialState,
+                                          TensorType outputStateType,
+                                          TensorType outputType) {
+  // Like XLA, the first word of the state is the key and the remaining words
+  // are the counter. `DEFAULT` is Philox.
+  int64_t stateSize = initialState.getNumElements();
+  bool isThreeFry = rngAlgorithm == RngAlgorithm::THREE_FRY;
+  if (stateSize != 2 && (isThreeFry || stateSize != 3))
+    report_fatal_error(invalidArgument(
+        "Unsupported size of initial_state for %s: %lld",
+        stringifyRngAlgorithm(rngAlgorithm).str().c_str(),
+        static_cast<long long>(stateSize)));
+  SmallVector<uint64_t> state;
+  for (auto it = initialState.index_begin(); it != initialState.index_end();
+       ++it)
+    state.push_back(initialState.get(*it).getIntegerValue().getZExtValue());
+  native::RandomCounter counter = {state[1], stateSize == 3 ? state[2] : 0};
+
+  Tensor output(outputType);
+  Type elementType = outputType.getElementType();
+  auto algorithm = isThreeFry ? native::RandomAlgorithm::kThreeFry
+                              : native::RandomAlgorithm::kPhilox;
+  dispatchStorageType(elementType, [&](auto tag) {
+    using T = decltype(tag);
+    if constexpr (std::is_integral_v<T>)
+      counter = native::generateRandomBits(algorithm, state[0], counter,
+                                           output.getMutableData<T>());
+    else
+      report_fatal_error(invalidArgument("Unsupported element type: %s",
+                                         debugString(elementType).c_str()));
+  });
+
+  // Elements narrower than their storage, i.e. 4-bit integers, take a byte of
+  // the stream each, which is truncated and, if signed, sign-extended.
+  unsigned bitWidth = elementType.getIntOrFloatBitWidth();
+  if (bitWidth < 8) {
+    unsigned unusedBits = 8 - bitWidth;
+    bool isSigned = isSupportedSignedIntegerType(elementType);
+    for (uint8_t &byte : output.getMutableData<uint8_t>())
+      byte = isSigned ? static_cast<uint8_t>(
+                            static_cast<int8_t>(byte << unusedBits) >>
+                            unusedBits)
+                      : static_cast<uint8_t>(byte << unusedBits) >> unusedBits;
+  }
+
+  state[1] = counter[0];
+  if (stateSize == 3) state[2] = counter[1];
+  Tensor outputState(outputStateType);
+  Type stateElementType = outputStateType.getElementType();
+  unsigned stateBitWidth = stateElementType.getIntOrFloatBitWidth();
+  for (auto [i, word] : llvm::enumerate(state))
+    outputState.set({static_cast<int64_t>(i)},
+                    Element(stateElementType, APInt(stateBitWidth, word)));
+  return {outputState, output};
+}
+
+Tensor evalRngOp(const Tensor &a, const Tensor &b,
+                 RngDistribution rngDistribution, Scope &scope,
+                 TensorType resultType) {
   Tensor result(resultType);
-  auto resultShape = result.getShape();
-  for (auto resultIt = result.index_begin(); resultIt != result.index_end();
-       ++resultIt) {
-    Index operandIdx(*resultIt);
-    for (auto dim : dimensions)
-      operandIdx[dim] = (resultShape[dim] - 1) - operandIdx[dim];
-    result.set(*resultIt, operand.get(operandIdx));
+  Type elementType = resultType.getElementType();
+  bool isFloat = isSupportedFloatType(elementType);
+  bool isUniform = rngDistribution == RngDistribution::UNIFORM;
+  if (!isUniform && !isFloat)
+    report_fatal_error(invalidArgument("Unsupported element type for %s: %s",
+                                       "NORMAL distribution",
+                                       debugString(elementType).c_str()));
+
+  // Elements are computed independently from their own Philox block, so the
+  // result doesn't depend on the number of threads. Counters are reserved
+  // from the root scope in program order, see `Scope::reserveRngCounters`.
+  int64_t numElements = result.getNumElements();
+  uint64_t firstCounter = scope.reserveRngCounters(numElements);
+  ProcessId processId = {0, 0};
+  if (Process *process = scope.getProcess()) processId = process->getId();
+  auto getBits = [&](int64_t i) {
+    std::array<uint32_t, 4> block = getRngBlock(firstCounter, i, processId);
+    return std::make_pair(
+        static_cast<uint64_t>(block[0]) | static_cast<uint64_t>(block[1]) << 32,
+        static_cast<uint64_t>(block[2]) |
+            static_cast<uint64_t>(block[3]) << 32);
+  };
+
+  // Floating-point elements are computed in double precision.
+  Element aElement = a.get({});
+  Element bElement = b.get({});
+  double aFloat = isFloat ? aElement.getFloatValue().convertToDouble() : 0;
+  double bFloat = isFloat ? bElement.getFloatValue().convertToDouble() : 0;
+  auto getFloat = [&](int64_t i) {
+    auto [bits0, bits1] = getBits(i);
+    if (isUniform) return aFloat + (bFloat - aFloat) * toUnitInterval(bits0);
+    // Box-Muller transform. 1 - u is in (0, 1], so its log is finite.
+    double radius = std::sqrt(-2 * std::log(1 - toUnitInterval(bits0)));
+    double angle = 2 * llvm::numbers::pi * toUnitInterval(bits1);
+    return aFloat + bFloat * radius * std::cos(angle);
+  };
+
+  // Integers are computed modulo 2^64, where `b - a` is the size of the
+  // range even for signed integers.
+  auto getInteger = [&](const Element &el) -> uint64_t {
+    if (isSupportedBooleanType(elementType)) return el.getBooleanValue();
+    APInt value = el.getIntegerValue();
+    return isSupportedSignedIntegerType(elementType) ? value.getSExtValue()
+                                                     : value.getZExtValue();
+  };
+  uint64_t aInteger = isFloat ? 0 : getInteger(aElement);
+  uint64_t range = isFloat ? 0 : getInteger(bElement) - aInteger;
+  auto getIntegerElement = [&](int64_t i) {
+    uint64_t bits = getBits(i).first;
+    return range == 0 ? aInteger : aInteger + bits % range;
+  };
+
+  if (dispatchNativeType<kNativeIntegral | kNativeFloat>(
+          elementType, [&](auto tag) {
+            using T = decltype(tag);
+            T *data = result.getMutableData<T>().data();
+            parallelFor(numElements, kDefaultGrainSize,
+                        [&](int64_t begin, int64_t end) {
+                          for (int64_t i = begin; i < end; ++i) {
+                            if constexpr (std::is_floating_point_v<T>) {
+                              // Rounding may give `b`, which is excluded.
+                              T value = static_cast<T>(getFloat(i));
+                              T bValue = static_cast<T>(bFloat);
+                              if (isUniform && value >= bValue)
+                                value = std::nextafter(
+                                    bValue, static_cast<T>(aFloat));
+                              data[i] = value;
+                            } else {
+                              data[i] = static_cast<T>(getIntegerElement(i));
+                            }
+                          }
+                        });
+          }))
+    return result;
+
+  int64_t i = 0;
+  for (auto it = result.index_begin(); it != result.index_end(); ++it, ++i) {
+    if (!isFloat) {
+      unsigned bitWidth = elementType.getIntOrFloatBitWidth();
+      result.set(*it, Element(elementType, APInt(64, getIntegerElement(i))
+                                               .trunc(bitWidth)));
+      continue;
+    }
+    APFloat value(getFloat(i));
+    APFloat bValue = bElement.getFloatValue();
+    bool losesInfo;
+    value.convert(bValue.getSemantics(), APFloat::rmNearestTiesToEven,
+                  &losesInfo);
+    if (isUniform && value.compare(bValue) != APFloat::cmpLessThan) {
+      value = bValue;
+      value.next(/*nextDown=*/true);
+    }
+    result.set(*it, Element(elementType, value));
   }
   return result;
 }
 
-Tensor evalRsqrtOp(const Tensor &operand, TensorType resultType) {
-  Tensor result(resultType);
+Tensor evalRsqrtOp(Tensor operand, TensorType resultType) {
+  Tensor result = reuseOrAllocate(resultType, operand);
+  if (mapNativeArray<kNativeFloat>(operand, result, [](auto x, auto y) {
+        native::rsqrt(x, y);
+      }))
+    return result;
+  if (mapNative<kNativeComplex>(operand, result, [](auto x) {
+        return native::rsqrt(x);
+      }))
+    return result;
   for (auto resultIt = result.index_begin(); resultIt != result.index_end();
        ++resultIt)
     result.set(*resultIt, rsqrt(operand.get(*resultIt)));
   return result;
 }
 
-Tensor evalSelectOp(const Tensor &pred, const Tensor &onTrue,
-                    const Tensor &onFalse, TensorType resultType) {
-  Tensor result(resultType);
-  for (auto it = result.index_begin(); it != result.index_end(); ++it) {
-    Element predValue = pred.getRank() != 0 ? pred.get(*it) : pred.get({});
-    result.set(
-        *it, predValue.getBooleanValue() ? onTrue.get(*it) : onFalse.get(*it));
+SmallVector<Tensor> evalScatterOp(
+    ArrayRef<Tensor> inputs, const Tensor &scatterIndices,
+    ArrayRef<Tensor> updates, const Axes &updateWindowDims,
+    const Axes &insertedWindowDims, const Axes &scatterDimsToOperandDims,
+    Axis indexVectorDim, Region &updateComputation, Scope &scope,
+    ArrayRef<TensorType> resultTypes) {
+  // The results start out as copies of the inputs, or as the inputs
+  // themselves if nothing else refers to them.
+  SmallVector<Tensor> results;
+  for (auto [input, resultType] : llvm::zip(inputs, resultTypes)) {
+    if (input.isReusableAs(resultType)) {
+      results.push_back(input);
+      continue;
+    }
+    results.emplace_back(resultType).copyFrom(input);
+  }
+
+  // Every index vector selects a window of the results, which is updated
+  // with the slice of the updates spanned by the update window dimensions, at
+  // the position given by the update scatter dimensions. How slices map onto
+  // windows doesn't depend on the index vectors, so it is computed upfront.
+  int64_t rank = results[0].getRank();
+  Sizes inputShape = inputs[0].getShape();
+  Sizes updateShape = updates[0].getShape();
+  SmallVector<Tensor> contiguousUpdates;
+  for (const Tensor &update : updates)
+    contiguousUpdates.push_back(update.materialize());
+  const Sizes &updateStrides = contiguousUpdates[0].getStrides();
+  const Sizes &resultStrides = results[0].getStrides();
+  Sizes fullWindowShape(rank, 1);
+  Axes windowDims;
+  Sizes windowShape, windowUpdateStrides, windowResultStrides;
+  for (int64_t dim = 0; dim < rank; ++dim) {
+    if (llvm::is_contained(insertedWindowDims, dim)) continue;
+    int64_t updateDim = updateWindowDims[windowDims.size()];
+    fullWindowShape[dim] = updateShape[updateDim];
+    windowDims.push_back(dim);
+    windowShape.push_back(updateShape[updateDim]);
+    windowUpdateStrides.push_back(updateStrides[updateDim]);
+    windowResultStrides.push_back(resultStrides[dim]);
+  }
+
+  Axes updateScatterDims;
+  Sizes batchShape, batchStrides;
+  for (int64_t dim = 0; dim < updates[0].getRank(); ++dim) {
+    if (llvm::is_contained(updateWindowDims, dim)) continue;
+    updateScatterDims.push_back(dim);
+    batchShape.push_back(updateShape[dim]);
+    batchStrides.push_back(updateStrides[dim]);
+  }
+  SmallVector<int64_t> indexVectors =
+      getIndexVectors(scatterIndices, indexVectorDim);
+  int64_t indexVectorSize = scatterDimsToOperandDims.size();
+  int64_t numBatches = ShapedType::getNumElements(batchShape);
+
+  // Returns the index of the first element of the window of `batch` in the
+  // results. Like XLA, skips windows which are out of bounds.
+  auto getStartIndex = [&](int64_t batch) -> std::optional<Index> {
+    const int64_t *indexVector = indexVectors.data() + batch * indexVectorSize;
+    Index startIndex(rank, 0);
+    for (auto [i, dim] : llvm::enumerate(scatterDimsToOperandDims)) {
+      if (indexVector[i] < 0 ||
+          indexVector[i] > inputShape[dim] - fullWindowShape[dim])
+        return std::nullopt;
+      startIndex[dim] = indexVector[i];
+    }
+    return startIndex;
+  };
+
+  // Update computations which replace elements, or which consist of a single
+  // known op, are applied to whole runs of elements at once. Windows may
+  // overlap, so they are updated one after the other.
+  auto kind = getReductionKind(updateComputation);
+  auto updateRuns = [&](auto tag, auto updateRun) {
+    using T = decltype(tag);
+    CopyRuns runs =
+        getCopyRuns(windowShape, windowUpdateStrides, windowResultStrides);
+    const T *updateData = contiguousUpdates[0].getData<T>().data();
+    T *resultData = results[0].getMutableData<T>().data();
+    for (int64_t batch = 0; batch < numBatches; ++batch) {
+      auto startIndex = getStartIndex(batch);
+      if (!startIndex) continue;
+      int64_t resultPosition = 0;
+      for (auto [start, stride] : llvm::zip(*startIndex, resultStrides))
+        resultPosition += start * stride;
+      int64_t updatePosition = getPosition(batch, batchShape, batchStrides);
+      for (auto [sourceOffset, destOffset] : runs.offsets)
+        updateRun(resultData + resultPosition + destOffset,
+                  updateData + updatePosition + sourceOffset, runs.length);
+    }
+  };
+  if (inputs.size() == 1 && isReplacement(updateComputation)) {
+    dispatchStorageType(results[0].getElementType(), [&](auto tag) {
+      updateRuns(tag, [](auto *result, const auto *update, int64_t length) {
+        std::memcpy(result, update, length * sizeof(*update));
+      });
+    });
+    return results;
+  }
+  if (inputs.size() == 1 && kind &&
+      dispatchReduction(*kind, results[0].getElementType(),
+                        [&](auto tag, auto op) {
+                          updateRuns(tag, [&](auto *result, const auto *update,
+                                              int64_t length) {
+                            for (int64_t i = 0; i < length; ++i)
+                              result[i] = op(result[i], update[i]);
+                          });
+                        }))
+    return results;
+
+  if (llvm::is_contained(windowShape, 0)) return results;
+  Index updateIndex(updates[0].getRank());
+  Sizes windowIndex(windowShape.size());
+  for (int64_t batch = 0; batch < numBatches; ++batch) {
+    auto startIndex = getStartIndex(batch);
+    if (!startIndex) continue;
+    for (int64_t i = batchShape.size() - 1, rest = batch; i >= 0; --i) {
+      updateIndex[updateScatterDims[i]] = rest % batchShape[i];
+      rest /= batchShape[i];
+    }
+
+    do {
+      Index resultIndex = *startIndex;
+      for (auto [i, dim] : llvm::enumerate(windowDims)) {
+        resultIndex[dim] += windowIndex[i];
+        updateIndex[updateWindowDims[i]] = windowIndex[i];
+      }
+
+      if (inputs.size() == 1 && kind) {
+        results[0].set(resultIndex,
+                       combineElements(*kind, results[0].get(resultIndex),
+                                       updates[0].get(updateIndex)));
+        continue;
+      }
+
+      SmallVector<Tensor> args;
+      for (const Tensor &result : results)
+        args.push_back(makeScalarTensor(result.get(resultIndex)));
+      for (const Tensor &update : updates)
+        args.push_back(makeScalarTensor(update.get(updateIndex)));
+      auto updatedValues = eval(updateComputation, args, &scope);
+      for (auto [result, updatedValue] : llvm::zip(results, updatedValues))
+        result.set(resultIndex, updatedValue.get({}));
+    } while (incrementIndex(windowIndex, windowShape));
+  }
+  return results;
+}
+
+Tensor evalSelectOp(const Tensor &pred, Tensor onTrue, Tensor onFalse,
+                    TensorType resultType) {
+  Tensor result = reuseOrAllocate(resultType, onTrue, onFalse);
+  Type elementType = resultType.getElementType();
+  if (onTrue.getType() == resultType && onFalse.getType() == resultType &&
+      dispatchNativeType<kNativeAll>(elementType, [&](auto tag) {
+        using T = decltype(tag);
+        // `pred` is either a scalar or has the same shape as the result, in
+        // which case it is indexed in lockstep.
+        Tensor contiguousPred = pred.materialize();
+        Tensor contiguousOnTrue = onTrue.materialize();
+        Tensor contiguousOnFalse = onFalse.materialize();
+        const bool *predData = contiguousPred.getData<bool>().data();
+        const T *onTrueData = contiguousOnTrue.getData<T>().data();
+        const T *onFalseData = contiguousOnFalse.getData<T>().data();
+        T *resultData = result.getMutableData<T>().data();
+        int64_t predStride = pred.getRank() != 0 ? 1 : 0;
+        parallelFor(result.getNumElements(), kDefaultGrainSize,
+                    [&](int64_t begin, int64_t end) {
+                      for (int64_t i = begin; i < end; ++i)
+                        resultData[i] = predData[i * predStride]
+                                            ? onTrueData[i]
+                                            : onFalseData[i];
+                    });
+      }))
+    return result;
+  for (int64_t i = 0, e = result.getNumElements(); i < e; ++i) {
+    Element predValue = pred.getRank() != 0 ? pred.getAt(i) : pred.get({});
+    result.setAt(
+        i, predValue.getBooleanValue() ? onTrue.getAt(i) : onFalse.getAt(i));
   }
   return result;
 }
 
-Tensor evalSineOp(const Tensor &operand, TensorType resultType) {
-  Tensor result(resultType);
-  for (auto it = result.index_begin(); it != result.index_end(); ++it)
-    result.set(*it, sine(operand.get(*it)));
+Tensor evalShiftLeftOp(Tensor lhs, Tensor rhs, TensorType resultType) {
+  Tensor result = reuseOrAllocate(resultType, lhs, rhs);
+  if (mapNative<kNativeInteger>(lhs, rhs, result, [](auto x, auto y) {
+        return native::shiftLeft(x, y);
+      }))
+    return result;
+  for (int64_t i = 0, e = result.getNumElements(); i < e; ++i)
+    result.setAt(i, shiftLeft(lhs.getAt(i), rhs.getAt(i)));
+  return result;
+}
+
+Tensor evalShiftRightArithmeticOp(Tensor lhs, Tensor rhs,
+                                  TensorType resultType) {
+  Tensor result = reuseOrAllocate(resultType, lhs, rhs);
+  if (mapNative<kNativeInteger>(lhs, rhs, result, [](auto x, auto y) {
+        return native::shiftRightArithmetic(x, y);
+      }))
+    return result;
+  for (int64_t i = 0, e = result.getNumElements(); i < e; ++i)
+    result.setAt(i, shiftRightArithmetic(lhs.getAt(i), rhs.getAt(i)));
+  return result;
+}
+
+Tensor evalShiftRightLogicalOp(Tensor lhs, Tensor rhs, TensorType resultType) {
+  Tensor result = reuseOrAllocate(resultType, lhs, rhs);
+  if (mapNative<kNativeInteger>(lhs, rhs, result, [](auto x, auto y) {
+        return native::shiftRightLogical(x, y);
+      }))
+    return result;
+  for (int64_t i = 0, e = result.getNumElements(); i < e; ++i)
+    result.setAt(i, shiftRightLogical(lhs.getAt(i), rhs.getAt(i)));
+  return result;
+}
+
+Tensor evalSignOp(Tensor operand, TensorType resultType) {
+  Tensor result = reuseOrAllocate(resultType, operand);
+  if (mapNative<kNativeNumeric>(operand, result, [](auto x) {
+        return native::sign(x);
+      }))
+    return result;
+  for (int64_t i = 0, e = result.getNumElements(); i < e; ++i)
+    result.setAt(i, sign(operand.getAt(i)));
+  return result;
+}
+
+Tensor evalSineOp(Tensor operand, TensorType resultType) {
+  Tensor result = reuseOrAllocate(resultType, operand);
+  if (mapNativeArray<kNativeFloat>(operand, result, [](auto x, auto y) {
+        native::sine(x, y);
+      }))
+    return result;
+  if (mapNative<kNativeComplex>(operand, result, [](auto x) {
+        return native::sine(x);
+      }))
+    return result;
+  for (int64_t i = 0, e = result.getNumElements(); i < e; ++i)
+    result.setAt(i, sine(operand.getAt(i)));
   return result;
 }
 
 Tensor evalSliceOp(const Tensor &operand, Index startIndices, Sizes strides,
                    TensorType resultType) {
-  Tensor result(resultType);
-  for (auto resultIt = result.index_begin(); resultIt != result.index_end();
-       ++resultIt) {
-    result.set(*resultIt, operand.get(startIndices + *resultIt * strides));
+  // The result is a view of `operand` which starts at `startIndices` and
+  // skips elements according to `strides`.
+  auto operandStrides = operand.getStrides();
+  int64_t resultOffset = operand.getOffset();
+  for (auto [startIndex, operandStride] :
+       llvm::zip(startIndices, operandStrides))
+    resultOffset += startIndex * operandStride;
+  return Tensor(resultType, operand, resultOffset, operandStrides * strides);
+}
+
+SmallVector<Tensor> evalSortOp(ArrayRef<Tensor> inputs, Axis dimension,
+                               Region &comparator, Scope &scope,
+                               ArrayRef<TensorType> resultTypes) {
+  // The inputs are viewed with `dimension` as their minor dimension, so that
+  // every row to sort is a run of consecutive elements of the materialized
+  // views. Every row is sorted into the order of its elements, which is then
+  // applied to all inputs. Sorts are always stable, which also satisfies
+  // `is_stable = false`.
+  int64_t rank = inputs[0].getRank();
+  if (dimension < 0) dimension += rank;
+  Axes permutation;
+  for (int64_t dim = 0; dim < rank; ++dim)
+    if (dim != dimension) permutation.push_back(dim);
+  permutation.push_back(dimension);
+  Sizes viewShape = inputs[0].getShape().permute(permutation);
+  SmallVector<Tensor> views;
+  for (const Tensor &input : inputs)
+    views.push_back(
+        Tensor(RankedTensorType::get(viewShape, input.getElementType()), input,
+               input.getOffset(), input.getStrides().permute(permutation))
+            .materialize());
+
+  int64_t rowSize = viewShape.back();
+  int64_t numRows = rowSize == 0 ? 0 : views[0].getNumElements() / rowSize;
+  SmallVector<int64_t> order(numRows * rowSize);
+  int64_t grainSize = kDefaultGrainSize / std::max<int64_t>(rowSize, 1);
+  if (auto comparison = getSortComparison(comparator)) {
+    // Comparators which compare the first input are applied to sort keys,
+    // which are sorted by radix sort unless the row is small or has NaNs.
+    SortKeys keys = getSortKeys(views[0], *comparison);
+    parallelFor(numRows, grainSize, [&](int64_t begin, int64_t end) {
+      for (int64_t row = begin; row < end; ++row) {
+        MutableArrayRef<int64_t> rowOrder(order.data() + row * rowSize,
+                                          rowSize);
+        std::iota(rowOrder.begin(), rowOrder.end(), 0);
+        ArrayRef<uint64_t> rowKeys(keys.values.data() + row * rowSize,
+                                   rowSize);
+        ArrayRef<bool> rowIsNaN;
+        if (!keys.isNaN.empty())
+          rowIsNaN = ArrayRef<bool>(keys.isNaN.data() + row * rowSize,
+                                    rowSize);
+        bool hasNaN = llvm::is_contained(rowIsNaN, true);
+        if (rowSize >= kMinRadixSortSize && !hasNaN) {
+          radixSort(rowKeys, keys.numBits, rowOrder);
+          continue;
+        }
+        mergeSort(rowOrder, [&](int64_t lhs, int64_t rhs) {
+          return (!hasNaN || (!rowIsNaN[lhs] && !rowIsNaN[rhs])) &&
+                 rowKeys[lhs] < rowKeys[rhs];
+        });
+      }
+    });
+  } else {
+    // Other comparators are evaluated for every comparison. Rows can only be
+    // sorted concurrently if the MLIRContext is thread-safe, since evaluating
+    // the comparator creates types.
+    if (!comparator.getContext()->isMultithreadingEnabled())
+      grainSize = std::max<int64_t>(numRows, 1);
+    parallelFor(numRows, grainSize, [&](int64_t begin, int64_t end) {
+      for (int64_t row = begin; row < end; ++row) {
+        MutableArrayRef<int64_t> rowOrder(order.data() + row * rowSize,
+                                          rowSize);
+        std::iota(rowOrder.begin(), rowOrder.end(), 0);
+        Index lhsIndex(rank);
+        for (int64_t dim = rank - 2, rest = row; dim >= 0; --dim) {
+          lhsIndex[dim] = rest % viewShape[dim];
+          rest /= viewShape[dim];
+        }
+        Index rhsIndex = lhsIndex;
+        mergeSort(rowOrder, [&](int64_t lhs, int64_t rhs) {
+          lhsIndex[rank - 1] = lhs;
+          rhsIndex[rank - 1] = rhs;
+          SmallVector<Tensor> args;
+          for (const Tensor &view : views) {
+            args.push_back(makeScalarTensor(view.get(lhsIndex)));
+            args.push_back(makeScalarTensor(view.get(rhsIndex)));
+          }
+          return eval(comparator, args, &scope)[0].get({}).getBooleanValue();
+        });
+      }
+    });
   }
-  return result;
+
+  Axes inversePermutation(permutation);
+  for (auto [viewDim, dim] : llvm::enumerate(permutation))
+    inversePermutation[dim] = viewDim;
+  SmallVector<Tensor> results;
+  for (auto [view, resultType] : llvm::zip(views, resultTypes)) {
+    Tensor sorted(RankedTensorType::get(viewShape, view.getElementType()));
+    dispatchStorageType(view.getElementType(), [&](auto tag) {
+      using T = decltype(tag);
+      const T *viewData = view.getData<T>().data();
+      T *sortedData = sorted.getMutableData<T>().data();
+      parallelFor(order.size(), kDefaultGrainSize,
+                  [&](int64_t begin, int64_t end) {
+                    for (int64_t i = begin; i < end; ++i)
+                      sortedData[i] = viewData[i - i % rowSize + order[i]];
+                  });
+    });
+    results.emplace_back(resultType, sorted, sorted.getOffset(),
+                         sorted.getStrides().permute(inversePermutation));
+  }
+  return results;
 }
 
-Tensor evalSqrtOp(const Tensor &operand, TensorType resultType) {
-  Tensor result(resultType);
-  for (auto it = result.index_begin(); it != result.index_end(); ++it)
-    result.set(*it, sqrt(operand.get(*it)));
+Tensor evalSqrtOp(Tensor operand, TensorType resultType) {
+  Tensor result = reuseOrAllocate(resultType, operand);
+  if (mapNativeArray<kNativeFloat>(operand, result, [](auto x, auto y) {
+        native::sqrt(x, y);
+      }))
+    return result;
+  if (mapNative<kNativeComplex>(operand, result, [](auto x) {
+        return native::sqrt(x);
+      }))
+    return result;
+  for (int64_t i = 0, e = result.getNumElements(); i < e; ++i)
+    result.setAt(i, sqrt(operand.getAt(i)));
   return result;
 }
 
-Tensor evalSubtractOp(const Tensor &lhs, const Tensor &rhs,
-                      TensorType resultType) {
-  Tensor result(resultType);
-  for (auto it = result.index_begin(); it != result.index_end(); ++it)
-    result.set(*it, lhs.get(*it) - rhs.get(*it));
+Tensor evalSubtractOp(Tensor lhs, Tensor rhs, TensorType resultType) {
+  Tensor result = reuseOrAllocate(resultType, lhs, rhs);
+  if (mapNative<kNativeNumeric>(lhs, rhs, result, [](auto x, auto y) {
+        return native::subtract(x, y);
+      }))
+    return result;
+  for (int64_t i = 0, e = result.getNumElements(); i < e; ++i)
+    result.setAt(i, lhs.getAt(i) - rhs.getAt(i));
   return result;
 }
 
-Tensor evalTanhOp(const Tensor &operand, TensorType resultType) {
-  Tensor result(resultType);
-  for (auto it = result.index_begin(); it != result.index_end(); ++it)
-    result.set(*it, tanh(operand.get(*it)));
+Tensor evalTanhOp(Tensor operand, TensorType resultType) {
+  Tensor result = reuseOrAllocate(resultType, operand);
+  if (mapNativeArray<kNativeFloat>(operand, result, [](auto x, auto y) {
+        native::tanh(x, y);
+      }))
+    return result;
+  if (mapNative<kNativeComplex>(operand, result, [](auto x) {
+        return native::tanh(x);
+      }))
+    return result;
+  for (int64_t i = 0, e = result.getNumElements(); i < e; ++i)
+    result.setAt(i, tanh(operand.getAt(i)));
   return result;
 }
 
 Tensor evalTransposeOp(const Tensor &operand, const Axes &permutation,
                        TensorType resultType) {
-  Tensor result(resultType);
-  for (auto operandIt = operand.index_begin(); operandIt != operand.index_end();
-       ++operandIt) {
-    auto resultIdx = operandIt->permute(permutation);
-    result.set(resultIdx, operand.get(*operandIt));
-  }
-  return result;
+  // The result is a view of `operand` with permuted strides.
+  return Tensor(resultType, operand, operand.getOffset(),
+                operand.getStrides().permute(permutation));
+}
+
+Tensor evalTriangularSolveOp(const Tensor &a, const Tensor &b, bool leftSide,
+                             bool lower, bool unitDiagonal,
+                             Transpose transposeA, TensorType resultType) {
+  Sizes shape = b.getShape();
+  int64_t m = shape[shape.size() - 2];
+  int64_t n = shape.back();
+  int64_t batchSize = m * n == 0 ? 0 : b.getNumElements() / (m * n);
+  return evalInNativePrecision(
+      {a, b}, resultType, [&](auto operands, auto *result) {
+        native::triangularSolve(batchSize, m, n, operands[0], operands[1],
+                                leftSide, lower, unitDiagonal,
+                                transposeA != Transpose::NO_TRANSPOSE,
+                                transposeA == Transpose::ADJOINT, result);
+      });
 }
 
 SmallVector<Tensor> evalWhileOp(ArrayRef<Tensor> operand, Region &cond,
                                 Region &body, Scope &scope) {
-  SmallVector<Tensor> runtimeResults(operand);
+  // `cond` and `body` are evaluated by one scope each for all iterations, so
+  // their captures and hoisted instructions are only evaluated once, see
+  // `PreparedRegion`. `body` is set up before its first iteration, since
+  // hoisted instructions may fail. The runtime values carried from one
+  // iteration to the next are moved into `body`, so that elementwise ops can
+  // update their buffers in place.
+  const PreparedRegion &preparedCond = getPreparedRegion(cond, scope);
+  const PreparedRegion &preparedBody = getPreparedRegion(body, scope);
+  checkNumArguments(preparedCond, operand.size());
+  checkNumArguments(preparedBody, operand.size());
+  Scope condScope(&scope, preparedCond);
+  Scope bodyScope(&scope, preparedBody);
+  initializeSlots(preparedCond, condScope, scope);
+  bool isBodyInitialized = false;
 
-  auto condResults = eval(cond, operand, &scope);
-  if (condResults.size() != 1)
-    llvm::report_fatal_error("Failed to evaluate cond");
-
-  while (condResults[0].get(*condResults[0].index_begin()).getBooleanValue()) {
-    runtimeResults = eval(body, runtimeResults, &scope);
-    condResults = eval(cond, runtimeResults, &scope);
+  SmallVector<Tensor> runtimeResults(operand);
+  while (true) {
+    MutableArrayRef<Tensor> condSlots = condScope.getSlots();
+    for (auto [slot, runtimeResult] : llvm::enumerate(runtimeResults))
+      if (preparedCond.numUsers[slot]) condSlots[slot] = runtimeResult;
+    auto condResults = evalInstructions(preparedCond, condScope, nullptr);
     if (condResults.size() != 1)
       llvm::report_fatal_error("Failed to evaluate cond");
+    if (!condResults[0].get(*condResults[0].index_begin()).getBooleanValue())
+      break;
+
+    if (!isBodyInitialized) {
+      initializeSlots(preparedBody, bodyScope, scope);
+      isBodyInitialized = true;
+    }
+    MutableArrayRef<Tensor> bodySlots = bodyScope.getSlots();
+    for (auto [slot, runtimeResult] : llvm::enumerate(runtimeResults))
+      if (preparedBody.numUsers[slot])
+        bodySlots[slot] = std::move(runtimeResult);
+    runtimeResults = evalInstructions(preparedBody, bodyScope, nullptr);
   }
 
   return runtimeResults;
 }
 
-Tensor evalXorOp(const Tensor &lhs, const Tensor &rhs, TensorType resultType) {
-  Tensor result(resultType);
-  for (auto it = lhs.index_begin(); it != lhs.index_end(); ++it)
-    result.set(*it, lhs.get(*it) ^ rhs.get(*it));
+Tensor evalXorOp(Tensor lhs, Tensor rhs, TensorType resultType) {
+  Tensor result = reuseOrAllocate(resultType, lhs, rhs);
+  if (mapNative<kNativeIntegral>(lhs, rhs, result, [](auto x, auto y) {
+        return native::bitwiseXor(x, y);
+      }))
+    return result;
+  for (int64_t i = 0, e = lhs.getNumElements(); i < e; ++i)
+    result.setAt(i, lhs.getAt(i) ^ rhs.getAt(i));
   return result;
 }
 
+void setPairwiseSummation(bool enabled) {
+  pairwiseSummation.store(enabled, std::memory_order_relaxed);
+}
+
+bool isPairwiseSummationEnabled() {
+  return pairwiseSummation.load(std::memory_order_relaxed);
+}
+
 SmallVector<Tensor> eval(
     Region &region, ArrayRef<Tensor> args, Scope *parent,
     llvm::function_ref<llvm::Error(Operation &, Scope &)> fallback) {
-  Block &block = region.front();
-  if (block.getArguments().size() != args.size())
-    report_fatal_error(invalidArgument(
-        "Expected same number of block arguments and runtime arguments (%d)",
-        args.size()));
-
-  Scope scope(parent);
-  scope.add(block.getArguments(), args);
-
-  for (Operation &op : block) {
-    if (auto absOp = dyn_cast<AbsOp>(op)) {
-      Tensor runtimeOperand = scope.find(absOp.getOperand());
-      Tensor runtimeResult = evalAbsOp(runtimeOperand, absOp.getType());
-      scope.add(op.getResults(), {runtimeResult});
-    } else if (auto addOp = dyn_cast<AddOp>(op)) {
-      Tensor runtimeLhs = scope.find(addOp.getLhs());
-      Tensor runtimeRhs = scope.find(addOp.getRhs());
-      Tensor runtimeResult = evalAddOp(runtimeLhs, runtimeRhs, addOp.getType());
-      scope.add(op.getResults(), {runtimeResult});
-    } else if (auto andOp = dyn_cast<AndOp>(op)) {
-      Tensor runtimeLhs = scope.find(andOp.getLhs());
-      Tensor runtimeRhs = scope.find(andOp.getRhs());
-      Tensor runtimeResult = evalAndOp(runtimeLhs, runtimeRhs, andOp.getType());
-      scope.add(op.getResults(), {runtimeResult});
-    } else if (auto broadcastInDimOp = dyn_cast<BroadcastInDimOp>(op)) {
-      Tensor runtimeOperand = scope.find(broadcastInDimOp.getOperand());
-      auto broadcastDimensions =
-          Axes(broadcastInDimOp.getBroadcastDimensions());
-      Tensor runtimeResult = evalBroadcastInDimOp(
-          runtimeOperand, broadcastDimensions, broadcastInDimOp.getType());
-      scope.add(op.getResults(), {runtimeResult});
-    } else if (auto ceilOp = dyn_cast<CeilOp>(op)) {
-      Tensor runtimeOperand = scope.find(ceilOp.getOperand());
-      Tensor runtimeResult = evalCeilOp(runtimeOperand, ceilOp.getType());
-      scope.add(op.getResults(), {runtimeResult});
-    } else if (auto clampOp = dyn_cast<ClampOp>(op)) {
-      Tensor runtimeMin = scope.find(clampOp.getMin());
-      Tensor runtimeOperand = scope.find(clampOp.getOperand());
-      Tensor runtimeMax = scope.find(clampOp.getMax());
-      Tensor runtimeResult = evalClampOp(runtimeMin, runtimeOperand, runtimeMax,
-                                         clampOp.getType());
-      scope.add(op.getResults(), {runtimeResult});
-    } else if (auto concatenateOp = dyn_cast<ConcatenateOp>(op)) {
-      auto runtimeOperands = scope.find(concatenateOp.getOperands());
-      Tensor runtimeResult =
-          evalConcatenateOp(runtimeOperands, concatenateOp.getDimension(),
-                            concatenateOp.getType());
-      scope.add(op.getResults(), {runtimeResult});
-    } else if (auto constantOp = dyn_cast<ConstantOp>(op)) {
-      Tensor runtimeResult = evalConstantOp(constantOp.getValue());
-      scope.add(op.getResults(), {runtimeResult});
-    } else if (auto convertOp = dyn_cast<ConvertOp>(op)) {
-      Tensor runtimeOperand = scope.find(convertOp.getOperand());
-      Tensor runtimeResult = evalConvertOp(runtimeOperand, convertOp.getType());
-      scope.add(op.getResults(), {runtimeResult});
-    } else if (auto cosineOp = dyn_cast<CosineOp>(op)) {
-      Tensor runtimeOperand = scope.find(cosineOp.getOperand());
-      Tensor runtimeResult = evalCosineOp(runtimeOperand, cosineOp.getType());
-      scope.add(op.getResults(), {runtimeResult});
-    } else if (auto divideOp = dyn_cast<DivOp>(op)) {
-      Tensor runtimeLhs = scope.find(divideOp.getLhs());
-      Tensor runtimeRhs = scope.find(divideOp.getRhs());
-      Tensor runtimeResult =
-          evalDivideOp(runtimeLhs, runtimeRhs, divideOp.getType());
-      scope.add(op.getResults(), {runtimeResult});
-    } else if (auto dynamicSliceOp = dyn_cast<DynamicSliceOp>(op)) {
-      Tensor runtimeOperand = scope.find(dynamicSliceOp.getOperand());
-      SmallVector<Tensor> runtimeStartIndices =
-          scope.find(dynamicSliceOp.getStartIndices());
-      auto runtimeSliceSizes = Sizes(dynamicSliceOp.getSliceSizes());
-      Tensor runtimeResult =
-          evalDynamicSliceOp(runtimeOperand, runtimeStartIndices,
-                             runtimeSliceSizes, dynamicSliceOp.getType());
-      scope.add(op.getResults(), {runtimeResult});
-    } else if (auto dynamicUpdateSliceOp = dyn_cast<DynamicUpdateSliceOp>(op)) {
-      Tensor runtimeOperand = scope.find(dynamicUpdateSliceOp.getOperand());
-      Tensor runtimeUpdate = scope.find(dynamicUpdateSliceOp.getUpdate());
-      SmallVector<Tensor> runtimeStartIndices =
-          scope.find(dynamicUpdateSliceOp.getStartIndices());
-      Tensor runtimeResult = evalDynamicUpdateSliceOp(
-          runtimeOperand, runtimeUpdate, runtimeStartIndices,
-          dynamicUpdateSliceOp.getType());
-      scope.add(op.getResults(), {runtimeResult});
-    } else if (auto expOp = dyn_cast<ExpOp>(op)) {
-      Tensor runtimeOperand = scope.find(expOp.getOperand());
-      Tensor runtimeResult = evalExponentialOp(runtimeOperand, expOp.getType());
-      scope.add(op.getResults(), {runtimeResult});
-    } else if (auto floorOp = dyn_cast<FloorOp>(op)) {
-      Tensor runtimeOperand = scope.find(floorOp.getOperand());
-      Tensor runtimeResult = evalFloorOp(runtimeOperand, floorOp.getType());
-      scope.add(op.getResults(), {runtimeResult});
-    } else if (auto ifOp = dyn_cast<IfOp>(op)) {
-      Tensor runtimePred = scope.find(ifOp.getPred());
-      auto runtimeResults = evalIfOp(runtimePred, ifOp.getTrueBranch(),
-                                     ifOp.getFalseBranch(), scope);
-      scope.add(op.getResults(), runtimeResults);
-    } else if (auto imagOp = dyn_cast<ImagOp>(op)) {
-      Tensor runtimeOperand = scope.find(imagOp.getOperand());
-      Tensor runtimeResult = evalImagOp(runtimeOperand, imagOp.getType());
-      scope.add(op.getResults(), {runtimeResult});
-    } else if (auto iotaOp = dyn_cast<IotaOp>(op)) {
-      Tensor runtimeResult =
-          evalIotaOp(iotaOp.getIotaDimension(), iotaOp.getType());
-      scope.add(op.getResults(), {runtimeResult});
-    } else if (auto logOp = dyn_cast<LogOp>(op)) {
-      Tensor runtimeOperand = scope.find(logOp.getOperand());
-      Tensor runtimeResult = evalLogOp(runtimeOperand, logOp.getType());
-      scope.add(op.getResults(), {runtimeResult});
-    } else if (auto maxOp = dyn_cast<MaxOp>(op)) {
-      Tensor runtimeLhs = scope.find(maxOp.getLhs());
-      Tensor runtimeRhs = scope.find(maxOp.getRhs());
-      Tensor runtimeResult = evalMaxOp(runtimeLhs, runtimeRhs, maxOp.getType());
-      scope.add(op.getResults(), {runtimeResult});
-    } else if (auto minOp = dyn_cast<MinOp>(op)) {
-      Tensor runtimeLhs = scope.find(minOp.getLhs());
-      Tensor runtimeRhs = scope.find(minOp.getRhs());
-      Tensor runtimeResult = evalMinOp(runtimeLhs, runtimeRhs, minOp.getType());
-      scope.add(op.getResults(), {runtimeResult});
-    } else if (auto multiplyOp = dyn_cast<MulOp>(op)) {
-      Tensor runtimeLhs = scope.find(multiplyOp.getLhs());
-      Tensor runtimeRhs = scope.find(multiplyOp.getRhs());
-      Tensor runtimeResult =
-          evalMultiplyOp(runtimeLhs, runtimeRhs, multiplyOp.getType());
-      scope.add(op.getResults(), {runtimeResult});
-    } else if (auto negOp = dyn_cast<NegOp>(op)) {
-      Tensor runtimeOperand = scope.find(negOp.getOperand());
-      Tensor runtimeResult = evalNegOp(runtimeOperand, negOp.getType());
-      scope.add(op.getResults(), {runtimeResult});
-    } else if (auto notOp = dyn_cast<NotOp>(op)) {
-      Tensor runtimeOperand = scope.find(notOp.getOperand());
-      Tensor runtimeResult = evalNotOp(runtimeOperand, notOp.getType());
-      scope.add(op.getResults(), {runtimeResult});
-    } else if (auto orOp = dyn_cast<OrOp>(op)) {
-      Tensor runtimeLhs = scope.find(orOp.getLhs());
-      Tensor runtimeRhs = scope.find(orOp.getRhs());
-      Tensor runtimeResult = evalOrOp(runtimeLhs, runtimeRhs, orOp.getType());
-      scope.add(op.getResults(), {runtimeResult});
-    } else if (auto padOp = dyn_cast<PadOp>(op)) {
-      Tensor runtimeOperand = scope.find(padOp.getOperand());
-      Tensor runtimePaddingValue = scope.find(padOp.getPaddingValue());
-      auto edgePaddingLow = Sizes(padOp.getEdgePaddingLow());
-      auto interiorPadding = Sizes(padOp.getInteriorPadding());
-      Tensor runtimeResult =
-          evalPadOp(runtimeOperand, runtimePaddingValue, edgePaddingLow,
-                    interiorPadding, padOp.getType());
-      scope.add(op.getResults(), {runtimeResult});
-    } else if (auto whileOp = dyn_cast<WhileOp>(op)) {
-      SmallVector<Value> runtimeOperands(whileOp.getOperand().begin(),
-                                         whileOp.getOperand().end());
-      auto runtimeInputs = scope.find(runtimeOperands);
-      auto runtimeResults = evalWhileOp(runtimeInputs, whileOp.getCond(),
-                                        whileOp.getBody(), scope);
-      scope.add(op.getResults(), runtimeResults);
-    } else if (auto realOp = dyn_cast<RealOp>(op)) {
-      Tensor runtimeOperand = scope.find(realOp.getOperand());
-      Tensor runtimeResult = evalRealOp(runtimeOperand, realOp.getType());
-      scope.add(op.getResults(), {runtimeResult});
-    } else if (auto reshapeOp = dyn_cast<ReshapeOp>(op)) {
-      Tensor runtimeOperand = scope.find(reshapeOp.getOperand());
-      Tensor runtimeResult = evalReshapeOp(runtimeOperand, reshapeOp.getType());
-      scope.add(op.getResults(), {runtimeResult});
-    } else if (auto reverseOp = dyn_cast<ReverseOp>(op)) {
-      Tensor runtimeOperand = scope.find(reverseOp.getOperand());
-      auto dimensions = Axes(reverseOp.getDimensions());
-      Tensor runtimeResult =
-          evalReverseOp(runtimeOperand, dimensions, reverseOp.getType());
-      scope.add(op.getResults(), {runtimeResult});
-    } else if (auto returnOp = dyn_cast<func::ReturnOp>(op)) {
-      return scope.find(returnOp.getOperands());
-    } else if (auto returnOp = dyn_cast<ReturnOp>(op)) {
-      return scope.find(returnOp.getResults());
-    } else if (auto selectOp = dyn_cast<SelectOp>(op)) {
-      Tensor runtimeResult = evalSelectOp(
-          scope.find(selectOp.getPred()), scope.find(selectOp.getOnTrue()),
-          scope.find(selectOp.getOnFalse()), selectOp.getType());
-      scope.add(op.getResults(), {runtimeResult});
-    } else if (auto rsqrtOp = dyn_cast<RsqrtOp>(op)) {
-      Tensor runtimeOperand = scope.find(rsqrtOp.getOperand());
-      Tensor runtimeResult = evalRsqrtOp(runtimeOperand, rsqrtOp.getType());
-      scope.add(op.getResults(), {runtimeResult});
-    } else if (auto sineOp = dyn_cast<SineOp>(op)) {
-      Tensor runtimeOperand = scope.find(sineOp.getOperand());
-      Tensor runtimeResult = evalSineOp(runtimeOperand, sineOp.getType());
-      scope.add(op.getResults(), {runtimeResult});
-    } else if (auto sliceOp = dyn_cast<SliceOp>(op)) {
-      Tensor runtimeOperand = scope.find(sliceOp.getOperand());
-      auto startIndices = Sizes(sliceOp.getStartIndices());
-      auto strides = Sizes(sliceOp.getStrides());
-      Tensor runtimeResult =
-          evalSliceOp(runtimeOperand, startIndices, strides, sliceOp.getType());
-      scope.add(op.getResults(), {runtimeResult});
-    } else if (auto sqrtOp = dyn_cast<SqrtOp>(op)) {
-      Tensor runtimeOperand = scope.find(sqrtOp.getOperand());
-      Tensor runtimeResult = evalSqrtOp(runtimeOperand, sqrtOp.getType());
-      scope.add(op.getResults(), {runtimeResult});
-    } else if (auto subtractOp = dyn_cast<SubtractOp>(op)) {
-      Tensor runtimeLhs = scope.find(subtractOp.getLhs());
-      Tensor runtimeRhs = scope.find(subtractOp.getRhs());
-      Tensor runtimeResult =
-          evalSubtractOp(runtimeLhs, runtimeRhs, subtractOp.getType());
-      scope.add(op.getResults(), {runtimeResult});
-    } else if (auto tanhOp = dyn_cast<TanhOp>(op)) {
-      Tensor runtimeOperand = scope.find(tanhOp.getOperand());
-      Tensor runtimeResult = evalTanhOp(runtimeOperand, tanhOp.getType());
-      scope.add(op.getResults(), {runtimeResult});
-    } else if (auto transposeOp = dyn_cast<TransposeOp>(op)) {
-      Tensor runtimeOperand = scope.find(transposeOp.getOperand());
-      auto permutation = Axes(transposeOp.getPermutation());
-      Tensor runtimeResult =
-          evalTransposeOp(runtimeOperand, permutation, transposeOp.getType());
-      scope.add(op.getResults(), {runtimeResult});
-    } else if (auto xorOp = dyn_cast<XorOp>(op)) {
-      Tensor runtimeLhs = scope.find(xorOp.getLhs());
-      Tensor runtimeRhs = scope.find(xorOp.getRhs());
-      Tensor runtimeResult = evalXorOp(runtimeLhs, runtimeRhs, xorOp.getType());
-      scope.add(op.getResults(), {runtimeResult});
-    } else {
-      if (!fallback)
-        report_fatal_error(
-            invalidArgument("Unsupported op: %s", debugString(op).c_str()));
-      auto status = fallback(op, scope);
-      if (status) llvm::report_fatal_error(std::move(status));
-    }
+  // The root scope owns the prepared regions, so that regions are only
+  // prepared once per evaluation. Nested regions, e.g. bodies of while
+  // loops, are prepared together with the region of the parent scope.
+  if (!parent) {
+    Scope root(nullptr);
+    return eval(region, args, &root, fallback);
   }
 
-  llvm::report_fatal_error("Expected a terminator when evaluating a region");
+  const PreparedRegion &prepared = getPreparedRegion(region, *parent);
+  checkNumArguments(prepared, args.size());
+
+  Scope scope(parent, prepared);
+  MutableArrayRef<Tensor> slots = scope.getSlots();
+  for (auto [slot, arg] : llvm::enumerate(args))
+    if (prepared.numUsers[slot]) slots[slot] = arg;
+  initializeSlots(prepared, scope, *parent);
+  return evalInstructions(prepared, scope, fallback);
 }
 
 }  // namespace stablehlo
@@ -16,9 +16,12 @@ limitations under the License.
 #ifndef STABLEHLO_REFERENCE_OPS_H
 #define STABLEHLO_REFERENCE_OPS_H
 
+#include <optional>
+
 #include "mlir/IR/BuiltinAttributes.h"
 #include "stablehlo/dialect/StablehloOps.h"
 #include "stablehlo/reference/Axes.h"
+#include "stablehlo/reference/Process.h"
 #include "stablehlo/reference/Scope.h"
 #include "stablehlo/reference/Sizes.h"
 #include "stablehlo/reference/Tensor.h"
@@ -26,63 +29,157 @@ limitations under the License.
 namespace mlir {
 namespace stablehlo {
 
-// Evaluators for StableHLO ops.
-Tensor evalAbsOp(const Tensor &operand, TensorType resultType);
-Tensor evalAddOp(const Tensor &lhs, const Tensor &rhs, TensorType resultType);
-Tensor evalAndOp(const Tensor &lhs, const Tensor &rhs, TensorType resultType);
+// Evaluators for StableHLO ops. Elementwise evaluators take their operands by
+// value, so that callers can move dead operands in and let the result reuse
+// their storage.
+Tensor evalAbsOp(Tensor operand, TensorType resultType);
+Tensor evalAddOp(Tensor lhs, Tensor rhs, TensorType resultType);
+Tensor evalAllGatherOp(const Tensor &operand, Axis allGatherDim,
+                       ArrayRef<SmallVector<uint32_t>> replicaGroups,
+                       int64_t channelId, bool useGlobalDeviceIds,
+                       Process &process, TensorType resultType);
+Tensor evalAllReduceOp(const Tensor &operand,
+                       ArrayRef<SmallVector<uint32_t>> replicaGroups,
+                       int64_t channelId, bool useGlobalDeviceIds,
+                       Region &computation, Process &process, Scope &scope,
+                       TensorType resultType);
+Tensor evalAllToAllOp(const Tensor &operand, Axis splitDimension,
+                      Axis concatDimension, int64_t splitCount,
+                      ArrayRef<SmallVector<uint32_t>> replicaGroups,
+                      int64_t channelId, Process &process,
+                      TensorType resultType);
+Tensor evalAndOp(Tensor lhs, Tensor rhs, TensorType resultType);
+Tensor evalAtan2Op(Tensor lhs, Tensor rhs, TensorType resultType);
 Tensor evalBroadcastInDimOp(const Tensor &operand, Axes broadcastDimensions,
                             TensorType resultType);
-Tensor evalCeilOp(const Tensor &operand, TensorType resultType);
-Tensor evalClampOp(const Tensor &min, const Tensor &operand, const Tensor &max,
+Tensor evalCbrtOp(Tensor operand, TensorType resultType);
+Tensor evalCeilOp(Tensor operand, TensorType resultType);
+Tensor evalCholeskyOp(const Tensor &a, bool lower, TensorType resultType);
+Tensor evalClampOp(Tensor min, Tensor operand, Tensor max,
                    TensorType resultType);
+Tensor evalCollectivePermuteOp(
+    const Tensor &operand, ArrayRef<SmallVector<uint32_t>> sourceTargetPairs,
+    int64_t channelId, Process &process, TensorType resultType);
+Tensor evalCompareOp(const Tensor &lhs, const Tensor &rhs,
+                     ComparisonDirection comparisonDirection,
+                     std::optional<ComparisonType> compareType,
+                     TensorType resultType);
 Tensor evalConcatenateOp(ArrayRef<Tensor> inputs, Axis dimension,
                          TensorType resultType);
 Tensor evalConstantOp(ElementsAttr value);
 Tensor evalConvertOp(const Tensor &operand, TensorType resultType);
-Tensor evalCosineOp(const Tensor &operand, TensorType resultType);
-Tensor evalDivideOp(const Tensor &lhs, const Tensor &rhs,
-                    TensorType resultType);
+Tensor evalConvolutionOp(
+    const Tensor &lhs, const Tensor &rhs, const Sizes &windowStrides,
+    const Sizes &paddingLow, const Sizes &lhsDilation,
+    const Sizes &rhsDilation, ArrayRef<bool> windowReversal,
+    Axis inputBatchDimension, Axis inputFeatureDimension,
+    const Axes &inputSpatialDimensions, Axis kernelInputFeatureDimension,
+    Axis kernelOutputFeatureDimension, const Axes &kernelSpatialDimensions,
+    Axis outputBatchDimension, Axis outputFeatureDimension,
+    const Axes &outputSpatialDimensions, int64_t featureGroupCount,
+    int64_t batchGroupCount, TensorType resultType);
+Tensor evalCosineOp(Tensor operand, TensorType resultType);
+Tensor evalCountLeadingZerosOp(Tensor operand, TensorType resultType);
+Tensor evalDivideOp(Tensor lhs, Tensor rhs, TensorType resultType);
+Tensor evalDotGeneralOp(const Tensor &lhs, const Tensor &rhs,
+                        const Axes &lhsBatchingDimensions,
+                        const Axes &rhsBatchingDimensions,
+                        const Axes &lhsContractingDimensions,
+                        const Axes &rhsContractingDimensions,
+                        TensorType resultType);
 Tensor evalDynamicSliceOp(const Tensor &operand, ArrayRef<Tensor> startIndices,
                           Sizes sliceSizes, TensorType resultType);
 Tensor evalDynamicUpdateSliceOp(const Tensor &operand, const Tensor &update,
                                 ArrayRef<Tensor> startIndices,
                                 TensorType resultType);
-Tensor evalExponentialOp(const Tensor &operand, TensorType resultType);
-Tensor evalFloorOp(const Tensor &operand, TensorType resultType);
+Tensor evalExponentialOp(Tensor operand, TensorType resultType);
+Tensor evalExponentialMinusOneOp(Tensor operand, TensorType resultType);
+Tensor evalFftOp(const Tensor &operand, FftType fftType,
+                 const Sizes &fftLength, TensorType resultType);
+Tensor evalFloorOp(Tensor operand, TensorType resultType);
+Tensor evalGatherOp(const Tensor &operand, const Tensor &startIndices,
+                    const Axes &offsetDims, const Axes &collapsedSliceDims,
+                    const Axes &startIndexMap, Axis indexVectorDim,
+                    const Sizes &sliceSizes, TensorType resultType);
 SmallVector<Tensor> evalIfOp(const Tensor &pred, Region &trueBranch,
                              Region &falseBranch, Scope &scope);
 Tensor evalImagOp(const Tensor &operand, TensorType resultType);
 Tensor evalIotaOp(Axis iotaDimension, TensorType resultType);
-Tensor evalLogOp(const Tensor &operand, TensorType resultType);
-Tensor evalMaxOp(const Tensor &lhs, const Tensor &rhs, TensorType resultType);
-Tensor evalMinOp(const Tensor &lhs, const Tensor &rhs, TensorType resultType);
-Tensor evalMultiplyOp(const Tensor &lhs, const Tensor &rhs,
-                      TensorType resultType);
-Tensor evalNegOp(const Tensor &operand, TensorType resultType);
-Tensor evalNotOp(const Tensor &operand, TensorType resultType);
-Tensor evalOrOp(const Tensor &lhs, const Tensor &rhs, TensorType resultType);
+Tensor evalLogOp(Tensor operand, TensorType resultType);
+Tensor evalLogPlusOneOp(Tensor operand, TensorType resultType);
+Tensor evalLogisticOp(Tensor operand, TensorType resultType);
+Tensor evalMaxOp(Tensor lhs, Tensor rhs, TensorType resultType);
+Tensor evalMinOp(Tensor lhs, Tensor rhs, TensorType resultType);
+Tensor evalMultiplyOp(Tensor lhs, Tensor rhs, TensorType resultType);
+Tensor evalNegOp(Tensor operand, TensorType resultType);
+Tensor evalNotOp(Tensor operand, TensorType resultType);
+Tensor evalOrOp(Tensor lhs, Tensor rhs, TensorType resultType);
 Tensor evalPadOp(const Tensor &operand, const Tensor &paddingValue,
                  Sizes edgePaddingLow, Sizes interiorPadding,
                  TensorType resultType);
+Tensor evalPartitionIdOp(const Process &process, TensorType resultType);
+Tensor evalPopcntOp(Tensor operand, TensorType resultType);
+Tensor evalPowerOp(Tensor lhs, Tensor rhs, TensorType resultType);
 Tensor evalRealOp(const Tensor &operand, TensorType resultType);
+SmallVector<Tensor> evalReduceOp(ArrayRef<Tensor> inputs,
+                                 ArrayRef<Tensor> initValues,
+                                 const Axes &dimensions, Region &body,
+                                 Scope &scope,
+                                 ArrayRef<TensorType> resultTypes);
+Tensor evalReduceScatterOp(const Tensor &operand, Axis scatterDimension,
+                           ArrayRef<SmallVector<uint32_t>> replicaGroups,
+                           int64_t channelId, bool useGlobalDeviceIds,
+                           Region &computation, Process &process,
+                           Scope &scope, TensorType resultType);
+SmallVector<Tensor> evalReduceWindowOp(
+    ArrayRef<Tensor> inputs, ArrayRef<Tensor> initValues,
+    const Sizes &windowDimensions, const Sizes &windowStrides,
+    const Sizes &baseDilations, const Sizes &windowDilations,
+    const Sizes &paddingLow, const Sizes &paddingHigh, Region &body,
+    Scope &scope, ArrayRef<TensorType> resultTypes);
+Tensor evalRemainderOp(Tensor lhs, Tensor rhs, TensorType resultType);
+Tensor evalReplicaIdOp(const Process &process, TensorType resultType);
 Tensor evalReshapeOp(const Tensor &operand, TensorType resultType);
 Tensor evalReverseOp(const Tensor &operand, Axes dimensions,
                      TensorType resultType);
-Tensor evalRsqrtOp(const Tensor &operand, TensorType resultType);
-Tensor evalSelectOp(const Tensor &pred, const Tensor &onTrue,
-                    const Tensor &onFalse, TensorType resultType);
-Tensor evalSineOp(const Tensor &operand, TensorType resultType);
+SmallVector<Tensor> evalRngBitGeneratorOp(RngAlgorithm rngAlgorithm,
+                                          const Tensor &initialState,
+                                          TensorType outputStateType,
+                                          TensorType outputType);
+Tensor evalRngOp(const Tensor &a, const Tensor &b,
+                 RngDistribution rngDistribution, Scope &scope,
+                 TensorType resultType);
+Tensor evalRsqrtOp(Tensor operand, TensorType resultType);
+SmallVector<Tensor> evalScatterOp(
+    ArrayRef<Tensor> inputs, const Tensor &scatterIndices,
+    ArrayRef<Tensor> updates, const Axes &updateWindowDims,
+    const Axes &insertedWindowDims, const Axes &scatterDimsToOperandDims,
+    Axis indexVectorDim, Region &updateComputation, Scope &scope,
+    ArrayRef<TensorType> resultTypes);
+Tensor evalSelectOp(const Tensor &pred, Tensor onTrue, Tensor onFalse,
+                    TensorType resultType);
+Tensor evalShiftLeftOp(Tensor lhs, Tensor rhs, TensorType resultType);
+Tensor evalShiftRightArithmeticOp(Tensor lhs, Tensor rhs,
+                                  TensorType resultType);
+Tensor evalShiftRightLogicalOp(Tensor lhs, Tensor rhs, TensorType resultType);
+Tensor evalSignOp(Tensor operand, TensorType resultType);
+Tensor evalSineOp(Tensor operand, TensorType resultType);
 Tensor evalSliceOp(const Tensor &operand, Index startIndices, Sizes strides,
                    TensorType resultType);
-Tensor evalSqrtOp(const Tensor &operand, TensorType resultType);
-Tensor evalSubtractOp(const Tensor &lhs, const Tensor &rhs,
-                      TensorType resultType);
-Tensor evalTanhOp(const Tensor &operand, TensorType resultType);
+SmallVector<Tensor> evalSortOp(ArrayRef<Tensor> inputs, Axis dimension,
+                               Region &comparator, Scope &scope,
+                               ArrayRef<TensorType> resultTypes);
+Tensor evalSqrtOp(Tensor operand, TensorType resultType);
+Tensor evalSubtractOp(Tensor lhs, Tensor rhs, TensorType resultType);
+Tensor evalTanhOp(Tensor operand, TensorType resultType);
 Tensor evalTransposeOp(const Tensor &operand, const Axes &permutation,
                        TensorType resultType);
+Tensor evalTriangularSolveOp(const Tensor &a, const Tensor &b, bool leftSide,
+                             bool lower, bool unitDiagonal,
+                             Transpose transposeA, TensorType resultType);
 SmallVector<Tensor> evalWhileOp(ArrayRef<Tensor> operand, Region &cond,
                                 Region &body, Scope &scope);
-Tensor evalXorOp(const Tensor &lhs, const Tensor &rhs, TensorType resultType);
+Tensor evalXorOp(Tensor lhs, Tensor rhs, TensorType resultType);
 
 /// Evaluates an mlir::Region `region` using the runtime values `args`
 /// corresponding to the arguments of the entry block of the region.
@@ -94,6 +191,20 @@ llvm::SmallVector<Tensor> eval(
     Region &region, llvm::ArrayRef<Tensor> args, Scope *parent = nullptr,
     llvm::function_ref<llvm::Error(Operation &, Scope &)> fallback = nullptr);
 
+/// Enables or disables pairwise summation in `reduce` and `reduce_window` ops
+/// whose body is a single `add` of floating-point or complex elements. Such
+/// reductions are evaluated without evaluating the body. By default, the
+/// elements are added up one after the other, which gives the same results
+/// as evaluating the body, but the rounding error grows linearly with the
+/// number of elements. Pairwise summation adds up halves of the elements
+/// recursively, so the error only grows logarithmically, and the additions
+/// vectorize. Can be called while evaluating, in which case reductions which
+/// have already started are unaffected.
+void setPairwiseSummation(bool enabled);
+
+/// Returns true if reductions use pairwise summation.
+bool isPairwiseSummationEnabled();
+
 }  // namespace stablehlo
 }  // namespace mlir
 
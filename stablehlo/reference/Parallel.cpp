@@ -0,0 +1,93 @@
+/* Copyright 2023 The StableHLO Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "stablehlo/reference/Parallel.h"
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+
+#include "llvm/Support/Threading.h"
+#include "llvm/Support/ThreadPool.h"
+
+namespace mlir {
+namespace stablehlo {
+namespace {
+
+unsigned numThreads = 1;
+bool interOpParallelism = false;
+
+// Runs all but the first range of every `parallelFor`. The calling thread
+// takes the first range, so the pool has one thread less than `numThreads`.
+std::unique_ptr<llvm::ThreadPool> threadPool;
+
+}  // namespace
+
+void setNumThreads(unsigned newNumThreads) {
+  if (newNumThreads == 0)
+    newNumThreads = llvm::hardware_concurrency().compute_thread_count();
+  numThreads = std::max(newNumThreads, 1u);
+  threadPool.reset();
+  if (numThreads > 1)
+    threadPool = std::make_unique<llvm::ThreadPool>(
+        llvm::hardware_concurrency(numThreads - 1));
+}
+
+unsigned getNumThreads() { return numThreads; }
+
+void setInterOpParallelism(bool enabled) { interOpParallelism = enabled; }
+
+bool isInterOpParallelismEnabled() { return interOpParallelism; }
+
+TaskGroup::TaskGroup() {
+  if (threadPool)
+    group_ = std::make_unique<llvm::ThreadPoolTaskGroup>(*threadPool);
+}
+
+TaskGroup::~TaskGroup() { wait(); }
+
+void TaskGroup::async(std::function<void()> task) {
+  if (!group_) return task();
+  group_->async(std::move(task));
+}
+
+void TaskGroup::wait() {
+  if (group_) group_->wait();
+}
+
+void parallelFor(int64_t size, int64_t grainSize,
+                 llvm::function_ref<void(int64_t begin, int64_t end)> fn) {
+  if (size <= 0) return;
+  grainSize = std::max<int64_t>(grainSize, 1);
+  int64_t numGrains = (size + grainSize - 1) / grainSize;
+  int64_t numRanges = std::min<int64_t>(numThreads, numGrains);
+  if (!threadPool || numRanges <= 1) return fn(0, size);
+
+  // Range `i` consists of grains `[numGrains * i / numRanges,
+  // numGrains * (i + 1) / numRanges)`.
+  auto getBoundary = [&](int64_t i) {
+    return std::min(size, numGrains * i / numRanges * grainSize);
+  };
+  TaskGroup group;
+  for (int64_t i = 1; i < numRanges; ++i)
+    group.async([fn, begin = getBoundary(i), end = getBoundary(i + 1)] {
+      fn(begin, end);
+    });
+  fn(0, getBoundary(1));
+  group.wait();
+}
+
+}  // namespace stablehlo
+}  // namespace mlir
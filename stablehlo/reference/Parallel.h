@@ -0,0 +1,85 @@
+/* Copyright 2023 The StableHLO Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef STABLEHLO_REFERENCE_PARALLEL_H
+#define STABLEHLO_REFERENCE_PARALLEL_H
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+#include "llvm/ADT/STLFunctionalExtras.h"
+
+namespace llvm {
+class ThreadPoolTaskGroup;
+}  // namespace llvm
+
+namespace mlir {
+namespace stablehlo {
+
+/// Number of elements below which kernels that do a small amount of work per
+/// element aren't worth splitting across threads.
+constexpr int64_t kDefaultGrainSize = 16384;
+
+/// Sets the number of threads which interpreter kernels may use, where 0
+/// stands for one thread per hardware thread. The default is 1, i.e. all
+/// kernels run on the calling thread. Must not be called while evaluating.
+void setNumThreads(unsigned numThreads);
+
+/// Returns the number of threads which interpreter kernels may use.
+unsigned getNumThreads();
+
+/// Enables or disables evaluating independent ops of a region concurrently,
+/// see `eval`. Only has an effect if `getNumThreads()` is greater than 1.
+/// Disabled by default. Must not be called while evaluating.
+void setInterOpParallelism(bool enabled);
+
+/// Returns true if independent ops of a region may be evaluated concurrently.
+bool isInterOpParallelismEnabled();
+
+/// A group of tasks which run on the thread pool of the interpreter. Tasks
+/// may add more tasks to the group. If `getNumThreads()` is 1, tasks run
+/// immediately on the calling thread.
+class TaskGroup {
+ public:
+  TaskGroup();
+  ~TaskGroup();
+
+  /// Schedules `task` to run on the thread pool.
+  void async(std::function<void()> task);
+
+  /// Waits until all tasks of the group, including tasks added by other
+  /// tasks, are done. If called from a task of the thread pool, runs tasks
+  /// while waiting, so groups can be nested.
+  void wait();
+
+ private:
+  std::unique_ptr<llvm::ThreadPoolTaskGroup> group_;
+};
+
+/// Calls `fn(begin, end)` for disjoint, contiguous ranges which together
+/// cover `[0, size)`, running the calls on up to `getNumThreads()` threads,
+/// and returns once all of them are done. All ranges except the last one
+/// have a length which is a multiple of `grainSize`, and ranges only depend
+/// on `size`, `grainSize` and `getNumThreads()`. Kernels which compute every
+/// output element independently are thus bit-identical to the serial path.
+/// Calls can be nested, e.g. `fn` may call `parallelFor` again.
+void parallelFor(int64_t size, int64_t grainSize,
+                 llvm::function_ref<void(int64_t begin, int64_t end)> fn);
+
+}  // namespace stablehlo
+}  // namespace mlir
+
+#endif  // STABLEHLO_REFERENCE_PARALLEL_H
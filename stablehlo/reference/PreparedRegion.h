@@ -0,0 +1,140 @@
+/* Copyright 2023 The StableHLO Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef STABLEHLO_REFERENCE_PREPAREDREGION_H
+#define STABLEHLO_REFERENCE_PREPAREDREGION_H
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallVector.h"
+#include "mlir/IR/Operation.h"
+#include "mlir/IR/Region.h"
+#include "mlir/IR/Value.h"
+#include "stablehlo/reference/Tensor.h"
+
+namespace mlir {
+namespace stablehlo {
+
+class Scope;
+
+/// An op of a `PreparedRegion`, decoded once so that evaluating it doesn't
+/// involve dispatching on the op kind or extracting attributes.
+struct Instruction {
+  /// Evaluates the op given the runtime values of its operands and returns
+  /// the runtime values of its results. Attributes are captured by the
+  /// kernel when it is created. Operands which die at this instruction are
+  /// moved into `operands`, so the kernel may move them further, e.g. into
+  /// elementwise evaluators. `scope` is the scope of the enclosing block and
+  /// is used for evaluating nested regions.
+  using Kernel = std::function<SmallVector<Tensor>(
+      MutableArrayRef<Tensor> operands, Scope &scope)>;
+
+  /// The op this instruction was prepared from.
+  Operation *op = nullptr;
+
+  /// The kernel of the op. Null for terminators and for ops which the
+  /// interpreter doesn't support, which are evaluated by the fallback.
+  Kernel kernel;
+
+  /// True if the op returns `operandSlots` from the region.
+  bool isTerminator = false;
+
+  /// Slots holding the operands and receiving the results of the op.
+  SmallVector<int64_t> operandSlots;
+  SmallVector<int64_t> resultSlots;
+
+  /// For each operand, whether its slot may be moved from rather than copied
+  /// when passing it to `kernel`, provided that this is its last user.
+  SmallVector<bool> movableOperands;
+
+  /// Slots of the values defined in the region which the op uses, directly
+  /// or within its regions, without duplicates.
+  SmallVector<int64_t> usedSlots;
+
+  /// Indices of the instructions which have to wait for this one, i.e. which
+  /// use its results or are ordered after it for other reasons, and the
+  /// number of instructions this one has to wait for. The terminator is not
+  /// included, since it always runs last.
+  SmallVector<int64_t> successors;
+  int64_t numPredecessors = 0;
+};
+
+/// An SSA value defined outside a `PreparedRegion` and used by its ops or
+/// within their regions.
+struct Capture {
+  Value value;
+
+  /// Slot of the value in the region.
+  int64_t slot;
+
+  /// Slot of the value in the enclosing region if the region was prepared
+  /// together with the enclosing region, and -1 otherwise.
+  int64_t parentSlot;
+};
+
+/// A region lowered into a flat array of instructions. Runtime values of the
+/// region live in numbered slots of the `Scope` evaluating it, so that
+/// instructions can access their operands by index rather than by looking
+/// up SSA values. Slots are numbered as follows: block arguments first, then
+/// op results and captures in the order in which the ops of the block define
+/// or use them.
+///
+/// Values which nested regions capture from further out are captured by the
+/// enclosing regions on the way, so every capture of a nested region has a
+/// slot in its enclosing region. Nested regions are prepared together with
+/// the region and refer to these slots, so evaluating them neither looks up
+/// their prepared form nor their captures by hashing.
+struct PreparedRegion {
+  /// The entry block of the region. Regions have only one block.
+  Block *block = nullptr;
+
+  /// Slots of all SSA values of the region, including captures.
+  llvm::DenseMap<Value, int64_t> slots;
+
+  /// Captured SSA values, whose slots are filled from the parent scope
+  /// whenever the region is evaluated.
+  SmallVector<Capture> captures;
+
+  /// Ops of the body or the condition of a while loop which compute the same
+  /// results in every iteration, i.e. ops without side effects and regions
+  /// whose operands are captures or results of other hoisted ops. They are
+  /// evaluated in block order before the other ops, once per evaluation of
+  /// the loop rather than once per iteration, and are not included in
+  /// `instructions`.
+  std::vector<Instruction> hoistedInstructions;
+
+  /// The other ops of the region in block order.
+  std::vector<Instruction> instructions;
+
+  /// For each slot, the number of instructions whose `usedSlots` contain the
+  /// slot. Runtime values are released once all of their users are
+  /// done. Captures and results of hoisted instructions are never released,
+  /// since they don't appear in `usedSlots`.
+  SmallVector<int64_t> numUsers;
+
+  /// The prepared forms of the regions of the ops of the region.
+  llvm::DenseMap<Region *, std::unique_ptr<PreparedRegion>> regions;
+};
+
+}  // namespace stablehlo
+}  // namespace mlir
+
+#endif  // STABLEHLO_REFERENCE_PREPAREDREGION_H
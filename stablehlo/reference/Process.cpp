@@ -0,0 +1,147 @@
+/* Copyright 2023 The StableHLO Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "stablehlo/reference/Process.h"
+
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/Support/ErrorHandling.h"
+#include "stablehlo/reference/Errors.h"
+
+namespace mlir {
+namespace stablehlo {
+namespace {
+
+// Returns `groups`, or a single group of all ids in `[0, numIds)` if `groups`
+// is empty. Ids must be smaller than `numIds`.
+SmallVector<SmallVector<uint32_t>> getGroups(
+    ArrayRef<SmallVector<uint32_t>> groups, uint32_t numIds,
+    const char *idName) {
+  if (groups.empty()) {
+    SmallVector<uint32_t> group(numIds);
+    for (uint32_t id = 0; id < numIds; ++id) group[id] = id;
+    return {group};
+  }
+  for (const auto &group : groups)
+    for (uint32_t id : group)
+      if (id >= numIds)
+        llvm::report_fatal_error(invalidArgument(
+            "Expected %s to be less than %d, but got %d", idName, numIds, id));
+  return SmallVector<SmallVector<uint32_t>>(groups.begin(), groups.end());
+}
+
+}  // namespace
+
+ProcessGrid::ProcessGrid(uint32_t numReplicas, uint32_t numPartitions)
+    : numReplicas_(numReplicas), numPartitions_(numPartitions) {
+  if (numReplicas == 0 || numPartitions == 0)
+    llvm::report_fatal_error(invalidArgument(
+        "Expected a non-empty process grid, but got %d replicas and %d "
+        "partitions",
+        numReplicas, numPartitions));
+}
+
+SmallVector<ProcessGroup> ProcessGrid::crossReplica(
+    ArrayRef<SmallVector<uint32_t>> replicaGroups) const {
+  SmallVector<ProcessGroup> processGroups;
+  for (const auto &replicaGroup :
+       getGroups(replicaGroups, numReplicas_, "replica ids")) {
+    for (uint32_t partitionId = 0; partitionId < numPartitions_;
+         ++partitionId) {
+      ProcessGroup &processGroup = processGroups.emplace_back();
+      for (uint32_t replicaId : replicaGroup)
+        processGroup.push_back({replicaId, partitionId});
+    }
+  }
+  return processGroups;
+}
+
+SmallVector<ProcessGroup> ProcessGrid::crossPartition(
+    ArrayRef<SmallVector<uint32_t>> partitionGroups) const {
+  SmallVector<ProcessGroup> processGroups;
+  for (const auto &partitionGroup :
+       getGroups(partitionGroups, numPartitions_, "partition ids")) {
+    for (uint32_t replicaId = 0; replicaId < numReplicas_; ++replicaId) {
+      ProcessGroup &processGroup = processGroups.emplace_back();
+      for (uint32_t partitionId : partitionGroup)
+        processGroup.push_back({replicaId, partitionId});
+    }
+  }
+  return processGroups;
+}
+
+SmallVector<ProcessGroup> ProcessGrid::crossReplicaAndPartition(
+    ArrayRef<SmallVector<uint32_t>> replicaGroups) const {
+  SmallVector<ProcessGroup> processGroups;
+  for (const auto &replicaGroup :
+       getGroups(replicaGroups, numReplicas_, "replica ids")) {
+    ProcessGroup &processGroup = processGroups.emplace_back();
+    for (uint32_t partitionId = 0; partitionId < numPartitions_; ++partitionId)
+      for (uint32_t replicaId : replicaGroup)
+        processGroup.push_back({replicaId, partitionId});
+  }
+  return processGroups;
+}
+
+SmallVector<ProcessGroup> ProcessGrid::flattenedIds(
+    ArrayRef<SmallVector<uint32_t>> flattenedIdGroups) const {
+  SmallVector<ProcessGroup> processGroups;
+  for (const auto &flattenedIdGroup :
+       getGroups(flattenedIdGroups, getNumProcesses(), "flattened ids")) {
+    ProcessGroup &processGroup = processGroups.emplace_back();
+    for (uint32_t flattenedId : flattenedIdGroup)
+      processGroup.push_back(
+          {flattenedId / numPartitions_, flattenedId % numPartitions_});
+  }
+  return processGroups;
+}
+
+SmallVector<Tensor> ProcessGrid::rendezvous(const ProcessGroup &processGroup,
+                                            ProcessId processId,
+                                            uint64_t sequenceNumber,
+                                            Tensor value) {
+  auto it = llvm::find(processGroup, processId);
+  if (it == processGroup.end())
+    llvm::report_fatal_error(invalidArgument(
+        "Process (%d, %d) is not a member of its process group",
+        processId.replicaId, processId.partitionId));
+  if (processGroup.size() == 1) return {std::move(value)};
+
+  const ProcessId &first = processGroup.front();
+  std::pair<uint64_t, uint32_t> key(
+      sequenceNumber, first.replicaId * numPartitions_ + first.partitionId);
+  std::unique_lock<std::mutex> lock(mutex_);
+  Rendezvous &rendezvous = rendezvous_[key];
+  if (rendezvous.values.empty()) rendezvous.values.resize(processGroup.size());
+  rendezvous.values[it - processGroup.begin()] = std::move(value);
+  if (++rendezvous.numArrived == processGroup.size())
+    rendezvous.arrived.notify_all();
+  else
+    rendezvous.arrived.wait(lock, [&] {
+      return rendezvous.numArrived == processGroup.size();
+    });
+
+  SmallVector<Tensor> values = rendezvous.values;
+  if (++rendezvous.numDeparted == processGroup.size()) rendezvous_.erase(key);
+  return values;
+}
+
+SmallVector<Tensor> Process::rendezvous(const ProcessGroup &processGroup,
+                                        Tensor value) {
+  return grid_->rendezvous(processGroup, id_, numRendezvous_++,
+                           std::move(value));
+}
+
+}  // namespace stablehlo
+}  // namespace mlir
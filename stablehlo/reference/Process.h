@@ -0,0 +1,133 @@
+/* Copyright 2023 The StableHLO Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef STABLEHLO_REFERENCE_PROCESS_H
+#define STABLEHLO_REFERENCE_PROCESS_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <utility>
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/SmallVector.h"
+#include "stablehlo/reference/Tensor.h"
+
+namespace mlir {
+namespace stablehlo {
+
+/// Identifies a process of the StableHLO process grid.
+struct ProcessId {
+  uint32_t replicaId;
+  uint32_t partitionId;
+
+  bool operator==(const ProcessId &other) const {
+    return replicaId == other.replicaId && partitionId == other.partitionId;
+  }
+  bool operator!=(const ProcessId &other) const { return !(*this == other); }
+};
+
+/// The processes which take part in a collective op together, in the order
+/// in which their values are combined.
+using ProcessGroup = SmallVector<ProcessId>;
+
+/// The StableHLO process grid, i.e. `numReplicas * numPartitions` processes
+/// which evaluate the same program. Every process is evaluated by its own
+/// thread, and collective ops exchange runtime values through shared memory:
+/// the processes of a group meet at a rendezvous, where every process
+/// contributes a tensor and receives the tensors of all other processes
+/// without copying them.
+class ProcessGrid {
+ public:
+  ProcessGrid(uint32_t numReplicas, uint32_t numPartitions);
+
+  ProcessGrid(const ProcessGrid &) = delete;
+  ProcessGrid &operator=(const ProcessGrid &) = delete;
+
+  uint32_t getNumReplicas() const { return numReplicas_; }
+  uint32_t getNumPartitions() const { return numPartitions_; }
+  uint32_t getNumProcesses() const { return numReplicas_ * numPartitions_; }
+
+  /// \name Process grouping strategies
+  /// Split the process grid into process groups as described by the
+  /// strategies of the same name in the spec. `groups` are lists of replica
+  /// ids, partition ids and flattened process ids respectively, and an empty
+  /// list of groups stands for a single group with all ids in order.
+  /// @{
+  SmallVector<ProcessGroup> crossReplica(
+      ArrayRef<SmallVector<uint32_t>> replicaGroups) const;
+  SmallVector<ProcessGroup> crossPartition(
+      ArrayRef<SmallVector<uint32_t>> partitionGroups) const;
+  SmallVector<ProcessGroup> crossReplicaAndPartition(
+      ArrayRef<SmallVector<uint32_t>> replicaGroups) const;
+  SmallVector<ProcessGroup> flattenedIds(
+      ArrayRef<SmallVector<uint32_t>> flattenedIdGroups) const;
+  /// @}
+
+  /// Contributes `value` of the process `processId` to the rendezvous number
+  /// `sequenceNumber` of `processGroup`, blocks until every process of
+  /// `processGroup` contributed to it, and returns the contributions in the
+  /// order of `processGroup`. The returned tensors share their storage with
+  /// the contributions, so they must not be written to. Thread-safe.
+  SmallVector<Tensor> rendezvous(const ProcessGroup &processGroup,
+                                 ProcessId processId, uint64_t sequenceNumber,
+                                 Tensor value);
+
+ private:
+  struct Rendezvous {
+    SmallVector<Tensor> values;
+    size_t numArrived = 0;
+    size_t numDeparted = 0;
+    std::condition_variable arrived;
+  };
+
+  uint32_t numReplicas_;
+  uint32_t numPartitions_;
+
+  /// Pending rendezvous, keyed by their sequence number and the flattened id
+  /// of the first process of their group.
+  std::mutex mutex_;
+  std::map<std::pair<uint64_t, uint32_t>, Rendezvous> rendezvous_;
+};
+
+/// A process of a `ProcessGrid`. The interpreter finds the process which
+/// evaluates a program through the root `Scope` of the evaluation.
+class Process {
+ public:
+  Process(ProcessId id, ProcessGrid &grid) : id_(id), grid_(&grid) {}
+
+  ProcessId getId() const { return id_; }
+  ProcessGrid &getGrid() const { return *grid_; }
+
+  /// Exchanges `value` with the other processes of `processGroup`, see
+  /// `ProcessGrid::rendezvous`. Rendezvous are matched by counting them, so
+  /// all processes of a group must take part in the same rendezvous in the
+  /// same order, which holds for collective ops of SPMD programs whose ops
+  /// are evaluated one after the other.
+  SmallVector<Tensor> rendezvous(const ProcessGroup &processGroup,
+                                 Tensor value);
+
+ private:
+  ProcessId id_;
+  ProcessGrid *grid_;
+  std::atomic<uint64_t> numRendezvous_ = 0;
+};
+
+}  // namespace stablehlo
+}  // namespace mlir
+
+#endif  // STABLEHLO_REFERENCE_PROCESS_H
@@ -0,0 +1,158 @@
+/* Copyright 2023 The StableHLO Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "stablehlo/reference/Random.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+#include "llvm/Support/ErrorHandling.h"
+#include "stablehlo/reference/Parallel.h"
+
+namespace mlir {
+namespace stablehlo {
+namespace native {
+namespace {
+
+uint32_t rotateLeft(uint32_t value, int amount) {
+  return (value << amount) | (value >> (32 - amount));
+}
+
+std::array<uint32_t, 2> splitWords(uint64_t value) {
+  return {static_cast<uint32_t>(value), static_cast<uint32_t>(value >> 32)};
+}
+
+// Returns element `i` of `T` of `block`, counting from its least significant
+// bits.
+template <typename T, size_t N>
+T getElement(const std::array<uint32_t, N> &block, int64_t i) {
+  if constexpr (sizeof(T) == 8) {
+    return static_cast<uint64_t>(block[2 * i]) |
+           static_cast<uint64_t>(block[2 * i + 1]) << 32;
+  } else {
+    constexpr int64_t kElementsPerWord = 4 / sizeof(T);
+    return static_cast<T>(block[i / kElementsPerWord] >>
+                          (i % kElementsPerWord * sizeof(T) * 8));
+  }
+}
+
+// Fills `result` with the elements of the blocks returned by
+// `blockFn(blockIndex)`.
+template <typename T, size_t N, typename BlockFn>
+void fillFromBlocks(MutableArrayRef<T> result, BlockFn blockFn) {
+  constexpr int64_t kElementsPerBlock = N * 4 / sizeof(T);
+  int64_t size = result.size();
+  int64_t numBlocks = (size + kElementsPerBlock - 1) / kElementsPerBlock;
+  parallelFor(numBlocks, kDefaultGrainSize / kElementsPerBlock,
+              [&](int64_t begin, int64_t end) {
+                for (int64_t j = begin; j < end; ++j) {
+                  std::array<uint32_t, N> block = blockFn(j);
+                  int64_t first = j * kElementsPerBlock;
+                  int64_t count = std::min(kElementsPerBlock, size - first);
+                  for (int64_t i = 0; i < count; ++i)
+                    result[first + i] = getElement<T>(block, i);
+                }
+              });
+}
+
+}  // namespace
+
+std::array<uint32_t, 2> threeFry2x32(std::array<uint32_t, 2> counter,
+                                     std::array<uint32_t, 2> key) {
+  constexpr int kRotations[2][4] = {{13, 15, 26, 6}, {17, 29, 16, 24}};
+  // 0x1BD11BDA is the parity constant of Threefry.
+  std::array<uint32_t, 3> keySchedule = {key[0], key[1],
+                                         0x1BD11BDA ^ key[0] ^ key[1]};
+  uint32_t x0 = counter[0] + keySchedule[0];
+  uint32_t x1 = counter[1] + keySchedule[1];
+  // Five groups of four rounds, each followed by a key injection.
+  for (uint32_t group = 0; group < 5; ++group) {
+    for (int rotation : kRotations[group % 2]) {
+      x0 += x1;
+      x1 = rotateLeft(x1, rotation) ^ x0;
+    }
+    x0 += keySchedule[(group + 1) % 3];
+    x1 += keySchedule[(group + 2) % 3] + group + 1;
+  }
+  return {x0, x1};
+}
+
+std::array<uint32_t, 4> philox4x32(std::array<uint32_t, 4> counter,
+                                   std::array<uint32_t, 2> key) {
+  constexpr uint64_t kMultiplier0 = 0xD2511F53;
+  constexpr uint64_t kMultiplier1 = 0xCD9E8D57;
+  constexpr uint32_t kWeyl0 = 0x9E3779B9;
+  constexpr uint32_t kWeyl1 = 0xBB67AE85;
+  for (int round = 0; round < 10; ++round) {
+    uint64_t product0 = kMultiplier0 * counter[0];
+    uint64_t product1 = kMultiplier1 * counter[2];
+    counter = {static_cast<uint32_t>(product1 >> 32) ^ counter[1] ^ key[0],
+               static_cast<uint32_t>(product1),
+               static_cast<uint32_t>(product0 >> 32) ^ counter[3] ^ key[1],
+               static_cast<uint32_t>(product0)};
+    key[0] += kWeyl0;
+    key[1] += kWeyl1;
+  }
+  return counter;
+}
+
+template <typename T>
+RandomCounter generateRandomBits(RandomAlgorithm algorithm, uint64_t key,
+                                 RandomCounter counter,
+                                 MutableArrayRef<T> result) {
+  std::array<uint32_t, 2> keyWords = splitWords(key);
+  int64_t bytes = static_cast<int64_t>(result.size() * sizeof(T));
+  switch (algorithm) {
+    case RandomAlgorithm::kThreeFry: {
+      fillFromBlocks<T, 2>(result, [&](int64_t j) {
+        return threeFry2x32(splitWords(counter[0] + j), keyWords);
+      });
+      return {counter[0] + (bytes + 7) / 8, counter[1]};
+    }
+    case RandomAlgorithm::kPhilox: {
+      // Adds `delta` to the 128-bit `counter`.
+      auto add = [&](uint64_t delta) -> RandomCounter {
+        uint64_t low = counter[0] + delta;
+        return {low, counter[1] + (low < delta ? 1 : 0)};
+      };
+      fillFromBlocks<T, 4>(result, [&](int64_t j) {
+        RandomCounter blockCounter = add(j);
+        auto low = splitWords(blockCounter[0]);
+        auto high = splitWords(blockCounter[1]);
+        return philox4x32({low[0], low[1], high[0], high[1]}, keyWords);
+      });
+      return add((bytes + 15) / 16);
+    }
+  }
+  llvm_unreachable("Unknown random algorithm");
+}
+
+template RandomCounter generateRandomBits(RandomAlgorithm, uint64_t,
+                                          RandomCounter,
+                                          MutableArrayRef<uint8_t>);
+template RandomCounter generateRandomBits(RandomAlgorithm, uint64_t,
+                                          RandomCounter,
+                                          MutableArrayRef<uint16_t>);
+template RandomCounter generateRandomBits(RandomAlgorithm, uint64_t,
+                                          RandomCounter,
+                                          MutableArrayRef<uint32_t>);
+template RandomCounter generateRandomBits(RandomAlgorithm, uint64_t,
+                                          RandomCounter,
+                                          MutableArrayRef<uint64_t>);
+
+}  // namespace native
+}  // namespace stablehlo
+}  // namespace mlir
@@ -0,0 +1,77 @@
+/* Copyright 2023 The StableHLO Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef STABLEHLO_REFERENCE_RANDOM_H
+#define STABLEHLO_REFERENCE_RANDOM_H
+
+#include <array>
+#include <cstdint>
+
+#include "llvm/ADT/ArrayRef.h"
+#include "mlir/Support/LLVM.h"
+
+namespace mlir {
+namespace stablehlo {
+namespace native {
+
+/// Counter-based pseudorandom bit generators from Salmon et al., "Parallel
+/// random numbers: as easy as 1, 2, 3", SC 2011. Both map a counter and a key
+/// to a block of random bits, so any part of a random stream can be computed
+/// without computing what comes before it.
+enum class RandomAlgorithm {
+  /// Threefry-2x32 with 20 rounds: 64-bit counters, 64-bit blocks.
+  kThreeFry,
+
+  /// Philox-4x32 with 10 rounds: 128-bit counters, 128-bit blocks.
+  kPhilox,
+};
+
+/// A 128-bit counter as its low and high 64 bits.
+using RandomCounter = std::array<uint64_t, 2>;
+
+/// Returns the block of Threefry-2x32 for `counter` and `key`, which are given
+/// as their low and high 32 bits. Follows XLA, which matches the known-answer
+/// tests of the Random123 library.
+std::array<uint32_t, 2> threeFry2x32(std::array<uint32_t, 2> counter,
+                                     std::array<uint32_t, 2> key);
+
+/// Returns the block of Philox-4x32 for `counter` and `key`, which are given
+/// as 32-bit words from least to most significant.
+std::array<uint32_t, 4> philox4x32(std::array<uint32_t, 4> counter,
+                                   std::array<uint32_t, 2> key);
+
+/// Fills `result` with the random stream of `algorithm` for `key`, starting
+/// with the block for `counter`. The stream consists of the blocks for
+/// consecutive counters, and blocks are split into elements of `T` from their
+/// least significant bits to their most significant bits. Threefry counters
+/// only use the low 64 bits of `counter`, and wrap around at 2^64.
+///
+/// Every block is computed independently, so blocks are distributed over
+/// `getNumThreads()` threads and results don't depend on the number of
+/// threads. Returns the counter after the last block which was used.
+///
+/// `T` is one of `uint8_t`, `uint16_t`, `uint32_t` and `uint64_t`. With 64-bit
+/// elements, the stream of `kThreeFry` and `kPhilox` is the one computed by
+/// `rng_bit_generator` in XLA.
+template <typename T>
+RandomCounter generateRandomBits(RandomAlgorithm algorithm, uint64_t key,
+                                 RandomCounter counter,
+                                 MutableArrayRef<T> result);
+
+}  // namespace native
+}  // namespace stablehlo
+}  // namespace mlir
+
+#endif  // STABLEHLO_REFERENCE_RANDOM_H
@@ -21,18 +21,37 @@ limitations under the License.
 namespace mlir {
 namespace stablehlo {
 
-void Scope::add(Value ssaValue, Tensor runtimeValue) {
-  // We are instantiating a new `Scope` object every time the
-  // interpreter evaluates a region. With that, the `stack_frame_` should not
-  // have any duplicates.
-  if (stack_frame_.count(ssaValue))
-    llvm::report_fatal_error("Duplicate SSA register found in scope");
+Scope::Scope(Scope *parent, Process *process)
+    : process_(process), parent_(parent) {
+  if (parent_ && process_)
+    llvm::report_fatal_error("Only root scopes may specify a process");
+  if (!parent_) root_ = std::make_unique<RootState>();
+}
 
+Scope::Scope(Scope *parent, const PreparedRegion &region)
+    : region_(&region), slots_(region.slots.size()), parent_(parent) {}
+
+void Scope::add(Value ssaValue, Tensor runtimeValue) {
   if (ssaValue.getType() != runtimeValue.getType())
     llvm::report_fatal_error(
         "Expected same type for an SSA register and its evaluated value");
 
-  stack_frame_[ssaValue] = runtimeValue;
+  // We are instantiating a new `Scope` object every time the
+  // interpreter evaluates a region. With that, the `stack_frame_` and the
+  // slots should not have any duplicates.
+  if (region_) {
+    auto it = region_->slots.find(ssaValue);
+    if (it != region_->slots.end()) {
+      if (slots_[it->second])
+        llvm::report_fatal_error("Duplicate SSA register found in scope");
+      slots_[it->second] = std::move(runtimeValue);
+      return;
+    }
+  }
+
+  if (stack_frame_.count(ssaValue))
+    llvm::report_fatal_error("Duplicate SSA register found in scope");
+  stack_frame_[ssaValue] = std::move(runtimeValue);
 }
 
 void Scope::add(ValueRange ssaValues, ArrayRef<Tensor> runtimeValues) {
@@ -41,7 +60,24 @@ void Scope::add(ValueRange ssaValues, ArrayRef<Tensor> runtimeValues) {
     add(ssaValue, runtimeValue);
 }
 
+void Scope::erase(Value ssaValue) {
+  if (region_) {
+    auto it = region_->slots.find(ssaValue);
+    if (it != region_->slots.end()) {
+      slots_[it->second] = Tensor();
+      return;
+    }
+  }
+  stack_frame_.erase(ssaValue);
+}
+
 Tensor Scope::find(Value ssaValue) const {
+  if (region_) {
+    auto it = region_->slots.find(ssaValue);
+    if (it != region_->slots.end() && slots_[it->second])
+      return slots_[it->second];
+  }
+
   auto it = stack_frame_.find(ssaValue);
 
   if (it != stack_frame_.end()) return it->second;
@@ -53,6 +89,25 @@ Tensor Scope::find(Value ssaValue) const {
   return parent_->find(ssaValue);
 }
 
+const PreparedRegion &Scope::getPreparedRegion(
+    Region &region,
+    llvm::function_ref<std::unique_ptr<PreparedRegion>(Region &)> prepare) {
+  if (parent_) return parent_->getPreparedRegion(region, prepare);
+  std::lock_guard<std::mutex> lock(root_->mutex);
+  auto &preparedRegion = root_->regions[&region];
+  if (!preparedRegion) preparedRegion = prepare(region);
+  return *preparedRegion;
+}
+
+uint64_t Scope::reserveRngCounters(uint64_t count) {
+  if (parent_) return parent_->reserveRngCounters(count);
+  return root_->rngCounter.fetch_add(count);
+}
+
+Process *Scope::getProcess() const {
+  return parent_ ? parent_->getProcess() : process_;
+}
+
 SmallVector<Tensor> Scope::find(ValueRange ssaValues) const {
   return llvm::to_vector(
       llvm::map_range(ssaValues, [&](Value value) { return find(value); }));
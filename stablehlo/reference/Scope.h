@@ -16,18 +16,41 @@ limitations under the License.
 #ifndef STABLEHLO_REFERENCE_SCOPE_H_
 #define STABLEHLO_REFERENCE_SCOPE_H_
 
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/STLFunctionalExtras.h"
+#include "mlir/IR/Region.h"
+#include "stablehlo/reference/PreparedRegion.h"
 #include "stablehlo/reference/Tensor.h"
 
 namespace mlir {
 namespace stablehlo {
 
+class Process;
+
 /// Represents the scope corresponding to a region of a program under
 /// evaluation. Holds (1) mapping from SSA values, defined in the current
 /// region, to their evaluated runtime `Tensor` values, and (2) handle to
 /// `Scope` object corresponding to the syntactically enclosing region.
+///
+/// Scopes evaluating a `PreparedRegion` store the runtime values of the
+/// region in slots, see `getSlots`. The root scope, i.e. the scope without a
+/// parent, additionally owns the prepared regions of the program and the
+/// state of its `rng` ops, and refers to the process which evaluates the
+/// program, if any.
 class Scope {
  public:
-  Scope(Scope *parent) : parent_(parent) {}
+  /// Creates a scope. Only root scopes may specify the `process` which
+  /// evaluates the program, see `getProcess`.
+  Scope(Scope *parent, Process *process = nullptr);
+
+  /// Creates a scope for evaluating `region`, with one empty slot per SSA
+  /// value of the region.
+  Scope(Scope *parent, const PreparedRegion &region);
 
   Scope(Scope &&other) = default;
   Scope &operator=(Scope &&other) = default;
@@ -43,11 +66,40 @@ class Scope {
   /// its evaluated runtime values (`runtimeValues`).
   void add(ValueRange ssaValues, ArrayRef<Tensor> runtimeValues);
 
+  /// Remove the mapping for SSA value `ssaValue` from the current scope, if
+  /// any. This releases the runtime value unless it is referenced elsewhere.
+  void erase(Value ssaValue);
+
   /// Find the runtime value mapped to SSA value `ssaValue`. The search starts
   /// with the current scope and then recursively continues over to the scope
   /// defined by `parent_`.
   Tensor find(Value ssaValue) const;
 
+  /// Returns the slots of the region evaluated by this scope.
+  MutableArrayRef<Tensor> getSlots() { return slots_; }
+
+  /// Returns the prepared region evaluated by this scope, if any.
+  const PreparedRegion *getRegion() const { return region_; }
+
+  /// Returns the prepared form of `region`, calling `prepare` to create it
+  /// the first time the region is evaluated under the current root scope.
+  /// Thread-safe.
+  const PreparedRegion &getPreparedRegion(
+      Region &region,
+      llvm::function_ref<std::unique_ptr<PreparedRegion>(Region &)> prepare);
+
+  /// Reserves `count` consecutive counters of the generator of `rng` and
+  /// returns the first one. Counters belong to the root scope and start
+  /// from zero, and ops with side effects such as `rng` keep their program
+  /// order even if independent ops are evaluated concurrently, so `rng`
+  /// results only depend on the program and the process. Thread-safe.
+  uint64_t reserveRngCounters(uint64_t count);
+
+  /// Returns the process which evaluates the program, as specified by the
+  /// root scope. Returns null if the program isn't evaluated as part of a
+  /// process grid.
+  Process *getProcess() const;
+
   /// Find the runtime values mapped to SSA values `ssaValues`.
   // SmallVector<Tensor> find(ArrayRef<Value> ssaValues) const;
   SmallVector<Tensor> find(ValueRange ssaValues) const;
@@ -56,6 +108,24 @@ class Scope {
   /// Internal store for mapping from SSA values to runtime `Tensor` values.
   llvm::DenseMap<Value, Tensor> stack_frame_;
 
+  /// The prepared region evaluated by this scope, if any, and the runtime
+  /// values of its SSA values indexed by slot.
+  const PreparedRegion *region_ = nullptr;
+  SmallVector<Tensor> slots_;
+
+  /// State of the evaluation of the program, i.e. prepared regions, keyed by
+  /// the region they were prepared from, and the next counter of `rng`. Only
+  /// allocated for the root scope.
+  struct RootState {
+    std::mutex mutex;
+    llvm::DenseMap<Region *, std::unique_ptr<PreparedRegion>> regions;
+    std::atomic<uint64_t> rngCounter = 0;
+  };
+  std::unique_ptr<RootState> root_;
+
+  /// The process which evaluates the program. Only set for the root scope.
+  Process *process_ = nullptr;
+
   /// A handle to the parent's scope.
   Scope *parent_;
 };
@@ -16,12 +16,20 @@ limitations under the License.
 #include "stablehlo/reference/Tensor.h"
 
 #include <complex>
+#include <cstdint>
+#include <cstring>
+#include <string>
 
 #include "llvm/ADT/APFloat.h"
 #include "llvm/ADT/APInt.h"
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/Support/Error.h"
+#include "llvm/Support/MathExtras.h"
+#include "mlir/IR/DialectResourceBlobManager.h"
 #include "mlir/Support/DebugStringHelper.h"
+#include "stablehlo/reference/BufferPool.h"
 #include "stablehlo/reference/Errors.h"
+#include "stablehlo/reference/Parallel.h"
 #include "stablehlo/reference/Types.h"
 
 namespace mlir {
@@ -44,31 +52,70 @@ int64_t getSizeInBytes(Type type) {
       invalidArgument("Unsupported type: %s", debugString(type).c_str()));
 }
 
-// Flattens multi-dimensional index 'index' of a tensor to a linearized index
-// into the underlying storage where elements are laid out in canonical order.
-int64_t flattenIndex(const Sizes &shape, const Index &index) {
-  if (!index.inBounds(shape))
-    llvm::report_fatal_error(
-        "Incompatible index and shape found while flattening index");
+// Returns a tensor which aliases the raw data of `attr` if the raw data is
+// laid out like the storage of the tensor, and a null tensor otherwise. This
+// is the case for non-splat attributes of floating-point, complex and integer
+// types whose elements take whole bytes, except booleans.
+Tensor aliasRawData(DenseElementsAttr attr) {
+  auto type = attr.getType().cast<TensorType>();
+  Type elementType = type.getElementType();
+  if (auto complexType = elementType.dyn_cast<ComplexType>())
+    elementType = complexType.getElementType();
+  bool isFloat = elementType.isF16() || elementType.isBF16() ||
+                 elementType.isF32() || elementType.isF64();
+  bool isInteger = false;
+  if (auto integerType = elementType.dyn_cast<IntegerType>())
+    isInteger = integerType.getWidth() >= 8 && integerType.getWidth() <= 64 &&
+                llvm::isPowerOf2_32(integerType.getWidth());
+  if (!isFloat && !isInteger) return Tensor();
+
+  // Splats store a single element, and kernels access elements through
+  // pointers of their storage type.
+  ArrayRef<char> rawData = attr.getRawData();
+  size_t alignment = elementType.getIntOrFloatBitWidth() / 8;
+  if (static_cast<int64_t>(rawData.size()) != getSizeInBytes(type) ||
+      reinterpret_cast<uintptr_t>(rawData.data()) % alignment != 0)
+    return Tensor();
+  return Tensor(
+      type, UnmanagedAsmResourceBlob::allocateWithAlign(rawData, alignment));
+}
+
+// Copies the elements of size `N` bytes which are stored at positions
+// `srcOffset + sum(index[d] * srcStrides[d])` of `src` to positions
+// `dstOffset + sum(index[d] * dstStrides[d])` of `dst`, for all indices
+// within `shape`. Positions are measured in elements. Ranges of indices in
+// major-to-minor order are copied in parallel.
+template <int64_t N>
+void copyStrided(const char *src, int64_t srcOffset, const Sizes &srcStrides,
+                 char *dst, int64_t dstOffset, const Sizes &dstStrides,
+                 const Sizes &shape) {
+  int64_t numElements = 1;
+  for (auto dimSize : shape) numElements *= dimSize;
+  int64_t rank = shape.size();
+
+  parallelFor(numElements, kDefaultGrainSize, [&](int64_t begin, int64_t end) {
+    Index index(rank);
+    int64_t srcPos = srcOffset;
+    int64_t dstPos = dstOffset;
+    for (int64_t dim = rank - 1, rest = begin; dim >= 0; --dim) {
+      index[dim] = rest % shape[dim];
+      rest /= shape[dim];
+      srcPos += index[dim] * srcStrides[dim];
+      dstPos += index[dim] * dstStrides[dim];
+    }
 
-  int64_t idx = 0;
-  if (shape.empty()) return idx;
-
-  // Computes strides of a tensor shape: The number of locations in memory
-  // between beginnings of successive array elements, measured in units of the
-  // size of the array's elements.
-  // Example: For a tensor shape [1,2,3], strides = [6,3,1]
-  std::vector<int64_t> strides(shape.size());
-  strides[shape.size() - 1] = 1;
-  for (int i = shape.size() - 2; i >= 0; --i)
-    strides[i] = strides[i + 1] * shape[i + 1];
-
-  // Use the computed strides to flatten the multi-dimensional index 'index'
-  // to a linearized index.
-  // Example: For a tensor with shape [1,2,3], strides = [6,3,1], and index =
-  // [0, 1, 2], the flattened index = 0*6 + 1*3 + 2*1 = 5
-  for (size_t i = 0; i < index.size(); i++) idx += strides[i] * index[i];
-  return idx;
+    for (int64_t i = begin; i < end; ++i) {
+      std::memcpy(dst + dstPos * N, src + srcPos * N, N);
+      for (int64_t dim = rank - 1; dim >= 0; --dim) {
+        srcPos += srcStrides[dim];
+        dstPos += dstStrides[dim];
+        if (++index[dim] < shape[dim]) break;
+        srcPos -= srcStrides[dim] * shape[dim];
+        dstPos -= dstStrides[dim] * shape[dim];
+        index[dim] = 0;
+      }
+    }
+  });
 }
 
 }  // namespace
@@ -76,9 +123,7 @@ int64_t flattenIndex(const Sizes &shape, const Index &index) {
 namespace detail {
 
 Buffer::Buffer(TensorType type)
-    : type_(type),
-      blob_(
-          HeapAsmResourceBlob::allocate(getSizeInBytes(type), alignof(char))) {}
+    : type_(type), blob_(allocatePooledBlob(getSizeInBytes(type))) {}
 
 Buffer::Buffer(TensorType type, AsmResourceBlob blob)
     : type_(type), blob_(std::move(blob)) {}
@@ -88,16 +133,138 @@ Buffer::Buffer(TensorType type, AsmResourceBlob blob)
 Tensor::Tensor() {}
 
 Tensor::Tensor(TensorType type)
-    : impl_(llvm::makeIntrusiveRefCnt<detail::Buffer>(type)) {}
+    : impl_(llvm::makeIntrusiveRefCnt<detail::Buffer>(type)),
+      type_(type),
+      strides_(getContiguousStrides(Sizes(type.getShape()))) {}
 
 Tensor::Tensor(TensorType type, AsmResourceBlob blob)
-    : impl_(llvm::makeIntrusiveRefCnt<detail::Buffer>(type, std::move(blob))) {}
+    : impl_(llvm::makeIntrusiveRefCnt<detail::Buffer>(type, std::move(blob))),
+      type_(type),
+      strides_(getContiguousStrides(Sizes(type.getShape()))) {}
+
+Tensor::Tensor(TensorType type, const Tensor &base, int64_t offset,
+               Sizes strides)
+    : impl_(base.impl_),
+      type_(type),
+      offset_(offset),
+      strides_(std::move(strides)) {
+  if (strides_.size() != static_cast<size_t>(type.getRank()))
+    llvm::report_fatal_error("Incompatible strides and shape found");
+  if (type.getElementType() != base.getElementType())
+    llvm::report_fatal_error("Views can't change the element type");
+
+  // Strides of dimensions of size 1 don't affect the layout.
+  auto shape = getShape();
+  auto contiguousStrides = getContiguousStrides(shape);
+  contiguous_ = true;
+  for (auto [dimSize, stride, contiguousStride] :
+       llvm::zip(shape, strides_, contiguousStrides))
+    if (dimSize != 1 && stride != contiguousStride) contiguous_ = false;
+  if (type.getNumElements() == 0) {
+    offset_ = 0;
+    contiguous_ = true;
+  }
+}
+
+ArrayRef<char> Tensor::getRawData() const {
+  if (!isContiguous()) llvm::report_fatal_error("Expected a contiguous tensor");
+  int64_t elementSize = getSizeInBytes(getElementType());
+  return impl_->getData().slice(offset_ * elementSize,
+                                getNumElements() * elementSize);
+}
+
+Tensor Tensor::materialize() const {
+  if (isContiguous()) return *this;
+
+  Tensor result(getType());
+  result.copyFrom(*this);
+  return result;
+}
+
+void Tensor::copyFrom(const Tensor &source) {
+  if (source.getShape() != getShape() ||
+      source.getElementType() != getElementType())
+    report_fatal_error(invalidArgument(
+        "Expected same shape and element type for copy, got %s and %s",
+        debugString(source.getType()).c_str(),
+        debugString(getType()).c_str()));
+  if (getNumElements() == 0) return;
+
+  const char *src = source.impl_->getData().data();
+  char *dst = impl_->getMutableData().data();
+  auto shape = getShape();
+  switch (getSizeInBytes(getElementType())) {
+    case 1:
+      copyStrided<1>(src, source.offset_, source.strides_, dst, offset_,
+                     strides_, shape);
+      break;
+    case 2:
+      copyStrided<2>(src, source.offset_, source.strides_, dst, offset_,
+                     strides_, shape);
+      break;
+    case 4:
+      copyStrided<4>(src, source.offset_, source.strides_, dst, offset_,
+                     strides_, shape);
+      break;
+    case 8:
+      copyStrided<8>(src, source.offset_, source.strides_, dst, offset_,
+                     strides_, shape);
+      break;
+    case 16:
+      copyStrided<16>(src, source.offset_, source.strides_, dst, offset_,
+                      strides_, shape);
+      break;
+    default:
+      report_fatal_error(invalidArgument(
+          "Unsupported element type: %s",
+          debugString(getElementType()).c_str()));
+  }
+}
+
+bool Tensor::isReusableAs(TensorType type) const {
+  return impl_ && impl_->getUseCount() == 1 && impl_->isMutable() &&
+         type_ == type && isContiguous();
+}
+
+// Computes the position of the element at index 'index' in the underlying
+// storage, measured in elements.
+int64_t Tensor::getStorageIndex(const Index &index) const {
+  if (!index.inBounds(getShape()))
+    llvm::report_fatal_error(
+        "Incompatible index and shape found while flattening index");
+
+  int64_t storageIndex = offset_;
+  for (auto [indexElement, stride] : llvm::zip(index, strides_))
+    storageIndex += indexElement * stride;
+  return storageIndex;
+}
+
+// Computes the position of the element at linear index 'linearIndex' in the
+// underlying storage, measured in elements.
+int64_t Tensor::getStorageIndex(int64_t linearIndex) const {
+  if (contiguous_) return offset_ + linearIndex;
+
+  ArrayRef<int64_t> shape = type_.getShape();
+  int64_t storageIndex = offset_;
+  for (int64_t dim = shape.size() - 1; dim >= 0; --dim) {
+    storageIndex += linearIndex % shape[dim] * strides_[dim];
+    linearIndex /= shape[dim];
+  }
+  return storageIndex;
+}
 
 Element Tensor::get(const Index &index) const {
+  return getElement(getStorageIndex(index));
+}
+
+Element Tensor::getAt(int64_t linearIndex) const {
+  return getElement(getStorageIndex(linearIndex));
+}
+
+Element Tensor::getElement(int64_t storageIndex) const {
   Type elementType = getType().getElementType();
-  const char *elementPtr =
-      impl_->getData().data() +
-      getSizeInBytes(elementType) * flattenIndex(getShape(), index);
+  const char *elementPtr = impl_->getData().data() +
+                           getSizeInBytes(elementType) * storageIndex;
 
   // Handle floating-point types.
   if (elementType.isF16()) {
@@ -114,12 +281,12 @@ Element Tensor::get(const Index &index) const {
 
   if (elementType.isF32()) {
     auto elementData = reinterpret_cast<const float *>(elementPtr);
-    return Element(elementType, APFloat(*elementData));
+    return Element(elementType, static_cast<double>(*elementData));
   }
 
   if (elementType.isF64()) {
     auto elementData = reinterpret_cast<const double *>(elementPtr);
-    return Element(elementType, APFloat(*elementData));
+    return Element(elementType, *elementData);
   }
 
   // Handle integer types.
@@ -128,41 +295,31 @@ Element Tensor::get(const Index &index) const {
   // StableHLO will adopt signfull integer semantics with signed and unsigned
   // integer variants.
   if (isSupportedIntegerType(elementType)) {
-    IntegerType intTy = elementType.cast<IntegerType>();
-
     if (elementType.isSignlessInteger(4) || elementType.isSignlessInteger(8)) {
       auto elementData = reinterpret_cast<const int8_t *>(elementPtr);
-      return Element(elementType, APInt(intTy.getWidth(), *elementData,
-                                        intTy.isSignedInteger()));
+      return Element(elementType, static_cast<int64_t>(*elementData));
     } else if (elementType.isSignlessInteger(16)) {
       auto elementData = reinterpret_cast<const int16_t *>(elementPtr);
-      return Element(elementType, APInt(intTy.getWidth(), *elementData,
-                                        intTy.isSignedInteger()));
+      return Element(elementType, static_cast<int64_t>(*elementData));
     } else if (elementType.isSignlessInteger(32)) {
       auto elementData = reinterpret_cast<const int32_t *>(elementPtr);
-      return Element(elementType, APInt(intTy.getWidth(), *elementData,
-                                        intTy.isSignedInteger()));
+      return Element(elementType, static_cast<int64_t>(*elementData));
     } else if (elementType.isSignlessInteger(64)) {
       auto elementData = reinterpret_cast<const int64_t *>(elementPtr);
-      return Element(elementType, APInt(intTy.getWidth(), *elementData,
-                                        intTy.isSignedInteger()));
+      return Element(elementType, static_cast<int64_t>(*elementData));
     } else if (elementType.isUnsignedInteger(4) ||
                elementType.isUnsignedInteger(8)) {
       auto elementData = reinterpret_cast<const uint8_t *>(elementPtr);
-      return Element(elementType, APInt(intTy.getWidth(), *elementData,
-                                        intTy.isSignedInteger()));
+      return Element(elementType, static_cast<int64_t>(*elementData));
     } else if (elementType.isUnsignedInteger(16)) {
       auto elementData = reinterpret_cast<const uint16_t *>(elementPtr);
-      return Element(elementType, APInt(intTy.getWidth(), *elementData,
-                                        intTy.isSignedInteger()));
+      return Element(elementType, static_cast<int64_t>(*elementData));
     } else if (elementType.isUnsignedInteger(32)) {
       auto elementData = reinterpret_cast<const uint32_t *>(elementPtr);
-      return Element(elementType, APInt(intTy.getWidth(), *elementData,
-                                        intTy.isSignedInteger()));
+      return Element(elementType, static_cast<int64_t>(*elementData));
     } else if (elementType.isUnsignedInteger(64)) {
       auto elementData = reinterpret_cast<const uint64_t *>(elementPtr);
-      return Element(elementType, APInt(intTy.getWidth(), *elementData,
-                                        intTy.isSignedInteger()));
+      return Element(elementType, static_cast<int64_t>(*elementData));
     }
   }
 
@@ -182,17 +339,13 @@ Element Tensor::get(const Index &index) const {
     if (complexElemTy.isF32()) {
       auto elementData =
           reinterpret_cast<const std::complex<float> *>(elementPtr);
-      return Element(elementType,
-                     std::complex<APFloat>(APFloat(elementData->real()),
-                                           APFloat(elementData->imag())));
+      return Element(elementType, std::complex<double>(*elementData));
     }
 
     if (complexElemTy.isF64()) {
       auto elementData =
           reinterpret_cast<const std::complex<double> *>(elementPtr);
-      return Element(elementType,
-                     std::complex<APFloat>(APFloat(elementData->real()),
-                                           APFloat(elementData->imag())));
+      return Element(elementType, std::complex<double>(*elementData));
     }
   }
 
@@ -201,10 +354,17 @@ Element Tensor::get(const Index &index) const {
 }
 
 void Tensor::set(const Index &index, const Element &element) {
+  setElement(getStorageIndex(index), element);
+}
+
+void Tensor::setAt(int64_t linearIndex, const Element &element) {
+  setElement(getStorageIndex(linearIndex), element);
+}
+
+void Tensor::setElement(int64_t storageIndex, const Element &element) {
   Type elementType = getType().getElementType();
-  char *elementPtr =
-      impl_->getMutableData().data() +
-      getSizeInBytes(elementType) * flattenIndex(getShape(), index);
+  char *elementPtr = impl_->getMutableData().data() +
+                     getSizeInBytes(elementType) * storageIndex;
 
   // Handle floating-point types.
   if (elementType.isF16() || elementType.isBF16()) {
@@ -216,15 +376,13 @@ void Tensor::set(const Index &index, const Element &element) {
 
   if (elementType.isF32()) {
     auto elementData = reinterpret_cast<float *>(elementPtr);
-    auto value = element.getFloatValue();
-    *elementData = value.convertToFloat();
+    *elementData = static_cast<float>(element.getNativeFloatValue());
     return;
   }
 
   if (elementType.isF64()) {
     auto elementData = reinterpret_cast<double *>(elementPtr);
-    auto value = element.getFloatValue();
-    *elementData = value.convertToDouble();
+    *elementData = element.getNativeFloatValue();
     return;
   }
 
@@ -235,58 +393,50 @@ void Tensor::set(const Index &index, const Element &element) {
   // integer variants.
   if (elementType.isSignlessInteger(4) || elementType.isSignlessInteger(8)) {
     auto elementData = reinterpret_cast<int8_t *>(elementPtr);
-    auto value = element.getIntegerValue();
-    *elementData = (int8_t)value.getSExtValue();
+    *elementData = static_cast<int8_t>(element.getNativeIntegerValue());
     return;
   }
 
   if (elementType.isSignlessInteger(16)) {
     auto elementData = reinterpret_cast<int16_t *>(elementPtr);
-    auto value = element.getIntegerValue();
-    *elementData = (int16_t)value.getSExtValue();
+    *elementData = static_cast<int16_t>(element.getNativeIntegerValue());
     return;
   }
 
   if (elementType.isSignlessInteger(32)) {
     auto elementData = reinterpret_cast<int32_t *>(elementPtr);
-    auto value = element.getIntegerValue();
-    *elementData = (int32_t)value.getSExtValue();
+    *elementData = static_cast<int32_t>(element.getNativeIntegerValue());
     return;
   }
 
   if (elementType.isSignlessInteger(64)) {
     auto elementData = reinterpret_cast<int64_t *>(elementPtr);
-    auto value = element.getIntegerValue();
-    *elementData = (int64_t)value.getSExtValue();
+    *elementData = static_cast<int64_t>(element.getNativeIntegerValue());
     return;
   }
 
   // Handle unsigned integer types.
   if (elementType.isUnsignedInteger(4) || elementType.isUnsignedInteger(8)) {
     auto elementData = reinterpret_cast<uint8_t *>(elementPtr);
-    auto value = element.getIntegerValue();
-    *elementData = (uint8_t)value.getZExtValue();
+    *elementData = static_cast<uint8_t>(element.getNativeIntegerValue());
     return;
   }
 
   if (elementType.isUnsignedInteger(16)) {
     auto elementData = reinterpret_cast<uint16_t *>(elementPtr);
-    auto value = element.getIntegerValue();
-    *elementData = (uint16_t)value.getZExtValue();
+    *elementData = static_cast<uint16_t>(element.getNativeIntegerValue());
     return;
   }
 
   if (elementType.isUnsignedInteger(32)) {
     auto elementData = reinterpret_cast<uint32_t *>(elementPtr);
-    auto value = element.getIntegerValue();
-    *elementData = (uint32_t)value.getZExtValue();
+    *elementData = static_cast<uint32_t>(element.getNativeIntegerValue());
     return;
   }
 
   if (elementType.isUnsignedInteger(64)) {
     auto elementData = reinterpret_cast<uint64_t *>(elementPtr);
-    auto value = element.getIntegerValue();
-    *elementData = (uint64_t)value.getZExtValue();
+    *elementData = static_cast<uint64_t>(element.getNativeIntegerValue());
     return;
   }
 
@@ -301,20 +451,17 @@ void Tensor::set(const Index &index, const Element &element) {
   // Handle complex types.
   if (elementType.isa<ComplexType>()) {
     auto complexElemTy = elementType.cast<ComplexType>().getElementType();
-    auto complexValue = element.getComplexValue();
+    auto complexValue = element.getNativeComplexValue();
 
     if (complexElemTy.isF32()) {
       auto elementData = reinterpret_cast<std::complex<float> *>(elementPtr);
-      *elementData = std::complex<float>(complexValue.real().convertToFloat(),
-                                         complexValue.imag().convertToFloat());
+      *elementData = std::complex<float>(complexValue);
       return;
     }
 
     if (complexElemTy.isF64()) {
       auto elementData = reinterpret_cast<std::complex<double> *>(elementPtr);
-      *elementData =
-          std::complex<double>(complexValue.real().convertToDouble(),
-                               complexValue.imag().convertToDouble());
+      *elementData = complexValue;
       return;
     }
   }
@@ -341,15 +488,57 @@ void Tensor::print(raw_ostream &os) const {
   getType().print(os);
   os << " {\n";
 
-  for (auto it = this->index_begin(); it != this->index_end(); ++it)
-    os << "  " << get(*it) << "\n";
+  for (int64_t i = 0, e = getNumElements(); i < e; ++i)
+    os << "  " << getAt(i) << "\n";
 
   os << "}";
 }
 
 void Tensor::dump() const { print(llvm::errs()); }
 
+Sizes getContiguousStrides(const Sizes &shape) {
+  Sizes strides(shape.size());
+  int64_t stride = 1;
+  for (int64_t dim = shape.size() - 1; dim >= 0; --dim) {
+    strides[dim] = stride;
+    stride *= shape[dim];
+  }
+  return strides;
+}
+
+Tensor makeTensor(DenseResourceElementsAttr attr) {
+  auto type = attr.getType().cast<TensorType>();
+  std::string key = attr.getRawHandle().getKey().str();
+  AsmResourceBlob *blob = attr.getRawHandle().getBlob();
+  if (!blob)
+    report_fatal_error(
+        invalidArgument("Expected data for resource %s", key.c_str()));
+
+  // Resources store every element in its full storage size, including
+  // booleans, which take a byte each like in the storage of tensors.
+  ArrayRef<char> data = blob->getData();
+  int64_t sizeInBytes = getSizeInBytes(type);
+  if (static_cast<int64_t>(data.size()) != sizeInBytes)
+    report_fatal_error(invalidArgument(
+        "Expected %lld bytes of data for resource %s, but got %zu",
+        static_cast<long long>(sizeInBytes), key.c_str(), data.size()));
+
+  // Kernels access elements through pointers of their storage type, so data
+  // which isn't aligned accordingly is copied.
+  Type elementType = type.getElementType();
+  if (auto complexType = elementType.dyn_cast<ComplexType>())
+    elementType = complexType.getElementType();
+  size_t alignment = getSizeInBytes(elementType);
+  if (reinterpret_cast<uintptr_t>(data.data()) % alignment != 0)
+    return Tensor(type, HeapAsmResourceBlob::allocateAndCopyWithAlign(
+                            data, alignment, /*dataIsMutable=*/false));
+  return Tensor(type,
+                UnmanagedAsmResourceBlob::allocateWithAlign(data, alignment));
+}
+
 Tensor makeTensor(DenseElementsAttr attr) {
+  if (Tensor tensor = aliasRawData(attr)) return tensor;
+
   auto type = attr.getType().cast<TensorType>();
   auto elemType = type.getElementType();
 
@@ -16,11 +16,13 @@ limitations under the License.
 #ifndef STABLEHLO_REFERENCE_TENSOR_H
 #define STABLEHLO_REFERENCE_TENSOR_H
 
+#include <atomic>
 #include <vector>
 
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/IntrusiveRefCntPtr.h"
 #include "llvm/ADT/StringRef.h"
+#include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/raw_ostream.h"
 #include "mlir/IR/AsmState.h"
 #include "mlir/IR/BuiltinAttributes.h"
@@ -35,21 +37,36 @@ namespace stablehlo {
 namespace detail {
 
 /// Underlying storage class for Tensor objects.
-class Buffer : public llvm::RefCountedBase<Buffer> {
+class Buffer {
  public:
   /// \name Constructors
   /// @{
   explicit Buffer(TensorType type);
   Buffer(TensorType type, AsmResourceBlob blob);
-  Buffer(Buffer &&other) = default;
   /// @}
 
-  /// Move assignment operator deleted in RefCountedBase
-  Buffer &operator=(Buffer &&other) = delete;
+  Buffer(const Buffer &) = delete;
+  Buffer &operator=(const Buffer &) = delete;
+
+  /// \name Thread-safe reference counting used by `IntrusiveRefCntPtr`.
+  /// @{
+  void Retain() const { refCount_.fetch_add(1, std::memory_order_relaxed); }
+  void Release() const {
+    if (refCount_.fetch_sub(1, std::memory_order_acq_rel) == 1) delete this;
+  }
+  /// @}
+
+  /// Returns the number of references to the Buffer object.
+  unsigned getUseCount() const {
+    return refCount_.load(std::memory_order_acquire);
+  }
 
   /// Returns type of the Buffer object.
   TensorType getType() { return type_; }
 
+  /// Returns true if the underlying storage can be written to.
+  bool isMutable() const { return blob_.isMutable(); }
+
   /// Provides access to the underlying non-mutable storage.
   ArrayRef<char> getData() const { return blob_.getData(); }
 
@@ -59,12 +76,18 @@ class Buffer : public llvm::RefCountedBase<Buffer> {
  private:
   TensorType type_;
   AsmResourceBlob blob_;
+  mutable std::atomic<unsigned> refCount_ = 0;
 };
 
 }  // namespace detail
 
 /// Class to model a tensor, an n-dimensional array. Provide access to
 /// individual elements of the tensor using n-dimensional indices.
+///
+/// Tensors can be views of other tensors, sharing their underlying storage,
+/// which makes ops like `reshape` or `transpose` cheap. Writing to a tensor
+/// is only meaningful for tensors which don't share storage, e.g. results
+/// freshly created by an evaluator.
 class Tensor {
  public:
   /// \name Constructors
@@ -73,25 +96,67 @@ class Tensor {
   explicit Tensor(TensorType type);
   explicit Tensor(TensorType type, AsmResourceBlob blob);
   Tensor(const Tensor &other) = default;
+  Tensor(Tensor &&other) = default;
+
+  /// Creates a view of type \a type which shares the underlying storage with
+  /// \a base. The element at index `i` of the view is stored at position
+  /// `offset + sum(i[d] * strides[d])` of the underlying storage, measured in
+  /// elements. Strides can be zero, e.g. for broadcasts, or negative, e.g.
+  /// for reverses.
+  Tensor(TensorType type, const Tensor &base, int64_t offset, Sizes strides);
   /// @}
 
-  /// Assignment operator.
+  /// Assignment operators.
   Tensor &operator=(const Tensor &other) = default;
+  Tensor &operator=(Tensor &&other) = default;
+
+  /// Returns false for default-constructed and moved-from Tensor objects.
+  explicit operator bool() const { return static_cast<bool>(impl_); }
 
   /// Returns type of the Tensor object.
-  TensorType getType() const { return impl_->getType(); };
+  TensorType getType() const { return type_; };
 
   /// Returns rank of the Tensor object.
-  int64_t getRank() const { return impl_->getType().getRank(); }
+  int64_t getRank() const { return type_.getRank(); }
 
   /// Returns shape of the Tensor object.
-  Sizes getShape() const { return Sizes(impl_->getType().getShape()); }
+  Sizes getShape() const { return Sizes(type_.getShape()); }
 
   /// Returns the number of elements.
-  int64_t getNumElements() const { return impl_->getType().getNumElements(); }
+  int64_t getNumElements() const { return type_.getNumElements(); }
 
   /// Returns element type of the Tensor object.
-  Type getElementType() const { return impl_->getType().getElementType(); };
+  Type getElementType() const { return type_.getElementType(); };
+
+  /// Returns the position of the element at index `[0, ..., 0]` in the
+  /// underlying storage, measured in elements.
+  int64_t getOffset() const { return offset_; }
+
+  /// Returns the distance between consecutive elements along each dimension
+  /// in the underlying storage, measured in elements.
+  const Sizes &getStrides() const { return strides_; }
+
+  /// Returns true if the elements are laid out in the underlying storage
+  /// densely and in major-to-minor order, starting at `getOffset()`. Tensors
+  /// created by views such as `transpose` or `broadcast_in_dim` generally
+  /// aren't contiguous.
+  bool isContiguous() const { return contiguous_; }
+
+  /// Returns `*this` if the tensor is contiguous. Otherwise, returns a
+  /// contiguous copy of the tensor.
+  Tensor materialize() const;
+
+  /// Copies the elements of \a source, which must have the same shape and
+  /// element type, into this tensor. This tensor may be a view, e.g. of the
+  /// part of a result under construction that \a source covers, but must not
+  /// overlap with \a source.
+  void copyFrom(const Tensor &source);
+
+  /// Returns true if the underlying storage can be reused for a result of
+  /// type \a type without anyone noticing: this tensor is the only reference
+  /// to the storage, the storage is mutable, and the tensor is contiguous and
+  /// has type \a type.
+  bool isReusableAs(TensorType type) const;
 
   /// Provides read access to the tensor element indexed at 'index'.
   Element get(const Index &index) const;
@@ -103,6 +168,59 @@ class Tensor {
   /// underlying storage pointed to by \a index.
   void set(const Index &index, const Element &element);
 
+  /// Provides read and write access to the tensor element at linear index
+  /// `linearIndex`, i.e. the element whose index is at position `linearIndex`
+  /// of the index space in lexicographical order (see
+  /// `IndexSpaceIterator::getLinearIndex`), which must be in
+  /// `[0, getNumElements())`. Unlike accesses through an index, these don't
+  /// validate the index and take constant time for contiguous tensors.
+  /// @{
+  Element getAt(int64_t linearIndex) const;
+  void setAt(int64_t linearIndex, const Element &element);
+  /// @}
+
+  /// Provides read access to the underlying storage as a flat array of `T`
+  /// laid out in major-to-minor order. `T` must be the C++ type which is used
+  /// to store the element type of the tensor (see `dispatchNativeType`).
+  /// Requires the tensor to be contiguous (see `materialize`).
+  template <typename T>
+  ArrayRef<T> getData() const {
+    if (!isContiguous())
+      llvm::report_fatal_error("Expected a contiguous tensor");
+    return ArrayRef<T>(
+        reinterpret_cast<const T *>(impl_->getData().data()) + offset_,
+        getNumElements());
+  }
+
+  /// Provides write access to the underlying storage as a flat array of `T`
+  /// laid out in major-to-minor order. `T` must be the C++ type which is used
+  /// to store the element type of the tensor (see `dispatchNativeType`).
+  /// Requires the tensor to be contiguous (see `materialize`).
+  template <typename T>
+  MutableArrayRef<T> getMutableData() {
+    if (!isContiguous())
+      llvm::report_fatal_error("Expected a contiguous tensor");
+    return MutableArrayRef<T>(
+        reinterpret_cast<T *>(impl_->getMutableData().data()) + offset_,
+        getNumElements());
+  }
+
+  /// Provides read access to the whole underlying storage as a flat array of
+  /// `T`, which may be shared with other tensors. Unlike `getData`, this
+  /// doesn't require the tensor to be contiguous: the element at index `i` is
+  /// at position `getOffset() + sum(i[d] * getStrides()[d])`.
+  template <typename T>
+  ArrayRef<T> getStorage() const {
+    ArrayRef<char> data = impl_->getData();
+    return ArrayRef<T>(reinterpret_cast<const T *>(data.data()),
+                       data.size() / sizeof(T));
+  }
+
+  /// Provides read access to the underlying storage as bytes, i.e. to the
+  /// elements laid out in major-to-minor order in their storage type.
+  /// Requires the tensor to be contiguous (see `materialize`).
+  ArrayRef<char> getRawData() const;
+
   /// Prints Tensor objects.
   void print(raw_ostream &os) const;
   void dump() const;
@@ -112,7 +230,16 @@ class Tensor {
   IndexSpaceIterator index_end() const;
 
  private:
+  int64_t getStorageIndex(const Index &index) const;
+  int64_t getStorageIndex(int64_t linearIndex) const;
+  Element getElement(int64_t storageIndex) const;
+  void setElement(int64_t storageIndex, const Element &element);
+
   llvm::IntrusiveRefCntPtr<detail::Buffer> impl_;
+  TensorType type_;
+  int64_t offset_ = 0;
+  Sizes strides_;
+  bool contiguous_ = true;
 };
 
 /// Print utilities for Tensor objects.
@@ -121,9 +248,36 @@ inline raw_ostream &operator<<(raw_ostream &os, Tensor tensor) {
   return os;
 }
 
-/// Creates a Tensor using 'DenseElementsAttr' object 'attr'.
+/// Returns the strides of a contiguous tensor of shape 'shape', i.e. of a
+/// tensor whose elements are laid out densely in major-to-minor order.
+/// Example: For a tensor shape [1,2,3], strides = [6,3,1].
+Sizes getContiguousStrides(const Sizes &shape);
+
+/// Returns the first of \a candidates whose storage can be reused for a
+/// result of type \a type (see `Tensor::isReusableAs`), or a new Tensor of
+/// type \a type if there is no such candidate. This is meant for evaluators
+/// of elementwise ops, which only write a result element after reading the
+/// operand elements at the same index.
+template <typename... Ts>
+Tensor reuseOrAllocate(TensorType type, const Ts &...candidates) {
+  for (const Tensor *candidate : {&candidates...})
+    if (candidate->isReusableAs(type)) return *candidate;
+  return Tensor(type);
+}
+
+/// Creates a Tensor using 'DenseElementsAttr' object 'attr'. If the raw data
+/// of 'attr' is laid out like the storage of the Tensor, e.g. for non-splat
+/// f32 or i64 attributes, the Tensor aliases the raw data instead of copying
+/// it. Such Tensors are immutable and must not outlive the MLIRContext of
+/// 'attr'. Otherwise, the elements are copied into a new mutable Tensor.
 Tensor makeTensor(DenseElementsAttr attr);
 
+/// Creates a Tensor which aliases the data of the resource blob referenced by
+/// 'attr' without copying it, unless the data isn't aligned for the element
+/// type. The Tensor is immutable and must not outlive the blob, which is
+/// owned by the MLIRContext of 'attr'.
+Tensor makeTensor(DenseResourceElementsAttr attr);
+
 }  // namespace stablehlo
 }  // namespace mlir
 
@@ -0,0 +1,244 @@
+/* Copyright 2023 The StableHLO Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "stablehlo/reference/TensorFile.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Endian.h"
+#include "llvm/Support/FileOutputBuffer.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
+#include "mlir/IR/AsmState.h"
+#include "mlir/Support/DebugStringHelper.h"
+#include "stablehlo/reference/Errors.h"
+#include "stablehlo/reference/Types.h"
+
+namespace mlir {
+namespace stablehlo {
+namespace {
+
+constexpr StringRef kNumPyMagic = "\x93NUMPY";
+
+// Byte order character of NumPy type descriptors for the host.
+constexpr char kNativeByteOrder = llvm::sys::IsLittleEndianHost ? '<' : '>';
+
+bool isNumPyFile(StringRef path) { return path.endswith(".npy"); }
+
+// Returns the size in bytes of the storage type of scalars of type `type`,
+// i.e. of floating-point and integer types, and of the parts of complex
+// types.
+size_t getScalarSizeInBytes(Type type) {
+  if (auto complexType = type.dyn_cast<ComplexType>())
+    type = complexType.getElementType();
+  return std::max(type.getIntOrFloatBitWidth(), 8u) / 8;
+}
+
+int64_t getSizeInBytes(TensorType type) {
+  int64_t elementSize = getScalarSizeInBytes(type.getElementType());
+  if (type.getElementType().isa<ComplexType>()) elementSize *= 2;
+  return type.getNumElements() * elementSize;
+}
+
+// Returns the NumPy type descriptor of arrays of elements of type `type`,
+// without the byte order character, or an empty string if NumPy has no
+// equivalent type.
+std::string getNumPyType(Type type) {
+  int64_t size = getScalarSizeInBytes(type);
+  if (isSupportedBooleanType(type)) return "b1";
+  if (isSupportedIntegerType(type) && type.getIntOrFloatBitWidth() >= 8)
+    return (isSupportedUnsignedIntegerType(type) ? "u" : "i") +
+           std::to_string(size);
+  if (type.isF16() || type.isF32() || type.isF64())
+    return "f" + std::to_string(size);
+  if (isSupportedComplexType(type)) return "c" + std::to_string(2 * size);
+  return "";
+}
+
+// Returns the value of `key` in the header of a NumPy file, which is a
+// Python dictionary literal, or an empty string if there is no such key.
+StringRef getNumPyHeaderValue(StringRef header, StringRef key) {
+  size_t pos = header.find(("'" + key + "'").str());
+  if (pos == StringRef::npos) pos = header.find(("\"" + key + "\"").str());
+  if (pos == StringRef::npos) return "";
+  StringRef value = header.drop_front(pos + key.size() + 2).ltrim();
+  if (!value.consume_front(":")) return "";
+  value = value.ltrim();
+  if (value.startswith("("))
+    return value.take_until([](char c) { return c == ')'; }).drop_front();
+  if (value.startswith("'") || value.startswith("\""))
+    return value.drop_front().take_until(
+        [](char c) { return c == '\'' || c == '"'; });
+  return value.take_until([](char c) { return c == ',' || c == '}'; }).rtrim();
+}
+
+// Checks that `contents` starts with the header of a NumPy array of type
+// `type`, and returns the size of the header.
+llvm::Expected<size_t> parseNumPyHeader(StringRef contents, TensorType type,
+                                        StringRef path) {
+  // The magic string is followed by the major and minor version and by the
+  // size of the header, which takes 2 bytes in version 1 and 4 bytes after.
+  if (!contents.startswith(kNumPyMagic) || contents.size() < 10)
+    return invalidArgument("%s is not a NumPy file", path.str().c_str());
+  uint8_t majorVersion = contents[6];
+  size_t prefixSize = majorVersion == 1 ? 10 : 12;
+  if (majorVersion < 1 || majorVersion > 3 || contents.size() < prefixSize)
+    return invalidArgument("%s has an unsupported NumPy version %d",
+                           path.str().c_str(), majorVersion);
+  size_t headerSize =
+      majorVersion == 1
+          ? llvm::support::endian::read16le(contents.data() + 8)
+          : llvm::support::endian::read32le(contents.data() + 8);
+  if (contents.size() < prefixSize + headerSize)
+    return invalidArgument("%s has a truncated NumPy header",
+                           path.str().c_str());
+  StringRef header = contents.substr(prefixSize, headerSize);
+
+  std::string expectedType = getNumPyType(type.getElementType());
+  if (expectedType.empty())
+    return invalidArgument("NumPy files don't support element type %s",
+                           debugString(type.getElementType()).c_str());
+  StringRef actualType = getNumPyHeaderValue(header, "descr");
+  if (actualType.empty() ||
+      (actualType[0] != '|' && actualType[0] != '=' &&
+       actualType[0] != kNativeByteOrder) ||
+      actualType.drop_front() != expectedType)
+    return invalidArgument("Expected %s to hold elements of NumPy type %s, "
+                           "but got %s",
+                           path.str().c_str(), expectedType.c_str(),
+                           actualType.str().c_str());
+  if (getNumPyHeaderValue(header, "fortran_order") != "False")
+    return invalidArgument("Expected %s to be in C order", path.str().c_str());
+
+  SmallVector<int64_t> shape;
+  SmallVector<StringRef> dimSizes;
+  getNumPyHeaderValue(header, "shape").split(dimSizes, ',');
+  for (StringRef dimSize : dimSizes) {
+    dimSize = dimSize.trim();
+    if (dimSize.empty()) continue;
+    if (dimSize.getAsInteger(10, shape.emplace_back()))
+      return invalidArgument("%s has an invalid NumPy shape",
+                             path.str().c_str());
+  }
+  if (ArrayRef<int64_t>(shape) != type.getShape())
+    return invalidArgument("Expected %s to hold an array of type %s",
+                           path.str().c_str(), debugString(type).c_str());
+  return prefixSize + headerSize;
+}
+
+// Returns the header of a NumPy file holding an array of type `type`, which
+// is padded so that the data is aligned to 64 bytes.
+llvm::Expected<std::string> getNumPyHeader(TensorType type) {
+  std::string numPyType = getNumPyType(type.getElementType());
+  if (numPyType.empty())
+    return invalidArgument("NumPy files don't support element type %s",
+                           debugString(type.getElementType()).c_str());
+  char byteOrder =
+      getScalarSizeInBytes(type.getElementType()) == 1 ? '|' : kNativeByteOrder;
+
+  std::string dictionary;
+  llvm::raw_string_ostream os(dictionary);
+  os << "{'descr': '" << byteOrder << numPyType
+     << "', 'fortran_order': False, 'shape': (";
+  llvm::interleave(type.getShape(), os, ", ");
+  if (type.getRank() == 1) os << ",";
+  os << "), }";
+  os.flush();
+
+  size_t prefixSize = 10;
+  if (dictionary.size() + 1 + 64 > UINT16_MAX) prefixSize = 12;
+  size_t headerSize = llvm::alignTo(prefixSize + dictionary.size() + 1, 64) -
+                      prefixSize;
+  dictionary.resize(headerSize - 1, ' ');
+  dictionary += '\n';
+
+  std::string header = kNumPyMagic.str();
+  header += static_cast<char>(prefixSize == 10 ? 1 : 2);
+  header += static_cast<char>(0);
+  char size[4];
+  if (prefixSize == 10) {
+    llvm::support::endian::write16le(size, headerSize);
+    header.append(size, 2);
+  } else {
+    llvm::support::endian::write32le(size, headerSize);
+    header.append(size, 4);
+  }
+  return header + dictionary;
+}
+
+}  // namespace
+
+llvm::Expected<Tensor> readTensorFile(StringRef path, TensorType type) {
+  auto buffer = llvm::MemoryBuffer::getFile(path, /*IsText=*/false,
+                                            /*RequiresNullTerminator=*/false);
+  if (!buffer)
+    return invalidArgument("Failed to read %s: %s", path.str().c_str(),
+                           buffer.getError().message().c_str());
+  StringRef contents = (*buffer)->getBuffer();
+
+  size_t dataOffset = 0;
+  if (isNumPyFile(path)) {
+    auto headerSize = parseNumPyHeader(contents, type, path);
+    if (!headerSize) return headerSize.takeError();
+    dataOffset = *headerSize;
+  }
+  ArrayRef<char> data(contents.data() + dataOffset,
+                      contents.size() - dataOffset);
+  if (static_cast<int64_t>(data.size()) != getSizeInBytes(type))
+    return invalidArgument("Expected %lld bytes of data in %s, but got %zu",
+                           static_cast<long long>(getSizeInBytes(type)),
+                           path.str().c_str(), data.size());
+
+  // Kernels access elements through pointers of their storage type, so data
+  // which isn't aligned accordingly is copied. Otherwise, the tensor owns the
+  // buffer, which keeps the file mapped until the tensor is destroyed.
+  size_t alignment = getScalarSizeInBytes(type.getElementType());
+  if (reinterpret_cast<uintptr_t>(data.data()) % alignment != 0)
+    return Tensor(type, HeapAsmResourceBlob::allocateAndCopyWithAlign(
+                            data, alignment, /*dataIsMutable=*/false));
+  return Tensor(type, UnmanagedAsmResourceBlob::allocateWithAlign(
+                          data, alignment,
+                          [buffer = std::move(*buffer)](void *, size_t,
+                                                        size_t) {}));
+}
+
+llvm::Error writeTensorFile(const Tensor &tensor, StringRef path) {
+  std::string header;
+  if (isNumPyFile(path)) {
+    auto numPyHeader = getNumPyHeader(tensor.getType());
+    if (!numPyHeader) return numPyHeader.takeError();
+    header = std::move(*numPyHeader);
+  }
+
+  Tensor contiguous = tensor.materialize();
+  ArrayRef<char> data = contiguous.getRawData();
+  auto output =
+      llvm::FileOutputBuffer::create(path, header.size() + data.size());
+  if (!output) return output.takeError();
+  uint8_t *start = (*output)->getBufferStart();
+  llvm::copy(header, start);
+  llvm::copy(data, start + header.size());
+  return (*output)->commit();
+}
+
+}  // namespace stablehlo
+}  // namespace mlir
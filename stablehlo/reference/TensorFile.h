@@ -0,0 +1,46 @@
+/* Copyright 2023 The StableHLO Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef STABLEHLO_REFERENCE_TENSORFILE_H
+#define STABLEHLO_REFERENCE_TENSORFILE_H
+
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Error.h"
+#include "mlir/IR/BuiltinTypes.h"
+#include "stablehlo/reference/Tensor.h"
+
+namespace mlir {
+namespace stablehlo {
+
+/// Reads a tensor of type `type` from the file at `path`. Files whose name
+/// ends in `.npy` are NumPy arrays, which must have the shape of `type`, an
+/// element type matching the element type of `type`, and C order. Other files
+/// hold the raw elements in their storage type in major-to-minor order (see
+/// `Tensor::getRawData`).
+///
+/// The file is memory-mapped if possible, and the tensor refers to its data
+/// without copying it unless the data isn't aligned for the element type.
+/// The tensor is immutable.
+llvm::Expected<Tensor> readTensorFile(StringRef path, TensorType type);
+
+/// Writes `tensor` to the file at `path`, in the same formats as
+/// `readTensorFile` reads. The file is written through a memory-mapped buffer
+/// if possible.
+llvm::Error writeTensorFile(const Tensor &tensor, StringRef path);
+
+}  // namespace stablehlo
+}  // namespace mlir
+
+#endif  // STABLEHLO_REFERENCE_TENSORFILE_H
@@ -0,0 +1,620 @@
+/* Copyright 2023 The StableHLO Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "stablehlo/reference/VectorMath.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#include "llvm/Support/ErrorHandling.h"
+
+#if defined(__x86_64__) && defined(__has_builtin)
+#if __has_builtin(__builtin_convertvector) && \
+    __has_builtin(__builtin_cpu_supports)
+#define STABLEHLO_VECTOR_MATH_X86 1
+#include <immintrin.h>
+#endif
+#endif
+
+namespace mlir {
+namespace stablehlo {
+namespace native {
+namespace {
+
+#ifdef STABLEHLO_VECTOR_MATH_X86
+
+// The vector kernels are written once using GCC vector extensions, which are
+// also supported by Clang, and instantiated for 256-bit and 512-bit vectors.
+// They are forcibly inlined into loops compiled for AVX2 and AVX-512
+// respectively, which is where the actual instruction selection happens.
+// Because of that, the kernels must not use target-specific intrinsics.
+//
+// All kernels compute in double precision and are meant for f32 results,
+// e.g. exponentialKernel clamps its input to a range which is only accurate
+// enough for f32.
+
+//
+// Kernels take vectors by reference, but they return vectors wider than the
+// baseline instruction set supports. GCC warns about that when it analyzes
+// them at the end of the translation unit, where diagnostic pragmas no longer
+// apply, so the build disables -Wpsabi for this file instead. The warning is
+// moot because the kernels are always inlined.
+//
+// The build also compiles this file with -ffp-contract=off, and kernels don't
+// use fused multiply-adds explicitly either. AVX-512 implies FMA, so fusing
+// would make results depend on the host: they would round differently than
+// on hosts with AVX2 only and than the scalar fallback.
+
+#define STABLEHLO_INLINE inline __attribute__((always_inline))
+
+typedef float Float4 __attribute__((vector_size(16)));
+typedef double Double4 __attribute__((vector_size(32)));
+typedef int64_t Int4 __attribute__((vector_size(32)));
+typedef float Float8 __attribute__((vector_size(32)));
+typedef double Double8 __attribute__((vector_size(64)));
+typedef int64_t Int8 __attribute__((vector_size(64)));
+
+template <typename V>
+struct VectorTraits;
+
+template <>
+struct VectorTraits<Double4> {
+  using Float = Float4;
+  using Int = Int4;
+  static constexpr int64_t kSize = 4;
+};
+
+template <>
+struct VectorTraits<Double8> {
+  using Float = Float8;
+  using Int = Int8;
+  static constexpr int64_t kSize = 8;
+};
+
+template <typename V>
+using IntOf = typename VectorTraits<V>::Int;
+
+template <typename V>
+STABLEHLO_INLINE V splat(double value) {
+  V result;
+  for (int64_t i = 0; i < VectorTraits<V>::kSize; ++i) result[i] = value;
+  return result;
+}
+
+template <typename V>
+STABLEHLO_INLINE IntOf<V> splatInt(int64_t value) {
+  IntOf<V> result;
+  for (int64_t i = 0; i < VectorTraits<V>::kSize; ++i) result[i] = value;
+  return result;
+}
+
+template <typename V>
+STABLEHLO_INLINE IntOf<V> asInt(const V &value) {
+  return (IntOf<V>)value;
+}
+
+template <typename V>
+STABLEHLO_INLINE V asDouble(const IntOf<V> &value) {
+  return (V)value;
+}
+
+// Comparisons return lane masks, i.e. all ones or all zeros per lane.
+// Comparisons involving NaN yield all zeros.
+template <typename V>
+STABLEHLO_INLINE IntOf<V> lessThan(const V &lhs, const V &rhs) {
+  return (IntOf<V>)(lhs < rhs);
+}
+
+template <typename V>
+STABLEHLO_INLINE IntOf<V> equal(const V &lhs, const V &rhs) {
+  return (IntOf<V>)(lhs == rhs);
+}
+
+template <typename V>
+STABLEHLO_INLINE IntOf<V> isNaN(const V &value) {
+  return (IntOf<V>)(value != value);
+}
+
+template <typename V>
+STABLEHLO_INLINE bool isAllTrue(const IntOf<V> &mask) {
+  for (int64_t i = 0; i < VectorTraits<V>::kSize; ++i)
+    if (!mask[i]) return false;
+  return true;
+}
+
+template <typename V>
+STABLEHLO_INLINE V select(const IntOf<V> &mask, const V &onTrue,
+                          const V &onFalse) {
+  return asDouble<V>((asInt(onTrue) & mask) | (asInt(onFalse) & ~mask));
+}
+
+template <typename V>
+STABLEHLO_INLINE V clamp(const V &value, double min, double max) {
+  V result = select(lessThan(value, splat<V>(min)), splat<V>(min), value);
+  return select(lessThan(splat<V>(max), result), splat<V>(max), result);
+}
+
+template <typename V>
+STABLEHLO_INLINE V abs(const V &value) {
+  return asDouble<V>(asInt(value) & splatInt<V>(INT64_MAX));
+}
+
+// Returns `value` rounded to the nearest integer and stores the same integer
+// in the low bits of `bits`. Requires |value| < 2^51.
+template <typename V>
+STABLEHLO_INLINE V roundToInt(const V &value, IntOf<V> &bits) {
+  const V magic = splat<V>(6755399441055744.0);  // 2^52 + 2^51
+  V shifted = value + magic;
+  bits = asInt(shifted);
+  return shifted - magic;
+}
+
+// Converts integers with |value| < 2^51 to double.
+template <typename V>
+STABLEHLO_INLINE V intToDouble(const IntOf<V> &value) {
+  const V magic = splat<V>(6755399441055744.0);
+  return asDouble<V>(value + asInt(magic)) - magic;
+}
+
+// Evaluates a polynomial with coefficients listed from the highest degree.
+template <typename V, size_t N>
+STABLEHLO_INLINE V horner(const V &x, const double (&coefficients)[N]) {
+  V result = splat<V>(coefficients[0]);
+  for (size_t i = 1; i < N; ++i) result = result * x + coefficients[i];
+  return result;
+}
+
+// 1/k! for k = 13, ..., 0.
+constexpr double kExpCoefficients[] = {
+    1.0 / 6227020800.0, 1.0 / 479001600.0, 1.0 / 39916800.0,
+    1.0 / 3628800.0,    1.0 / 362880.0,    1.0 / 40320.0,
+    1.0 / 5040.0,       1.0 / 720.0,       1.0 / 120.0,
+    1.0 / 24.0,         1.0 / 6.0,         1.0 / 2.0,
+    1.0,                1.0};
+
+// 1/k! for k = 14, ..., 2.
+constexpr double kExpm1Coefficients[] = {
+    1.0 / 87178291200.0, 1.0 / 6227020800.0, 1.0 / 479001600.0,
+    1.0 / 39916800.0,    1.0 / 3628800.0,    1.0 / 362880.0,
+    1.0 / 40320.0,       1.0 / 5040.0,       1.0 / 720.0,
+    1.0 / 120.0,         1.0 / 24.0,         1.0 / 6.0,
+    1.0 / 2.0};
+
+// 1/(2k+1) for k = 10, ..., 0.
+constexpr double kLogCoefficients[] = {
+    1.0 / 21.0, 1.0 / 19.0, 1.0 / 17.0, 1.0 / 15.0, 1.0 / 13.0, 1.0 / 11.0,
+    1.0 / 9.0,  1.0 / 7.0,  1.0 / 5.0,  1.0 / 3.0,  1.0};
+
+// (-1)^k/(2k+1)! for k = 8, ..., 1.
+constexpr double kSinCoefficients[] = {
+    1.0 / 355687428096000.0, -1.0 / 1307674368000.0, 1.0 / 6227020800.0,
+    -1.0 / 39916800.0,       1.0 / 362880.0,         -1.0 / 5040.0,
+    1.0 / 120.0,             -1.0 / 6.0};
+
+// (-1)^k/(2k)! for k = 8, ..., 2.
+constexpr double kCosCoefficients[] = {
+    1.0 / 20922789888000.0, -1.0 / 87178291200.0, 1.0 / 479001600.0,
+    -1.0 / 3628800.0,       1.0 / 40320.0,        -1.0 / 720.0,
+    1.0 / 24.0};
+
+// ln(2) split into a part with 32 significant bits and the remainder.
+constexpr double kLn2Hi = 6.93147180369123816490e-01;
+constexpr double kLn2Lo = 1.90821492927058770002e-10;
+
+// pi/2 split into three parts with 33 significant bits and the remainder.
+constexpr double kPiOver2[] = {
+    1.57079632673412561417e+00, 6.07710050630396597660e-11,
+    2.02226624871116645580e-21, 8.47842766036889956997e-32};
+
+// Larger inputs of sine and cosine are left to libm. This keeps n * kPiOver2
+// exact in sineKernel.
+constexpr double kMaxTrigonometricInput = 524288.0;  // 2^19
+
+template <typename V>
+STABLEHLO_INLINE V exponentialKernel(const V &x) {
+  // exp(x) = 2^n * exp(r), where n = round(x / ln(2)) and |r| <= ln(2) / 2.
+  // Clamping keeps 2^n a normal number and the result still overflows or
+  // underflows when rounded to f32.
+  V clamped = clamp(x, -700.0, 700.0);
+  IntOf<V> bits;
+  V n = roundToInt(clamped * 1.4426950408889634, bits);
+  V r = (clamped - n * kLn2Hi) - n * kLn2Lo;
+  V scale = asDouble<V>((bits + splatInt<V>(1023)) << 52);
+  V result = horner(r, kExpCoefficients) * scale;
+  return select(isNaN(x), x, result);
+}
+
+template <typename V>
+STABLEHLO_INLINE V expm1Kernel(const V &x) {
+  // Uses the Taylor series for small |x| to avoid cancellation.
+  V small = x * horner(x, kExpm1Coefficients) * x + x;
+  V large = exponentialKernel(x) - 1.0;
+  return select(lessThan(abs(x), splat<V>(0.34657359027997264)), small,
+                large);
+}
+
+template <typename V>
+STABLEHLO_INLINE V logKernel(const V &x) {
+  // log(x) = e * ln(2) + log(m), where x = 2^e * m and
+  // sqrt(1/2) <= m < sqrt(2), and log(m) = 2 * atanh((m - 1) / (m + 1)).
+  // Subnormal f32 inputs are normal in double, so only zeros, negative
+  // numbers, infinities and NaNs need special handling.
+  IntOf<V> bits = asInt(x);
+  IntOf<V> exponent = (bits >> 52) - splatInt<V>(1023);
+  V m = asDouble<V>((bits & splatInt<V>(0x000FFFFFFFFFFFFF)) |
+                    splatInt<V>(0x3FF0000000000000));
+  IntOf<V> isLarge = lessThan(splat<V>(1.4142135623730951), m);
+  m = select(isLarge, m * 0.5, m);
+  exponent = exponent - isLarge;
+  V e = intToDouble<V>(exponent);
+  V f = (m - 1.0) / (m + 1.0);
+  V logM = 2.0 * f * horner(f * f, kLogCoefficients);
+  V result = e * kLn2Hi + (logM + e * kLn2Lo);
+
+  const V inf = splat<V>(INFINITY);
+  result = select(equal(x, splat<V>(0.0)), -inf, result);
+  result = select(lessThan(x, splat<V>(0.0)), splat<V>(NAN), result);
+  result = select(equal(x, inf), inf, result);
+  return select(isNaN(x), x, result);
+}
+
+// Computes sin(x + quadrant * pi/2). Requires |x| < kMaxTrigonometricInput.
+template <typename V>
+STABLEHLO_INLINE V sineKernel(const V &x, int64_t quadrant) {
+  // sin(x) is one of sin(r), cos(r), -sin(r) and -cos(r) depending on n mod 4,
+  // where n = round(x / (pi/2)) and r = x - n * pi/2.
+  IntOf<V> bits;
+  V n = roundToInt(x * 0.63661977236758134, bits);
+  V r = x - n * kPiOver2[0];
+  r = r - n * kPiOver2[1];
+  r = r - n * kPiOver2[2];
+  r = r - n * kPiOver2[3];
+  bits = bits + splatInt<V>(quadrant);
+
+  V r2 = r * r;
+  V sinR = r + r * r2 * horner(r2, kSinCoefficients);
+  V cosR = (1.0 - 0.5 * r2) + r2 * r2 * horner(r2, kCosCoefficients);
+  IntOf<V> useCos = (IntOf<V>)((bits & splatInt<V>(1)) != splatInt<V>(0));
+  V result = select(useCos, cosR, sinR);
+  return asDouble<V>(asInt(result) ^ ((bits & splatInt<V>(2)) << 62));
+}
+
+template <typename V>
+STABLEHLO_INLINE V tanhKernel(const V &x) {
+  // tanh(|x|) = expm1(2|x|) / (expm1(2|x|) + 2), which rounds to 1 for
+  // |x| >= 20.
+  V ax = clamp(abs(x), 0.0, 20.0);
+  V e = expm1Kernel(2.0 * ax);
+  V result = e / (e + 2.0);
+  result = asDouble<V>(asInt(result) | (asInt(x) & splatInt<V>(INT64_MIN)));
+  return select(isNaN(x), x, result);
+}
+
+#endif  // STABLEHLO_VECTOR_MATH_X86
+
+// Functions which have a vector kernel for f32. `scalar` is used for f64,
+// on hosts without vector support, and for inputs which `vector` can't
+// handle, in which case `vector` returns false.
+
+struct Cosine {
+  static double scalar(double x) { return std::cos(x); }
+#ifdef STABLEHLO_VECTOR_MATH_X86
+  template <typename V>
+  static STABLEHLO_INLINE bool vector(const V &x, V &result) {
+    if (!isAllTrue<V>(lessThan(abs(x), splat<V>(kMaxTrigonometricInput))))
+      return false;
+    result = sineKernel(x, 1);
+    return true;
+  }
+#endif
+};
+
+struct Exponential {
+  static double scalar(double x) { return std::exp(x); }
+#ifdef STABLEHLO_VECTOR_MATH_X86
+  template <typename V>
+  static STABLEHLO_INLINE bool vector(const V &x, V &result) {
+    result = exponentialKernel(x);
+    return true;
+  }
+#endif
+};
+
+struct Log {
+  static double scalar(double x) { return std::log(x); }
+#ifdef STABLEHLO_VECTOR_MATH_X86
+  template <typename V>
+  static STABLEHLO_INLINE bool vector(const V &x, V &result) {
+    result = logKernel(x);
+    return true;
+  }
+#endif
+};
+
+struct Sine {
+  static double scalar(double x) { return std::sin(x); }
+#ifdef STABLEHLO_VECTOR_MATH_X86
+  template <typename V>
+  static STABLEHLO_INLINE bool vector(const V &x, V &result) {
+    if (!isAllTrue<V>(lessThan(abs(x), splat<V>(kMaxTrigonometricInput))))
+      return false;
+    // sin(-0) = -0, but the kernel computes r + r * ... = +0 for r = -0.
+    result = sineKernel(x, 0);
+    result = select(equal(x, splat<V>(0.0)), x, result);
+    return true;
+  }
+#endif
+};
+
+struct Tanh {
+  static double scalar(double x) { return std::tanh(x); }
+#ifdef STABLEHLO_VECTOR_MATH_X86
+  template <typename V>
+  static STABLEHLO_INLINE bool vector(const V &x, V &result) {
+    result = tanhKernel(x);
+    return true;
+  }
+#endif
+};
+
+template <typename T>
+void checkSizes(ArrayRef<T> operand, MutableArrayRef<T> result) {
+  if (operand.size() != result.size())
+    llvm::report_fatal_error("Mismatched operand and result sizes");
+}
+
+template <typename T, typename Fn>
+void mapScalar(ArrayRef<T> operand, MutableArrayRef<T> result, Fn fn) {
+  checkSizes(operand, result);
+  for (size_t i = 0; i < operand.size(); ++i)
+    result[i] = static_cast<T>(fn(static_cast<double>(operand[i])));
+}
+
+#ifdef STABLEHLO_VECTOR_MATH_X86
+
+enum class InstructionSet { kNone, kAvx2, kAvx512 };
+
+InstructionSet getInstructionSet() {
+  static const InstructionSet instructionSet = [] {
+    if (__builtin_cpu_supports("avx512f")) return InstructionSet::kAvx512;
+    if (__builtin_cpu_supports("avx2")) return InstructionSet::kAvx2;
+    return InstructionSet::kNone;
+  }();
+  return instructionSet;
+}
+
+// Applies `Kernel` to one vector worth of f32 data.
+template <typename V, typename Kernel>
+STABLEHLO_INLINE void mapBlock(const float *operand, float *result) {
+  using Float = typename VectorTraits<V>::Float;
+  Float x;
+  std::memcpy(&x, operand, sizeof(x));
+  V y;
+  if (Kernel::vector(__builtin_convertvector(x, V), y)) {
+    Float z = __builtin_convertvector(y, Float);
+    std::memcpy(result, &z, sizeof(z));
+    return;
+  }
+  for (int64_t i = 0; i < VectorTraits<V>::kSize; ++i)
+    result[i] = static_cast<float>(Kernel::scalar(operand[i]));
+}
+
+// Applies `Kernel` to f32 data, processing the tail via a zero-padded copy.
+template <typename V, typename Kernel>
+STABLEHLO_INLINE void mapVector(const float *operand, float *result,
+                                int64_t size) {
+  constexpr int64_t kSize = VectorTraits<V>::kSize;
+  int64_t i = 0;
+  for (; i + kSize <= size; i += kSize)
+    mapBlock<V, Kernel>(operand + i, result + i);
+  if (i == size) return;
+
+  float in[kSize] = {};
+  float out[kSize];
+  std::memcpy(in, operand + i, (size - i) * sizeof(float));
+  mapBlock<V, Kernel>(in, out);
+  std::memcpy(result + i, out, (size - i) * sizeof(float));
+}
+
+template <typename Kernel>
+__attribute__((target("avx2"))) void mapAvx2(const float *operand,
+                                             float *result, int64_t size) {
+  mapVector<Double4, Kernel>(operand, result, size);
+}
+
+template <typename Kernel>
+__attribute__((target("avx512f"))) void mapAvx512(const float *operand,
+                                                  float *result,
+                                                  int64_t size) {
+  mapVector<Double8, Kernel>(operand, result, size);
+}
+
+// sqrt and rsqrt are correctly rounded operations, so their vector versions
+// give bit-identical results for both f32 and f64.
+
+// The AVX-512 versions use the zero-masking forms of the intrinsics with all
+// lanes enabled, which compute the same as the unmasked forms. GCC implements
+// the latter with an uninitialized pass-through operand, which it then warns
+// about with -Wmaybe-uninitialized.
+constexpr __mmask8 kAllLanes = 0xFF;
+
+template <bool kReciprocal>
+__attribute__((target("avx2"))) void sqrtAvx2(const float *operand,
+                                              float *result, int64_t size) {
+  int64_t i = 0;
+  for (; i + 4 <= size; i += 4) {
+    __m256d y = _mm256_sqrt_pd(_mm256_cvtps_pd(_mm_loadu_ps(operand + i)));
+    if (kReciprocal) y = _mm256_div_pd(_mm256_set1_pd(1.0), y);
+    _mm_storeu_ps(result + i, _mm256_cvtpd_ps(y));
+  }
+  for (; i < size; ++i) {
+    double y = std::sqrt(static_cast<double>(operand[i]));
+    result[i] = static_cast<float>(kReciprocal ? 1.0 / y : y);
+  }
+}
+
+template <bool kReciprocal>
+__attribute__((target("avx2"))) void sqrtAvx2(const double *operand,
+                                              double *result, int64_t size) {
+  int64_t i = 0;
+  for (; i + 4 <= size; i += 4) {
+    __m256d y = _mm256_sqrt_pd(_mm256_loadu_pd(operand + i));
+    if (kReciprocal) y = _mm256_div_pd(_mm256_set1_pd(1.0), y);
+    _mm256_storeu_pd(result + i, y);
+  }
+  for (; i < size; ++i) {
+    double y = std::sqrt(operand[i]);
+    result[i] = kReciprocal ? 1.0 / y : y;
+  }
+}
+
+template <bool kReciprocal>
+__attribute__((target("avx512f"))) void sqrtAvx512(const float *operand,
+                                                   float *result,
+                                                   int64_t size) {
+  int64_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    __m512d x = _mm512_maskz_cvtps_pd(kAllLanes, _mm256_loadu_ps(operand + i));
+    __m512d y = _mm512_maskz_sqrt_pd(kAllLanes, x);
+    if (kReciprocal) y = _mm512_div_pd(_mm512_set1_pd(1.0), y);
+    _mm256_storeu_ps(result + i, _mm512_maskz_cvtpd_ps(kAllLanes, y));
+  }
+  for (; i < size; ++i) {
+    double y = std::sqrt(static_cast<double>(operand[i]));
+    result[i] = static_cast<float>(kReciprocal ? 1.0 / y : y);
+  }
+}
+
+template <bool kReciprocal>
+__attribute__((target("avx512f"))) void sqrtAvx512(const double *operand,
+                                                   double *result,
+                                                   int64_t size) {
+  int64_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    __m512d y = _mm512_maskz_sqrt_pd(kAllLanes, _mm512_loadu_pd(operand + i));
+    if (kReciprocal) y = _mm512_div_pd(_mm512_set1_pd(1.0), y);
+    _mm512_storeu_pd(result + i, y);
+  }
+  for (; i < size; ++i) {
+    double y = std::sqrt(operand[i]);
+    result[i] = kReciprocal ? 1.0 / y : y;
+  }
+}
+
+#endif  // STABLEHLO_VECTOR_MATH_X86
+
+template <typename Kernel>
+void map(ArrayRef<float> operand, MutableArrayRef<float> result) {
+  checkSizes(operand, result);
+#ifdef STABLEHLO_VECTOR_MATH_X86
+  switch (getInstructionSet()) {
+    case InstructionSet::kAvx512:
+      return mapAvx512<Kernel>(operand.data(), result.data(), operand.size());
+    case InstructionSet::kAvx2:
+      return mapAvx2<Kernel>(operand.data(), result.data(), operand.size());
+    case InstructionSet::kNone:
+      break;
+  }
+#endif
+  mapScalar(operand, result, Kernel::scalar);
+}
+
+template <typename Kernel>
+void map(ArrayRef<double> operand, MutableArrayRef<double> result) {
+  mapScalar(operand, result, Kernel::scalar);
+}
+
+template <bool kReciprocal, typename T>
+void mapSqrt(ArrayRef<T> operand, MutableArrayRef<T> result) {
+  checkSizes(operand, result);
+#ifdef STABLEHLO_VECTOR_MATH_X86
+  switch (getInstructionSet()) {
+    case InstructionSet::kAvx512:
+      return sqrtAvx512<kReciprocal>(operand.data(), result.data(),
+                                     operand.size());
+    case InstructionSet::kAvx2:
+      return sqrtAvx2<kReciprocal>(operand.data(), result.data(),
+                                   operand.size());
+    case InstructionSet::kNone:
+      break;
+  }
+#endif
+  mapScalar(operand, result, [](double x) {
+    return kReciprocal ? 1.0 / std::sqrt(x) : std::sqrt(x);
+  });
+}
+
+}  // namespace
+
+void cosine(ArrayRef<float> operand, MutableArrayRef<float> result) {
+  map<Cosine>(operand, result);
+}
+
+void cosine(ArrayRef<double> operand, MutableArrayRef<double> result) {
+  map<Cosine>(operand, result);
+}
+
+void exponential(ArrayRef<float> operand, MutableArrayRef<float> result) {
+  map<Exponential>(operand, result);
+}
+
+void exponential(ArrayRef<double> operand, MutableArrayRef<double> result) {
+  map<Exponential>(operand, result);
+}
+
+void log(ArrayRef<float> operand, MutableArrayRef<float> result) {
+  map<Log>(operand, result);
+}
+
+void log(ArrayRef<double> operand, MutableArrayRef<double> result) {
+  map<Log>(operand, result);
+}
+
+void rsqrt(ArrayRef<float> operand, MutableArrayRef<float> result) {
+  mapSqrt</*kReciprocal=*/true>(operand, result);
+}
+
+void rsqrt(ArrayRef<double> operand, MutableArrayRef<double> result) {
+  mapSqrt</*kReciprocal=*/true>(operand, result);
+}
+
+void sine(ArrayRef<float> operand, MutableArrayRef<float> result) {
+  map<Sine>(operand, result);
+}
+
+void sine(ArrayRef<double> operand, MutableArrayRef<double> result) {
+  map<Sine>(operand, result);
+}
+
+void sqrt(ArrayRef<float> operand, MutableArrayRef<float> result) {
+  mapSqrt</*kReciprocal=*/false>(operand, result);
+}
+
+void sqrt(ArrayRef<double> operand, MutableArrayRef<double> result) {
+  mapSqrt</*kReciprocal=*/false>(operand, result);
+}
+
+void tanh(ArrayRef<float> operand, MutableArrayRef<float> result) {
+  map<Tanh>(operand, result);
+}
+
+void tanh(ArrayRef<double> operand, MutableArrayRef<double> result) {
+  map<Tanh>(operand, result);
+}
+
+}  // namespace native
+}  // namespace stablehlo
+}  // namespace mlir
@@ -0,0 +1,67 @@
+/* Copyright 2023 The StableHLO Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef STABLEHLO_REFERENCE_VECTORMATH_H
+#define STABLEHLO_REFERENCE_VECTORMATH_H
+
+#include "llvm/ADT/ArrayRef.h"
+#include "mlir/Support/LLVM.h"
+
+namespace mlir {
+namespace stablehlo {
+namespace native {
+
+/// Batch versions of the unary math functions from Kernels.h. Each function
+/// computes `result[i] = fn(operand[i])` for all `i`, where `operand` and
+/// `result` have the same size and may be the same array.
+///
+/// On x86-64, f32 kernels are vectorized using AVX-512 or AVX2, whichever is
+/// the best instruction set supported by the host, with the choice made once
+/// at runtime. Otherwise, the kernels fall back to calling libm element by
+/// element, exactly like the `Element` implementation does.
+///
+/// Accuracy:
+///   * f32 exponential, log, sine, cosine, tanh: evaluated in double precision
+///     with a relative error of at most 4 ULPs of double before rounding to
+///     f32, so results are within 1 ULP of f32 of the correctly rounded result
+///     and match the libm-based scalar path except for inputs whose exact
+///     result lies within ~2^-50 of a rounding boundary.
+///   * f32 and f64 sqrt, rsqrt: computed with IEEE-754 sqrt and divide
+///     instructions and thus bit-identical to the scalar path.
+///   * f64 exponential, log, sine, cosine, tanh: not vectorized, because
+///     `check.almost_eq` only tolerates differences for positive values, so
+///     anything less than the accuracy of libm would be observable.
+/// @{
+void cosine(ArrayRef<float> operand, MutableArrayRef<float> result);
+void cosine(ArrayRef<double> operand, MutableArrayRef<double> result);
+void exponential(ArrayRef<float> operand, MutableArrayRef<float> result);
+void exponential(ArrayRef<double> operand, MutableArrayRef<double> result);
+void log(ArrayRef<float> operand, MutableArrayRef<float> result);
+void log(ArrayRef<double> operand, MutableArrayRef<double> result);
+void rsqrt(ArrayRef<float> operand, MutableArrayRef<float> result);
+void rsqrt(ArrayRef<double> operand, MutableArrayRef<double> result);
+void sine(ArrayRef<float> operand, MutableArrayRef<float> result);
+void sine(ArrayRef<double> operand, MutableArrayRef<double> result);
+void sqrt(ArrayRef<float> operand, MutableArrayRef<float> result);
+void sqrt(ArrayRef<double> operand, MutableArrayRef<double> result);
+void tanh(ArrayRef<float> operand, MutableArrayRef<float> result);
+void tanh(ArrayRef<double> operand, MutableArrayRef<double> result);
+/// @}
+
+}  // namespace native
+}  // namespace stablehlo
+}  // namespace mlir
+
+#endif  // STABLEHLO_REFERENCE_VECTORMATH_H
@@ -0,0 +1,150 @@
+/* Copyright 2023 The StableHLO Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Times `native::gemm` against a naive triple loop, which computes every
+// element of the product the same way, and checks that both give the same
+// results. Not built by default:
+//
+//   cmake --build build --target stablehlo-gemm-benchmark
+//   build/bin/stablehlo-gemm-benchmark --threads=1
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/raw_ostream.h"
+#include "stablehlo/reference/Gemm.h"
+#include "stablehlo/reference/Kernels.h"
+#include "stablehlo/reference/Parallel.h"
+
+namespace mlir {
+namespace stablehlo {
+namespace {
+
+llvm::cl::opt<unsigned> numThreads(
+    "threads",
+    llvm::cl::desc("Number of threads used by `gemm`, 0 for one per hardware "
+                   "thread"),
+    llvm::cl::init(1));
+
+llvm::cl::opt<unsigned> numRepetitions(
+    "repetitions",
+    llvm::cl::desc("Number of timed runs per shape, of which the fastest is "
+                   "reported"),
+    llvm::cl::init(3));
+
+struct Shape {
+  int64_t batchSize;
+  int64_t m;
+  int64_t n;
+  int64_t k;
+};
+
+// Small and large square matrices, a matrix-vector product, long and thin
+// matrices, and many small batches.
+constexpr Shape kShapes[] = {
+    {1, 64, 64, 64},     {1, 256, 256, 256}, {1, 512, 512, 512},
+    {1, 1024, 1, 1024},  {1, 1024, 64, 512}, {1, 64, 1024, 512},
+    {256, 16, 16, 16},
+};
+
+// Computes the same product as `native::gemm`, one element after the other.
+template <typename T>
+void naiveGemm(int64_t batchSize, int64_t m, int64_t n, int64_t k,
+               const T *lhs, const T *rhs, T *result) {
+  for (int64_t b = 0; b < batchSize; ++b, lhs += m * k, rhs += k * n)
+    for (int64_t i = 0; i < m; ++i)
+      for (int64_t j = 0; j < n; ++j) {
+        T sum = T();
+        for (int64_t p = 0; p < k; ++p)
+          sum = native::add(sum, native::multiply(lhs[i * k + p],
+                                                  rhs[p * n + j]));
+        *result++ = sum;
+      }
+}
+
+// Returns the fastest of `numRepetitions` runs of `fn` in milliseconds.
+template <typename Fn>
+double getBestTime(Fn fn) {
+  double best = 0;
+  for (unsigned i = 0; i < std::max(numRepetitions.getValue(), 1u); ++i) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - start;
+    if (i == 0 || elapsed.count() < best) best = elapsed.count();
+  }
+  return best;
+}
+
+// Benchmarks all shapes for element type `T` and returns false if `gemm`
+// and the naive loop disagree for any of them.
+template <typename T>
+bool benchmark(const char *typeName) {
+  std::mt19937 generator(42);
+  std::uniform_real_distribution<double> distribution(-1, 1);
+  bool success = true;
+  for (const Shape &shape : kShapes) {
+    auto [batchSize, m, n, k] = shape;
+    std::vector<T> lhs(batchSize * m * k);
+    std::vector<T> rhs(batchSize * k * n);
+    for (T &value : lhs) value = static_cast<T>(distribution(generator));
+    for (T &value : rhs) value = static_cast<T>(distribution(generator));
+
+    std::vector<T> expected(batchSize * m * n);
+    std::vector<T> actual(batchSize * m * n);
+    double naiveTime = getBestTime([&] {
+      naiveGemm(batchSize, m, n, k, lhs.data(), rhs.data(), expected.data());
+    });
+    double gemmTime = getBestTime([&] {
+      native::gemm(batchSize, m, n, k, lhs.data(), rhs.data(), actual.data());
+    });
+
+    // Both add up the products in the same order, so the results are
+    // bit-identical rather than merely close.
+    bool matches = std::memcmp(expected.data(), actual.data(),
+                               expected.size() * sizeof(T)) == 0;
+    success &= matches;
+    llvm::outs() << llvm::format(
+        "%-4s %4lld x %4lld x %4lld x %4lld: gemm %9.3f ms, naive %9.3f ms, "
+        "speedup %6.2fx%s\n",
+        typeName, static_cast<long long>(batchSize),
+        static_cast<long long>(m), static_cast<long long>(n),
+        static_cast<long long>(k), gemmTime, naiveTime,
+        naiveTime / std::max(gemmTime, 1e-9),
+        matches ? "" : ", MISMATCH");
+  }
+  return success;
+}
+
+}  // namespace
+}  // namespace stablehlo
+}  // namespace mlir
+
+int main(int argc, char **argv) {
+  llvm::cl::ParseCommandLineOptions(argc, argv,
+                                    "Benchmark of the interpreter's GEMM\n");
+  mlir::stablehlo::setNumThreads(mlir::stablehlo::numThreads);
+  llvm::outs() << "batch x m x n x k, best of "
+               << mlir::stablehlo::numRepetitions << " runs\n";
+  bool success = mlir::stablehlo::benchmark<float>("f32");
+  success &= mlir::stablehlo::benchmark<double>("f64");
+  return success ? 0 : 1;
+}
@@ -1,4 +1,6 @@
 // RUN: stablehlo-interpreter --interpret -split-input-file %s
+// RUN: stablehlo-interpreter --interpret --threads=4 -split-input-file %s
+// RUN: stablehlo-interpreter --interpret --threads=4 --inter-op-parallelism -split-input-file %s
 
 func.func @add_op_test_si4() {
   %0 = stablehlo.constant dense<[0, 1, 2, -3, 0]> : tensor<5xi4>
@@ -189,3 +191,35 @@ func.func @add_op_tensor_shape_with_zero_dim_size() {
   check.eq %2, dense<> : tensor<2x0x3xi4>
   func.return
 }
+
+// -----
+
+func.func @add_op_test_si64_reused_operands() {
+  %0 = stablehlo.constant dense<[1, 2]> : tensor<2xi64>
+  %1 = stablehlo.add %0, %0 : tensor<2xi64>
+  %2 = stablehlo.add %1, %0 : tensor<2xi64>
+  %3 = stablehlo.add %2, %2 : tensor<2xi64>
+  %4 = stablehlo.add %3, %1 : tensor<2xi64>
+  check.eq %4, dense<[8, 16]> : tensor<2xi64>
+  check.eq %0, dense<[1, 2]> : tensor<2xi64>
+  func.return
+}
+
+// -----
+
+func.func @add_op_test_f32_large() {
+  %0 = stablehlo.constant dense<[1.0, 2.0]> : tensor<2xf32>
+  %1 = "stablehlo.broadcast_in_dim"(%0) {
+    broadcast_dimensions = dense<[1]> : tensor<1xi64>
+  } : (tensor<2xf32>) -> tensor<65536x2xf32>
+  %2 = "stablehlo.transpose"(%1) {
+    permutation = dense<[1, 0]> : tensor<2xi64>
+  } : (tensor<65536x2xf32>) -> tensor<2x65536xf32>
+  %3 = stablehlo.constant dense<[[2.0], [1.0]]> : tensor<2x1xf32>
+  %4 = "stablehlo.broadcast_in_dim"(%3) {
+    broadcast_dimensions = dense<[0, 1]> : tensor<2xi64>
+  } : (tensor<2x1xf32>) -> tensor<2x65536xf32>
+  %5 = stablehlo.add %2, %4 : tensor<2x65536xf32>
+  check.eq %5, dense<3.0> : tensor<2x65536xf32>
+  func.return
+}
@@ -0,0 +1,55 @@
+// RUN: stablehlo-interpreter --interpret --num-replicas=4 -split-input-file %s
+// RUN: stablehlo-interpreter --interpret --num-replicas=4 --threads=4 --inter-op-parallelism -split-input-file %s
+
+func.func @all_gather() {
+  %table = stablehlo.constant dense<[[1.0, 2.0], [3.0, 4.0], [5.0, 6.0], [7.0, 8.0]]> : tensor<4x2xf32>
+  %replica_id = "stablehlo.replica_id"() : () -> tensor<ui32>
+  %zero = stablehlo.constant dense<0> : tensor<ui32>
+  %operand = "stablehlo.dynamic_slice"(%table, %replica_id, %zero) {
+    slice_sizes = dense<[1, 2]> : tensor<2xi64>
+  } : (tensor<4x2xf32>, tensor<ui32>, tensor<ui32>) -> tensor<1x2xf32>
+  %result = "stablehlo.all_gather"(%operand) {
+    all_gather_dim = 0 : i64,
+    replica_groups = dense<[[0, 1, 2, 3]]> : tensor<1x4xi64>
+  } : (tensor<1x2xf32>) -> tensor<4x2xf32>
+  check.eq %result, dense<[[1.0, 2.0], [3.0, 4.0], [5.0, 6.0], [7.0, 8.0]]> : tensor<4x2xf32>
+  func.return
+}
+
+// -----
+
+func.func @all_gather_in_group_order() {
+  %table = stablehlo.constant dense<[[1, 2], [3, 4], [5, 6], [7, 8]]> : tensor<4x2xi32>
+  %replica_id = "stablehlo.replica_id"() : () -> tensor<ui32>
+  %zero = stablehlo.constant dense<0> : tensor<ui32>
+  %operand = "stablehlo.dynamic_slice"(%table, %replica_id, %zero) {
+    slice_sizes = dense<[1, 2]> : tensor<2xi64>
+  } : (tensor<4x2xi32>, tensor<ui32>, tensor<ui32>) -> tensor<1x2xi32>
+  %result = "stablehlo.all_gather"(%operand) {
+    all_gather_dim = 0 : i64,
+    replica_groups = dense<[[3, 2, 1, 0]]> : tensor<1x4xi64>
+  } : (tensor<1x2xi32>) -> tensor<4x2xi32>
+  check.eq %result, dense<[[7, 8], [5, 6], [3, 4], [1, 2]]> : tensor<4x2xi32>
+  func.return
+}
+
+// -----
+
+func.func @all_gather_replica_groups() {
+  %table = stablehlo.constant dense<[[1, 2], [3, 4], [5, 6], [7, 8]]> : tensor<4x2xi32>
+  %replica_id = "stablehlo.replica_id"() : () -> tensor<ui32>
+  %zero = stablehlo.constant dense<0> : tensor<ui32>
+  %operand = "stablehlo.dynamic_slice"(%table, %replica_id, %zero) {
+    slice_sizes = dense<[1, 2]> : tensor<2xi64>
+  } : (tensor<4x2xi32>, tensor<ui32>, tensor<ui32>) -> tensor<1x2xi32>
+  %result = "stablehlo.all_gather"(%operand) {
+    all_gather_dim = 1 : i64,
+    replica_groups = dense<[[0, 2], [1, 3]]> : tensor<2x2xi64>
+  } : (tensor<1x2xi32>) -> tensor<1x4xi32>
+  %gathered = "stablehlo.all_gather"(%result) {
+    all_gather_dim = 0 : i64,
+    replica_groups = dense<[[0, 1, 2, 3]]> : tensor<1x4xi64>
+  } : (tensor<1x4xi32>) -> tensor<4x4xi32>
+  check.eq %gathered, dense<[[1, 2, 5, 6], [3, 4, 7, 8], [1, 2, 5, 6], [3, 4, 7, 8]]> : tensor<4x4xi32>
+  func.return
+}
@@ -0,0 +1,110 @@
+// RUN: stablehlo-interpreter --interpret --num-replicas=4 -split-input-file %s
+// RUN: stablehlo-interpreter --interpret --num-replicas=4 --threads=4 --inter-op-parallelism -split-input-file %s
+
+func.func @all_reduce_add() {
+  %table = stablehlo.constant dense<[[1.0, 2.0, 3.0, 4.0, 5.0], [10.0, 20.0, 30.0, 40.0, 50.0], [100.0, 200.0, 300.0, 400.0, 500.0], [1000.0, 2000.0, 3000.0, 4000.0, 5000.0]]> : tensor<4x5xf32>
+  %replica_id = "stablehlo.replica_id"() : () -> tensor<ui32>
+  %zero = stablehlo.constant dense<0> : tensor<ui32>
+  %row = "stablehlo.dynamic_slice"(%table, %replica_id, %zero) {
+    slice_sizes = dense<[1, 5]> : tensor<2xi64>
+  } : (tensor<4x5xf32>, tensor<ui32>, tensor<ui32>) -> tensor<1x5xf32>
+  %operand = "stablehlo.reshape"(%row) : (tensor<1x5xf32>) -> tensor<5xf32>
+  %result = "stablehlo.all_reduce"(%operand) ({
+    ^bb0(%arg0: tensor<f32>, %arg1: tensor<f32>):
+      %0 = "stablehlo.add"(%arg0, %arg1) : (tensor<f32>, tensor<f32>) -> tensor<f32>
+      "stablehlo.return"(%0) : (tensor<f32>) -> ()
+  }) {
+    replica_groups = dense<[[0, 1, 2, 3]]> : tensor<1x4xi64>
+  } : (tensor<5xf32>) -> tensor<5xf32>
+  check.eq %result, dense<[1111.0, 2222.0, 3333.0, 4444.0, 5555.0]> : tensor<5xf32>
+  func.return
+}
+
+// -----
+
+func.func @all_reduce_max_replica_groups() {
+  %table = stablehlo.constant dense<[[1, 20], [10, 2], [-3, -4], [-5, -6]]> : tensor<4x2xi32>
+  %replica_id = "stablehlo.replica_id"() : () -> tensor<ui32>
+  %zero = stablehlo.constant dense<0> : tensor<ui32>
+  %operand = "stablehlo.dynamic_slice"(%table, %replica_id, %zero) {
+    slice_sizes = dense<[1, 2]> : tensor<2xi64>
+  } : (tensor<4x2xi32>, tensor<ui32>, tensor<ui32>) -> tensor<1x2xi32>
+  %result = "stablehlo.all_reduce"(%operand) ({
+    ^bb0(%arg0: tensor<i32>, %arg1: tensor<i32>):
+      %0 = "stablehlo.maximum"(%arg0, %arg1) : (tensor<i32>, tensor<i32>) -> tensor<i32>
+      "stablehlo.return"(%0) : (tensor<i32>) -> ()
+  }) {
+    replica_groups = dense<[[0, 1], [2, 3]]> : tensor<2x2xi64>
+  } : (tensor<1x2xi32>) -> tensor<1x2xi32>
+  %gathered = "stablehlo.all_gather"(%result) {
+    all_gather_dim = 0 : i64,
+    replica_groups = dense<[[0, 1, 2, 3]]> : tensor<1x4xi64>
+  } : (tensor<1x2xi32>) -> tensor<4x2xi32>
+  check.eq %gathered, dense<[[10, 20], [10, 20], [-3, -4], [-3, -4]]> : tensor<4x2xi32>
+  func.return
+}
+
+// -----
+
+func.func @all_reduce_subtract_in_group_order() {
+  %table = stablehlo.constant dense<[[1000, 2000], [1, 2], [10, 20], [100, 200]]> : tensor<4x2xi64>
+  %replica_id = "stablehlo.replica_id"() : () -> tensor<ui32>
+  %zero = stablehlo.constant dense<0> : tensor<ui32>
+  %row = "stablehlo.dynamic_slice"(%table, %replica_id, %zero) {
+    slice_sizes = dense<[1, 2]> : tensor<2xi64>
+  } : (tensor<4x2xi64>, tensor<ui32>, tensor<ui32>) -> tensor<1x2xi64>
+  %operand = "stablehlo.reshape"(%row) : (tensor<1x2xi64>) -> tensor<2xi64>
+  %result = "stablehlo.all_reduce"(%operand) ({
+    ^bb0(%arg0: tensor<i64>, %arg1: tensor<i64>):
+      %0 = "stablehlo.subtract"(%arg0, %arg1) : (tensor<i64>, tensor<i64>) -> tensor<i64>
+      "stablehlo.return"(%0) : (tensor<i64>) -> ()
+  }) {
+    replica_groups = dense<[[3, 2, 1, 0]]> : tensor<1x4xi64>
+  } : (tensor<2xi64>) -> tensor<2xi64>
+  check.eq %result, dense<[-911, -1822]> : tensor<2xi64>
+  func.return
+}
+
+// -----
+
+func.func @all_reduce_single_replica_groups() {
+  %operand = stablehlo.constant dense<[[1.0, 2.0], [3.0, 4.0]]> : tensor<2x2xf64>
+  %result = "stablehlo.all_reduce"(%operand) ({
+    ^bb0(%arg0: tensor<f64>, %arg1: tensor<f64>):
+      %0 = "stablehlo.add"(%arg0, %arg1) : (tensor<f64>, tensor<f64>) -> tensor<f64>
+      "stablehlo.return"(%0) : (tensor<f64>) -> ()
+  }) {
+    replica_groups = dense<[[0], [1], [2], [3]]> : tensor<4x1xi64>
+  } : (tensor<2x2xf64>) -> tensor<2x2xf64>
+  check.eq %result, dense<[[1.0, 2.0], [3.0, 4.0]]> : tensor<2x2xf64>
+  func.return
+}
+
+// -----
+
+func.func @all_reduce_in_while_loop() {
+  %init = stablehlo.constant dense<1> : tensor<i64>
+  %zero = stablehlo.constant dense<0> : tensor<i64>
+  %result:2 = "stablehlo.while"(%zero, %init) ({
+    ^bb0(%i: tensor<i64>, %value: tensor<i64>):
+      %limit = stablehlo.constant dense<3> : tensor<i64>
+      %cond = "stablehlo.compare"(%i, %limit) {
+        comparison_direction = #stablehlo<comparison_direction LT>
+      } : (tensor<i64>, tensor<i64>) -> tensor<i1>
+      "stablehlo.return"(%cond) : (tensor<i1>) -> ()
+  }, {
+    ^bb0(%i: tensor<i64>, %value: tensor<i64>):
+      %one = stablehlo.constant dense<1> : tensor<i64>
+      %next_i = "stablehlo.add"(%i, %one) : (tensor<i64>, tensor<i64>) -> tensor<i64>
+      %sum = "stablehlo.all_reduce"(%value) ({
+        ^bb0(%arg0: tensor<i64>, %arg1: tensor<i64>):
+          %0 = "stablehlo.add"(%arg0, %arg1) : (tensor<i64>, tensor<i64>) -> tensor<i64>
+          "stablehlo.return"(%0) : (tensor<i64>) -> ()
+      }) {
+        replica_groups = dense<[[0, 1, 2, 3]]> : tensor<1x4xi64>
+      } : (tensor<i64>) -> tensor<i64>
+      "stablehlo.return"(%next_i, %sum) : (tensor<i64>, tensor<i64>) -> ()
+  }) : (tensor<i64>, tensor<i64>) -> (tensor<i64>, tensor<i64>)
+  check.eq %result#1, dense<64> : tensor<i64>
+  func.return
+}
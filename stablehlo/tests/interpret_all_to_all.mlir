@@ -0,0 +1,48 @@
+// RUN: stablehlo-interpreter --interpret --num-replicas=4 -split-input-file %s
+// RUN: stablehlo-interpreter --interpret --num-replicas=4 --threads=4 --inter-op-parallelism -split-input-file %s
+
+func.func @all_to_all_transpose() {
+  %table = stablehlo.constant dense<[[0, 1, 2, 3], [4, 5, 6, 7], [8, 9, 10, 11], [12, 13, 14, 15]]> : tensor<4x4xi32>
+  %replica_id = "stablehlo.replica_id"() : () -> tensor<ui32>
+  %zero = stablehlo.constant dense<0> : tensor<ui32>
+  %operand = "stablehlo.dynamic_slice"(%table, %replica_id, %zero) {
+    slice_sizes = dense<[1, 4]> : tensor<2xi64>
+  } : (tensor<4x4xi32>, tensor<ui32>, tensor<ui32>) -> tensor<1x4xi32>
+  %result = "stablehlo.all_to_all"(%operand) {
+    split_dimension = 1 : i64,
+    concat_dimension = 0 : i64,
+    split_count = 4 : i64,
+    replica_groups = dense<[[0, 1, 2, 3]]> : tensor<1x4xi64>
+  } : (tensor<1x4xi32>) -> tensor<4x1xi32>
+  %column = "stablehlo.reshape"(%result) : (tensor<4x1xi32>) -> tensor<1x4xi32>
+  %gathered = "stablehlo.all_gather"(%column) {
+    all_gather_dim = 0 : i64,
+    replica_groups = dense<[[0, 1, 2, 3]]> : tensor<1x4xi64>
+  } : (tensor<1x4xi32>) -> tensor<4x4xi32>
+  check.eq %gathered, dense<[[0, 4, 8, 12], [1, 5, 9, 13], [2, 6, 10, 14], [3, 7, 11, 15]]> : tensor<4x4xi32>
+  func.return
+}
+
+// -----
+
+func.func @all_to_all_replica_groups() {
+  %table = stablehlo.constant dense<[[0.0, 1.0, 2.0, 3.0], [4.0, 5.0, 6.0, 7.0], [8.0, 9.0, 10.0, 11.0], [12.0, 13.0, 14.0, 15.0]]> : tensor<4x4xf32>
+  %replica_id = "stablehlo.replica_id"() : () -> tensor<ui32>
+  %zero = stablehlo.constant dense<0> : tensor<ui32>
+  %row = "stablehlo.dynamic_slice"(%table, %replica_id, %zero) {
+    slice_sizes = dense<[1, 4]> : tensor<2xi64>
+  } : (tensor<4x4xf32>, tensor<ui32>, tensor<ui32>) -> tensor<1x4xf32>
+  %operand = "stablehlo.reshape"(%row) : (tensor<1x4xf32>) -> tensor<2x2xf32>
+  %result = "stablehlo.all_to_all"(%operand) {
+    split_dimension = 0 : i64,
+    concat_dimension = 1 : i64,
+    split_count = 2 : i64,
+    replica_groups = dense<[[0, 1], [2, 3]]> : tensor<2x2xi64>
+  } : (tensor<2x2xf32>) -> tensor<1x4xf32>
+  %gathered = "stablehlo.all_gather"(%result) {
+    all_gather_dim = 0 : i64,
+    replica_groups = dense<[[0, 1, 2, 3]]> : tensor<1x4xi64>
+  } : (tensor<1x4xf32>) -> tensor<4x4xf32>
+  check.eq %gathered, dense<[[0.0, 1.0, 4.0, 5.0], [2.0, 3.0, 6.0, 7.0], [8.0, 9.0, 12.0, 13.0], [10.0, 11.0, 14.0, 15.0]]> : tensor<4x4xf32>
+  func.return
+}
@@ -0,0 +1,30 @@
+// RUN: stablehlo-interpreter --interpret -split-input-file %s
+// RUN: stablehlo-interpreter --interpret --threads=4 -split-input-file %s
+
+func.func @atan2_op_test_f32() {
+  %lhs = stablehlo.constant dense<[0.0, 1.0, -1.0]> : tensor<3xf32>
+  %rhs = stablehlo.constant dense<[0.0, 0.0, 0.0]> : tensor<3xf32>
+  %result = stablehlo.atan2 %lhs, %rhs : tensor<3xf32>
+  check.almost_eq %result, dense<[0.0, 1.5707964, -1.5707964]> : tensor<3xf32>
+  func.return
+}
+
+// -----
+
+func.func @atan2_op_test_f64() {
+  %lhs = stablehlo.constant dense<[1.0, -3.0]> : tensor<2xf64>
+  %rhs = stablehlo.constant dense<[2.0, -4.0]> : tensor<2xf64>
+  %result = stablehlo.atan2 %lhs, %rhs : tensor<2xf64>
+  check.almost_eq %result, dense<[0.4636476090008061, -2.498091544796509]> : tensor<2xf64>
+  func.return
+}
+
+// -----
+
+func.func @atan2_op_test_c64() {
+  %lhs = stablehlo.constant dense<(1.0, 2.0)> : tensor<complex<f32>>
+  %rhs = stablehlo.constant dense<(3.0, 1.0)> : tensor<complex<f32>>
+  %result = stablehlo.atan2 %lhs, %rhs : tensor<complex<f32>>
+  check.almost_eq %result, dense<(0.5535744, 0.4023595)> : tensor<complex<f32>>
+  func.return
+}
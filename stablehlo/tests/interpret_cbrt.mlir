@@ -0,0 +1,36 @@
+// RUN: stablehlo-interpreter --interpret -split-input-file %s
+// RUN: stablehlo-interpreter --interpret --threads=4 -split-input-file %s
+
+func.func @cbrt_op_test_f32() {
+  %operand = stablehlo.constant dense<[0.0, 1.0, 8.0, 27.0]> : tensor<4xf32>
+  %result = stablehlo.cbrt %operand : tensor<4xf32>
+  check.almost_eq %result, dense<[0.0, 1.0, 2.0, 3.0]> : tensor<4xf32>
+  func.return
+}
+
+// -----
+
+func.func @cbrt_op_test_f64() {
+  %operand = stablehlo.constant dense<[-8.0, 2.0]> : tensor<2xf64>
+  %result = stablehlo.cbrt %operand : tensor<2xf64>
+  check.almost_eq %result, dense<[-2.0, 1.2599210498948734]> : tensor<2xf64>
+  func.return
+}
+
+// -----
+
+func.func @cbrt_op_test_f16() {
+  %operand = stablehlo.constant dense<[-27.0, 64.0]> : tensor<2xf16>
+  %result = stablehlo.cbrt %operand : tensor<2xf16>
+  check.almost_eq %result, dense<[-3.0, 4.0]> : tensor<2xf16>
+  func.return
+}
+
+// -----
+
+func.func @cbrt_op_test_c64() {
+  %operand = stablehlo.constant dense<(1.0, 2.0)> : tensor<complex<f32>>
+  %result = stablehlo.cbrt %operand : tensor<complex<f32>>
+  check.almost_eq %result, dense<(1.2196165, 0.47171128)> : tensor<complex<f32>>
+  func.return
+}
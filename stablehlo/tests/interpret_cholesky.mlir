@@ -0,0 +1,78 @@
+// RUN: stablehlo-interpreter --interpret -split-input-file %s
+// RUN: stablehlo-interpreter --interpret --threads=4 -split-input-file %s
+
+func.func @cholesky_op_test_lower() {
+  %a = stablehlo.constant dense<[[1.0, 2.0, 3.0], [2.0, 20.0, 26.0], [3.0, 26.0, 70.0]]> : tensor<3x3xf32>
+  %result = "stablehlo.cholesky"(%a) {
+    lower = true
+  } : (tensor<3x3xf32>) -> tensor<3x3xf32>
+  check.eq %result, dense<[[1.0, 0.0, 0.0], [2.0, 4.0, 0.0], [3.0, 5.0, 6.0]]> : tensor<3x3xf32>
+  func.return
+}
+
+// -----
+
+func.func @cholesky_op_test_upper() {
+  %a = stablehlo.constant dense<[[1.0, 2.0, 3.0], [2.0, 20.0, 26.0], [3.0, 26.0, 70.0]]> : tensor<3x3xf32>
+  %result = "stablehlo.cholesky"(%a) {
+    lower = false
+  } : (tensor<3x3xf32>) -> tensor<3x3xf32>
+  check.eq %result, dense<[[1.0, 2.0, 3.0], [0.0, 4.0, 5.0], [0.0, 0.0, 6.0]]> : tensor<3x3xf32>
+  func.return
+}
+
+// -----
+
+func.func @cholesky_op_test_reads_one_triangle() {
+  // Only the lower triangle is read.
+  %a = stablehlo.constant dense<[[1.0, 9.0, -7.0], [2.0, 20.0, 0.5], [3.0, 26.0, 70.0]]> : tensor<3x3xf64>
+  %result = "stablehlo.cholesky"(%a) {
+    lower = true
+  } : (tensor<3x3xf64>) -> tensor<3x3xf64>
+  check.eq %result, dense<[[1.0, 0.0, 0.0], [2.0, 4.0, 0.0], [3.0, 5.0, 6.0]]> : tensor<3x3xf64>
+  func.return
+}
+
+// -----
+
+func.func @cholesky_op_test_batched() {
+  %a = stablehlo.constant dense<[[[4.0, 2.0], [2.0, 5.0]], [[9.0, 3.0], [3.0, 5.0]]]> : tensor<2x2x2xf64>
+  %result = "stablehlo.cholesky"(%a) {
+    lower = true
+  } : (tensor<2x2x2xf64>) -> tensor<2x2x2xf64>
+  check.eq %result, dense<[[[2.0, 0.0], [1.0, 2.0]], [[3.0, 0.0], [1.0, 2.0]]]> : tensor<2x2x2xf64>
+  func.return
+}
+
+// -----
+
+func.func @cholesky_op_test_complex_lower() {
+  %a = stablehlo.constant dense<[[(4.0, 0.0), (2.0, -2.0)], [(2.0, 2.0), (6.0, 0.0)]]> : tensor<2x2xcomplex<f32>>
+  %result = "stablehlo.cholesky"(%a) {
+    lower = true
+  } : (tensor<2x2xcomplex<f32>>) -> tensor<2x2xcomplex<f32>>
+  check.eq %result, dense<[[(2.0, 0.0), (0.0, 0.0)], [(1.0, 1.0), (2.0, 0.0)]]> : tensor<2x2xcomplex<f32>>
+  func.return
+}
+
+// -----
+
+func.func @cholesky_op_test_complex_upper() {
+  %a = stablehlo.constant dense<[[(4.0, 0.0), (2.0, -2.0)], [(2.0, 2.0), (6.0, 0.0)]]> : tensor<2x2xcomplex<f64>>
+  %result = "stablehlo.cholesky"(%a) {
+    lower = false
+  } : (tensor<2x2xcomplex<f64>>) -> tensor<2x2xcomplex<f64>>
+  check.eq %result, dense<[[(2.0, 0.0), (1.0, -1.0)], [(0.0, 0.0), (2.0, 0.0)]]> : tensor<2x2xcomplex<f64>>
+  func.return
+}
+
+// -----
+
+func.func @cholesky_op_test_f16() {
+  %a = stablehlo.constant dense<[[1.0, 2.0, 3.0], [2.0, 20.0, 26.0], [3.0, 26.0, 70.0]]> : tensor<3x3xf16>
+  %result = "stablehlo.cholesky"(%a) {
+    lower = true
+  } : (tensor<3x3xf16>) -> tensor<3x3xf16>
+  check.eq %result, dense<[[1.0, 0.0, 0.0], [2.0, 4.0, 0.0], [3.0, 5.0, 6.0]]> : tensor<3x3xf16>
+  func.return
+}
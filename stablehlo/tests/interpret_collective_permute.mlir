@@ -0,0 +1,40 @@
+// RUN: stablehlo-interpreter --interpret --num-replicas=4 -split-input-file %s
+// RUN: stablehlo-interpreter --interpret --num-replicas=4 --threads=4 --inter-op-parallelism -split-input-file %s
+
+func.func @collective_permute_ring() {
+  %table = stablehlo.constant dense<[[1, 2], [3, 4], [5, 6], [7, 8]]> : tensor<4x2xi64>
+  %replica_id = "stablehlo.replica_id"() : () -> tensor<ui32>
+  %zero = stablehlo.constant dense<0> : tensor<ui32>
+  %operand = "stablehlo.dynamic_slice"(%table, %replica_id, %zero) {
+    slice_sizes = dense<[1, 2]> : tensor<2xi64>
+  } : (tensor<4x2xi64>, tensor<ui32>, tensor<ui32>) -> tensor<1x2xi64>
+  %result = "stablehlo.collective_permute"(%operand) {
+    source_target_pairs = dense<[[0, 1], [1, 2], [2, 3], [3, 0]]> : tensor<4x2xi64>
+  } : (tensor<1x2xi64>) -> tensor<1x2xi64>
+  %gathered = "stablehlo.all_gather"(%result) {
+    all_gather_dim = 0 : i64,
+    replica_groups = dense<[[0, 1, 2, 3]]> : tensor<1x4xi64>
+  } : (tensor<1x2xi64>) -> tensor<4x2xi64>
+  check.eq %gathered, dense<[[7, 8], [1, 2], [3, 4], [5, 6]]> : tensor<4x2xi64>
+  func.return
+}
+
+// -----
+
+func.func @collective_permute_no_source() {
+  %table = stablehlo.constant dense<[[1.0, 2.0], [3.0, 4.0], [5.0, 6.0], [7.0, 8.0]]> : tensor<4x2xf32>
+  %replica_id = "stablehlo.replica_id"() : () -> tensor<ui32>
+  %zero = stablehlo.constant dense<0> : tensor<ui32>
+  %operand = "stablehlo.dynamic_slice"(%table, %replica_id, %zero) {
+    slice_sizes = dense<[1, 2]> : tensor<2xi64>
+  } : (tensor<4x2xf32>, tensor<ui32>, tensor<ui32>) -> tensor<1x2xf32>
+  %result = "stablehlo.collective_permute"(%operand) {
+    source_target_pairs = dense<[[0, 1], [2, 3]]> : tensor<2x2xi64>
+  } : (tensor<1x2xf32>) -> tensor<1x2xf32>
+  %gathered = "stablehlo.all_gather"(%result) {
+    all_gather_dim = 0 : i64,
+    replica_groups = dense<[[0, 1, 2, 3]]> : tensor<1x4xi64>
+  } : (tensor<1x2xf32>) -> tensor<4x2xf32>
+  check.eq %gathered, dense<[[0.0, 0.0], [1.0, 2.0], [0.0, 0.0], [5.0, 6.0]]> : tensor<4x2xf32>
+  func.return
+}
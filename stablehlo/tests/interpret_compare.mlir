@@ -0,0 +1,103 @@
+// RUN: stablehlo-interpreter --interpret -split-input-file %s
+// RUN: stablehlo-interpreter --interpret --threads=4 -split-input-file %s
+
+func.func @compare_op_test_f32() {
+  %lhs = stablehlo.constant dense<[1.0, 3.0]> : tensor<2xf32>
+  %rhs = stablehlo.constant dense<[1.1, 2.9]> : tensor<2xf32>
+  %result = "stablehlo.compare"(%lhs, %rhs) {
+    comparison_direction = #stablehlo<comparison_direction LT>,
+    compare_type = #stablehlo<comparison_type FLOAT>
+  } : (tensor<2xf32>, tensor<2xf32>) -> tensor<2xi1>
+  check.eq %result, dense<[true, false]> : tensor<2xi1>
+  func.return
+}
+
+// -----
+
+func.func @compare_op_test_ge_si64() {
+  %lhs = stablehlo.constant dense<[-1, 0, 1]> : tensor<3xi64>
+  %rhs = stablehlo.constant dense<[0, 0, 0]> : tensor<3xi64>
+  %result = "stablehlo.compare"(%lhs, %rhs) {
+    comparison_direction = #stablehlo<comparison_direction GE>
+  } : (tensor<3xi64>, tensor<3xi64>) -> tensor<3xi1>
+  check.eq %result, dense<[false, true, true]> : tensor<3xi1>
+  func.return
+}
+
+// -----
+
+func.func @compare_op_test_gt_ui32() {
+  %lhs = stablehlo.constant dense<[0, 4294967295]> : tensor<2xui32>
+  %rhs = stablehlo.constant dense<[1, 0]> : tensor<2xui32>
+  %result = "stablehlo.compare"(%lhs, %rhs) {
+    comparison_direction = #stablehlo<comparison_direction GT>
+  } : (tensor<2xui32>, tensor<2xui32>) -> tensor<2xi1>
+  check.eq %result, dense<[false, true]> : tensor<2xi1>
+  func.return
+}
+
+// -----
+
+func.func @compare_op_test_eq_i1() {
+  %lhs = stablehlo.constant dense<[true, false]> : tensor<2xi1>
+  %rhs = stablehlo.constant dense<[true, true]> : tensor<2xi1>
+  %result = "stablehlo.compare"(%lhs, %rhs) {
+    comparison_direction = #stablehlo<comparison_direction EQ>
+  } : (tensor<2xi1>, tensor<2xi1>) -> tensor<2xi1>
+  check.eq %result, dense<[true, false]> : tensor<2xi1>
+  func.return
+}
+
+// -----
+
+// NaNs are unordered and +0.0 is equal to -0.0.
+func.func @compare_op_test_ne_f64() {
+  %lhs = stablehlo.constant dense<[0x7FF8000000000000, 0.0, -0.0]> : tensor<3xf64>
+  %rhs = stablehlo.constant dense<[0x7FF8000000000000, -0.0, 0.0]> : tensor<3xf64>
+  %result = "stablehlo.compare"(%lhs, %rhs) {
+    comparison_direction = #stablehlo<comparison_direction NE>,
+    compare_type = #stablehlo<comparison_type FLOAT>
+  } : (tensor<3xf64>, tensor<3xf64>) -> tensor<3xi1>
+  check.eq %result, dense<[true, false, false]> : tensor<3xi1>
+  func.return
+}
+
+// -----
+
+// TOTALORDER orders -NaN < -Inf < -0.0 < +0.0 < +Inf < +NaN.
+func.func @compare_op_test_totalorder_f32() {
+  %lhs = stablehlo.constant dense<[-0.0, 0x7FC00000, 1.0, 0xFFC00000]> : tensor<4xf32>
+  %rhs = stablehlo.constant dense<[0.0, 0x7F800000, 0x7FC00000, 0xFF800000]> : tensor<4xf32>
+  %result = "stablehlo.compare"(%lhs, %rhs) {
+    comparison_direction = #stablehlo<comparison_direction LT>,
+    compare_type = #stablehlo<comparison_type TOTALORDER>
+  } : (tensor<4xf32>, tensor<4xf32>) -> tensor<4xi1>
+  check.eq %result, dense<[true, false, true, true]> : tensor<4xi1>
+  func.return
+}
+
+// -----
+
+func.func @compare_op_test_le_c64() {
+  %lhs = stablehlo.constant dense<[(1.0, 2.0), (1.0, 2.0), (1.0, 2.0)]> : tensor<3xcomplex<f32>>
+  %rhs = stablehlo.constant dense<[(1.0, 3.0), (1.0, 2.0), (0.0, 5.0)]> : tensor<3xcomplex<f32>>
+  %result = "stablehlo.compare"(%lhs, %rhs) {
+    comparison_direction = #stablehlo<comparison_direction LE>,
+    compare_type = #stablehlo<comparison_type FLOAT>
+  } : (tensor<3xcomplex<f32>>, tensor<3xcomplex<f32>>) -> tensor<3xi1>
+  check.eq %result, dense<[true, true, false]> : tensor<3xi1>
+  func.return
+}
+
+// -----
+
+func.func @compare_op_test_f16() {
+  %lhs = stablehlo.constant dense<[1.0, -2.0, 0x7E00]> : tensor<3xf16>
+  %rhs = stablehlo.constant dense<[1.5, -3.0, 1.0]> : tensor<3xf16>
+  %result = "stablehlo.compare"(%lhs, %rhs) {
+    comparison_direction = #stablehlo<comparison_direction LT>,
+    compare_type = #stablehlo<comparison_type FLOAT>
+  } : (tensor<3xf16>, tensor<3xf16>) -> tensor<3xi1>
+  check.eq %result, dense<[true, false, false]> : tensor<3xi1>
+  func.return
+}
@@ -125,3 +125,46 @@ func.func @constant_op_test_c128() {
   check.almost_eq %0, dense<[(1.500000e+00, 2.500000e+00), (3.500000e+00, 4.500000e+00)]> : tensor<2xcomplex<f64>>
   func.return
 }
+
+// -----
+
+func.func @constant_op_test_shared_value() {
+  %0 = stablehlo.constant dense<[1.0, 2.0]> : tensor<2xf32>
+  %1 = stablehlo.constant dense<[1.0, 2.0]> : tensor<2xf32>
+  %2 = stablehlo.add %0, %0 : tensor<2xf32>
+  check.eq %1, dense<[1.0, 2.0]> : tensor<2xf32>
+  check.eq %2, dense<[2.0, 4.0]> : tensor<2xf32>
+  func.return
+}
+
+// -----
+
+func.func @constant_op_test_dense_resource_si32() {
+  %0 = stablehlo.constant dense_resource<si32_data> : tensor<2xi32>
+  check.eq %0, dense<[1, -2]> : tensor<2xi32>
+  func.return
+}
+
+{-#
+  dialect_resources: {
+    builtin: {
+      si32_data: "0x0400000001000000FEFFFFFF"
+    }
+  }
+#-}
+
+// -----
+
+func.func @constant_op_test_dense_resource_i1() {
+  %0 = stablehlo.constant dense_resource<i1_data> : tensor<3xi1>
+  check.eq %0, dense<[true, false, true]> : tensor<3xi1>
+  func.return
+}
+
+{-#
+  dialect_resources: {
+    builtin: {
+      i1_data: "0x01000000010001"
+    }
+  }
+#-}
@@ -0,0 +1,105 @@
+// RUN: stablehlo-interpreter --interpret -split-input-file %s
+// RUN: stablehlo-interpreter --interpret --threads=4 -split-input-file %s
+
+func.func @convolution_op_test_si32() {
+  %lhs = stablehlo.constant dense<[[
+    [[1], [2], [5], [6]],
+    [[3], [4], [7], [8]],
+    [[10], [11], [14], [15]],
+    [[12], [13], [16], [17]]
+  ]]> : tensor<1x4x4x1xi32>
+  %rhs = stablehlo.constant dense<1> : tensor<3x3x1x1xi32>
+  %result = "stablehlo.convolution"(%lhs, %rhs) {
+    window_strides = dense<4> : tensor<2xi64>,
+    padding = dense<0> : tensor<2x2xi64>,
+    lhs_dilation = dense<2> : tensor<2xi64>,
+    rhs_dilation = dense<1> : tensor<2xi64>,
+    window_reversal = dense<false> : tensor<2xi1>,
+    dimension_numbers = #stablehlo.conv<[b, 0, 1, f]x[0, 1, i, o]->[b, 0, 1, f]>,
+    feature_group_count = 1 : i64,
+    batch_group_count = 1 : i64,
+    precision_config = [#stablehlo<precision DEFAULT>, #stablehlo<precision DEFAULT>]
+  } : (tensor<1x4x4x1xi32>, tensor<3x3x1x1xi32>) -> tensor<1x2x2x1xi32>
+  check.eq %result, dense<[[[[10], [26]], [[46], [62]]]]> : tensor<1x2x2x1xi32>
+  func.return
+}
+
+// -----
+
+func.func @convolution_op_test_nchw_padding_f32() {
+  %lhs = stablehlo.constant dense<[[[[-1.0, -2.0, 0.0], [2.0, -3.0, -3.0], [3.0, 1.0, -3.0]],
+                                    [[-1.0, 1.0, -3.0], [1.0, -2.0, -3.0], [-3.0, 0.0, 0.0]]]]> : tensor<1x2x3x3xf32>
+  %rhs = stablehlo.constant dense<[[[[-3.0, -2.0, -3.0], [1.0, 0.0, -3.0], [3.0, 1.0, -3.0]],
+                                    [[-2.0, 2.0, 2.0], [1.0, -3.0, 1.0], [1.0, 0.0, -3.0]]],
+                                   [[[-2.0, -3.0, 1.0], [3.0, -2.0, -1.0], [0.0, -2.0, 1.0]],
+                                    [[-3.0, 1.0, -1.0], [1.0, 3.0, 2.0], [-2.0, -3.0, 1.0]]]]> : tensor<2x2x3x3xf32>
+  %result = "stablehlo.convolution"(%lhs, %rhs) {
+    padding = dense<1> : tensor<2x2xi64>,
+    dimension_numbers = #stablehlo.conv<[b, f, 0, 1]x[o, i, 0, 1]->[b, f, 0, 1]>,
+    feature_group_count = 1 : i64,
+    batch_group_count = 1 : i64
+  } : (tensor<1x2x3x3xf32>, tensor<2x2x3x3xf32>) -> tensor<1x2x3x3xf32>
+  check.eq %result, dense<[[[[27.0, 14.0, -6.0], [12.0, 36.0, 2.0], [9.0, 6.0, 14.0]],
+                            [[-9.0, 1.0, 5.0], [1.0, 20.0, -10.0], [-22.0, 7.0, 27.0]]]]> : tensor<1x2x3x3xf32>
+  func.return
+}
+
+// -----
+
+func.func @convolution_op_test_feature_group_count_si32() {
+  %lhs = stablehlo.constant dense<[[[1, 2, -2, -1], [-3, 1, 2, -3], [1, -3, 1, -2], [0, 2, 1, 0],
+                                    [3, -1, 0, 1], [0, -1, -1, -2], [3, -2, 2, 3]],
+                                   [[-2, -3, 1, -1], [1, 0, -1, 2], [0, -1, 1, -3], [-3, 1, 0, -2],
+                                    [3, -1, -2, 0], [0, -3, 2, -3], [3, 1, 1, 3]]]> : tensor<2x7x4xi32>
+  %rhs = stablehlo.constant dense<[[[3, -1, -1, 2], [-1, 1, 0, 1]],
+                                   [[3, 0, -3, 3], [-3, -1, 0, 2]]]> : tensor<2x2x4xi32>
+  %result = "stablehlo.convolution"(%lhs, %rhs) {
+    window_strides = dense<2> : tensor<1xi64>,
+    rhs_dilation = dense<2> : tensor<1xi64>,
+    window_reversal = dense<true> : tensor<1xi1>,
+    dimension_numbers = #stablehlo.conv<[b, 0, f]x[0, i, o]->[b, 0, f]>,
+    feature_group_count = 2 : i64,
+    batch_group_count = 1 : i64
+  } : (tensor<2x7x4xi32>, tensor<2x2x4xi32>) -> tensor<2x3x4xi32>
+  check.eq %result, dense<[[[3, -6, 5, -8], [22, -1, -3, 0], [23, -4, -2, 9]],
+                           [[4, 2, -4, 0], [13, -3, -1, -7], [20, -1, 5, -1]]]> : tensor<2x3x4xi32>
+  func.return
+}
+
+// -----
+
+func.func @convolution_op_test_batch_group_count_si32() {
+  %lhs = stablehlo.constant dense<[[[2, -3], [-3, 2], [2, -1]],
+                                   [[2, 1], [2, 3], [0, -1]],
+                                   [[2, 0], [2, -1], [-3, 0]],
+                                   [[-1, -2], [1, -3], [0, -3]]]> : tensor<4x3x2xi32>
+  %rhs = stablehlo.constant dense<[[[-2, 3, -1, -2], [2, -2, 0, 0]],
+                                   [[3, 0, -3, -2], [0, 0, 1, -1]]]> : tensor<2x2x4xi32>
+  %result = "stablehlo.convolution"(%lhs, %rhs) {
+    padding = dense<[[-1, 2]]> : tensor<1x2xi64>,
+    lhs_dilation = dense<2> : tensor<1xi64>,
+    dimension_numbers = #stablehlo.conv<[b, 0, f]x[0, i, o]->[b, 0, f]>,
+    feature_group_count = 1 : i64,
+    batch_group_count = 2 : i64
+  } : (tensor<4x3x2xi32>, tensor<2x2x4xi32>) -> tensor<2x5x4xi32>
+  check.eq %result, dense<[[[-9, 0, -7, -3], [10, -13, -2, -4], [6, 0, 9, 6], [-6, 8, 3, 6], [0, 0, 0, 0]],
+                           [[6, 0, -6, 1], [2, 0, -1, -2], [0, 0, -3, 3], [-2, 2, 0, 0], [0, 0, 0, 0]]]> : tensor<2x5x4xi32>
+  func.return
+}
+
+// -----
+
+func.func @convolution_op_test_f16() {
+  %lhs = stablehlo.constant dense<[[[[-2.0], [3.0], [0.0]],
+                                    [[3.0], [1.0], [-1.0]],
+                                    [[2.0], [0.0], [-1.0]]]]> : tensor<1x3x3x1xf16>
+  %rhs = stablehlo.constant dense<[[[[2.0]], [[0.0]]],
+                                   [[[-2.0]], [[-2.0]]]]> : tensor<2x2x1x1xf16>
+  %result = "stablehlo.convolution"(%lhs, %rhs) {
+    dimension_numbers = #stablehlo.conv<[b, 0, 1, f]x[0, 1, i, o]->[b, 0, 1, f]>,
+    feature_group_count = 1 : i64,
+    batch_group_count = 1 : i64
+  } : (tensor<1x3x3x1xf16>, tensor<2x2x1x1xf16>) -> tensor<1x2x2x1xf16>
+  check.eq %result, dense<[[[[-12.0], [6.0]], [[2.0], [4.0]]]]> : tensor<1x2x2x1xf16>
+  func.return
+}
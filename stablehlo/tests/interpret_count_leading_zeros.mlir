@@ -0,0 +1,27 @@
+// RUN: stablehlo-interpreter --interpret -split-input-file %s
+// RUN: stablehlo-interpreter --interpret --threads=4 -split-input-file %s
+
+func.func @count_leading_zeros_op_test_si8() {
+  %operand = stablehlo.constant dense<[[0, 1], [127, -1]]> : tensor<2x2xi8>
+  %result = stablehlo.count_leading_zeros %operand : tensor<2x2xi8>
+  check.eq %result, dense<[[8, 7], [1, 0]]> : tensor<2x2xi8>
+  func.return
+}
+
+// -----
+
+func.func @count_leading_zeros_op_test_ui64() {
+  %operand = stablehlo.constant dense<[0, 1, 18446744073709551615]> : tensor<3xui64>
+  %result = stablehlo.count_leading_zeros %operand : tensor<3xui64>
+  check.eq %result, dense<[64, 63, 0]> : tensor<3xui64>
+  func.return
+}
+
+// -----
+
+func.func @count_leading_zeros_op_test_si4() {
+  %operand = stablehlo.constant dense<[0, 1, -8, 7]> : tensor<4xi4>
+  %result = stablehlo.count_leading_zeros %operand : tensor<4xi4>
+  check.eq %result, dense<[4, 3, 0, 1]> : tensor<4xi4>
+  func.return
+}
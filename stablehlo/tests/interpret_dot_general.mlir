@@ -0,0 +1,133 @@
+// RUN: stablehlo-interpreter --interpret -split-input-file %s
+// RUN: stablehlo-interpreter --interpret --threads=4 -split-input-file %s
+
+func.func @dot_general_op_test_si64() {
+  %lhs = stablehlo.constant dense<[[[1, 2], [3, 4]],
+                                   [[5, 6], [7, 8]]]> : tensor<2x2x2xi64>
+  %rhs = stablehlo.constant dense<[[[1, 0], [0, 1]],
+                                   [[1, 0], [0, 1]]]> : tensor<2x2x2xi64>
+  %result = "stablehlo.dot_general"(%lhs, %rhs) {
+    dot_dimension_numbers = #stablehlo.dot<
+      lhs_batching_dimensions = [0],
+      rhs_batching_dimensions = [0],
+      lhs_contracting_dimensions = [2],
+      rhs_contracting_dimensions = [1]
+    >,
+    precision_config = [#stablehlo<precision DEFAULT>, #stablehlo<precision DEFAULT>]
+  } : (tensor<2x2x2xi64>, tensor<2x2x2xi64>) -> tensor<2x2x2xi64>
+  check.eq %result, dense<[[[1, 2], [3, 4]],
+                           [[5, 6], [7, 8]]]> : tensor<2x2x2xi64>
+  func.return
+}
+
+// -----
+
+func.func @dot_general_op_test_matmul_f32() {
+  %lhs = stablehlo.constant dense<[[1.0, 2.0, 3.0], [4.0, 5.0, 6.0]]> : tensor<2x3xf32>
+  %rhs = stablehlo.constant dense<[[1.0, 2.0], [3.0, 4.0], [5.0, 6.0]]> : tensor<3x2xf32>
+  %result = "stablehlo.dot_general"(%lhs, %rhs) {
+    dot_dimension_numbers = #stablehlo.dot<
+      lhs_contracting_dimensions = [1],
+      rhs_contracting_dimensions = [0]
+    >
+  } : (tensor<2x3xf32>, tensor<3x2xf32>) -> tensor<2x2xf32>
+  check.eq %result, dense<[[22.0, 28.0], [49.0, 64.0]]> : tensor<2x2xf32>
+  func.return
+}
+
+// -----
+
+func.func @dot_general_op_test_transposed_lhs_si32() {
+  %lhs = stablehlo.constant dense<[[1, 2], [3, 4], [5, 6]]> : tensor<3x2xi32>
+  %rhs = stablehlo.constant dense<[[1, -1, 2], [0, 3, -2], [4, 1, 1]]> : tensor<3x3xi32>
+  %result = "stablehlo.dot_general"(%lhs, %rhs) {
+    dot_dimension_numbers = #stablehlo.dot<
+      lhs_contracting_dimensions = [0],
+      rhs_contracting_dimensions = [0]
+    >
+  } : (tensor<3x2xi32>, tensor<3x3xi32>) -> tensor<2x3xi32>
+  check.eq %result, dense<[[21, 13, 1], [26, 16, 2]]> : tensor<2x3xi32>
+  func.return
+}
+
+// -----
+
+func.func @dot_general_op_test_matrix_vector_si32() {
+  %lhs = stablehlo.constant dense<[[1, 2, 3], [4, 5, 6]]> : tensor<2x3xi32>
+  %rhs = stablehlo.constant dense<[1, 0, -1]> : tensor<3xi32>
+  %result = "stablehlo.dot_general"(%lhs, %rhs) {
+    dot_dimension_numbers = #stablehlo.dot<
+      lhs_contracting_dimensions = [1],
+      rhs_contracting_dimensions = [0]
+    >
+  } : (tensor<2x3xi32>, tensor<3xi32>) -> tensor<2xi32>
+  check.eq %result, dense<[-2, -2]> : tensor<2xi32>
+  func.return
+}
+
+// -----
+
+func.func @dot_general_op_test_multiple_contracting_dimensions_si32() {
+  %lhs = stablehlo.constant dense<[[[1, 2], [3, 4], [5, 6]],
+                                   [[7, 8], [9, 10], [11, 12]]]> : tensor<2x3x2xi32>
+  %rhs = stablehlo.constant dense<[[[[-2, -1], [1, 2], [-1, 0]],
+                                    [[0, 1], [-2, -1], [1, 2]]],
+                                   [[[-1, 0], [2, -2], [0, 1]],
+                                    [[1, 2], [-1, 0], [2, -2]]]]> : tensor<2x2x3x2xi32>
+  %result = "stablehlo.dot_general"(%lhs, %rhs) {
+    dot_dimension_numbers = #stablehlo.dot<
+      lhs_batching_dimensions = [2],
+      rhs_batching_dimensions = [1],
+      lhs_contracting_dimensions = [1, 0],
+      rhs_contracting_dimensions = [2, 0]
+    >
+  } : (tensor<2x3x2xi32>, tensor<2x2x3x2xi32>) -> tensor<2x2xi32>
+  check.eq %result, dense<[[7, -2], [20, 2]]> : tensor<2x2xi32>
+  func.return
+}
+
+// -----
+
+func.func @dot_general_op_test_f16() {
+  %lhs = stablehlo.constant dense<[[0.5, 1.5], [2.0, -1.0]]> : tensor<2x2xf16>
+  %rhs = stablehlo.constant dense<[[2.0, 0.25], [-1.0, 4.0]]> : tensor<2x2xf16>
+  %result = "stablehlo.dot_general"(%lhs, %rhs) {
+    dot_dimension_numbers = #stablehlo.dot<
+      lhs_contracting_dimensions = [1],
+      rhs_contracting_dimensions = [0]
+    >
+  } : (tensor<2x2xf16>, tensor<2x2xf16>) -> tensor<2x2xf16>
+  check.eq %result, dense<[[-0.5, 6.125], [5.0, -3.5]]> : tensor<2x2xf16>
+  func.return
+}
+
+// -----
+
+func.func @dot_general_op_test_empty_contracting_dimension_f32() {
+  %lhs = stablehlo.constant dense<> : tensor<2x0xf32>
+  %rhs = stablehlo.constant dense<> : tensor<0x3xf32>
+  %result = "stablehlo.dot_general"(%lhs, %rhs) {
+    dot_dimension_numbers = #stablehlo.dot<
+      lhs_contracting_dimensions = [1],
+      rhs_contracting_dimensions = [0]
+    >
+  } : (tensor<2x0xf32>, tensor<0x3xf32>) -> tensor<2x3xf32>
+  check.eq %result, dense<0.0> : tensor<2x3xf32>
+  func.return
+}
+
+// -----
+
+// Spans several blocks of the GEMM along every dimension.
+func.func @dot_general_op_test_large_f32() {
+  %lhs = stablehlo.iota dim = 1 : tensor<130x260xf32>
+  %rhs = stablehlo.constant dense<1.0> : tensor<260x1030xf32>
+  %result = "stablehlo.dot_general"(%lhs, %rhs) {
+    dot_dimension_numbers = #stablehlo.dot<
+      lhs_contracting_dimensions = [1],
+      rhs_contracting_dimensions = [0]
+    >
+  } : (tensor<130x260xf32>, tensor<260x1030xf32>) -> tensor<130x1030xf32>
+  check.eq %result, dense<33670.0> : tensor<130x1030xf32>
+  func.return
+}
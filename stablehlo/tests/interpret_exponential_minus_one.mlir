@@ -0,0 +1,27 @@
+// RUN: stablehlo-interpreter --interpret -split-input-file %s
+// RUN: stablehlo-interpreter --interpret --threads=4 -split-input-file %s
+
+func.func @exponential_minus_one_op_test_f32() {
+  %operand = stablehlo.constant dense<[0.0, 1.0]> : tensor<2xf32>
+  %result = stablehlo.exponential_minus_one %operand : tensor<2xf32>
+  check.almost_eq %result, dense<[0.0, 1.7182819]> : tensor<2xf32>
+  func.return
+}
+
+// -----
+
+func.func @exponential_minus_one_op_test_f64() {
+  %operand = stablehlo.constant dense<[-1.0, 1.0e-10]> : tensor<2xf64>
+  %result = stablehlo.exponential_minus_one %operand : tensor<2xf64>
+  check.almost_eq %result, dense<[-0.6321205588285577, 1.00000000005e-10]> : tensor<2xf64>
+  func.return
+}
+
+// -----
+
+func.func @exponential_minus_one_op_test_c64() {
+  %operand = stablehlo.constant dense<(0.5, 0.5)> : tensor<complex<f32>>
+  %result = stablehlo.exponential_minus_one %operand : tensor<complex<f32>>
+  check.almost_eq %result, dense<(0.44688904, 0.79043907)> : tensor<complex<f32>>
+  func.return
+}
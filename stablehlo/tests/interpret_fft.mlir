@@ -0,0 +1,127 @@
+// RUN: stablehlo-interpreter --interpret -split-input-file %s
+// RUN: stablehlo-interpreter --interpret --threads=4 -split-input-file %s
+
+func.func @fft_op_test_fft() {
+  %operand = stablehlo.constant dense<[(1.0, 0.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0)]> : tensor<4xcomplex<f32>>
+  %result = stablehlo.fft %operand, type = FFT, length = [4] : (tensor<4xcomplex<f32>>) -> tensor<4xcomplex<f32>>
+  check.eq %result, dense<[(1.0, 0.0), (1.0, 0.0), (1.0, 0.0), (1.0, 0.0)]> : tensor<4xcomplex<f32>>
+  func.return
+}
+
+// -----
+
+func.func @fft_op_test_fft_radix_4() {
+  %operand = stablehlo.constant dense<[(1.0, 0.0), (2.0, 0.0), (3.0, 0.0), (4.0, 0.0)]> : tensor<4xcomplex<f32>>
+  %result = stablehlo.fft %operand, type = FFT, length = [4] : (tensor<4xcomplex<f32>>) -> tensor<4xcomplex<f32>>
+  check.eq %result, dense<[(10.0, 0.0), (-2.0, 2.0), (-2.0, 0.0), (-2.0, -2.0)]> : tensor<4xcomplex<f32>>
+  func.return
+}
+
+// -----
+
+func.func @fft_op_test_ifft() {
+  %operand = stablehlo.constant dense<[(10.0, 0.0), (-2.0, 2.0), (-2.0, 0.0), (-2.0, -2.0)]> : tensor<4xcomplex<f64>>
+  %result = stablehlo.fft %operand, type = IFFT, length = [4] : (tensor<4xcomplex<f64>>) -> tensor<4xcomplex<f64>>
+  check.eq %result, dense<[(1.0, 0.0), (2.0, 0.0), (3.0, 0.0), (4.0, 0.0)]> : tensor<4xcomplex<f64>>
+  func.return
+}
+
+// -----
+
+func.func @fft_op_test_fft_mixed_radix() {
+  %operand = stablehlo.constant dense<[(0.0, 0.0), (1.0, 1.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0)]> : tensor<6xcomplex<f32>>
+  %result = stablehlo.fft %operand, type = FFT, length = [6] : (tensor<6xcomplex<f32>>) -> tensor<6xcomplex<f32>>
+  check.almost_eq %result, dense<[(1.0, 1.0), (1.36602545, -0.366025418), (0.366025418, -1.36602545), (-1.0, -1.0), (-1.36602545, 0.366025418), (-0.366025418, 1.36602545)]> : tensor<6xcomplex<f32>>
+  func.return
+}
+
+// -----
+
+func.func @fft_op_test_ifft_mixed_radix() {
+  %operand = stablehlo.constant dense<[(0.0, 0.0), (1.0, 1.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0)]> : tensor<6xcomplex<f32>>
+  %result = stablehlo.fft %operand, type = IFFT, length = [6] : (tensor<6xcomplex<f32>>) -> tensor<6xcomplex<f32>>
+  check.almost_eq %result, dense<[(0.166666672, 0.166666672), (-0.0610042326, 0.227670908), (-0.227670908, 0.0610042326), (-0.166666672, -0.166666672), (0.0610042326, -0.227670908), (0.227670908, -0.0610042326)]> : tensor<6xcomplex<f32>>
+  func.return
+}
+
+// -----
+
+func.func @fft_op_test_fft_bluestein() {
+  %operand = stablehlo.constant dense<[(0.0, 0.0), (1.0, 1.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0)]> : tensor<37xcomplex<f32>>
+  %result = stablehlo.fft %operand, type = FFT, length = [37] : (tensor<37xcomplex<f32>>) -> tensor<37xcomplex<f32>>
+  check.almost_eq %result, dense<[(1.0, 1.0), (1.15461671, 0.816615105), (1.27601719, 0.609737635), (1.36070907, 0.385319173), (1.40625572, 0.149815753), (1.41134703, -0.0899975821), (1.37583637, -0.327221841), (1.30074549, -0.555032551), (1.18823457, -0.766875982), (1.04154015, -0.956657767), (0.864882588, -1.1189183), (0.663343966, -1.24898946), (0.442722112, -1.34312963), (0.209363952, -1.39863026), (-0.0300172251, -1.41389501), (-0.268534869, -1.38848448), (-0.499327242, -1.32312977), (-0.715754867, -1.21971107), (-0.911591589, -1.08120346), (-1.08120346, -0.911591589), (-1.21971107, -0.715754867), (-1.32312977, -0.499327242), (-1.38848448, -0.268534869), (-1.41389501, -0.0300172251), (-1.39863026, 0.209363952), (-1.34312963, 0.442722112), (-1.24898946, 0.663343966), (-1.1189183, 0.864882588), (-0.956657767, 1.04154015), (-0.766875982, 1.18823457), (-0.555032551, 1.30074549), (-0.327221841, 1.37583637), (-0.0899975821, 1.41134703), (0.149815753, 1.40625572), (0.385319173, 1.36070907), (0.609737635, 1.27601719), (0.816615105, 1.15461671)]> : tensor<37xcomplex<f32>>
+  func.return
+}
+
+// -----
+
+func.func @fft_op_test_ifft_bluestein() {
+  %operand = stablehlo.constant dense<[(0.0, 0.0), (1.0, 1.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0), (0.0, 0.0)]> : tensor<37xcomplex<f32>>
+  %result = stablehlo.fft %operand, type = IFFT, length = [37] : (tensor<37xcomplex<f32>>) -> tensor<37xcomplex<f32>>
+  check.almost_eq %result, dense<[(0.0270270277, 0.0270270277), (0.022070678, 0.0312058572), (0.0164793953, 0.0344869532), (0.0104140313, 0.0367759205), (0.00404907437, 0.0380069129), (-0.00243236707, 0.038144514), (-0.00884383358, 0.0371847674), (-0.0150008798, 0.0351552851), (-0.0207263771, 0.0321144462), (-0.0258556157, 0.0281497352), (-0.0302410331, 0.0233752057), (-0.0337564722, 0.0179282147), (-0.0363008007, 0.0119654629), (-0.0378008187, 0.00565848546), (-0.038213376, -0.000811276375), (-0.0375266075, -0.00725769904), (-0.0357602648, -0.0134953307), (-0.0329651609, -0.0193447266), (-0.0292217135, -0.0246376097), (-0.0246376097, -0.0292217135), (-0.0193447266, -0.0329651609), (-0.0134953307, -0.0357602648), (-0.00725769904, -0.0375266075), (-0.000811276375, -0.038213376), (0.00565848546, -0.0378008187), (0.0119654629, -0.0363008007), (0.0179282147, -0.0337564722), (0.0233752057, -0.0302410331), (0.0281497352, -0.0258556157), (0.0321144462, -0.0207263771), (0.0351552851, -0.0150008798), (0.0371847674, -0.00884383358), (0.038144514, -0.00243236707), (0.0380069129, 0.00404907437), (0.0367759205, 0.0104140313), (0.0344869532, 0.0164793953), (0.0312058572, 0.022070678)]> : tensor<37xcomplex<f32>>
+  func.return
+}
+
+// -----
+
+func.func @fft_op_test_fft_2d() {
+  %operand = stablehlo.constant dense<[[(1.0, 2.0), (3.0, 0.0), (-1.0, 1.0), (2.0, -1.0)], [(0.0, 1.0), (4.0, 0.0), (1.0, -2.0), (-3.0, 0.0)]]> : tensor<2x4xcomplex<f64>>
+  %result = stablehlo.fft %operand, type = FFT, length = [2, 4] : (tensor<2x4xcomplex<f64>>) -> tensor<2x4xcomplex<f64>>
+  check.eq %result, dense<[[(7.0, 1.0), (2.0, -4.0), (-5.0, 3.0), (0.0, 12.0)], [(3.0, 3.0), (4.0, 4.0), (-5.0, 5.0), (2.0, -8.0)]]> : tensor<2x4xcomplex<f64>>
+  func.return
+}
+
+// -----
+
+func.func @fft_op_test_ifft_2d() {
+  %operand = stablehlo.constant dense<[[(7.0, 1.0), (2.0, -4.0), (-5.0, 3.0), (0.0, 12.0)], [(3.0, 3.0), (4.0, 4.0), (-5.0, 5.0), (2.0, -8.0)]]> : tensor<2x4xcomplex<f64>>
+  %result = stablehlo.fft %operand, type = IFFT, length = [2, 4] : (tensor<2x4xcomplex<f64>>) -> tensor<2x4xcomplex<f64>>
+  check.eq %result, dense<[[(1.0, 2.0), (3.0, 0.0), (-1.0, 1.0), (2.0, -1.0)], [(0.0, 1.0), (4.0, 0.0), (1.0, -2.0), (-3.0, 0.0)]]> : tensor<2x4xcomplex<f64>>
+  func.return
+}
+
+// -----
+
+func.func @fft_op_test_rfft() {
+  %operand = stablehlo.constant dense<[1.0, 2.0, 3.0, 4.0]> : tensor<4xf32>
+  %result = stablehlo.fft %operand, type = RFFT, length = [4] : (tensor<4xf32>) -> tensor<3xcomplex<f32>>
+  check.eq %result, dense<[(10.0, 0.0), (-2.0, 2.0), (-2.0, 0.0)]> : tensor<3xcomplex<f32>>
+  func.return
+}
+
+// -----
+
+func.func @fft_op_test_irfft() {
+  %operand = stablehlo.constant dense<[(10.0, 0.0), (-2.0, 2.0), (-2.0, 0.0)]> : tensor<3xcomplex<f32>>
+  %result = stablehlo.fft %operand, type = IRFFT, length = [4] : (tensor<3xcomplex<f32>>) -> tensor<4xf32>
+  check.eq %result, dense<[1.0, 2.0, 3.0, 4.0]> : tensor<4xf32>
+  func.return
+}
+
+// -----
+
+func.func @fft_op_test_rfft_2d() {
+  %operand = stablehlo.constant dense<[[1.0, -2.0, 3.0, 5.0], [2.0, 0.0, -1.0, 4.0]]> : tensor<2x4xf64>
+  %result = stablehlo.fft %operand, type = RFFT, length = [2, 4] : (tensor<2x4xf64>) -> tensor<2x3xcomplex<f64>>
+  check.eq %result, dense<[[(12.0, 0.0), (1.0, 11.0), (-2.0, 0.0)], [(2.0, 0.0), (-5.0, 3.0), (4.0, 0.0)]]> : tensor<2x3xcomplex<f64>>
+  func.return
+}
+
+// -----
+
+func.func @fft_op_test_irfft_2d() {
+  %operand = stablehlo.constant dense<[[(12.0, 0.0), (1.0, 11.0), (-2.0, 0.0)], [(2.0, 0.0), (-5.0, 3.0), (4.0, 0.0)]]> : tensor<2x3xcomplex<f64>>
+  %result = stablehlo.fft %operand, type = IRFFT, length = [2, 4] : (tensor<2x3xcomplex<f64>>) -> tensor<2x4xf64>
+  check.eq %result, dense<[[1.0, -2.0, 3.0, 5.0], [2.0, 0.0, -1.0, 4.0]]> : tensor<2x4xf64>
+  func.return
+}
+
+// -----
+
+func.func @fft_op_test_rfft_irfft_odd_length() {
+  %operand = stablehlo.constant dense<[[1.0, 2.0, 3.0, 4.0, 5.0], [-3.0, 0.5, 7.0, -2.0, 1.0]]> : tensor<2x5xf32>
+  %0 = stablehlo.fft %operand, type = RFFT, length = [5] : (tensor<2x5xf32>) -> tensor<2x3xcomplex<f32>>
+  %result = stablehlo.fft %0, type = IRFFT, length = [5] : (tensor<2x3xcomplex<f32>>) -> tensor<2x5xf32>
+  check.almost_eq %result, dense<[[1.0, 2.0, 3.0, 4.0, 5.0], [-3.0, 0.5, 7.0, -2.0, 1.0]]> : tensor<2x5xf32>
+  func.return
+}
@@ -0,0 +1,77 @@
+// RUN: stablehlo-interpreter --interpret -split-input-file %s
+// RUN: stablehlo-interpreter --interpret --threads=4 -split-input-file %s
+
+func.func @gather_op_test_si32() {
+  %operand = stablehlo.constant dense<[[[1, 2], [3, 4], [5, 6], [7, 8]],
+                                       [[9, 10],[11, 12], [13, 14], [15, 16]],
+                                       [[17, 18], [19, 20], [21, 22], [23, 24]]]> : tensor<3x4x2xi32>
+  %start_indices = stablehlo.constant dense<[[[0, 0], [1, 0], [2, 1]],
+                                             [[0, 1], [1, 1], [0, 2]]]> : tensor<2x3x2xi64>
+  %result = "stablehlo.gather"(%operand, %start_indices) {
+    dimension_numbers = #stablehlo.gather<
+      offset_dims = [2, 3],
+      collapsed_slice_dims = [0],
+      start_index_map = [1, 0],
+      index_vector_dim = 2>,
+    slice_sizes = dense<[1, 2, 2]> : tensor<3xi64>,
+    indices_are_sorted = false
+  } : (tensor<3x4x2xi32>, tensor<2x3x2xi64>) -> tensor<2x3x2x2xi32>
+  check.eq %result, dense<[[[[1, 2], [3, 4]],
+                            [[3, 4], [5, 6]],
+                            [[13, 14], [15, 16]]],
+                           [[[9, 10], [11, 12]],
+                            [[11, 12], [13, 14]],
+                            [[17, 18], [19, 20]]]]> : tensor<2x3x2x2xi32>
+  func.return
+}
+
+// -----
+
+func.func @gather_op_test_embedding_lookup_f32() {
+  %operand = stablehlo.constant dense<[[0.0, 1.0], [2.0, 3.0], [4.0, 5.0], [6.0, 7.0]]> : tensor<4x2xf32>
+  %start_indices = stablehlo.constant dense<[2, 0, 3]> : tensor<3xi32>
+  %result = "stablehlo.gather"(%operand, %start_indices) {
+    dimension_numbers = #stablehlo.gather<
+      offset_dims = [1],
+      collapsed_slice_dims = [0],
+      start_index_map = [0],
+      index_vector_dim = 1>,
+    slice_sizes = dense<[1, 2]> : tensor<2xi64>
+  } : (tensor<4x2xf32>, tensor<3xi32>) -> tensor<3x2xf32>
+  check.eq %result, dense<[[4.0, 5.0], [0.0, 1.0], [6.0, 7.0]]> : tensor<3x2xf32>
+  func.return
+}
+
+// -----
+
+func.func @gather_op_test_clamped_indices_si32() {
+  %operand = stablehlo.constant dense<[0, 1, 2, 3, 4]> : tensor<5xi32>
+  %start_indices = stablehlo.constant dense<[[-1], [4], [2]]> : tensor<3x1xi64>
+  %result = "stablehlo.gather"(%operand, %start_indices) {
+    dimension_numbers = #stablehlo.gather<
+      offset_dims = [1],
+      collapsed_slice_dims = [],
+      start_index_map = [0],
+      index_vector_dim = 1>,
+    slice_sizes = dense<2> : tensor<1xi64>
+  } : (tensor<5xi32>, tensor<3x1xi64>) -> tensor<3x2xi32>
+  check.eq %result, dense<[[0, 1], [3, 4], [2, 3]]> : tensor<3x2xi32>
+  func.return
+}
+
+// -----
+
+func.func @gather_op_test_f16() {
+  %operand = stablehlo.constant dense<[1.5, 2.5, 3.5]> : tensor<3xf16>
+  %start_indices = stablehlo.constant dense<[[2], [0]]> : tensor<2x1xi32>
+  %result = "stablehlo.gather"(%operand, %start_indices) {
+    dimension_numbers = #stablehlo.gather<
+      offset_dims = [],
+      collapsed_slice_dims = [0],
+      start_index_map = [0],
+      index_vector_dim = 1>,
+    slice_sizes = dense<1> : tensor<1xi64>
+  } : (tensor<3xf16>, tensor<2x1xi32>) -> tensor<2xf16>
+  check.eq %result, dense<[3.5, 1.5]> : tensor<2xf16>
+  func.return
+}
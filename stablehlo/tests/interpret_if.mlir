@@ -1,4 +1,5 @@
 // RUN: stablehlo-interpreter --interpret -split-input-file %s
+// RUN: stablehlo-interpreter --interpret --threads=4 --inter-op-parallelism -split-input-file %s
 
 func.func @if_ops_true_branch() {
   %pred = stablehlo.constant dense<true> : tensor<i1>
@@ -0,0 +1,18 @@
+// RUN: stablehlo-interpreter --interpret %s > %t.serial
+// RUN: stablehlo-interpreter --interpret --threads=4 --inter-op-parallelism %s > %t.parallel
+// RUN: diff %t.serial %t.parallel
+
+// The `rng` ops don't depend on each other, but both advance the generator,
+// so they must run in program order for the results to match.
+func.func @inter_op_parallelism_test_side_effects() -> (tensor<64xui32>, tensor<64xui32>) {
+  %a = stablehlo.constant dense<0> : tensor<ui32>
+  %b = stablehlo.constant dense<4294967295> : tensor<ui32>
+  %shape = stablehlo.constant dense<64> : tensor<1xi64>
+  %0 = "stablehlo.rng"(%a, %b, %shape) {
+    rng_distribution = #stablehlo<rng_distribution UNIFORM>
+  } : (tensor<ui32>, tensor<ui32>, tensor<1xi64>) -> tensor<64xui32>
+  %1 = "stablehlo.rng"(%a, %b, %shape) {
+    rng_distribution = #stablehlo<rng_distribution UNIFORM>
+  } : (tensor<ui32>, tensor<ui32>, tensor<1xi64>) -> tensor<64xui32>
+  func.return %0, %1 : tensor<64xui32>, tensor<64xui32>
+}
@@ -0,0 +1,27 @@
+// RUN: stablehlo-interpreter --interpret -split-input-file %s
+// RUN: stablehlo-interpreter --interpret --threads=4 -split-input-file %s
+
+func.func @log_plus_one_op_test_f32() {
+  %operand = stablehlo.constant dense<[-2.0, -0.0, -0.999, 7.0, 6.38905621, 15.0]> : tensor<6xf32>
+  %result = stablehlo.log_plus_one %operand : tensor<6xf32>
+  check.almost_eq %result, dense<[0xFFC00000, 0.0, -6.9077682, 2.0794415, 2.0, 2.7725887]> : tensor<6xf32>
+  func.return
+}
+
+// -----
+
+func.func @log_plus_one_op_test_f64() {
+  %operand = stablehlo.constant dense<[-0.5, 1.0e-10]> : tensor<2xf64>
+  %result = stablehlo.log_plus_one %operand : tensor<2xf64>
+  check.almost_eq %result, dense<[-0.6931471805599453, 9.999999999500001e-11]> : tensor<2xf64>
+  func.return
+}
+
+// -----
+
+func.func @log_plus_one_op_test_c64() {
+  %operand = stablehlo.constant dense<(1.0, 2.0)> : tensor<complex<f32>>
+  %result = stablehlo.log_plus_one %operand : tensor<complex<f32>>
+  check.almost_eq %result, dense<(1.0397208, 0.7853982)> : tensor<complex<f32>>
+  func.return
+}
@@ -0,0 +1,27 @@
+// RUN: stablehlo-interpreter --interpret -split-input-file %s
+// RUN: stablehlo-interpreter --interpret --threads=4 -split-input-file %s
+
+func.func @logistic_op_test_f32() {
+  %operand = stablehlo.constant dense<[[0.0, 1.0], [2.0, 3.0]]> : tensor<2x2xf32>
+  %result = stablehlo.logistic %operand : tensor<2x2xf32>
+  check.almost_eq %result, dense<[[0.5, 0.7310586], [0.8807971, 0.95257413]]> : tensor<2x2xf32>
+  func.return
+}
+
+// -----
+
+func.func @logistic_op_test_f64() {
+  %operand = stablehlo.constant dense<[-1.0, 0.5]> : tensor<2xf64>
+  %result = stablehlo.logistic %operand : tensor<2xf64>
+  check.almost_eq %result, dense<[0.2689414213699951, 0.6224593312018546]> : tensor<2xf64>
+  func.return
+}
+
+// -----
+
+func.func @logistic_op_test_c64() {
+  %operand = stablehlo.constant dense<(1.0, 2.0)> : tensor<complex<f32>>
+  %result = stablehlo.logistic %operand : tensor<complex<f32>>
+  check.almost_eq %result, dense<(1.0214154, 0.40343872)> : tensor<complex<f32>>
+  func.return
+}
@@ -1,4 +1,5 @@
 // RUN: stablehlo-interpreter --interpret -split-input-file %s
+// RUN: stablehlo-interpreter --interpret --threads=4 -split-input-file %s
 
 func.func @pad() {
   %operand = stablehlo.constant dense<[[0, 0, 0, 0],
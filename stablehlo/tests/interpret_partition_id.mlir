@@ -0,0 +1,94 @@
+// RUN: stablehlo-interpreter --interpret --num-replicas=2 --num-partitions=2 -split-input-file %s
+// RUN: stablehlo-interpreter --interpret --num-replicas=2 --num-partitions=2 --threads=4 -split-input-file %s
+
+func.func @partition_id() {
+  %partition_id = "stablehlo.partition_id"() : () -> tensor<ui32>
+  %operand = "stablehlo.reshape"(%partition_id) : (tensor<ui32>) -> tensor<1xui32>
+  %result = "stablehlo.all_gather"(%operand) {
+    all_gather_dim = 0 : i64,
+    replica_groups = dense<[[0, 1, 2, 3]]> : tensor<1x4xi64>,
+    channel_handle = #stablehlo.channel_handle<handle = 1, type = 0>,
+    use_global_device_ids
+  } : (tensor<1xui32>) -> tensor<4xui32>
+  check.eq %result, dense<[0, 1, 0, 1]> : tensor<4xui32>
+  func.return
+}
+
+// -----
+
+func.func @partition_id_replica_id() {
+  %replica_id = "stablehlo.replica_id"() : () -> tensor<ui32>
+  %operand = "stablehlo.reshape"(%replica_id) : (tensor<ui32>) -> tensor<1xui32>
+  %result = "stablehlo.all_gather"(%operand) {
+    all_gather_dim = 0 : i64,
+    replica_groups = dense<[[0, 1, 2, 3]]> : tensor<1x4xi64>,
+    channel_handle = #stablehlo.channel_handle<handle = 1, type = 0>,
+    use_global_device_ids
+  } : (tensor<1xui32>) -> tensor<4xui32>
+  check.eq %result, dense<[0, 0, 1, 1]> : tensor<4xui32>
+  func.return
+}
+
+// -----
+
+func.func @partition_id_cross_replica() {
+  %replica_id = "stablehlo.replica_id"() : () -> tensor<ui32>
+  %partition_id = "stablehlo.partition_id"() : () -> tensor<ui32>
+  %0 = "stablehlo.add"(%replica_id, %partition_id) : (tensor<ui32>, tensor<ui32>) -> tensor<ui32>
+  %1 = "stablehlo.all_reduce"(%0) ({
+    ^bb0(%arg0: tensor<ui32>, %arg1: tensor<ui32>):
+      %2 = "stablehlo.add"(%arg0, %arg1) : (tensor<ui32>, tensor<ui32>) -> tensor<ui32>
+      "stablehlo.return"(%2) : (tensor<ui32>) -> ()
+  }) {
+    replica_groups = dense<[[0, 1]]> : tensor<1x2xi64>
+  } : (tensor<ui32>) -> tensor<ui32>
+  %operand = "stablehlo.reshape"(%1) : (tensor<ui32>) -> tensor<1xui32>
+  %result = "stablehlo.all_gather"(%operand) {
+    all_gather_dim = 0 : i64,
+    replica_groups = dense<[[0, 1, 2, 3]]> : tensor<1x4xi64>,
+    channel_handle = #stablehlo.channel_handle<handle = 1, type = 0>,
+    use_global_device_ids
+  } : (tensor<1xui32>) -> tensor<4xui32>
+  check.eq %result, dense<[1, 3, 1, 3]> : tensor<4xui32>
+  func.return
+}
+
+// -----
+
+func.func @partition_id_cross_replica_and_partition() {
+  %replica_id = "stablehlo.replica_id"() : () -> tensor<ui32>
+  %partition_id = "stablehlo.partition_id"() : () -> tensor<ui32>
+  %0 = "stablehlo.add"(%replica_id, %partition_id) : (tensor<ui32>, tensor<ui32>) -> tensor<ui32>
+  %result = "stablehlo.all_reduce"(%0) ({
+    ^bb0(%arg0: tensor<ui32>, %arg1: tensor<ui32>):
+      %1 = "stablehlo.add"(%arg0, %arg1) : (tensor<ui32>, tensor<ui32>) -> tensor<ui32>
+      "stablehlo.return"(%1) : (tensor<ui32>) -> ()
+  }) {
+    replica_groups = dense<[[0, 1]]> : tensor<1x2xi64>,
+    channel_handle = #stablehlo.channel_handle<handle = 1, type = 0>
+  } : (tensor<ui32>) -> tensor<ui32>
+  check.eq %result, dense<4> : tensor<ui32>
+  func.return
+}
+
+// -----
+
+func.func @partition_id_cross_partition() {
+  %replica_id = "stablehlo.replica_id"() : () -> tensor<ui32>
+  %partition_id = "stablehlo.partition_id"() : () -> tensor<ui32>
+  %0 = "stablehlo.add"(%replica_id, %replica_id) : (tensor<ui32>, tensor<ui32>) -> tensor<ui32>
+  %1 = "stablehlo.add"(%0, %partition_id) : (tensor<ui32>, tensor<ui32>) -> tensor<ui32>
+  %2 = "stablehlo.collective_permute"(%1) {
+    source_target_pairs = dense<[[0, 1], [1, 0]]> : tensor<2x2xi64>,
+    channel_handle = #stablehlo.channel_handle<handle = 1, type = 0>
+  } : (tensor<ui32>) -> tensor<ui32>
+  %operand = "stablehlo.reshape"(%2) : (tensor<ui32>) -> tensor<1xui32>
+  %result = "stablehlo.all_gather"(%operand) {
+    all_gather_dim = 0 : i64,
+    replica_groups = dense<[[0, 1, 2, 3]]> : tensor<1x4xi64>,
+    channel_handle = #stablehlo.channel_handle<handle = 1, type = 0>,
+    use_global_device_ids
+  } : (tensor<1xui32>) -> tensor<4xui32>
+  check.eq %result, dense<[1, 0, 3, 2]> : tensor<4xui32>
+  func.return
+}
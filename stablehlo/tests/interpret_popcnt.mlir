@@ -0,0 +1,36 @@
+// RUN: stablehlo-interpreter --interpret -split-input-file %s
+// RUN: stablehlo-interpreter --interpret --threads=4 -split-input-file %s
+
+func.func @popcnt_op_test_si8() {
+  %operand = stablehlo.constant dense<[0, 1, 2, 127]> : tensor<4xi8>
+  %result = stablehlo.popcnt %operand : tensor<4xi8>
+  check.eq %result, dense<[0, 1, 1, 7]> : tensor<4xi8>
+  func.return
+}
+
+// -----
+
+func.func @popcnt_op_test_ui16() {
+  %operand = stablehlo.constant dense<[65535, 256]> : tensor<2xui16>
+  %result = stablehlo.popcnt %operand : tensor<2xui16>
+  check.eq %result, dense<[16, 1]> : tensor<2xui16>
+  func.return
+}
+
+// -----
+
+func.func @popcnt_op_test_si64() {
+  %operand = stablehlo.constant dense<[-1, -9223372036854775808]> : tensor<2xi64>
+  %result = stablehlo.popcnt %operand : tensor<2xi64>
+  check.eq %result, dense<[64, 1]> : tensor<2xi64>
+  func.return
+}
+
+// -----
+
+func.func @popcnt_op_test_si4() {
+  %operand = stablehlo.constant dense<[-1, 5]> : tensor<2xi4>
+  %result = stablehlo.popcnt %operand : tensor<2xi4>
+  check.eq %result, dense<[4, 2]> : tensor<2xi4>
+  func.return
+}
@@ -0,0 +1,61 @@
+// RUN: stablehlo-interpreter --interpret -split-input-file %s
+// RUN: stablehlo-interpreter --interpret --threads=4 -split-input-file %s
+
+func.func @power_op_test_f32() {
+  %lhs = stablehlo.constant dense<[-2.0, -0.0, -36.0, 5.0, 3.0, 10000.0]> : tensor<6xf32>
+  %rhs = stablehlo.constant dense<[2.0, 2.0, 1.1, 2.0, -1.0, 10.0]> : tensor<6xf32>
+  %result = stablehlo.power %lhs, %rhs : tensor<6xf32>
+  check.almost_eq %result, dense<[4.0, 0.0, 0x7FC00000, 25.0, 0.33333334, 0x7F800000]> : tensor<6xf32>
+  func.return
+}
+
+// -----
+
+func.func @power_op_test_si32() {
+  %lhs = stablehlo.constant dense<[2, -2, 3, 1, -1, -1, 2, 0]> : tensor<8xi32>
+  %rhs = stablehlo.constant dense<[10, 3, 0, -5, -3, -4, -1, 0]> : tensor<8xi32>
+  %result = stablehlo.power %lhs, %rhs : tensor<8xi32>
+  check.eq %result, dense<[1024, -8, 1, 1, -1, 1, 0, 1]> : tensor<8xi32>
+  func.return
+}
+
+// -----
+
+// Integer exponentiation wraps around like multiplication.
+func.func @power_op_test_si8_overflow() {
+  %lhs = stablehlo.constant dense<[2, 3]> : tensor<2xi8>
+  %rhs = stablehlo.constant dense<[8, 5]> : tensor<2xi8>
+  %result = stablehlo.power %lhs, %rhs : tensor<2xi8>
+  check.eq %result, dense<[0, -13]> : tensor<2xi8>
+  func.return
+}
+
+// -----
+
+func.func @power_op_test_ui64() {
+  %lhs = stablehlo.constant dense<[3, 2]> : tensor<2xui64>
+  %rhs = stablehlo.constant dense<[40, 63]> : tensor<2xui64>
+  %result = stablehlo.power %lhs, %rhs : tensor<2xui64>
+  check.eq %result, dense<[12157665459056928801, 9223372036854775808]> : tensor<2xui64>
+  func.return
+}
+
+// -----
+
+func.func @power_op_test_f16() {
+  %lhs = stablehlo.constant dense<[2.0, 4.0]> : tensor<2xf16>
+  %rhs = stablehlo.constant dense<[-2.0, 0.5]> : tensor<2xf16>
+  %result = stablehlo.power %lhs, %rhs : tensor<2xf16>
+  check.almost_eq %result, dense<[0.25, 2.0]> : tensor<2xf16>
+  func.return
+}
+
+// -----
+
+func.func @power_op_test_c64() {
+  %lhs = stablehlo.constant dense<(2.0, 0.0)> : tensor<complex<f32>>
+  %rhs = stablehlo.constant dense<(3.0, 0.0)> : tensor<complex<f32>>
+  %result = stablehlo.power %lhs, %rhs : tensor<complex<f32>>
+  check.almost_eq %result, dense<(8.0, 0.0)> : tensor<complex<f32>>
+  func.return
+}
@@ -0,0 +1,135 @@
+// RUN: stablehlo-interpreter --interpret -split-input-file %s
+// RUN: stablehlo-interpreter --interpret --threads=4 -split-input-file %s
+// RUN: stablehlo-interpreter --interpret --pairwise-summation -split-input-file %s
+
+func.func @reduce_op_test_si32() {
+  %input = stablehlo.constant dense<[[0, 1, 2, 3, 4, 5]]> : tensor<1x6xi32>
+  %init_value = stablehlo.constant dense<0> : tensor<i32>
+  %result = "stablehlo.reduce"(%input, %init_value) ({
+    ^bb0(%arg0: tensor<i32>, %arg1: tensor<i32>):
+      %0 = "stablehlo.add"(%arg0, %arg1) : (tensor<i32>, tensor<i32>) -> tensor<i32>
+      "stablehlo.return"(%0) : (tensor<i32>) -> ()
+  }) {
+    dimensions = dense<1> : tensor<1xi64>
+  } : (tensor<1x6xi32>, tensor<i32>) -> tensor<1xi32>
+  check.eq %result, dense<[15]> : tensor<1xi32>
+  func.return
+}
+
+// -----
+
+func.func @reduce_op_test_multiple_dimensions_si32() {
+  %input = stablehlo.constant dense<[[[1, 2], [3, 4]],
+                                     [[5, 6], [7, 8]]]> : tensor<2x2x2xi32>
+  %init_value = stablehlo.constant dense<0> : tensor<i32>
+  %result = "stablehlo.reduce"(%input, %init_value) ({
+    ^bb0(%arg0: tensor<i32>, %arg1: tensor<i32>):
+      %0 = "stablehlo.add"(%arg1, %arg0) : (tensor<i32>, tensor<i32>) -> tensor<i32>
+      "stablehlo.return"(%0) : (tensor<i32>) -> ()
+  }) {
+    dimensions = dense<[2, 0]> : tensor<2xi64>
+  } : (tensor<2x2x2xi32>, tensor<i32>) -> tensor<2xi32>
+  check.eq %result, dense<[14, 22]> : tensor<2xi32>
+  func.return
+}
+
+// -----
+
+func.func @reduce_op_test_max_major_dimension_f32() {
+  %input = stablehlo.constant dense<[[1.0, 5.0, -2.0], [3.0, -1.0, 0.0]]> : tensor<2x3xf32>
+  %init_value = stablehlo.constant dense<0xFF800000> : tensor<f32>
+  %result = "stablehlo.reduce"(%input, %init_value) ({
+    ^bb0(%arg0: tensor<f32>, %arg1: tensor<f32>):
+      %0 = "stablehlo.maximum"(%arg0, %arg1) : (tensor<f32>, tensor<f32>) -> tensor<f32>
+      "stablehlo.return"(%0) : (tensor<f32>) -> ()
+  }) {
+    dimensions = dense<0> : tensor<1xi64>
+  } : (tensor<2x3xf32>, tensor<f32>) -> tensor<3xf32>
+  check.eq %result, dense<[3.0, 5.0, 0.0]> : tensor<3xf32>
+  func.return
+}
+
+// -----
+
+func.func @reduce_op_test_and_i1() {
+  %input = stablehlo.constant dense<[[true, false], [true, true]]> : tensor<2x2xi1>
+  %init_value = stablehlo.constant dense<true> : tensor<i1>
+  %result = "stablehlo.reduce"(%input, %init_value) ({
+    ^bb0(%arg0: tensor<i1>, %arg1: tensor<i1>):
+      %0 = "stablehlo.and"(%arg0, %arg1) : (tensor<i1>, tensor<i1>) -> tensor<i1>
+      "stablehlo.return"(%0) : (tensor<i1>) -> ()
+  }) {
+    dimensions = dense<1> : tensor<1xi64>
+  } : (tensor<2x2xi1>, tensor<i1>) -> tensor<2xi1>
+  check.eq %result, dense<[false, true]> : tensor<2xi1>
+  func.return
+}
+
+// -----
+
+func.func @reduce_op_test_empty_dimension_si64() {
+  %input = stablehlo.constant dense<> : tensor<2x0xi64>
+  %init_value = stablehlo.constant dense<1> : tensor<i64>
+  %result = "stablehlo.reduce"(%input, %init_value) ({
+    ^bb0(%arg0: tensor<i64>, %arg1: tensor<i64>):
+      %0 = "stablehlo.multiply"(%arg0, %arg1) : (tensor<i64>, tensor<i64>) -> tensor<i64>
+      "stablehlo.return"(%0) : (tensor<i64>) -> ()
+  }) {
+    dimensions = dense<1> : tensor<1xi64>
+  } : (tensor<2x0xi64>, tensor<i64>) -> tensor<2xi64>
+  check.eq %result, dense<1> : tensor<2xi64>
+  func.return
+}
+
+// -----
+
+func.func @reduce_op_test_f16() {
+  %input = stablehlo.constant dense<[1.5, 2.5, -1.0]> : tensor<3xf16>
+  %init_value = stablehlo.constant dense<0.5> : tensor<f16>
+  %result = "stablehlo.reduce"(%input, %init_value) ({
+    ^bb0(%arg0: tensor<f16>, %arg1: tensor<f16>):
+      %0 = "stablehlo.add"(%arg0, %arg1) : (tensor<f16>, tensor<f16>) -> tensor<f16>
+      "stablehlo.return"(%0) : (tensor<f16>) -> ()
+  }) {
+    dimensions = dense<0> : tensor<1xi64>
+  } : (tensor<3xf16>, tensor<f16>) -> tensor<f16>
+  check.eq %result, dense<3.5> : tensor<f16>
+  func.return
+}
+
+// -----
+
+func.func @reduce_op_test_variadic_si32() {
+  %input0 = stablehlo.constant dense<[[1, 2, 3], [4, 5, 6]]> : tensor<2x3xi32>
+  %input1 = stablehlo.constant dense<[[1, 2, 3], [4, 5, 6]]> : tensor<2x3xi32>
+  %init_value0 = stablehlo.constant dense<0> : tensor<i32>
+  %init_value1 = stablehlo.constant dense<1> : tensor<i32>
+  %result0, %result1 = "stablehlo.reduce"(%input0, %input1, %init_value0, %init_value1) ({
+    ^bb0(%arg0: tensor<i32>, %arg1: tensor<i32>, %arg2: tensor<i32>, %arg3: tensor<i32>):
+      %0 = "stablehlo.add"(%arg0, %arg2) : (tensor<i32>, tensor<i32>) -> tensor<i32>
+      %1 = "stablehlo.multiply"(%arg1, %arg3) : (tensor<i32>, tensor<i32>) -> tensor<i32>
+      "stablehlo.return"(%0, %1) : (tensor<i32>, tensor<i32>) -> ()
+  }) {
+    dimensions = dense<1> : tensor<1xi64>
+  } : (tensor<2x3xi32>, tensor<2x3xi32>, tensor<i32>, tensor<i32>) -> (tensor<2xi32>, tensor<2xi32>)
+  check.eq %result0, dense<[6, 15]> : tensor<2xi32>
+  check.eq %result1, dense<[6, 120]> : tensor<2xi32>
+  func.return
+}
+
+// -----
+
+// Large enough to be reduced by several threads.
+func.func @reduce_op_test_large_f32() {
+  %input = stablehlo.constant dense<1.0> : tensor<1000000xf32>
+  %init_value = stablehlo.constant dense<0.0> : tensor<f32>
+  %result = "stablehlo.reduce"(%input, %init_value) ({
+    ^bb0(%arg0: tensor<f32>, %arg1: tensor<f32>):
+      %0 = "stablehlo.add"(%arg0, %arg1) : (tensor<f32>, tensor<f32>) -> tensor<f32>
+      "stablehlo.return"(%0) : (tensor<f32>) -> ()
+  }) {
+    dimensions = dense<0> : tensor<1xi64>
+  } : (tensor<1000000xf32>, tensor<f32>) -> tensor<f32>
+  check.eq %result, dense<1000000.0> : tensor<f32>
+  func.return
+}
@@ -0,0 +1,72 @@
+// RUN: stablehlo-interpreter --interpret --num-replicas=4 -split-input-file %s
+// RUN: stablehlo-interpreter --interpret --num-replicas=4 --threads=4 --inter-op-parallelism -split-input-file %s
+
+func.func @reduce_scatter() {
+  %table = stablehlo.constant dense<[[1, 2, 3, 4], [10, 20, 30, 40], [100, 200, 300, 400], [1000, 2000, 3000, 4000]]> : tensor<4x4xi64>
+  %replica_id = "stablehlo.replica_id"() : () -> tensor<ui32>
+  %zero = stablehlo.constant dense<0> : tensor<ui32>
+  %row = "stablehlo.dynamic_slice"(%table, %replica_id, %zero) {
+    slice_sizes = dense<[1, 4]> : tensor<2xi64>
+  } : (tensor<4x4xi64>, tensor<ui32>, tensor<ui32>) -> tensor<1x4xi64>
+  %operand = "stablehlo.reshape"(%row) : (tensor<1x4xi64>) -> tensor<4xi64>
+  %result = "stablehlo.reduce_scatter"(%operand) ({
+    ^bb0(%arg0: tensor<i64>, %arg1: tensor<i64>):
+      %0 = "stablehlo.add"(%arg0, %arg1) : (tensor<i64>, tensor<i64>) -> tensor<i64>
+      "stablehlo.return"(%0) : (tensor<i64>) -> ()
+  }) {
+    scatter_dimension = 0 : i64,
+    replica_groups = dense<[[0, 1, 2, 3]]> : tensor<1x4xi64>
+  } : (tensor<4xi64>) -> tensor<1xi64>
+  %gathered = "stablehlo.all_gather"(%result) {
+    all_gather_dim = 0 : i64,
+    replica_groups = dense<[[0, 1, 2, 3]]> : tensor<1x4xi64>
+  } : (tensor<1xi64>) -> tensor<4xi64>
+  check.eq %gathered, dense<[1111, 2222, 3333, 4444]> : tensor<4xi64>
+  func.return
+}
+
+// -----
+
+func.func @reduce_scatter_replica_groups() {
+  %operand = stablehlo.constant dense<[[1.0, 2.0, 3.0, 4.0], [5.0, 6.0, 7.0, 8.0]]> : tensor<2x4xf32>
+  %result = "stablehlo.reduce_scatter"(%operand) ({
+    ^bb0(%arg0: tensor<f32>, %arg1: tensor<f32>):
+      %0 = "stablehlo.add"(%arg0, %arg1) : (tensor<f32>, tensor<f32>) -> tensor<f32>
+      "stablehlo.return"(%0) : (tensor<f32>) -> ()
+  }) {
+    scatter_dimension = 1 : i64,
+    replica_groups = dense<[[0, 1], [2, 3]]> : tensor<2x2xi64>
+  } : (tensor<2x4xf32>) -> tensor<2x2xf32>
+  %gathered = "stablehlo.all_gather"(%result) {
+    all_gather_dim = 0 : i64,
+    replica_groups = dense<[[0, 1, 2, 3]]> : tensor<1x4xi64>
+  } : (tensor<2x2xf32>) -> tensor<8x2xf32>
+  check.eq %gathered, dense<[[2.0, 4.0], [10.0, 12.0], [6.0, 8.0], [14.0, 16.0], [2.0, 4.0], [10.0, 12.0], [6.0, 8.0], [14.0, 16.0]]> : tensor<8x2xf32>
+  func.return
+}
+
+// -----
+
+func.func @reduce_scatter_subtract_in_group_order() {
+  %table = stablehlo.constant dense<[[1, 2, 3, 4], [10, 20, 30, 40], [100, 200, 300, 400], [1000, 2000, 3000, 4000]]> : tensor<4x4xi32>
+  %replica_id = "stablehlo.replica_id"() : () -> tensor<ui32>
+  %zero = stablehlo.constant dense<0> : tensor<ui32>
+  %row = "stablehlo.dynamic_slice"(%table, %replica_id, %zero) {
+    slice_sizes = dense<[1, 4]> : tensor<2xi64>
+  } : (tensor<4x4xi32>, tensor<ui32>, tensor<ui32>) -> tensor<1x4xi32>
+  %operand = "stablehlo.reshape"(%row) : (tensor<1x4xi32>) -> tensor<4xi32>
+  %result = "stablehlo.reduce_scatter"(%operand) ({
+    ^bb0(%arg0: tensor<i32>, %arg1: tensor<i32>):
+      %0 = "stablehlo.subtract"(%arg0, %arg1) : (tensor<i32>, tensor<i32>) -> tensor<i32>
+      "stablehlo.return"(%0) : (tensor<i32>) -> ()
+  }) {
+    scatter_dimension = 0 : i64,
+    replica_groups = dense<[[0, 1, 2, 3]]> : tensor<1x4xi64>
+  } : (tensor<4xi32>) -> tensor<1xi32>
+  %gathered = "stablehlo.all_gather"(%result) {
+    all_gather_dim = 0 : i64,
+    replica_groups = dense<[[0, 1, 2, 3]]> : tensor<1x4xi64>
+  } : (tensor<1xi32>) -> tensor<4xi32>
+  check.eq %gathered, dense<[-1109, -2218, -3327, -4436]> : tensor<4xi32>
+  func.return
+}
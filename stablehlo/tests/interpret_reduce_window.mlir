@@ -0,0 +1,109 @@
+// RUN: stablehlo-interpreter --interpret -split-input-file %s
+// RUN: stablehlo-interpreter --interpret --threads=4 -split-input-file %s
+
+func.func @reduce_window_op_test_si32() {
+  %input = stablehlo.constant dense<[[1, 2], [3, 4], [5, 6]]> : tensor<3x2xi32>
+  %init_value = stablehlo.constant dense<0> : tensor<i32>
+  %result = "stablehlo.reduce_window"(%input, %init_value) ({
+    ^bb0(%arg0: tensor<i32>, %arg1: tensor<i32>):
+      %0 = "stablehlo.add"(%arg0, %arg1) : (tensor<i32>, tensor<i32>) -> tensor<i32>
+      "stablehlo.return"(%0) : (tensor<i32>) -> ()
+  }) {
+    window_dimensions = dense<[2, 1]> : tensor<2xi64>,
+    window_strides = dense<[4, 1]> : tensor<2xi64>,
+    base_dilations = dense<[2, 1]> : tensor<2xi64>,
+    window_dilations = dense<[3, 1]> : tensor<2xi64>,
+    padding = dense<[[2, 1], [0, 0]]> : tensor<2x2xi64>
+  } : (tensor<3x2xi32>, tensor<i32>) -> tensor<2x2xi32>
+  check.eq %result, dense<[[0, 0], [3, 4]]> : tensor<2x2xi32>
+  func.return
+}
+
+// -----
+
+func.func @reduce_window_op_test_max_pool_f32() {
+  %input = stablehlo.constant dense<[[0.0, 1.0, 2.0, 3.0],
+                                     [4.0, 5.0, 6.0, 7.0],
+                                     [8.0, 9.0, 10.0, 11.0],
+                                     [12.0, 13.0, 14.0, 15.0]]> : tensor<4x4xf32>
+  %init_value = stablehlo.constant dense<0xFF800000> : tensor<f32>
+  %result = "stablehlo.reduce_window"(%input, %init_value) ({
+    ^bb0(%arg0: tensor<f32>, %arg1: tensor<f32>):
+      %0 = "stablehlo.maximum"(%arg0, %arg1) : (tensor<f32>, tensor<f32>) -> tensor<f32>
+      "stablehlo.return"(%0) : (tensor<f32>) -> ()
+  }) {
+    window_dimensions = dense<2> : tensor<2xi64>,
+    window_strides = dense<2> : tensor<2xi64>
+  } : (tensor<4x4xf32>, tensor<f32>) -> tensor<2x2xf32>
+  check.eq %result, dense<[[5.0, 7.0], [13.0, 15.0]]> : tensor<2x2xf32>
+  func.return
+}
+
+// -----
+
+func.func @reduce_window_op_test_padding_si64() {
+  %input = stablehlo.constant dense<1> : tensor<3x3xi64>
+  %init_value = stablehlo.constant dense<0> : tensor<i64>
+  %result = "stablehlo.reduce_window"(%input, %init_value) ({
+    ^bb0(%arg0: tensor<i64>, %arg1: tensor<i64>):
+      %0 = "stablehlo.add"(%arg0, %arg1) : (tensor<i64>, tensor<i64>) -> tensor<i64>
+      "stablehlo.return"(%0) : (tensor<i64>) -> ()
+  }) {
+    window_dimensions = dense<3> : tensor<2xi64>,
+    padding = dense<1> : tensor<2x2xi64>
+  } : (tensor<3x3xi64>, tensor<i64>) -> tensor<3x3xi64>
+  check.eq %result, dense<[[4, 6, 4], [6, 9, 6], [4, 6, 4]]> : tensor<3x3xi64>
+  func.return
+}
+
+// -----
+
+func.func @reduce_window_op_test_f16() {
+  %input = stablehlo.constant dense<[1.0, -2.0, 3.5, 0.5]> : tensor<4xf16>
+  %init_value = stablehlo.constant dense<0xFC00> : tensor<f16>
+  %result = "stablehlo.reduce_window"(%input, %init_value) ({
+    ^bb0(%arg0: tensor<f16>, %arg1: tensor<f16>):
+      %0 = "stablehlo.maximum"(%arg0, %arg1) : (tensor<f16>, tensor<f16>) -> tensor<f16>
+      "stablehlo.return"(%0) : (tensor<f16>) -> ()
+  }) {
+    window_dimensions = dense<2> : tensor<1xi64>
+  } : (tensor<4xf16>, tensor<f16>) -> tensor<3xf16>
+  check.eq %result, dense<[1.0, 3.5, 3.5]> : tensor<3xf16>
+  func.return
+}
+
+// -----
+
+func.func @reduce_window_op_test_variadic_si32() {
+  %input0 = stablehlo.constant dense<[[1, 2], [3, 4], [5, 6]]> : tensor<3x2xi32>
+  %input1 = stablehlo.constant dense<[[1, 2], [3, 4], [5, 6]]> : tensor<3x2xi32>
+  %init_value0 = stablehlo.constant dense<0> : tensor<i32>
+  %init_value1 = stablehlo.constant dense<1> : tensor<i32>
+  %result0, %result1 = "stablehlo.reduce_window"(%input0, %input1, %init_value0, %init_value1) ({
+    ^bb0(%arg0: tensor<i32>, %arg1: tensor<i32>, %arg2: tensor<i32>, %arg3: tensor<i32>):
+      %0 = "stablehlo.add"(%arg0, %arg2) : (tensor<i32>, tensor<i32>) -> tensor<i32>
+      %1 = "stablehlo.multiply"(%arg1, %arg3) : (tensor<i32>, tensor<i32>) -> tensor<i32>
+      "stablehlo.return"(%0, %1) : (tensor<i32>, tensor<i32>) -> ()
+  }) {
+    window_dimensions = dense<[2, 1]> : tensor<2xi64>
+  } : (tensor<3x2xi32>, tensor<3x2xi32>, tensor<i32>, tensor<i32>) -> (tensor<2x2xi32>, tensor<2x2xi32>)
+  check.eq %result0, dense<[[4, 6], [8, 10]]> : tensor<2x2xi32>
+  check.eq %result1, dense<[[3, 8], [15, 24]]> : tensor<2x2xi32>
+  func.return
+}
+
+// -----
+
+func.func @reduce_window_op_test_overlapping_windows_f32() {
+  %input = stablehlo.constant dense<[[1.0, 2.0, 3.0, 4.0], [5.0, 6.0, 7.0, 8.0], [9.0, 10.0, 11.0, 12.0], [13.0, 14.0, 15.0, 16.0]]> : tensor<4x4xf32>
+  %init_value = stablehlo.constant dense<0.0> : tensor<f32>
+  %result = "stablehlo.reduce_window"(%input, %init_value) ({
+    ^bb0(%arg0: tensor<f32>, %arg1: tensor<f32>):
+      %0 = "stablehlo.add"(%arg0, %arg1) : (tensor<f32>, tensor<f32>) -> tensor<f32>
+      "stablehlo.return"(%0) : (tensor<f32>) -> ()
+  }) {
+    window_dimensions = dense<2> : tensor<2xi64>
+  } : (tensor<4x4xf32>, tensor<f32>) -> tensor<3x3xf32>
+  check.eq %result, dense<[[14.0, 18.0, 22.0], [30.0, 34.0, 38.0], [46.0, 50.0, 54.0]]> : tensor<3x3xf32>
+  func.return
+}
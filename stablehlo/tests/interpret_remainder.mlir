@@ -0,0 +1,60 @@
+// RUN: stablehlo-interpreter --interpret -split-input-file %s
+// RUN: stablehlo-interpreter --interpret --threads=4 -split-input-file %s
+
+func.func @remainder_op_test_si32() {
+  %lhs = stablehlo.constant dense<[17, -17, 17, -17]> : tensor<4xi32>
+  %rhs = stablehlo.constant dense<[3, 3, -3, -3]> : tensor<4xi32>
+  %result = stablehlo.remainder %lhs, %rhs : tensor<4xi32>
+  check.eq %result, dense<[2, -2, 2, -2]> : tensor<4xi32>
+  func.return
+}
+
+// -----
+
+func.func @remainder_op_test_ui32() {
+  %lhs = stablehlo.constant dense<[17, 4294967295]> : tensor<2xui32>
+  %rhs = stablehlo.constant dense<[3, 10]> : tensor<2xui32>
+  %result = stablehlo.remainder %lhs, %rhs : tensor<2xui32>
+  check.eq %result, dense<[2, 5]> : tensor<2xui32>
+  func.return
+}
+
+// -----
+
+func.func @remainder_op_test_si8_overflow() {
+  %lhs = stablehlo.constant dense<-128> : tensor<i8>
+  %rhs = stablehlo.constant dense<-1> : tensor<i8>
+  %result = stablehlo.remainder %lhs, %rhs : tensor<i8>
+  check.eq %result, dense<0> : tensor<i8>
+  func.return
+}
+
+// -----
+
+func.func @remainder_op_test_f32() {
+  %lhs = stablehlo.constant dense<[17.1, -17.1, 17.1, -17.1]> : tensor<4xf32>
+  %rhs = stablehlo.constant dense<[3.0, 3.0, -3.0, -3.0]> : tensor<4xf32>
+  %result = stablehlo.remainder %lhs, %rhs : tensor<4xf32>
+  check.almost_eq %result, dense<[2.1000004, -2.1000004, 2.1000004, -2.1000004]> : tensor<4xf32>
+  func.return
+}
+
+// -----
+
+func.func @remainder_op_test_f64() {
+  %lhs = stablehlo.constant dense<[17.1, -17.1, 17.1, -17.1]> : tensor<4xf64>
+  %rhs = stablehlo.constant dense<[3.0, 3.0, -3.0, -3.0]> : tensor<4xf64>
+  %result = stablehlo.remainder %lhs, %rhs : tensor<4xf64>
+  check.almost_eq %result, dense<[2.1000000000000014, -2.1000000000000014, 2.1000000000000014, -2.1000000000000014]> : tensor<4xf64>
+  func.return
+}
+
+// -----
+
+func.func @remainder_op_test_f16() {
+  %lhs = stablehlo.constant dense<[5.5, -5.5]> : tensor<2xf16>
+  %rhs = stablehlo.constant dense<[2.0, 2.0]> : tensor<2xf16>
+  %result = stablehlo.remainder %lhs, %rhs : tensor<2xf16>
+  check.almost_eq %result, dense<[1.5, -1.5]> : tensor<2xf16>
+  func.return
+}
@@ -0,0 +1,21 @@
+// RUN: stablehlo-interpreter --interpret --num-replicas=4 -split-input-file %s
+// RUN: stablehlo-interpreter --interpret --num-replicas=4 --threads=4 -split-input-file %s
+
+func.func @replica_id() {
+  %replica_id = "stablehlo.replica_id"() : () -> tensor<ui32>
+  %operand = "stablehlo.reshape"(%replica_id) : (tensor<ui32>) -> tensor<1xui32>
+  %result = "stablehlo.all_gather"(%operand) {
+    all_gather_dim = 0 : i64,
+    replica_groups = dense<[[0, 1, 2, 3]]> : tensor<1x4xi64>
+  } : (tensor<1xui32>) -> tensor<4xui32>
+  check.eq %result, dense<[0, 1, 2, 3]> : tensor<4xui32>
+  func.return
+}
+
+// -----
+
+func.func @partition_id_single_partition() {
+  %partition_id = "stablehlo.partition_id"() : () -> tensor<ui32>
+  check.eq %partition_id, dense<0> : tensor<ui32>
+  func.return
+}
@@ -33,3 +33,13 @@ func.func @reshape_op_test_si32() {
   check.eq %1, dense<[1, 2, 3, 4, 5, 6]> : tensor<6xi32>
   func.return
 }
+
+// -----
+
+func.func @reshape_op_test_si32_transposed() {
+  %0 = stablehlo.constant dense<[[1,2,3],[4,5,6]]> : tensor<2x3xi32>
+  %1 = "stablehlo.transpose"(%0) {permutation = dense<[1,0]> : tensor<2xi64>} : (tensor<2x3xi32>) -> tensor<3x2xi32>
+  %2 = stablehlo.reshape %1 : (tensor<3x2xi32>) -> tensor<6xi32>
+  check.eq %2, dense<[1, 4, 2, 5, 3, 6]> : tensor<6xi32>
+  func.return
+}
@@ -0,0 +1,154 @@
+// RUN: stablehlo-interpreter --interpret -split-input-file %s
+// RUN: stablehlo-interpreter --interpret --threads=4 -split-input-file %s
+// RUN: stablehlo-interpreter --interpret -split-input-file %s > %t.serial
+// RUN: stablehlo-interpreter --interpret --threads=4 --inter-op-parallelism -split-input-file %s > %t.parallel
+// RUN: diff %t.serial %t.parallel
+// RUN: stablehlo-interpreter --interpret -split-input-file %s | FileCheck %s
+
+func.func @rng_op_test_uniform_si32() {
+  %a = stablehlo.constant dense<-3> : tensor<i32>
+  %b = stablehlo.constant dense<-2> : tensor<i32>
+  %shape = stablehlo.constant dense<[3, 3]> : tensor<2xi64>
+  %result = "stablehlo.rng"(%a, %b, %shape) {
+    rng_distribution = #stablehlo<rng_distribution UNIFORM>
+  } : (tensor<i32>, tensor<i32>, tensor<2xi64>) -> tensor<3x3xi32>
+  check.eq %result, dense<-3> : tensor<3x3xi32>
+  func.return
+}
+
+// -----
+
+func.func @rng_op_test_uniform_ui64() {
+  %a = stablehlo.constant dense<18446744073709551614> : tensor<ui64>
+  %b = stablehlo.constant dense<18446744073709551615> : tensor<ui64>
+  %shape = stablehlo.constant dense<[4]> : tensor<1xi64>
+  %result = "stablehlo.rng"(%a, %b, %shape) {
+    rng_distribution = #stablehlo<rng_distribution UNIFORM>
+  } : (tensor<ui64>, tensor<ui64>, tensor<1xi64>) -> tensor<4xui64>
+  check.eq %result, dense<18446744073709551614> : tensor<4xui64>
+  func.return
+}
+
+// -----
+
+func.func @rng_op_test_uniform_i1() {
+  %a = stablehlo.constant dense<false> : tensor<i1>
+  %b = stablehlo.constant dense<true> : tensor<i1>
+  %shape = stablehlo.constant dense<[5]> : tensor<1xi64>
+  %result = "stablehlo.rng"(%a, %b, %shape) {
+    rng_distribution = #stablehlo<rng_distribution UNIFORM>
+  } : (tensor<i1>, tensor<i1>, tensor<1xi64>) -> tensor<5xi1>
+  check.eq %result, dense<false> : tensor<5xi1>
+  func.return
+}
+
+// -----
+
+func.func @rng_op_test_uniform_f32() {
+  // The interval only contains `a`.
+  %a = stablehlo.constant dense<1.0> : tensor<f32>
+  %b = stablehlo.constant dense<1.00000012> : tensor<f32>
+  %shape = stablehlo.constant dense<[2, 3]> : tensor<2xi64>
+  %result = "stablehlo.rng"(%a, %b, %shape) {
+    rng_distribution = #stablehlo<rng_distribution UNIFORM>
+  } : (tensor<f32>, tensor<f32>, tensor<2xi64>) -> tensor<2x3xf32>
+  check.eq %result, dense<1.0> : tensor<2x3xf32>
+  func.return
+}
+
+// -----
+
+func.func @rng_op_test_uniform_f16() {
+  // The interval only contains `a`.
+  %a = stablehlo.constant dense<2.0> : tensor<f16>
+  %b = stablehlo.constant dense<2.001953125> : tensor<f16>
+  %shape = stablehlo.constant dense<[3]> : tensor<1xi64>
+  %result = "stablehlo.rng"(%a, %b, %shape) {
+    rng_distribution = #stablehlo<rng_distribution UNIFORM>
+  } : (tensor<f16>, tensor<f16>, tensor<1xi64>) -> tensor<3xf16>
+  check.eq %result, dense<2.0> : tensor<3xf16>
+  func.return
+}
+
+// -----
+
+func.func @rng_op_test_uniform_f64_bounds() {
+  %a = stablehlo.constant dense<-1.0> : tensor<f64>
+  %b = stablehlo.constant dense<1.0> : tensor<f64>
+  %shape = stablehlo.constant dense<[64]> : tensor<1xi64>
+  %result = "stablehlo.rng"(%a, %b, %shape) {
+    rng_distribution = #stablehlo<rng_distribution UNIFORM>
+  } : (tensor<f64>, tensor<f64>, tensor<1xi64>) -> tensor<64xf64>
+  %a_splat = "stablehlo.broadcast_in_dim"(%a) {
+    broadcast_dimensions = dense<[]> : tensor<0xi64>
+  } : (tensor<f64>) -> tensor<64xf64>
+  %b_splat = "stablehlo.broadcast_in_dim"(%b) {
+    broadcast_dimensions = dense<[]> : tensor<0xi64>
+  } : (tensor<f64>) -> tensor<64xf64>
+  %ge_a = "stablehlo.compare"(%result, %a_splat) {
+    comparison_direction = #stablehlo<comparison_direction GE>
+  } : (tensor<64xf64>, tensor<64xf64>) -> tensor<64xi1>
+  %lt_b = "stablehlo.compare"(%result, %b_splat) {
+    comparison_direction = #stablehlo<comparison_direction LT>
+  } : (tensor<64xf64>, tensor<64xf64>) -> tensor<64xi1>
+  check.eq %ge_a, dense<true> : tensor<64xi1>
+  check.eq %lt_b, dense<true> : tensor<64xi1>
+  func.return
+}
+
+// -----
+
+func.func @rng_op_test_normal_f32() {
+  // The standard deviation is 0.
+  %a = stablehlo.constant dense<3.5> : tensor<f32>
+  %b = stablehlo.constant dense<0.0> : tensor<f32>
+  %shape = stablehlo.constant dense<[4]> : tensor<1xi64>
+  %result = "stablehlo.rng"(%a, %b, %shape) {
+    rng_distribution = #stablehlo<rng_distribution NORMAL>
+  } : (tensor<f32>, tensor<f32>, tensor<1xi64>) -> tensor<4xf32>
+  check.eq %result, dense<3.5> : tensor<4xf32>
+  func.return
+}
+
+// -----
+
+// Independent `rng` ops draw the same values regardless of the schedule, and
+// every evaluation starts from the same state, so both functions return the
+// same values.
+// CHECK: tensor<2xui32> {
+// CHECK-NEXT: [[FIRST0:.*]]
+// CHECK-NEXT: [[FIRST1:.*]]
+// CHECK: tensor<2xui32> {
+// CHECK-NEXT: [[SECOND0:.*]]
+// CHECK-NEXT: [[SECOND1:.*]]
+// CHECK: tensor<2xui32> {
+// CHECK-NEXT: [[FIRST0]]
+// CHECK-NEXT: [[FIRST1]]
+// CHECK: tensor<2xui32> {
+// CHECK-NEXT: [[SECOND0]]
+// CHECK-NEXT: [[SECOND1]]
+func.func @rng_op_test_independent_ops() -> (tensor<2xui32>, tensor<2xui32>) {
+  %a = stablehlo.constant dense<0> : tensor<ui32>
+  %b = stablehlo.constant dense<4294967295> : tensor<ui32>
+  %shape = stablehlo.constant dense<2> : tensor<1xi64>
+  %0 = "stablehlo.rng"(%a, %b, %shape) {
+    rng_distribution = #stablehlo<rng_distribution UNIFORM>
+  } : (tensor<ui32>, tensor<ui32>, tensor<1xi64>) -> tensor<2xui32>
+  %1 = "stablehlo.rng"(%a, %b, %shape) {
+    rng_distribution = #stablehlo<rng_distribution UNIFORM>
+  } : (tensor<ui32>, tensor<ui32>, tensor<1xi64>) -> tensor<2xui32>
+  func.return %0, %1 : tensor<2xui32>, tensor<2xui32>
+}
+
+func.func @rng_op_test_independent_ops_again() -> (tensor<2xui32>, tensor<2xui32>) {
+  %a = stablehlo.constant dense<0> : tensor<ui32>
+  %b = stablehlo.constant dense<4294967295> : tensor<ui32>
+  %shape = stablehlo.constant dense<2> : tensor<1xi64>
+  %0 = "stablehlo.rng"(%a, %b, %shape) {
+    rng_distribution = #stablehlo<rng_distribution UNIFORM>
+  } : (tensor<ui32>, tensor<ui32>, tensor<1xi64>) -> tensor<2xui32>
+  %1 = "stablehlo.rng"(%a, %b, %shape) {
+    rng_distribution = #stablehlo<rng_distribution UNIFORM>
+  } : (tensor<ui32>, tensor<ui32>, tensor<1xi64>) -> tensor<2xui32>
+  func.return %0, %1 : tensor<2xui32>, tensor<2xui32>
+}
@@ -0,0 +1,62 @@
+// RUN: stablehlo-interpreter --interpret -split-input-file %s
+// RUN: stablehlo-interpreter --interpret --threads=4 -split-input-file %s
+
+func.func @rng_bit_generator_op_test_three_fry() {
+  %initial_state = stablehlo.constant dense<[1, 2]> : tensor<2xui64>
+  %output_state, %output = "stablehlo.rng_bit_generator"(%initial_state) {
+    rng_algorithm = #stablehlo<rng_algorithm THREE_FRY>
+  } : (tensor<2xui64>) -> (tensor<2xui64>, tensor<2x2xui64>)
+  check.eq %output_state, dense<[1, 6]> : tensor<2xui64>
+  check.eq %output, dense<[[9236835810183407956, 16087790271692313299],
+                           [18212823393184779219, 2658481902456610144]]> : tensor<2x2xui64>
+  func.return
+}
+
+// -----
+
+func.func @rng_bit_generator_op_test_three_fry_ui8() {
+  %initial_state = stablehlo.constant dense<[1, 2]> : tensor<2xui64>
+  %output_state, %output = "stablehlo.rng_bit_generator"(%initial_state) {
+    rng_algorithm = #stablehlo<rng_algorithm THREE_FRY>
+  } : (tensor<2xui64>) -> (tensor<2xui64>, tensor<10xui8>)
+  check.eq %output_state, dense<[1, 4]> : tensor<2xui64>
+  check.eq %output, dense<[84, 233, 150, 2, 59, 213, 47, 128, 211, 146]> : tensor<10xui8>
+  func.return
+}
+
+// -----
+
+func.func @rng_bit_generator_op_test_philox() {
+  %initial_state = stablehlo.constant dense<[5, 7]> : tensor<2xui64>
+  %output_state, %output = "stablehlo.rng_bit_generator"(%initial_state) {
+    rng_algorithm = #stablehlo<rng_algorithm PHILOX>
+  } : (tensor<2xui64>) -> (tensor<2xui64>, tensor<2x2xui64>)
+  check.eq %output_state, dense<[5, 9]> : tensor<2xui64>
+  check.eq %output, dense<[[10958159418354826246, 2010039072213502125],
+                           [1495503009147551558, 10531262360823183371]]> : tensor<2x2xui64>
+  func.return
+}
+
+// -----
+
+func.func @rng_bit_generator_op_test_philox_counter_carry() {
+  %initial_state = stablehlo.constant dense<[3, 18446744073709551615, 4]> : tensor<3xui64>
+  %output_state, %output = "stablehlo.rng_bit_generator"(%initial_state) {
+    rng_algorithm = #stablehlo<rng_algorithm PHILOX>
+  } : (tensor<3xui64>) -> (tensor<3xui64>, tensor<3xui32>)
+  check.eq %output_state, dense<[3, 0, 5]> : tensor<3xui64>
+  check.eq %output, dense<[1056563770, 1480421817, 3548832022]> : tensor<3xui32>
+  func.return
+}
+
+// -----
+
+func.func @rng_bit_generator_op_test_default_si4() {
+  %initial_state = stablehlo.constant dense<[0, 0]> : tensor<2xui64>
+  %output_state, %output = "stablehlo.rng_bit_generator"(%initial_state) {
+    rng_algorithm = #stablehlo<rng_algorithm DEFAULT>
+  } : (tensor<2xui64>) -> (tensor<2xui64>, tensor<6xi4>)
+  check.eq %output_state, dense<[0, 1]> : tensor<2xui64>
+  check.eq %output, dense<[5, -8, 7, 6, -3, 5]> : tensor<6xi4>
+  func.return
+}
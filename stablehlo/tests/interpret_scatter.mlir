@@ -0,0 +1,115 @@
+// RUN: stablehlo-interpreter --interpret -split-input-file %s
+// RUN: stablehlo-interpreter --interpret --threads=4 -split-input-file %s
+
+func.func @scatter_op_test_si32() {
+  %input = stablehlo.constant dense<[[[1, 2], [3, 4], [5, 6], [7, 8]],
+                                     [[9, 10], [11, 12], [13, 14], [15, 16]],
+                                     [[17, 18], [19, 20], [21, 22], [23, 24]]]> : tensor<3x4x2xi32>
+  %scatter_indices = stablehlo.constant dense<[[[0, 2], [1, 0], [2, 1]],
+                                               [[0, 1], [1, 0], [2, 0]]]> : tensor<2x3x2xi64>
+  %update = stablehlo.constant dense<1> : tensor<2x3x2x2xi32>
+  %result = "stablehlo.scatter"(%input, %scatter_indices, %update) ({
+    ^bb0(%arg0: tensor<i32>, %arg1: tensor<i32>):
+      %0 = "stablehlo.add"(%arg0, %arg1) : (tensor<i32>, tensor<i32>) -> tensor<i32>
+      "stablehlo.return"(%0) : (tensor<i32>) -> ()
+  }) {
+    scatter_dimension_numbers = #stablehlo.scatter<
+      update_window_dims = [2, 3],
+      inserted_window_dims = [0],
+      scatter_dims_to_operand_dims = [1, 0],
+      index_vector_dim = 2>,
+    indices_are_sorted = false,
+    unique_indices = false
+  } : (tensor<3x4x2xi32>, tensor<2x3x2xi64>, tensor<2x3x2x2xi32>) -> tensor<3x4x2xi32>
+  check.eq %result, dense<[[[1, 2], [5, 6], [8, 9], [8, 9]],
+                           [[10, 11], [12, 13], [14, 15], [16, 17]],
+                           [[18, 19], [20, 21], [21, 22], [23, 24]]]> : tensor<3x4x2xi32>
+  func.return
+}
+
+// -----
+
+func.func @scatter_op_test_replacement_si32() {
+  %input = stablehlo.constant dense<0> : tensor<2x3xi32>
+  %scatter_indices = stablehlo.constant dense<[[1], [0]]> : tensor<2x1xi64>
+  %update = stablehlo.constant dense<[[1, 2, 3], [4, 5, 6]]> : tensor<2x3xi32>
+  %result = "stablehlo.scatter"(%input, %scatter_indices, %update) ({
+    ^bb0(%arg0: tensor<i32>, %arg1: tensor<i32>):
+      "stablehlo.return"(%arg1) : (tensor<i32>) -> ()
+  }) {
+    scatter_dimension_numbers = #stablehlo.scatter<
+      update_window_dims = [1],
+      inserted_window_dims = [0],
+      scatter_dims_to_operand_dims = [0],
+      index_vector_dim = 1>
+  } : (tensor<2x3xi32>, tensor<2x1xi64>, tensor<2x3xi32>) -> tensor<2x3xi32>
+  check.eq %result, dense<[[4, 5, 6], [1, 2, 3]]> : tensor<2x3xi32>
+  func.return
+}
+
+// -----
+
+func.func @scatter_op_test_out_of_bounds_si32() {
+  %input = stablehlo.constant dense<0> : tensor<4xi32>
+  %scatter_indices = stablehlo.constant dense<[[-1], [3], [1]]> : tensor<3x1xi64>
+  %update = stablehlo.constant dense<[[1, 1], [2, 2], [3, 3]]> : tensor<3x2xi32>
+  %result = "stablehlo.scatter"(%input, %scatter_indices, %update) ({
+    ^bb0(%arg0: tensor<i32>, %arg1: tensor<i32>):
+      %0 = "stablehlo.add"(%arg0, %arg1) : (tensor<i32>, tensor<i32>) -> tensor<i32>
+      "stablehlo.return"(%0) : (tensor<i32>) -> ()
+  }) {
+    scatter_dimension_numbers = #stablehlo.scatter<
+      update_window_dims = [1],
+      inserted_window_dims = [],
+      scatter_dims_to_operand_dims = [0],
+      index_vector_dim = 1>
+  } : (tensor<4xi32>, tensor<3x1xi64>, tensor<3x2xi32>) -> tensor<4xi32>
+  check.eq %result, dense<[0, 3, 3, 0]> : tensor<4xi32>
+  func.return
+}
+
+// -----
+
+func.func @scatter_op_test_f16() {
+  %input = stablehlo.constant dense<[1.0, 2.0, 3.0]> : tensor<3xf16>
+  %scatter_indices = stablehlo.constant dense<[[1], [1]]> : tensor<2x1xi32>
+  %update = stablehlo.constant dense<[0.5, 0.25]> : tensor<2xf16>
+  %result = "stablehlo.scatter"(%input, %scatter_indices, %update) ({
+    ^bb0(%arg0: tensor<f16>, %arg1: tensor<f16>):
+      %0 = "stablehlo.add"(%arg0, %arg1) : (tensor<f16>, tensor<f16>) -> tensor<f16>
+      "stablehlo.return"(%0) : (tensor<f16>) -> ()
+  }) {
+    scatter_dimension_numbers = #stablehlo.scatter<
+      update_window_dims = [],
+      inserted_window_dims = [0],
+      scatter_dims_to_operand_dims = [0],
+      index_vector_dim = 1>
+  } : (tensor<3xf16>, tensor<2x1xi32>, tensor<2xf16>) -> tensor<3xf16>
+  check.eq %result, dense<[1.0, 2.75, 3.0]> : tensor<3xf16>
+  func.return
+}
+
+// -----
+
+func.func @scatter_op_test_variadic_si32() {
+  %input0 = stablehlo.constant dense<[1, 2, 3]> : tensor<3xi32>
+  %input1 = stablehlo.constant dense<[10, 20, 30]> : tensor<3xi32>
+  %scatter_indices = stablehlo.constant dense<[[0], [2]]> : tensor<2x1xi64>
+  %update0 = stablehlo.constant dense<[5, 6]> : tensor<2xi32>
+  %update1 = stablehlo.constant dense<[7, 8]> : tensor<2xi32>
+  %result0, %result1 = "stablehlo.scatter"(%input0, %input1, %scatter_indices, %update0, %update1) ({
+    ^bb0(%arg0: tensor<i32>, %arg1: tensor<i32>, %arg2: tensor<i32>, %arg3: tensor<i32>):
+      %0 = "stablehlo.add"(%arg0, %arg2) : (tensor<i32>, tensor<i32>) -> tensor<i32>
+      %1 = "stablehlo.multiply"(%arg1, %arg3) : (tensor<i32>, tensor<i32>) -> tensor<i32>
+      "stablehlo.return"(%0, %1) : (tensor<i32>, tensor<i32>) -> ()
+  }) {
+    scatter_dimension_numbers = #stablehlo.scatter<
+      update_window_dims = [],
+      inserted_window_dims = [0],
+      scatter_dims_to_operand_dims = [0],
+      index_vector_dim = 1>
+  } : (tensor<3xi32>, tensor<3xi32>, tensor<2x1xi64>, tensor<2xi32>, tensor<2xi32>) -> (tensor<3xi32>, tensor<3xi32>)
+  check.eq %result0, dense<[6, 2, 9]> : tensor<3xi32>
+  check.eq %result1, dense<[70, 20, 240]> : tensor<3xi32>
+  func.return
+}
@@ -0,0 +1,31 @@
+// RUN: stablehlo-interpreter --interpret -split-input-file %s
+// RUN: stablehlo-interpreter --interpret --threads=4 -split-input-file %s
+
+func.func @shift_left_op_test_si8() {
+  %lhs = stablehlo.constant dense<[-1, -2, 3, 4, 7, 7]> : tensor<6xi8>
+  %rhs = stablehlo.constant dense<[1, 2, 3, 6, 7, 8]> : tensor<6xi8>
+  %result = stablehlo.shift_left %lhs, %rhs : tensor<6xi8>
+  check.eq %result, dense<[-2, -8, 24, 0, -128, 0]> : tensor<6xi8>
+  func.return
+}
+
+// -----
+
+// Shift amounts are unsigned, so shifting by the bit width or more gives 0.
+func.func @shift_left_op_test_ui32() {
+  %lhs = stablehlo.constant dense<[1, 1, 1]> : tensor<3xui32>
+  %rhs = stablehlo.constant dense<[31, 32, 4294967295]> : tensor<3xui32>
+  %result = stablehlo.shift_left %lhs, %rhs : tensor<3xui32>
+  check.eq %result, dense<[2147483648, 0, 0]> : tensor<3xui32>
+  func.return
+}
+
+// -----
+
+func.func @shift_left_op_test_si4() {
+  %lhs = stablehlo.constant dense<[1, -1, 3]> : tensor<3xi4>
+  %rhs = stablehlo.constant dense<[3, 4, -1]> : tensor<3xi4>
+  %result = stablehlo.shift_left %lhs, %rhs : tensor<3xi4>
+  check.eq %result, dense<[-8, 0, 0]> : tensor<3xi4>
+  func.return
+}
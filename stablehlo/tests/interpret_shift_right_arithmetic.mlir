@@ -0,0 +1,41 @@
+// RUN: stablehlo-interpreter --interpret -split-input-file %s
+// RUN: stablehlo-interpreter --interpret --threads=4 -split-input-file %s
+
+func.func @shift_right_arithmetic_op_test_si8() {
+  %lhs = stablehlo.constant dense<[-1, -128, -36, 5, 3, 7]> : tensor<6xi8>
+  %rhs = stablehlo.constant dense<[1, 2, 3, 2, 1, 3]> : tensor<6xi8>
+  %result = stablehlo.shift_right_arithmetic %lhs, %rhs : tensor<6xi8>
+  check.eq %result, dense<[-1, -32, -5, 1, 1, 0]> : tensor<6xi8>
+  func.return
+}
+
+// -----
+
+// Shifting by the bit width or more fills all bits with the sign bit.
+func.func @shift_right_arithmetic_op_test_si32() {
+  %lhs = stablehlo.constant dense<[-8, -8, 8, 8]> : tensor<4xi32>
+  %rhs = stablehlo.constant dense<[1, 40, 40, -1]> : tensor<4xi32>
+  %result = stablehlo.shift_right_arithmetic %lhs, %rhs : tensor<4xi32>
+  check.eq %result, dense<[-4, -1, 0, 0]> : tensor<4xi32>
+  func.return
+}
+
+// -----
+
+func.func @shift_right_arithmetic_op_test_ui8() {
+  %lhs = stablehlo.constant dense<[128, 64]> : tensor<2xui8>
+  %rhs = stablehlo.constant dense<[1, 1]> : tensor<2xui8>
+  %result = stablehlo.shift_right_arithmetic %lhs, %rhs : tensor<2xui8>
+  check.eq %result, dense<[192, 32]> : tensor<2xui8>
+  func.return
+}
+
+// -----
+
+func.func @shift_right_arithmetic_op_test_si4() {
+  %lhs = stablehlo.constant dense<[-8, 7]> : tensor<2xi4>
+  %rhs = stablehlo.constant dense<[2, 4]> : tensor<2xi4>
+  %result = stablehlo.shift_right_arithmetic %lhs, %rhs : tensor<2xi4>
+  check.eq %result, dense<[-2, 0]> : tensor<2xi4>
+  func.return
+}
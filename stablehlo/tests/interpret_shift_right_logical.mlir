@@ -0,0 +1,30 @@
+// RUN: stablehlo-interpreter --interpret -split-input-file %s
+// RUN: stablehlo-interpreter --interpret --threads=4 -split-input-file %s
+
+func.func @shift_right_logical_op_test_si8() {
+  %lhs = stablehlo.constant dense<[-1, -128, -36, 5, 3, 7]> : tensor<6xi8>
+  %rhs = stablehlo.constant dense<[1, 2, 3, 2, 1, 3]> : tensor<6xi8>
+  %result = stablehlo.shift_right_logical %lhs, %rhs : tensor<6xi8>
+  check.eq %result, dense<[127, 32, 27, 1, 1, 0]> : tensor<6xi8>
+  func.return
+}
+
+// -----
+
+func.func @shift_right_logical_op_test_si64() {
+  %lhs = stablehlo.constant dense<[-1, -1, -1]> : tensor<3xi64>
+  %rhs = stablehlo.constant dense<[63, 64, -1]> : tensor<3xi64>
+  %result = stablehlo.shift_right_logical %lhs, %rhs : tensor<3xi64>
+  check.eq %result, dense<[1, 0, 0]> : tensor<3xi64>
+  func.return
+}
+
+// -----
+
+func.func @shift_right_logical_op_test_si4() {
+  %lhs = stablehlo.constant dense<[-8, -1]> : tensor<2xi4>
+  %rhs = stablehlo.constant dense<[1, 3]> : tensor<2xi4>
+  %result = stablehlo.shift_right_logical %lhs, %rhs : tensor<2xi4>
+  check.eq %result, dense<[4, 1]> : tensor<2xi4>
+  func.return
+}
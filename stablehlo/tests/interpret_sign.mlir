@@ -0,0 +1,37 @@
+// RUN: stablehlo-interpreter --interpret -split-input-file %s
+// RUN: stablehlo-interpreter --interpret --threads=4 -split-input-file %s
+
+func.func @sign_op_test_f32() {
+  // Logical values: -Inf, +Inf, NaN, ...
+  %operand = stablehlo.constant dense<[0xFF800000, 0x7F800000, 0x7FFFFFFF, -10.0, -0.0, 0.0, 10.0]> : tensor<7xf32>
+  %result = stablehlo.sign %operand : tensor<7xf32>
+  check.almost_eq %result, dense<[-1.0, 1.0, 0x7FFFFFFF, -1.0, -0.0, 0.0, 1.0]> : tensor<7xf32>
+  func.return
+}
+
+// -----
+
+func.func @sign_op_test_si32() {
+  %operand = stablehlo.constant dense<[-5, 0, 7, -2147483648]> : tensor<4xi32>
+  %result = stablehlo.sign %operand : tensor<4xi32>
+  check.eq %result, dense<[-1, 0, 1, -1]> : tensor<4xi32>
+  func.return
+}
+
+// -----
+
+func.func @sign_op_test_f16() {
+  %operand = stablehlo.constant dense<[-2.5, 0.0, 3.0, 0x7E00]> : tensor<4xf16>
+  %result = stablehlo.sign %operand : tensor<4xf16>
+  check.almost_eq %result, dense<[-1.0, 0.0, 1.0, 0x7E00]> : tensor<4xf16>
+  func.return
+}
+
+// -----
+
+func.func @sign_op_test_c128() {
+  %operand = stablehlo.constant dense<[(3.0, 4.0), (0.0, -2.0)]> : tensor<2xcomplex<f64>>
+  %result = stablehlo.sign %operand : tensor<2xcomplex<f64>>
+  check.almost_eq %result, dense<[(0.6, 0.8), (0.0, -1.0)]> : tensor<2xcomplex<f64>>
+  func.return
+}
@@ -27,6 +27,18 @@ func.func @sine_op_test_f32() {
 
 // -----
 
+func.func @sine_op_test_f32_negative_zero() {
+  // check.almost_eq doesn't tell -0 from +0, but their reciprocals differ.
+  %0 = stablehlo.constant dense<[-0.0, 0.0]> : tensor<2xf32>
+  %1 = stablehlo.sine %0 : tensor<2xf32>
+  %2 = stablehlo.constant dense<1.0> : tensor<2xf32>
+  %3 = stablehlo.divide %2, %1 : tensor<2xf32>
+  check.eq %3, dense<[0xFF800000, 0x7F800000]> : tensor<2xf32>
+  func.return
+}
+
+// -----
+
 func.func @sine_op_test_f64() {
   %0 = stablehlo.constant dense<[0.0, -0.0, 1.0, 0.125, 0.1, 3.1415926535897931, 0x7FF0000000000000, 0xFFF0000000000000, 0x7FFFFFFFFFFFFFFF, 0x0000000000000001, 0x8000000000000001]> : tensor<11xf64>
   %1 = stablehlo.sine %0 : tensor<11xf64>
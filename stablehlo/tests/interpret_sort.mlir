@@ -0,0 +1,142 @@
+// RUN: stablehlo-interpreter --interpret -split-input-file %s
+// RUN: stablehlo-interpreter --interpret --threads=4 -split-input-file %s
+
+func.func @sort_op_test_dimension_0_si32() {
+  %input0 = stablehlo.constant dense<[[1, 2, 3], [3, 2, 1]]> : tensor<2x3xi32>
+  %input1 = stablehlo.constant dense<[[3, 2, 1], [1, 2, 3]]> : tensor<2x3xi32>
+  %result0, %result1 = "stablehlo.sort"(%input0, %input1) ({
+    ^bb0(%arg0: tensor<i32>, %arg1: tensor<i32>, %arg2: tensor<i32>, %arg3: tensor<i32>):
+      %predicate = "stablehlo.compare"(%arg0, %arg1) {
+        comparison_direction = #stablehlo<comparison_direction GT>
+      } : (tensor<i32>, tensor<i32>) -> tensor<i1>
+      "stablehlo.return"(%predicate) : (tensor<i1>) -> ()
+  }) {
+    dimension = 0 : i64,
+    is_stable = true
+  } : (tensor<2x3xi32>, tensor<2x3xi32>) -> (tensor<2x3xi32>, tensor<2x3xi32>)
+  check.eq %result0, dense<[[3, 2, 3], [1, 2, 1]]> : tensor<2x3xi32>
+  check.eq %result1, dense<[[1, 2, 1], [3, 2, 3]]> : tensor<2x3xi32>
+  func.return
+}
+
+// -----
+
+func.func @sort_op_test_dimension_1_si32() {
+  %input0 = stablehlo.constant dense<[[1, 2, 3], [3, 2, 1]]> : tensor<2x3xi32>
+  %input1 = stablehlo.constant dense<[[3, 2, 1], [1, 2, 3]]> : tensor<2x3xi32>
+  %result0, %result1 = "stablehlo.sort"(%input0, %input1) ({
+    ^bb0(%arg0: tensor<i32>, %arg1: tensor<i32>, %arg2: tensor<i32>, %arg3: tensor<i32>):
+      %predicate = "stablehlo.compare"(%arg0, %arg1) {
+        comparison_direction = #stablehlo<comparison_direction GT>
+      } : (tensor<i32>, tensor<i32>) -> tensor<i1>
+      "stablehlo.return"(%predicate) : (tensor<i1>) -> ()
+  }) {
+    dimension = 1 : i64,
+    is_stable = true
+  } : (tensor<2x3xi32>, tensor<2x3xi32>) -> (tensor<2x3xi32>, tensor<2x3xi32>)
+  check.eq %result0, dense<[[3, 2, 1], [3, 2, 1]]> : tensor<2x3xi32>
+  check.eq %result1, dense<[[1, 2, 3], [1, 2, 3]]> : tensor<2x3xi32>
+  func.return
+}
+
+// -----
+
+func.func @sort_op_test_negative_dimension_unsigned_compare_si32() {
+  %input = stablehlo.constant dense<[[-1, 1, 0], [2, -2, 3]]> : tensor<2x3xi32>
+  %result = "stablehlo.sort"(%input) ({
+    ^bb0(%arg0: tensor<i32>, %arg1: tensor<i32>):
+      %predicate = "stablehlo.compare"(%arg0, %arg1) {
+        comparison_direction = #stablehlo<comparison_direction LT>,
+        compare_type = #stablehlo<comparison_type UNSIGNED>
+      } : (tensor<i32>, tensor<i32>) -> tensor<i1>
+      "stablehlo.return"(%predicate) : (tensor<i1>) -> ()
+  }) {
+    dimension = -1 : i64
+  } : (tensor<2x3xi32>) -> tensor<2x3xi32>
+  check.eq %result, dense<[[0, 1, -1], [2, 3, -2]]> : tensor<2x3xi32>
+  func.return
+}
+
+// -----
+
+func.func @sort_op_test_f16() {
+  %input = stablehlo.constant dense<[1.5, -2.0, 0.5, -0.25]> : tensor<4xf16>
+  %result = "stablehlo.sort"(%input) ({
+    ^bb0(%arg0: tensor<f16>, %arg1: tensor<f16>):
+      %predicate = "stablehlo.compare"(%arg1, %arg0) {
+        comparison_direction = #stablehlo<comparison_direction GT>
+      } : (tensor<f16>, tensor<f16>) -> tensor<i1>
+      "stablehlo.return"(%predicate) : (tensor<i1>) -> ()
+  }) {
+    dimension = 0 : i64
+  } : (tensor<4xf16>) -> tensor<4xf16>
+  check.eq %result, dense<[-2.0, -0.25, 0.5, 1.5]> : tensor<4xf16>
+  func.return
+}
+
+// -----
+
+// Large enough to be sorted by radix sort.
+func.func @sort_op_test_argsort_large_si32() {
+  %iota = stablehlo.iota dim = 0 : tensor<300xi32>
+  %input = "stablehlo.reverse"(%iota) {
+    dimensions = dense<0> : tensor<1xi64>
+  } : (tensor<300xi32>) -> tensor<300xi32>
+  %result0, %result1 = "stablehlo.sort"(%input, %iota) ({
+    ^bb0(%arg0: tensor<i32>, %arg1: tensor<i32>, %arg2: tensor<i32>, %arg3: tensor<i32>):
+      %predicate = "stablehlo.compare"(%arg0, %arg1) {
+        comparison_direction = #stablehlo<comparison_direction LT>
+      } : (tensor<i32>, tensor<i32>) -> tensor<i1>
+      "stablehlo.return"(%predicate) : (tensor<i1>) -> ()
+  }) {
+    dimension = 0 : i64
+  } : (tensor<300xi32>, tensor<300xi32>) -> (tensor<300xi32>, tensor<300xi32>)
+  %diff0 = stablehlo.subtract %result0, %iota : tensor<300xi32>
+  %diff1 = stablehlo.subtract %result1, %input : tensor<300xi32>
+  check.eq %diff0, dense<0> : tensor<300xi32>
+  check.eq %diff1, dense<0> : tensor<300xi32>
+  func.return
+}
+
+// -----
+
+func.func @sort_op_test_descending_large_f32() {
+  %input = stablehlo.iota dim = 1 : tensor<2x300xf32>
+  %result = "stablehlo.sort"(%input) ({
+    ^bb0(%arg0: tensor<f32>, %arg1: tensor<f32>):
+      %predicate = "stablehlo.compare"(%arg0, %arg1) {
+        comparison_direction = #stablehlo<comparison_direction GT>,
+        compare_type = #stablehlo<comparison_type TOTALORDER>
+      } : (tensor<f32>, tensor<f32>) -> tensor<i1>
+      "stablehlo.return"(%predicate) : (tensor<i1>) -> ()
+  }) {
+    dimension = 1 : i64
+  } : (tensor<2x300xf32>) -> tensor<2x300xf32>
+  %expected = "stablehlo.reverse"(%input) {
+    dimensions = dense<1> : tensor<1xi64>
+  } : (tensor<2x300xf32>) -> tensor<2x300xf32>
+  %diff = stablehlo.subtract %result, %expected : tensor<2x300xf32>
+  check.eq %diff, dense<0.0> : tensor<2x300xf32>
+  func.return
+}
+
+// -----
+
+// Comparators which aren't a single compare are evaluated for every
+// comparison.
+func.func @sort_op_test_comparator_region_i1() {
+  %input0 = stablehlo.constant dense<[true, false, true, false]> : tensor<4xi1>
+  %input1 = stablehlo.constant dense<[0, 1, 2, 3]> : tensor<4xi32>
+  %result0, %result1 = "stablehlo.sort"(%input0, %input1) ({
+    ^bb0(%arg0: tensor<i1>, %arg1: tensor<i1>, %arg2: tensor<i32>, %arg3: tensor<i32>):
+      %0 = "stablehlo.not"(%arg0) : (tensor<i1>) -> tensor<i1>
+      %1 = "stablehlo.and"(%0, %arg1) : (tensor<i1>, tensor<i1>) -> tensor<i1>
+      "stablehlo.return"(%1) : (tensor<i1>) -> ()
+  }) {
+    dimension = 0 : i64,
+    is_stable = true
+  } : (tensor<4xi1>, tensor<4xi32>) -> (tensor<4xi1>, tensor<4xi32>)
+  check.eq %result0, dense<[false, false, true, true]> : tensor<4xi1>
+  check.eq %result1, dense<[1, 3, 0, 2]> : tensor<4xi32>
+  func.return
+}
@@ -0,0 +1,21 @@
+// RUN: printf '\001\000\000\000\002\000\000\000' > %t.x.bin
+// RUN: stablehlo-interpreter --interpret --args=%t.x.bin,%t.x.bin --results=%t.y.npy %s
+// RUN: stablehlo-interpreter --interpret --args=%t.y.npy,%t.y.npy --results=%t.z.bin %s
+// RUN: printf '\004\000\000\000\010\000\000\000' > %t.expected.bin
+// RUN: cmp %t.z.bin %t.expected.bin
+// RUN: not stablehlo-interpreter --interpret --args=%t.x.bin %s 2>&1 | FileCheck %s
+// RUN: not stablehlo-interpreter --interpret --args=%t.x.bin,%t.x.bin --entry-function=add_op_test_si32_args %s 2>&1 | FileCheck %s --check-prefix=CHECK-ENTRY
+
+// CHECK: expected 2 argument files, but got 1
+// CHECK-ENTRY: expected an entry function @add_op_test_si32_args for the argument files
+func.func @main(%x: tensor<2xi32>, %y: tensor<2xi32>) -> tensor<2xi32> {
+  %result = stablehlo.add %x, %y : tensor<2xi32>
+  func.return %result : tensor<2xi32>
+}
+
+// Functions other than the entry function don't receive the arguments.
+func.func @constant_op_test_no_args() {
+  %result = stablehlo.constant dense<[1, 2]> : tensor<2xi32>
+  check.eq %result, dense<[1, 2]> : tensor<2xi32>
+  func.return
+}
@@ -0,0 +1,135 @@
+// RUN: stablehlo-interpreter --interpret -split-input-file %s
+// RUN: stablehlo-interpreter --interpret --threads=4 -split-input-file %s
+
+func.func @triangular_solve_op_test() {
+  %a = stablehlo.constant dense<[[1.0, 0.0, 0.0], [2.0, 4.0, 0.0], [3.0, 5.0, 6.0]]> : tensor<3x3xf32>
+  %b = stablehlo.constant dense<[[2.0, 0.0, 0.0], [4.0, 8.0, 0.0], [6.0, 10.0, 12.0]]> : tensor<3x3xf32>
+  %result = "stablehlo.triangular_solve"(%a, %b) {
+    left_side = true,
+    lower = true,
+    unit_diagonal = false,
+    transpose_a = #stablehlo<transpose NO_TRANSPOSE>
+  } : (tensor<3x3xf32>, tensor<3x3xf32>) -> tensor<3x3xf32>
+  check.eq %result, dense<[[2.0, 0.0, 0.0], [0.0, 2.0, 0.0], [0.0, 0.0, 2.0]]> : tensor<3x3xf32>
+  func.return
+}
+
+// -----
+
+func.func @triangular_solve_op_test_left_side_lower_transpose() {
+  %a = stablehlo.constant dense<[[2.0, 7.0, -9.0], [1.0, 4.0, 11.0], [3.0, -1.0, 1.0]]> : tensor<3x3xf32>
+  %b = stablehlo.constant dense<[[2.0, 11.0], [13.0, -5.0], [-1.0, 5.0]]> : tensor<3x2xf32>
+  %result = "stablehlo.triangular_solve"(%a, %b) {
+    left_side = true,
+    lower = true,
+    unit_diagonal = false,
+    transpose_a = #stablehlo<transpose TRANSPOSE>
+  } : (tensor<3x3xf32>, tensor<3x2xf32>) -> tensor<3x2xf32>
+  check.eq %result, dense<[[1.0, -2.0], [3.0, 0.0], [-1.0, 5.0]]> : tensor<3x2xf32>
+  func.return
+}
+
+// -----
+
+func.func @triangular_solve_op_test_left_side_upper() {
+  %a = stablehlo.constant dense<[[2.0, 7.0, -9.0], [1.0, 4.0, 11.0], [3.0, -1.0, 1.0]]> : tensor<3x3xf64>
+  %b = stablehlo.constant dense<[[32.0, -49.0], [1.0, 55.0], [-1.0, 5.0]]> : tensor<3x2xf64>
+  %result = "stablehlo.triangular_solve"(%a, %b) {
+    left_side = true,
+    lower = false,
+    unit_diagonal = false,
+    transpose_a = #stablehlo<transpose NO_TRANSPOSE>
+  } : (tensor<3x3xf64>, tensor<3x2xf64>) -> tensor<3x2xf64>
+  check.eq %result, dense<[[1.0, -2.0], [3.0, 0.0], [-1.0, 5.0]]> : tensor<3x2xf64>
+  func.return
+}
+
+// -----
+
+func.func @triangular_solve_op_test_right_side_lower() {
+  %a = stablehlo.constant dense<[[2.0, 7.0, -9.0], [1.0, 4.0, 11.0], [3.0, -1.0, 1.0]]> : tensor<3x3xf32>
+  %b = stablehlo.constant dense<[[9.0, -11.0, 3.0], [1.0, 17.0, -1.0]]> : tensor<2x3xf32>
+  %result = "stablehlo.triangular_solve"(%a, %b) {
+    left_side = false,
+    lower = true,
+    unit_diagonal = false,
+    transpose_a = #stablehlo<transpose NO_TRANSPOSE>
+  } : (tensor<3x3xf32>, tensor<2x3xf32>) -> tensor<2x3xf32>
+  check.eq %result, dense<[[1.0, -2.0, 3.0], [0.0, 4.0, -1.0]]> : tensor<2x3xf32>
+  func.return
+}
+
+// -----
+
+func.func @triangular_solve_op_test_right_side_upper_transpose() {
+  %a = stablehlo.constant dense<[[2.0, 7.0, -9.0], [1.0, 4.0, 11.0], [3.0, -1.0, 1.0]]> : tensor<3x3xf32>
+  %b = stablehlo.constant dense<[[-39.0, 25.0, 3.0], [37.0, 5.0, -1.0]]> : tensor<2x3xf32>
+  %result = "stablehlo.triangular_solve"(%a, %b) {
+    left_side = false,
+    lower = false,
+    unit_diagonal = false,
+    transpose_a = #stablehlo<transpose TRANSPOSE>
+  } : (tensor<3x3xf32>, tensor<2x3xf32>) -> tensor<2x3xf32>
+  check.eq %result, dense<[[1.0, -2.0, 3.0], [0.0, 4.0, -1.0]]> : tensor<2x3xf32>
+  func.return
+}
+
+// -----
+
+func.func @triangular_solve_op_test_unit_diagonal() {
+  %a = stablehlo.constant dense<[[2.0, 7.0, -9.0], [1.0, 4.0, 11.0], [3.0, -1.0, 1.0]]> : tensor<3x3xf32>
+  %b = stablehlo.constant dense<[[1.0, -2.0], [4.0, -2.0], [-1.0, -1.0]]> : tensor<3x2xf32>
+  %result = "stablehlo.triangular_solve"(%a, %b) {
+    left_side = true,
+    lower = true,
+    unit_diagonal = true,
+    transpose_a = #stablehlo<transpose NO_TRANSPOSE>
+  } : (tensor<3x3xf32>, tensor<3x2xf32>) -> tensor<3x2xf32>
+  check.eq %result, dense<[[1.0, -2.0], [3.0, 0.0], [-1.0, 5.0]]> : tensor<3x2xf32>
+  func.return
+}
+
+// -----
+
+func.func @triangular_solve_op_test_adjoint_complex() {
+  %a = stablehlo.constant dense<[[(2.0, 0.0), (0.0, 5.0), (0.0, 0.0)], [(1.0, 1.0), (4.0, 0.0), (1.0, 0.0)], [(3.0, 0.0), (2.0, -1.0), (0.0, 1.0)]]> : tensor<3x3xcomplex<f32>>
+  %b = stablehlo.constant dense<[[(10.0, 3.0)], [(6.0, -1.0)], [(0.0, -3.0)]]> : tensor<3x1xcomplex<f32>>
+  %result = "stablehlo.triangular_solve"(%a, %b) {
+    left_side = true,
+    lower = true,
+    unit_diagonal = false,
+    transpose_a = #stablehlo<transpose ADJOINT>
+  } : (tensor<3x3xcomplex<f32>>, tensor<3x1xcomplex<f32>>) -> tensor<3x1xcomplex<f32>>
+  check.eq %result, dense<[[(1.0, 2.0)], [(0.0, -1.0)], [(3.0, 0.0)]]> : tensor<3x1xcomplex<f32>>
+  func.return
+}
+
+// -----
+
+func.func @triangular_solve_op_test_right_side_adjoint_complex() {
+  %a = stablehlo.constant dense<[[(2.0, 0.0), (0.0, 5.0), (0.0, 0.0)], [(1.0, 1.0), (4.0, 0.0), (1.0, 0.0)], [(3.0, 0.0), (2.0, -1.0), (0.0, 1.0)]]> : tensor<3x3xcomplex<f32>>
+  %b = stablehlo.constant dense<[[(-3.0, 4.0), (3.0, -4.0), (0.0, -3.0)]]> : tensor<1x3xcomplex<f32>>
+  %result = "stablehlo.triangular_solve"(%a, %b) {
+    left_side = false,
+    lower = false,
+    unit_diagonal = false,
+    transpose_a = #stablehlo<transpose ADJOINT>
+  } : (tensor<3x3xcomplex<f32>>, tensor<1x3xcomplex<f32>>) -> tensor<1x3xcomplex<f32>>
+  check.eq %result, dense<[[(1.0, 2.0), (0.0, -1.0), (3.0, 0.0)]]> : tensor<1x3xcomplex<f32>>
+  func.return
+}
+
+// -----
+
+func.func @triangular_solve_op_test_batched() {
+  %a = stablehlo.constant dense<[[[2.0, 0.0], [1.0, 4.0]], [[1.0, 0.0], [-3.0, 2.0]]]> : tensor<2x2x2xf64>
+  %b = stablehlo.constant dense<[[[2.0], [9.0]], [[-1.0], [5.0]]]> : tensor<2x2x1xf64>
+  %result = "stablehlo.triangular_solve"(%a, %b) {
+    left_side = true,
+    lower = true,
+    unit_diagonal = false,
+    transpose_a = #stablehlo<transpose NO_TRANSPOSE>
+  } : (tensor<2x2x2xf64>, tensor<2x2x1xf64>) -> tensor<2x2x1xf64>
+  check.eq %result, dense<[[[1.0], [2.0]], [[-1.0], [1.0]]]> : tensor<2x2x1xf64>
+  func.return
+}
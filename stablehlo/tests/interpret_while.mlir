@@ -1,4 +1,5 @@
 // RUN: stablehlo-interpreter --interpret -split-input-file %s
+// RUN: stablehlo-interpreter --interpret --threads=4 --inter-op-parallelism -split-input-file %s
 
 func.func @while() {
   // int i = 10;
@@ -24,3 +25,93 @@ func.func @while() {
   check.eq %result_state, dense<10> : tensor<i64>
   func.return
 }
+
+// -----
+
+func.func @while_operand_used_in_body() {
+  %zero = stablehlo.constant dense<0> : tensor<i64>
+  %three = stablehlo.constant dense<3> : tensor<i64>
+  %result_i, %result_state = "stablehlo.while"(%three, %zero) ({
+    ^bb0(%i: tensor<i64>, %state: tensor<i64>):
+      %cond = stablehlo.convert %i : (tensor<i64>) -> tensor<i1>
+      stablehlo.return %cond : tensor<i1>
+  }, {
+    ^bb0(%i: tensor<i64>, %state: tensor<i64>):
+      %one = stablehlo.constant dense<1> : tensor<i64>
+      %new_i = stablehlo.subtract %i, %one : tensor<i64>
+      %new_state = stablehlo.add %state, %three : tensor<i64>
+      stablehlo.return %new_i, %new_state : tensor<i64>, tensor<i64>
+  }) : (tensor<i64>, tensor<i64>) -> (tensor<i64>, tensor<i64>)
+  check.eq %result_state, dense<9> : tensor<i64>
+  func.return
+}
+
+// -----
+
+func.func @while_operand_used_in_nested_region() {
+  %zero = stablehlo.constant dense<0> : tensor<i64>
+  %one = stablehlo.constant dense<1> : tensor<i64>
+  %three = stablehlo.constant dense<3> : tensor<i64>
+  %result_i, %result_state = "stablehlo.while"(%three, %zero) ({
+    ^bb0(%i: tensor<i64>, %state: tensor<i64>):
+      %cond = stablehlo.convert %i : (tensor<i64>) -> tensor<i1>
+      stablehlo.return %cond : tensor<i1>
+  }, {
+    ^bb0(%i: tensor<i64>, %state: tensor<i64>):
+      %new_i = stablehlo.subtract %i, %one : tensor<i64>
+      %pred = "stablehlo.compare"(%i, %one) {
+        comparison_direction = #stablehlo<comparison_direction NE>
+      } : (tensor<i64>, tensor<i64>) -> tensor<i1>
+      %new_state = "stablehlo.if"(%pred) ({
+        %0 = stablehlo.add %state, %three : tensor<i64>
+        stablehlo.return %0 : tensor<i64>
+      }, {
+        %1 = stablehlo.add %state, %one : tensor<i64>
+        stablehlo.return %1 : tensor<i64>
+      }) : (tensor<i1>) -> tensor<i64>
+      stablehlo.return %new_i, %new_state : tensor<i64>, tensor<i64>
+  }) : (tensor<i64>, tensor<i64>) -> (tensor<i64>, tensor<i64>)
+  check.eq %result_state, dense<7> : tensor<i64>
+  func.return
+}
+
+// -----
+
+func.func @while_loop_invariant_ops() {
+  %zero = stablehlo.constant dense<0> : tensor<i64>
+  %two = stablehlo.constant dense<2> : tensor<i64>
+  %result_i, %result_state, %result_step = "stablehlo.while"(%two, %zero, %zero) ({
+    ^bb0(%i: tensor<i64>, %state: tensor<i64>, %step: tensor<i64>):
+      %cond = stablehlo.convert %i : (tensor<i64>) -> tensor<i1>
+      stablehlo.return %cond : tensor<i1>
+  }, {
+    ^bb0(%i: tensor<i64>, %state: tensor<i64>, %step: tensor<i64>):
+      %one = stablehlo.constant dense<1> : tensor<i64>
+      %three = stablehlo.add %one, %two : tensor<i64>
+      %new_i = stablehlo.subtract %i, %one : tensor<i64>
+      %new_state = stablehlo.add %state, %three : tensor<i64>
+      stablehlo.return %new_i, %new_state, %three : tensor<i64>, tensor<i64>, tensor<i64>
+  }) : (tensor<i64>, tensor<i64>, tensor<i64>) -> (tensor<i64>, tensor<i64>, tensor<i64>)
+  check.eq %result_state, dense<6> : tensor<i64>
+  check.eq %result_step, dense<3> : tensor<i64>
+  func.return
+}
+
+// -----
+
+func.func @while_loop_invariant_ops_without_iterations() {
+  %zero = stablehlo.constant dense<0> : tensor<i64>
+  %result = "stablehlo.while"(%zero) ({
+    ^bb0(%i: tensor<i64>):
+      %cond = stablehlo.convert %i : (tensor<i64>) -> tensor<i1>
+      stablehlo.return %cond : tensor<i1>
+  }, {
+    ^bb0(%i: tensor<i64>):
+      %one = stablehlo.constant dense<1> : tensor<i64>
+      %invalid = stablehlo.divide %one, %zero : tensor<i64>
+      %new_i = stablehlo.add %i, %invalid : tensor<i64>
+      stablehlo.return %new_i : tensor<i64>
+  }) : (tensor<i64>) -> tensor<i64>
+  check.eq %result, dense<0> : tensor<i64>
+  func.return
+}
@@ -13,23 +13,107 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/raw_ostream.h"
 #include "mlir/Dialect/Func/IR/FuncOps.h"
 #include "mlir/IR/OpDefinition.h"
 #include "mlir/Support/DebugStringHelper.h"
 #include "mlir/Tools/mlir-translate/MlirTranslateMain.h"
 #include "mlir/Tools/mlir-translate/Translation.h"
 #include "stablehlo/dialect/StablehloOps.h"
+#include "stablehlo/reference/BufferPool.h"
 #include "stablehlo/reference/Errors.h"
 #include "stablehlo/reference/Ops.h"
+#include "stablehlo/reference/Parallel.h"
+#include "stablehlo/reference/Process.h"
 #include "stablehlo/reference/Scope.h"
 #include "stablehlo/reference/Tensor.h"
+#include "stablehlo/reference/TensorFile.h"
 #include "stablehlo/tests/CheckOps.h"
 
 namespace mlir {
 
+llvm::cl::opt<unsigned> numThreads(
+    "threads",
+    llvm::cl::desc("Number of threads used by interpreter kernels, 0 for one "
+                   "per hardware thread"),
+    llvm::cl::init(1));
+
+llvm::cl::opt<bool> interOpParallelism(
+    "inter-op-parallelism",
+    llvm::cl::desc("Evaluate independent ops of a region concurrently when "
+                   "using multiple threads"),
+    llvm::cl::init(false));
+
+llvm::cl::opt<bool> pairwiseSummation(
+    "pairwise-summation",
+    llvm::cl::desc("Use pairwise summation in reductions which add up "
+                   "floating-point elements"),
+    llvm::cl::init(false));
+
+llvm::cl::opt<unsigned> numReplicas(
+    "num-replicas",
+    llvm::cl::desc("Number of replicas of the process grid. Every process "
+                   "of the grid evaluates every function on its own thread"),
+    llvm::cl::init(1));
+
+llvm::cl::opt<unsigned> numPartitions(
+    "num-partitions",
+    llvm::cl::desc("Number of partitions of the process grid"),
+    llvm::cl::init(1));
+
+llvm::cl::opt<bool> printBufferPoolStatistics(
+    "print-buffer-pool-statistics",
+    llvm::cl::desc("Print the counters of the buffer pool of the interpreter "
+                   "to stderr after evaluation"),
+    llvm::cl::init(false));
+
+llvm::cl::opt<std::string> entryFunction(
+    "entry-function",
+    llvm::cl::desc("Name of the function which receives the arguments given "
+                   "by --args"),
+    llvm::cl::init("main"));
+
+llvm::cl::list<std::string> argFiles(
+    "args",
+    llvm::cl::desc("Comma-separated files which hold the arguments of the "
+                   "entry function, either NumPy arrays (.npy) or raw "
+                   "elements"),
+    llvm::cl::CommaSeparated);
+
+llvm::cl::list<std::string> resultFiles(
+    "results",
+    llvm::cl::desc("Comma-separated files which the results are written to "
+                   "instead of being printed, in the order in which they "
+                   "would be printed"),
+    llvm::cl::CommaSeparated);
+
 TranslateFromMLIRRegistration stablehlo_interpreter(
     "interpret", "Interpreter for StableHLO",
     [](ModuleOp module, raw_ostream &os) {
+      stablehlo::setNumThreads(numThreads);
+      stablehlo::setInterOpParallelism(interOpParallelism);
+      stablehlo::setPairwiseSummation(pairwiseSummation);
+      stablehlo::ProcessGrid processGrid(numReplicas, numPartitions);
+      uint32_t numProcesses = processGrid.getNumProcesses();
+      if (numProcesses > 1 &&
+          !module.getContext()->isMultithreadingEnabled()) {
+        module.emitError(
+            "evaluating multiple processes requires multithreading");
+        return failure();
+      }
+      if (!argFiles.empty() &&
+          !module.lookupSymbol<func::FuncOp>(entryFunction)) {
+        module.emitError() << "expected an entry function @" << entryFunction
+                           << " for the argument files";
+        return failure();
+      }
+      size_t numResultsWritten = 0;
       auto walkResult = module.walk([&](func::FuncOp funcOp) {
         auto evalCheckOps = [&](Operation &op,
                                 stablehlo::Scope &scope) -> llvm::Error {
@@ -59,14 +143,90 @@ TranslateFromMLIRRegistration stablehlo_interpreter(
           return llvm::Error::success();
         };
 
-        // Run the test model.
-        auto results = stablehlo::eval(funcOp.getBody(), {}, /*parent=*/nullptr,
-                                       evalCheckOps);
+        // Map the arguments of the entry function into memory. All processes
+        // share them, which is fine because tensors read from files are
+        // immutable. Other functions are evaluated without arguments.
+        SmallVector<stablehlo::Tensor> args;
+        if (!argFiles.empty() && funcOp.getSymName() == entryFunction) {
+          if (funcOp.getNumArguments() != argFiles.size()) {
+            funcOp.emitError() << "expected " << funcOp.getNumArguments()
+                               << " argument files, but got "
+                               << argFiles.size();
+            return WalkResult::interrupt();
+          }
+          for (auto [argFile, argType] :
+               llvm::zip(argFiles, funcOp.getArgumentTypes())) {
+            auto tensorType = argType.dyn_cast<TensorType>();
+            if (!tensorType) {
+              funcOp.emitError() << "expected tensor arguments, but got "
+                                 << argType;
+              return WalkResult::interrupt();
+            }
+            auto arg = stablehlo::readTensorFile(argFile, tensorType);
+            if (!arg) {
+              funcOp.emitError() << toString(arg.takeError());
+              return WalkResult::interrupt();
+            }
+            args.push_back(std::move(*arg));
+          }
+        }
+
+        // Run the test model, once per process of the process grid.
+        SmallVector<SmallVector<stablehlo::Tensor>> results(numProcesses);
+        auto evalProcess = [&](uint32_t flattenedId) {
+          uint32_t numPartitions = processGrid.getNumPartitions();
+          stablehlo::Process process(
+              {flattenedId / numPartitions, flattenedId % numPartitions},
+              processGrid);
+          stablehlo::Scope root(/*parent=*/nullptr, &process);
+          results[flattenedId] =
+              stablehlo::eval(funcOp.getBody(), args, &root, evalCheckOps);
+        };
+        if (numProcesses == 1) {
+          evalProcess(0);
+        } else {
+          std::vector<std::thread> threads;
+          for (uint32_t flattenedId = 0; flattenedId < numProcesses;
+               ++flattenedId)
+            threads.emplace_back(evalProcess, flattenedId);
+          for (auto &thread : threads) thread.join();
+        }
 
-        // Dump the results.
-        for (auto &result : results) result.print(os);
+        // Dump the results, ordered by process.
+        for (auto &processResults : results) {
+          for (auto &result : processResults) {
+            if (resultFiles.empty()) {
+              result.print(os);
+              continue;
+            }
+            if (numResultsWritten == resultFiles.size()) {
+              funcOp.emitError() << "expected more than "
+                                 << resultFiles.size() << " result files";
+              return WalkResult::interrupt();
+            }
+            if (auto error = stablehlo::writeTensorFile(
+                    result, resultFiles[numResultsWritten++])) {
+              funcOp.emitError() << toString(std::move(error));
+              return WalkResult::interrupt();
+            }
+          }
+        }
         return WalkResult::advance();
       });
+      if (!walkResult.wasInterrupted() && !resultFiles.empty() &&
+          numResultsWritten != resultFiles.size()) {
+        module.emitError() << "expected " << numResultsWritten
+                           << " result files, but got " << resultFiles.size();
+        return failure();
+      }
+
+      if (printBufferPoolStatistics) {
+        auto statistics = stablehlo::getBufferPoolStatistics();
+        llvm::errs() << "buffer pool: " << statistics.numHits << " hits, "
+                     << statistics.numMisses << " misses, "
+                     << statistics.peakBytesInUse << " peak bytes in use, "
+                     << statistics.numBytesCached << " bytes cached\n";
+      }
 
       return success(!walkResult.wasInterrupted());
     },